@@ -15,7 +15,7 @@
 #include <list>
 #include <unordered_map>
 
-#include "common/logger.h" /* for debugging, delete after pass all the test */
+#include "common/logger.h"
 
 namespace bustub {
 
@@ -45,15 +45,16 @@ Page *BufferPoolManager::FetchPageImpl(page_id_t page_id) {
   // 3.     Delete R from the page table and insert P.
   // 4.     Update P's metadata, read in the page content from disk, and then return a pointer to P.
 
+  std::lock_guard<std::mutex> guard(latch_);
+
   /* S1: Search the page table for the requested page (P) */
   /* S1.1: IF P exists, pin it and return it immediately */
-  if (page_table_.find(page_id) != page_table_.end()) {
-    frame_id_t p_requested = page_table_[page_id]; /* the requested page (P) */
+  auto it = page_table_.find(page_id);
+  if (it != page_table_.end()) {
+    frame_id_t p_requested = it->second; /* the requested page (P) */
 
     replacer_->Pin(p_requested); /* pin it */
     pages_[p_requested].pin_count_ += 1;
-
-    LOG_INFO("Fetch page %d from mem", page_id);
     return &pages_[p_requested];
   }
   /* S1.2: If P does NOT exist, find a replacement page (R) */
@@ -71,8 +72,6 @@ Page *BufferPoolManager::FetchPageImpl(page_id_t page_id) {
     pages_[r_target].is_dirty_ = false;
     page_table_[page_id] = r_target;
     disk_manager_->ReadPage(page_id, pages_[r_target].data_);
-
-    LOG_INFO("Fetch page %d from the fl", page_id);
     return &pages_[r_target];
   }
 
@@ -88,12 +87,8 @@ Page *BufferPoolManager::FetchPageImpl(page_id_t page_id) {
   evict_page = pages_[r_target].GetPageId(); /* get the victim page id */
 
   /* S2 IF: R is dirty, write it back to the disk */
-  if (pages_[r_target].IsDirty()) {           /* page in memory has been modified from that on disk */
-    bool flu_suc = FlushPageImpl(evict_page); /* flush the victim page to disk first */
-    /* IF evict_page could not be found in the page table */
-    if (!flu_suc) {
-      return nullptr;
-    }
+  if (pages_[r_target].IsDirty()) { /* page in memory has been modified from that on disk */
+    FlushFrame(r_target);           /* flush the victim page to disk first */
   }
 
   replacer_->Pin(r_target);
@@ -110,53 +105,58 @@ Page *BufferPoolManager::FetchPageImpl(page_id_t page_id) {
 }
 
 bool BufferPoolManager::UnpinPageImpl(page_id_t page_id, bool is_dirty) {
-  frame_id_t frame;
+  std::lock_guard<std::mutex> guard(latch_);
 
   /* IF: page NOT found */
-  if (page_table_.find(page_id) == page_table_.end()) {
-    LOG_INFO("Unpin page %d from non-ex", page_id);
+  auto it = page_table_.find(page_id);
+  if (it == page_table_.end()) {
     return true;
   }
 
   /* IF: return false if the page pin count is <= 0 before this call */
-  frame = page_table_[page_id];
+  frame_id_t frame = it->second;
   if (pages_[frame].GetPinCount() <= 0) {
     LOG_ERROR("Unpin page %d failed, pincnt <= 0", page_id);
     return false;
   }
 
-  /* CASE: the page CAN be unpinned */
+  /* CASE: the page CAN be unpinned, it only becomes a victim candidate once nobody holds it */
   pages_[frame].pin_count_--;
   pages_[frame].is_dirty_ |= is_dirty;
-  replacer_->Unpin(frame);
-  LOG_INFO("Unpin page %d from bf, present pin_cnt: %d", page_id, pages_[frame].pin_count_);
+  if (pages_[frame].pin_count_ == 0) {
+    replacer_->Unpin(frame);
+  }
   return true;
 }
 
 bool BufferPoolManager::FlushPageImpl(page_id_t page_id) {
-  frame_id_t frame;
   // Make sure you call DiskManager::WritePage!
+  std::lock_guard<std::mutex> guard(latch_);
 
   /* IF: page NOT found */
-  if (page_table_.find(page_id) == page_table_.end()) {
-    LOG_ERROR("Flush page %d failed, not found in page table", page_id);
+  auto it = page_table_.find(page_id);
+  if (it == page_table_.end()) {
     return false; /* return false if the page could not be found in the page table */
   }
 
-  /* IF: the page hasn't been modified */
-  frame = page_table_[page_id];
-  if (!pages_[frame].IsDirty()) {
-    LOG_INFO("Flush page %d without dirty", page_id);
-    return true;
+  /* IF: the page hasn't been modified, there is nothing to write */
+  if (pages_[it->second].IsDirty()) {
+    FlushFrame(it->second);
   }
-
-  /* CASE: the page has been modified, write back to disk first */
-  disk_manager_->WritePage(page_id, pages_[frame].data_);
-  pages_[frame].is_dirty_ = false;
-  LOG_INFO("Flush page %d dirty, write back to disk", page_id);
   return true;
 }
 
+void BufferPoolManager::FlushFrame(frame_id_t frame_id) {
+  Page *page = &pages_[frame_id];
+  /* WAL: every log record describing this page must be durable before the page itself. This also holds while
+   * recovery writes compensation log records, which happens before logging is enabled. */
+  if (log_manager_ != nullptr && page->GetLSN() > log_manager_->GetPersistentLSN()) {
+    log_manager_->Flush();
+  }
+  disk_manager_->WritePage(page->GetPageId(), page->GetData());
+  page->is_dirty_ = false;
+}
+
 Page *BufferPoolManager::NewPageImpl(page_id_t *page_id) {
   // 0.   Make sure you call DiskManager::AllocatePage!
   // 1.   If all the pages in the buffer pool are pinned, return nullptr.
@@ -164,6 +164,8 @@ Page *BufferPoolManager::NewPageImpl(page_id_t *page_id) {
   // 3.   Update P's metadata, zero out memory and add P to the page table.
   // 4.   Set the page ID output parameter. Return a pointer to P.
 
+  std::lock_guard<std::mutex> guard(latch_);
+
   /* S2 IF: there's free page in fl, pick a victim page P from fl */
   if (!free_list_.empty()) {
     frame_id_t free_id = free_list_.front();
@@ -177,33 +179,24 @@ Page *BufferPoolManager::NewPageImpl(page_id_t *page_id) {
     pages_[free_id].is_dirty_ = false;
     replacer_->Pin(free_id);
     page_table_[*page_id] = free_id;
-
-    LOG_INFO("New page %d created from fl", *page_id);
     return &pages_[free_id];
   }
 
   /* There's NO free page in fl */
   /* S2 CASE: there's free page in replacer, pick a victim page P from replacer */
-  LOG_INFO("No free page in fl, pick a victim page P from replacer...");
   frame_id_t candi_id;
   page_id_t victim_id;
   bool evict_suc = replacer_->Victim(&candi_id);
 
   /* S1 IF: all the pages in the buffer pool are pinned, return nullptr */
   if (!evict_suc) { /* there's NO space in replacer */
-    LOG_INFO("All the pages in the buffer pool are pinned, return nullptr");
     return nullptr;
   }
 
   /* IF: candi page is dirty, then flush the dirty page */
   victim_id = pages_[candi_id].GetPageId();
   if (pages_[candi_id].IsDirty()) {
-    bool flu_suc = FlushPageImpl(victim_id);
-    /* IF the dirty candi page could not be found in the page table */
-    if (!flu_suc) {
-      LOG_INFO("The dirty candi page could not be found in the page table");
-      return nullptr;
-    }
+    FlushFrame(candi_id);
   }
 
   /* S3: Update P's metadata, zero out memory and add P to the page table */
@@ -218,7 +211,6 @@ Page *BufferPoolManager::NewPageImpl(page_id_t *page_id) {
   page_table_[*page_id] = candi_id;
 
   /* S4: set the page ID output parameter. Return a pointer to P */
-  LOG_INFO("New page %d created from replacer", *page_id);
   return &pages_[candi_id];
 }
 
@@ -229,14 +221,16 @@ bool BufferPoolManager::DeletePageImpl(page_id_t page_id) {
   // 2.   If P exists, but has a non-zero pin-count, return false. Someone is using the page.
   // 3.   Otherwise, P can be deleted. Remove P from the page table, reset its metadata and return it to the free list.
 
+  std::lock_guard<std::mutex> guard(latch_);
+
   /* IF S1: P does NOT exist, return true. */
-  if (page_id == INVALID_PAGE_ID || page_table_.find(page_id) == page_table_.end()) {
-    LOG_INFO("Delete non-ex page %d suc", page_id);
+  auto it = page_table_.find(page_id);
+  if (page_id == INVALID_PAGE_ID || it == page_table_.end()) {
     return true;
   }
 
   /* CASE S2&3: P exists */
-  frame_id_t delete_id = page_table_[page_id]; /* Search the page table for the requested page (P) */
+  frame_id_t delete_id = it->second; /* Search the page table for the requested page (P) */
 
   /* IF S2: P has a non-zero pin-count, return false. Someone is using the page */
   if (pages_[delete_id].GetPinCount() != 0) {
@@ -246,22 +240,21 @@ bool BufferPoolManager::DeletePageImpl(page_id_t page_id) {
 
   /* CASE S3: P can be deleted */
   disk_manager_->DeallocatePage(page_id);
+  replacer_->Pin(delete_id);                    /* the frame must not be victimized from the free list */
   page_table_.erase(page_id);                   /* remove P from the page table */
   pages_[delete_id].page_id_ = INVALID_PAGE_ID; /* reset P's metadata */
   pages_[delete_id].is_dirty_ = false;          /* reset P's metadata */
   free_list_.push_back(delete_id);              /* return P to the free list */
-
-  LOG_INFO("Del page %d suc, from bf", page_id);
   return true;
 }
 
 void BufferPoolManager::FlushAllPagesImpl() {
+  std::lock_guard<std::mutex> guard(latch_);
   for (size_t i = 0; i < pool_size_; i++) {
-    if (pages_[i].IsDirty()) {
-      FlushPageImpl(pages_[i].GetPageId());
+    if (pages_[i].GetPageId() != INVALID_PAGE_ID && pages_[i].IsDirty()) {
+      FlushFrame(static_cast<frame_id_t>(i));
     }
   }
-  LOG_INFO("All pages have been flushed!");
 }
 
 }  // namespace bustub
@@ -76,7 +76,7 @@ bool ClockReplacer::Victim(frame_id_t *frame_id) {
  */
 void ClockReplacer::Pin(frame_id_t frame_id) {
   /* IF frame_id is valid */
-  if (frame_id < buffer_size && frame_id > 0) {
+  if (frame_id >= 0 && frame_id < buffer_size) {
     /* remove the frame containing the pinned page from the ClockReplacer */
     inflag[frame_id] = false;
   }
@@ -88,7 +88,7 @@ void ClockReplacer::Pin(frame_id_t frame_id) {
  */
 void ClockReplacer::Unpin(frame_id_t frame_id) {
   /* IF frame_id is valid */
-  if (frame_id < buffer_size || frame_id > 0) {
+  if (frame_id >= 0 && frame_id < buffer_size) {
     /* add the frame containing the unpinned page to the ClockReplacer */
     inflag[frame_id] = true;
     reflag[frame_id] = true;
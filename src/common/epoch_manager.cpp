@@ -0,0 +1,134 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// epoch_manager.cpp
+//
+// Identification: src/common/epoch_manager.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/epoch_manager.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+namespace {
+
+/**
+ * Hands out the slot index of a thread while it runs, so that indexes are reused by later threads. A thread that finds
+ * every index taken gets an exception, and another index the next time it enters an epoch.
+ */
+class ThreadIndex {
+ public:
+  ThreadIndex() {
+    std::lock_guard<std::mutex> guard(latch_);
+    auto it = std::find(in_use_.begin(), in_use_.end(), false);
+    if (it == in_use_.end()) {
+      throw Exception(ExceptionType::OUT_OF_RANGE, "Too many threads use epochs at the same time.");
+    }
+    *it = true;
+    index_ = it - in_use_.begin();
+  }
+
+  ~ThreadIndex() {
+    std::lock_guard<std::mutex> guard(latch_);
+    in_use_[index_] = false;
+  }
+
+  size_t GetIndex() const { return index_; }
+
+ private:
+  static std::mutex latch_;
+  static std::vector<bool> in_use_;
+  size_t index_;
+};
+
+std::mutex ThreadIndex::latch_;
+std::vector<bool> ThreadIndex::in_use_(EPOCH_MAX_THREADS, false);
+
+/** @return the slot index of the calling thread */
+size_t GetThreadIndex() {
+  static thread_local ThreadIndex index;
+  return index.GetIndex();
+}
+
+}  // namespace
+
+EpochManager::EpochManager(size_t reclaim_batch)
+    : slots_(new Slot[EPOCH_MAX_THREADS]), reclaim_batch_(std::max<size_t>(reclaim_batch, 1)) {}
+
+EpochManager::~EpochManager() {
+  BUSTUB_ASSERT(GetMinEpoch() == INACTIVE, "No thread may be inside an epoch of a destroyed epoch manager.");
+  for (auto &item : retired_) {
+    item.second();
+  }
+}
+
+void EpochManager::Enter() {
+  Slot &slot = slots_[GetThreadIndex()];
+  if (slot.depth_++ == 0) {
+    // Sequentially consistent, so that a retiring thread either sees this epoch or the object was unlinked before
+    // this thread can look for it.
+    slot.epoch_.store(global_epoch_.load());
+  }
+}
+
+void EpochManager::Exit() {
+  Slot &slot = slots_[GetThreadIndex()];
+  BUSTUB_ASSERT(slot.depth_ > 0, "The thread is not inside an epoch.");
+  if (--slot.depth_ == 0) {
+    slot.epoch_.store(INACTIVE, std::memory_order_release);
+  }
+}
+
+void EpochManager::Retire(std::function<void()> reclaim) {
+  bool full;
+  {
+    std::lock_guard<std::mutex> guard(retired_latch_);
+    // Threads entering from now on cannot find the object, they get a later epoch.
+    retired_.emplace_back(global_epoch_.fetch_add(1), std::move(reclaim));
+    full = retired_.size() >= reclaim_batch_;
+  }
+  if (full) {
+    Reclaim();
+  }
+}
+
+size_t EpochManager::Reclaim() {
+  uint64_t min_epoch = GetMinEpoch();
+  std::vector<std::function<void()>> reclaimable;
+  {
+    std::lock_guard<std::mutex> guard(retired_latch_);
+    while (!retired_.empty() && retired_.front().first < min_epoch) {
+      reclaimable.push_back(std::move(retired_.front().second));
+      retired_.pop_front();
+    }
+  }
+  // The reclaim functions may take latches of their own.
+  for (auto &reclaim : reclaimable) {
+    reclaim();
+  }
+  return reclaimable.size();
+}
+
+size_t EpochManager::GetNumRetired() {
+  std::lock_guard<std::mutex> guard(retired_latch_);
+  return retired_.size();
+}
+
+uint64_t EpochManager::GetMinEpoch() {
+  uint64_t min_epoch = INACTIVE;
+  for (size_t i = 0; i < EPOCH_MAX_THREADS; i++) {
+    min_epoch = std::min(min_epoch, slots_[i].epoch_.load());
+  }
+  return min_epoch;
+}
+
+}  // namespace bustub
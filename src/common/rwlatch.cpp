@@ -0,0 +1,197 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// rwlatch.cpp
+//
+// Identification: src/common/rwlatch.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/rwlatch.h"
+
+#include <climits>
+#include <thread>  // NOLINT
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <condition_variable>  // NOLINT
+#endif
+
+namespace bustub {
+
+namespace {
+
+/** How often a waiting thread checks the latch again before it goes to sleep. */
+constexpr int SPIN_COUNT = 64;
+
+/** Tells the CPU that the thread is spinning. */
+inline void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
+#ifdef __linux__
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "A futex is a plain 32-bit word.");
+
+/** Sleeps until word is woken up, unless it no longer holds expected. */
+void FutexWait(std::atomic<uint32_t> *word, uint32_t expected) {
+  syscall(SYS_futex, reinterpret_cast<uint32_t *>(word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+}
+
+/** Wakes all threads sleeping on word. */
+void FutexWakeAll(std::atomic<uint32_t> *word) {
+  syscall(SYS_futex, reinterpret_cast<uint32_t *>(word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+}
+
+#else
+
+/** Without futexes, threads sleep on a condition variable picked by the address of the word. */
+struct alignas(CACHE_LINE_SIZE) ParkingSlot {
+  std::mutex latch_;
+  std::condition_variable cv_;
+};
+
+constexpr size_t NUM_PARKING_SLOTS = 64;
+
+ParkingSlot *GetParkingSlot(std::atomic<uint32_t> *word) {
+  static ParkingSlot slots[NUM_PARKING_SLOTS];
+  return &slots[(reinterpret_cast<uintptr_t>(word) / sizeof(uint32_t)) % NUM_PARKING_SLOTS];
+}
+
+void FutexWait(std::atomic<uint32_t> *word, uint32_t expected) {
+  ParkingSlot *slot = GetParkingSlot(word);
+  std::unique_lock<std::mutex> lock(slot->latch_);
+  // A waker changes the word before it takes the latch, so the change cannot be missed.
+  if (word->load() == expected) {
+    slot->cv_.wait(lock);
+  }
+}
+
+void FutexWakeAll(std::atomic<uint32_t> *word) {
+  ParkingSlot *slot = GetParkingSlot(word);
+  std::lock_guard<std::mutex> guard(slot->latch_);
+  slot->cv_.notify_all();
+}
+
+#endif
+
+}  // namespace
+
+void ReaderWriterLatch::WLockSlow() {
+  // Enter as the writer, which keeps new readers out.
+  int spins = 0;
+  while (true) {
+    uint32_t state = state_.load(std::memory_order_relaxed);
+    if ((state & WRITER) == 0) {
+      if (state_.compare_exchange_weak(state, state | WRITER, std::memory_order_acquire)) {
+        break;
+      }
+    } else if (spins++ < SPIN_COUNT) {
+      CpuRelax();
+    } else {
+      Wait(state);
+    }
+  }
+  // Wait for the readers to leave.
+  spins = 0;
+  while (true) {
+    uint32_t state = state_.load(std::memory_order_acquire);
+    if ((state & READER_MASK) == 0) {
+      return;
+    }
+    if (spins++ < SPIN_COUNT) {
+      CpuRelax();
+    } else {
+      Wait(state);
+    }
+  }
+}
+
+void ReaderWriterLatch::RLockSlow() {
+  int spins = 0;
+  while (true) {
+    uint32_t state = state_.load(std::memory_order_relaxed);
+    if ((state & WRITER) == 0 && (state & READER_MASK) != READER_MASK) {
+      if (state_.compare_exchange_weak(state, state + 1, std::memory_order_acquire)) {
+        return;
+      }
+    } else if (spins++ < SPIN_COUNT) {
+      CpuRelax();
+    } else {
+      Wait(state);
+    }
+  }
+}
+
+void ReaderWriterLatch::RUnlockSlow() {
+  uint32_t state = state_.load(std::memory_order_relaxed);
+  while ((state & WAITERS) != 0) {
+    if (state_.compare_exchange_weak(state, state & ~WAITERS, std::memory_order_relaxed)) {
+      WakeAll();
+      return;
+    }
+  }
+}
+
+void ReaderWriterLatch::Wait(uint32_t state) {
+  if ((state & WAITERS) == 0) {
+    if (!state_.compare_exchange_strong(state, state | WAITERS, std::memory_order_relaxed)) {
+      // The latch changed, the caller looks at it again.
+      return;
+    }
+    state |= WAITERS;
+  }
+  FutexWait(&state_, state);
+}
+
+void ReaderWriterLatch::WakeAll() { FutexWakeAll(&state_); }
+
+void DistributedReaderWriterLatch::WLock() {
+  writer_latch_.lock();
+  writer_.store(1);
+  for (size_t i = 0; i < NUM_SLOTS; i++) {
+    int spins = 0;
+    while (slots_[i].readers_.load(std::memory_order_acquire) != 0) {
+      // Readers do not wake up writers, write latching is rare enough to poll.
+      if (spins++ < SPIN_COUNT) {
+        CpuRelax();
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  }
+}
+
+void DistributedReaderWriterLatch::WUnlock() {
+  writer_.store(0);
+  FutexWakeAll(&writer_);
+  writer_latch_.unlock();
+}
+
+void DistributedReaderWriterLatch::RLockSlow(std::atomic<uint32_t> *readers) {
+  do {
+    // Step aside, so that the writer can drain the slot.
+    readers->fetch_sub(1, std::memory_order_release);
+    int spins = 0;
+    while (writer_.load() != 0) {
+      if (spins++ < SPIN_COUNT) {
+        CpuRelax();
+      } else {
+        FutexWait(&writer_, 1);
+      }
+    }
+    readers->fetch_add(1);
+  } while (writer_.load() != 0);
+}
+
+}  // namespace bustub
@@ -12,56 +12,708 @@
 
 #include "concurrency/lock_manager.h"
 
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <limits>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
 namespace bustub {
 
-bool LockManager::LockShared(Transaction *txn, const RID &rid) {
+/*
+ * COMPATIBLE[requested][held], in the order of LockMode: IS, IX, S, SIX, X.
+ */
+static constexpr bool COMPATIBLE[5][5] = {{true, true, true, true, false},
+                                          {true, true, false, false, false},
+                                          {true, false, true, false, false},
+                                          {true, false, false, false, false},
+                                          {false, false, false, false, false}};
+
+bool LockManager::LockShared(Transaction *txn, const RID &rid, LockWaitPolicy wait_policy) {
+  if (!CanLock(txn)) {
+    return false;
+  }
+  if (txn->IsSharedLocked(rid) || txn->IsExclusiveLocked(rid)) {
+    return true;
+  }
+  if (!Acquire(txn, LockTarget::Row(rid), LockMode::SHARED, wait_policy)) {
+    return false;
+  }
   txn->GetSharedLockSet()->emplace(rid);
   return true;
 }
 
-bool LockManager::LockExclusive(Transaction *txn, const RID &rid) {
+bool LockManager::LockExclusive(Transaction *txn, const RID &rid, LockWaitPolicy wait_policy) {
+  if (!CanLock(txn)) {
+    return false;
+  }
+  if (txn->IsExclusiveLocked(rid)) {
+    return true;
+  }
+  if (!Acquire(txn, LockTarget::Row(rid), LockMode::EXCLUSIVE, wait_policy)) {
+    return false;
+  }
   txn->GetExclusiveLockSet()->emplace(rid);
   return true;
 }
 
-bool LockManager::LockUpgrade(Transaction *txn, const RID &rid) {
-  txn->GetSharedLockSet()->erase(rid);
-  txn->GetExclusiveLockSet()->emplace(rid);
-  return true;
+bool LockManager::LockUpgrade(Transaction *txn, const RID &rid, LockWaitPolicy wait_policy) {
+  if (!CanLock(txn)) {
+    return false;
+  }
+  if (txn->IsExclusiveLocked(rid)) {
+    return true;
+  }
+  BUSTUB_ASSERT(txn->IsSharedLocked(rid), "Only shared locks can be upgraded.");
+  bool granted = Strengthen(txn, LockTarget::Row(rid), LockMode::EXCLUSIVE, wait_policy);
+  if (granted || wait_policy == LockWaitPolicy::BLOCK) {
+    txn->GetSharedLockSet()->erase(rid);
+  }
+  if (granted) {
+    txn->GetExclusiveLockSet()->emplace(rid);
+  }
+  return granted;
 }
 
 bool LockManager::Unlock(Transaction *txn, const RID &rid) {
   txn->GetSharedLockSet()->erase(rid);
   txn->GetExclusiveLockSet()->erase(rid);
+  return Release(txn, LockTarget::Row(rid));
+}
+
+bool LockManager::LockTable(Transaction *txn, table_oid_t oid, LockMode lock_mode, LockWaitPolicy wait_policy) {
+  // A held lock is good for any state of the transaction, e.g. while it rolls back.
+  auto held = txn->GetTableLockMap()->find(oid);
+  if (held != txn->GetTableLockMap()->end() && Covers(held->second, lock_mode)) {
+    return true;
+  }
+  if (!CanLock(txn)) {
+    return false;
+  }
+  return LockGranule(txn, LockTarget::Table(oid), txn->GetTableLockMap().get(), oid, lock_mode, wait_policy);
+}
+
+bool LockManager::LockPage(Transaction *txn, table_oid_t oid, page_id_t page_id, LockMode lock_mode,
+                           LockWaitPolicy wait_policy) {
+  if (!CanLock(txn)) {
+    return false;
+  }
+  if (!HoldsIntention(txn, oid, lock_mode)) {
+    txn->SetState(TransactionState::ABORTED);
+    return false;
+  }
+  auto table_lock = txn->GetTableLockMap()->find(oid);
+  if (Covers(table_lock->second, lock_mode)) {
+    return true;
+  }
+  return LockGranule(txn, LockTarget::Page(page_id), txn->GetPageLockMap().get(), page_id, lock_mode, wait_policy);
+}
+
+bool LockManager::LockRow(Transaction *txn, table_oid_t oid, const RID &rid, LockMode lock_mode,
+                          LockWaitPolicy wait_policy) {
+  BUSTUB_ASSERT(lock_mode == LockMode::SHARED || lock_mode == LockMode::EXCLUSIVE, "Rows have no intention locks.");
+  if (oid != INVALID_TABLE_OID) {
+    // A scan that locked the whole table or page does not add a request per row. Like a held table lock, the covering
+    // lock is good for any state of the transaction.
+    auto table_lock = txn->GetTableLockMap()->find(oid);
+    if (table_lock != txn->GetTableLockMap()->end() && Covers(table_lock->second, lock_mode)) {
+      return true;
+    }
+    auto page_lock = txn->GetPageLockMap()->find(rid.GetPageId());
+    if (page_lock != txn->GetPageLockMap()->end() && Covers(page_lock->second, lock_mode)) {
+      return true;
+    }
+  }
+  if (!CanLock(txn)) {
+    return false;
+  }
+  if (oid != INVALID_TABLE_OID && !HoldsIntention(txn, oid, lock_mode)) {
+    txn->SetState(TransactionState::ABORTED);
+    return false;
+  }
+  bool held = txn->IsSharedLocked(rid) || txn->IsExclusiveLocked(rid);
+  bool locked;
+  if (lock_mode == LockMode::SHARED) {
+    locked = LockShared(txn, rid, wait_policy);
+  } else {
+    locked = txn->IsSharedLocked(rid) ? LockUpgrade(txn, rid, wait_policy) : LockExclusive(txn, rid, wait_policy);
+  }
+  if (locked && !held && oid != INVALID_TABLE_OID) {
+    auto &row_locks = (*txn->GetRowLockMap())[oid];
+    row_locks.push_back(rid);
+    // Escalation is retried after every escalation_threshold_ further row locks, in case it could not be granted.
+    if (row_locks.size() > escalation_threshold_ && (row_locks.size() - 1) % escalation_threshold_ == 0) {
+      Escalate(txn, oid);
+    }
+  }
+  return locked;
+}
+
+bool LockManager::UnlockTable(Transaction *txn, table_oid_t oid) {
+  txn->GetTableLockMap()->erase(oid);
+  return Release(txn, LockTarget::Table(oid));
+}
+
+bool LockManager::UnlockPage(Transaction *txn, page_id_t page_id) {
+  txn->GetPageLockMap()->erase(page_id);
+  return Release(txn, LockTarget::Page(page_id));
+}
+
+bool LockManager::Covers(LockMode held, LockMode requested) {
+  switch (held) {
+    case LockMode::EXCLUSIVE:
+      return true;
+    case LockMode::SHARED_INTENTION_EXCLUSIVE:
+      return requested != LockMode::EXCLUSIVE;
+    case LockMode::SHARED:
+    case LockMode::INTENTION_EXCLUSIVE:
+      return requested == held || requested == LockMode::INTENTION_SHARED;
+    case LockMode::INTENTION_SHARED:
+      return requested == LockMode::INTENTION_SHARED;
+  }
+  UNREACHABLE("Unknown lock mode.");
+}
+
+LockMode LockManager::Combine(LockMode held, LockMode requested) {
+  if (Covers(held, requested)) {
+    return held;
+  }
+  if (Covers(requested, held)) {
+    return requested;
+  }
+  // The remaining pairs are S and IX, or one of them with SIX, or anything with X, which Covers handles.
+  return LockMode::SHARED_INTENTION_EXCLUSIVE;
+}
+
+bool LockManager::HoldsIntention(Transaction *txn, table_oid_t oid, LockMode lock_mode) {
+  auto table_lock = txn->GetTableLockMap()->find(oid);
+  if (table_lock == txn->GetTableLockMap()->end()) {
+    return false;
+  }
+  if (lock_mode == LockMode::SHARED || lock_mode == LockMode::INTENTION_SHARED) {
+    return true;
+  }
+  return table_lock->second == LockMode::INTENTION_EXCLUSIVE ||
+         table_lock->second == LockMode::SHARED_INTENTION_EXCLUSIVE || table_lock->second == LockMode::EXCLUSIVE;
+}
+
+template <typename Key>
+bool LockManager::LockGranule(Transaction *txn, const LockTarget &target, std::unordered_map<Key, LockMode> *lock_map,
+                              Key key, LockMode lock_mode, LockWaitPolicy wait_policy) {
+  auto held = lock_map->find(key);
+  if (held == lock_map->end()) {
+    if (!Acquire(txn, target, lock_mode, wait_policy)) {
+      return false;
+    }
+    lock_map->emplace(key, lock_mode);
+    return true;
+  }
+  if (Covers(held->second, lock_mode)) {
+    return true;
+  }
+  LockMode upgraded = Combine(held->second, lock_mode);
+  if (!Strengthen(txn, target, upgraded, wait_policy)) {
+    if (wait_policy == LockWaitPolicy::BLOCK) {
+      lock_map->erase(held);
+    }
+    return false;
+  }
+  held->second = upgraded;
+  return true;
+}
+
+bool LockManager::Strengthen(Transaction *txn, const LockTarget &target, LockMode lock_mode,
+                             LockWaitPolicy wait_policy) {
+  if (wait_policy == LockWaitPolicy::BLOCK) {
+    return Upgrade(txn, target, lock_mode);
+  }
+  // An upgrade that does not wait can be made in place, which keeps the held lock if it fails.
+  return TryUpgrade(txn, target, lock_mode) || FailWithoutWaiting(txn, wait_policy);
+}
+
+size_t LockManager::GetNumLockRequests() {
+  size_t num_requests = 0;
+  for (size_t i = 0; i < num_stripes_; i++) {
+    std::lock_guard<std::mutex> guard(stripes_[i].latch_);
+    for (const auto &queue : stripes_[i].lock_table_) {
+      num_requests += queue.second.request_queue_.size();
+    }
+  }
+  return num_requests;
+}
+
+size_t LockManager::GetLockTableMemory() {
+  // Hash map and list nodes carry a next pointer and a cached hash, or a next and a previous pointer respectively.
+  const size_t queue_size = sizeof(LockTarget) + sizeof(LockRequestQueue) + 2 * sizeof(void *);
+  const size_t request_size = sizeof(LockRequest) + 2 * sizeof(void *);
+  size_t num_queues = 0;
+  size_t num_requests = 0;
+  for (size_t i = 0; i < num_stripes_; i++) {
+    std::lock_guard<std::mutex> guard(stripes_[i].latch_);
+    num_queues += stripes_[i].lock_table_.size();
+    for (const auto &queue : stripes_[i].lock_table_) {
+      num_requests += queue.second.request_queue_.size();
+    }
+  }
+  return num_queues * queue_size + num_requests * request_size;
+}
+
+void LockManager::Escalate(Transaction *txn, table_oid_t oid) {
+  auto &row_locks = (*txn->GetRowLockMap())[oid];
+  bool exclusive = std::any_of(row_locks.begin(), row_locks.end(), [txn](const RID &rid) {
+    return txn->IsExclusiveLocked(rid);
+  });
+  // A writer keeps the IX part of its table lock, so that it can go on locking rows exclusively.
+  LockMode &table_mode = txn->GetTableLockMap()->at(oid);
+  LockMode escalated = Combine(table_mode, exclusive ? LockMode::EXCLUSIVE : LockMode::SHARED);
+  if (!TryUpgrade(txn, LockTarget::Table(oid), escalated)) {
+    return;
+  }
+  table_mode = escalated;
+  num_escalations_++;
+
+  // Rows locked in a mode the table lock does not cover, i.e. exclusively under SIX, stay locked.
+  std::vector<RID> remaining;
+  for (const auto &rid : row_locks) {
+    bool shared = txn->IsSharedLocked(rid);
+    if (!shared && !txn->IsExclusiveLocked(rid)) {
+      continue;
+    }
+    if (!Covers(escalated, shared ? LockMode::SHARED : LockMode::EXCLUSIVE)) {
+      remaining.push_back(rid);
+      continue;
+    }
+    txn->GetSharedLockSet()->erase(rid);
+    txn->GetExclusiveLockSet()->erase(rid);
+    RemoveRequest(txn, LockTarget::Row(rid));
+  }
+  row_locks = std::move(remaining);
+}
+
+bool LockManager::TryUpgrade(Transaction *txn, const LockTarget &target, LockMode lock_mode) {
+  LockTableStripe *stripe = GetStripe(target);
+  std::lock_guard<std::mutex> guard(stripe->latch_);
+  LockRequestQueue &queue = stripe->lock_table_.find(target)->second;
+  if (queue.upgrading_) {
+    return false;
+  }
+  auto &requests = queue.request_queue_;
+  auto request = requests.end();
+  for (auto it = requests.begin(); it != requests.end(); ++it) {
+    if (it->txn_id_ == txn->GetTransactionId()) {
+      request = it;
+    } else if (it->granted_ && !COMPATIBLE[static_cast<int>(lock_mode)][static_cast<int>(it->lock_mode_)]) {
+      return false;
+    }
+  }
+  // Like any upgrade, the stronger request goes ahead of the waiting ones, which have to look at it again.
+  auto position =
+      std::find_if(requests.begin(), requests.end(), [](const LockRequest &request) { return !request.granted_; });
+  request->lock_mode_ = lock_mode;
+  requests.splice(position, requests, request);
+  queue.cv_.notify_all();
+  return true;
+}
+
+bool LockManager::Release(Transaction *txn, const LockTarget &target) {
+  if (txn->GetState() == TransactionState::GROWING) {
+    txn->SetState(TransactionState::SHRINKING);
+  }
+  return RemoveRequest(txn, target);
+}
+
+bool LockManager::RemoveRequest(Transaction *txn, const LockTarget &target) {
+  LockTableStripe *stripe = GetStripe(target);
+  std::lock_guard<std::mutex> guard(stripe->latch_);
+  auto queue = stripe->lock_table_.find(target);
+  if (queue == stripe->lock_table_.end()) {
+    return false;
+  }
+  auto &requests = queue->second.request_queue_;
+  auto request = std::find_if(requests.begin(), requests.end(), [txn](const LockRequest &request) {
+    return request.txn_id_ == txn->GetTransactionId();
+  });
+  if (request == requests.end()) {
+    return false;
+  }
+  requests.erase(request);
+  if (requests.empty()) {
+    stripe->lock_table_.erase(queue);
+  } else {
+    DropEdgesTo(queue->second, txn->GetTransactionId());
+    queue->second.cv_.notify_all();
+  }
+  return true;
+}
+
+LockManager::LockTableStripe *LockManager::GetStripe(const LockTarget &target) {
+  return &stripes_[LockTargetHash()(target) % num_stripes_];
+}
+
+bool LockManager::CanLock(Transaction *txn) {
+  if (txn->GetState() == TransactionState::SHRINKING) {
+    txn->SetState(TransactionState::ABORTED);
+  }
+  return txn->GetState() == TransactionState::GROWING;
+}
+
+bool LockManager::Acquire(Transaction *txn, const LockTarget &target, LockMode lock_mode,
+                          LockWaitPolicy wait_policy) {
+  LockTableStripe *stripe = GetStripe(target);
+  std::unique_lock<std::mutex> guard(stripe->latch_);
+  LockRequestQueue &queue = stripe->lock_table_[target];
+  auto &requests = queue.request_queue_;
+  auto request = requests.emplace(requests.end(), txn, lock_mode);
+  if (wait_policy != LockWaitPolicy::BLOCK && !IsGrantable(queue, request)) {
+    // The conflicting requests ahead keep the queue alive, and nobody waits behind this one yet.
+    requests.erase(request);
+    return FailWithoutWaiting(txn, wait_policy);
+  }
+  return WaitForGrant(txn, target, request, &guard);
+}
+
+bool LockManager::FailWithoutWaiting(Transaction *txn, LockWaitPolicy wait_policy) {
+  if (wait_policy == LockWaitPolicy::NOWAIT) {
+    txn->SetState(TransactionState::ABORTED);
+  }
+  return false;
+}
+
+bool LockManager::Upgrade(Transaction *txn, const LockTarget &target, LockMode lock_mode) {
+  LockTableStripe *stripe = GetStripe(target);
+  std::unique_lock<std::mutex> guard(stripe->latch_);
+  LockRequestQueue &queue = stripe->lock_table_[target];
+  // The upgrade replaces the held request and goes ahead of every waiting request.
+  auto &requests = queue.request_queue_;
+  requests.remove_if([txn](const LockRequest &request) { return request.txn_id_ == txn->GetTransactionId(); });
+  if (queue.upgrading_) {
+    // Two upgraders would wait for each other's lock forever.
+    txn->SetState(TransactionState::ABORTED);
+    if (requests.empty()) {
+      stripe->lock_table_.erase(target);
+    } else {
+      DropEdgesTo(queue, txn->GetTransactionId());
+      queue.cv_.notify_all();
+    }
+    return false;
+  }
+  auto position =
+      std::find_if(requests.begin(), requests.end(), [](const LockRequest &request) { return !request.granted_; });
+  auto request = requests.emplace(position, txn, lock_mode);
+  queue.upgrading_ = true;
+  // The waiters behind the upgrade now wait for it as well, which the prevention policy has to look at.
+  queue.cv_.notify_all();
+  bool granted = WaitForGrant(txn, target, request, &guard, true);
+  if (granted) {
+    queue.upgrading_ = false;
+  }
+  return granted;
+}
+
+bool LockManager::WaitForGrant(Transaction *txn, const LockTarget &target, std::list<LockRequest>::iterator request,
+                               std::unique_lock<std::mutex> *guard, bool upgrade) {
+  LockTableStripe *stripe = GetStripe(target);
+  // The queue cannot go away while it holds the request.
+  LockRequestQueue *queue = &stripe->lock_table_.find(target)->second;
+  bool blocked = false;
+  std::vector<Transaction *> victims;
+  auto deadline = std::chrono::steady_clock::now() + txn->GetLockTimeout();
+  while (txn->GetState() != TransactionState::ABORTED) {
+    if (IsGrantable(*queue, request)) {
+      request->granted_ = true;
+      break;
+    }
+    if (Prevention() && !PreventDeadlock(txn, *queue, request, &victims)) {
+      txn->SetState(TransactionState::ABORTED);
+      break;
+    }
+    if (!blocked) {
+      std::lock_guard<std::mutex> blocked_guard(blocked_latch_);
+      blocked_on_.emplace(txn->GetTransactionId(), target);
+      blocked = true;
+      // Look at the state again: an abort may have happened before the transaction showed up as blocked.
+      continue;
+    }
+    if (Detection() && !DetectDeadlock(txn, *queue, request, &victims)) {
+      txn->SetState(TransactionState::ABORTED);
+      break;
+    }
+    if (!victims.empty()) {
+      // Victims blocked on other resources are woken without holding this stripe latch.
+      guard->unlock();
+      WakeUp(victims);
+      victims.clear();
+      guard->lock();
+      continue;
+    }
+    if (txn->GetLockTimeout() == std::chrono::milliseconds::zero()) {
+      queue->cv_.wait(*guard);
+    } else if (queue->cv_.wait_until(*guard, deadline) == std::cv_status::timeout && !IsGrantable(*queue, request)) {
+      txn->SetState(TransactionState::ABORTED);
+      break;
+    }
+  }
+  if (blocked) {
+    std::lock_guard<std::mutex> blocked_guard(blocked_latch_);
+    blocked_on_.erase(txn->GetTransactionId());
+  }
+  if (Detection()) {
+    std::lock_guard<std::mutex> graph_guard(latch_);
+    RemoveWaitsFor(txn->GetTransactionId());
+  }
+  if (request->granted_) {
+    return true;
+  }
+
+  queue->request_queue_.erase(request);
+  if (upgrade) {
+    // Only the upgrade itself ends the upgrade, the held lock it replaced is already gone.
+    queue->upgrading_ = false;
+  }
+  if (queue->request_queue_.empty()) {
+    stripe->lock_table_.erase(target);
+  } else {
+    // The requests behind the aborted one may be grantable now.
+    DropEdgesTo(*queue, txn->GetTransactionId());
+    queue->cv_.notify_all();
+  }
+  return false;
+}
+
+bool LockManager::IsGrantable(const LockRequestQueue &queue, std::list<LockRequest>::iterator request) {
+  // Requests are granted in FIFO order, so a waiting exclusive request holds back the shared requests behind it.
+  for (auto it = queue.request_queue_.begin(); it != request; ++it) {
+    if (Conflicts(*it, *request)) {
+      return false;
+    }
+  }
   return true;
 }
 
-void LockManager::AddEdge(txn_id_t t1, txn_id_t t2) { assert(Detection()); }
+bool LockManager::Conflicts(const LockRequest &a, const LockRequest &b) {
+  return !COMPATIBLE[static_cast<int>(a.lock_mode_)][static_cast<int>(b.lock_mode_)];
+}
+
+bool LockManager::PreventDeadlock(Transaction *txn, const LockRequestQueue &queue,
+                                  std::list<LockRequest>::iterator request, std::vector<Transaction *> *wounded) {
+  // A transaction only ever waits for older (WAIT_DIE) or younger (WOUND_WAIT) transactions, so there are no cycles.
+  for (auto it = queue.request_queue_.begin(); it != request; ++it) {
+    if (!Conflicts(*it, *request)) {
+      continue;
+    }
+    if (prevention_policy_ == PreventionPolicy::WAIT_DIE) {
+      if (txn->GetTransactionId() > it->txn_id_) {
+        return false;
+      }
+    } else if (txn->GetTransactionId() < it->txn_id_ &&
+               it->txn_->CompareAndSetState(TransactionState::GROWING, TransactionState::ABORTED)) {
+      // Shrinking transactions are left alone, they do not wait for new locks and release theirs soon.
+      wounded->push_back(it->txn_);
+    }
+  }
+  return true;
+}
 
-void LockManager::RemoveEdge(txn_id_t t1, txn_id_t t2) { assert(Detection()); }
+void LockManager::WakeUp(const std::vector<Transaction *> &txns) {
+  for (auto txn : txns) {
+    LockTarget target;
+    {
+      std::lock_guard<std::mutex> blocked_guard(blocked_latch_);
+      auto blocked = blocked_on_.find(txn->GetTransactionId());
+      if (blocked == blocked_on_.end()) {
+        // It checks its state before blocking.
+        continue;
+      }
+      target = blocked->second;
+    }
+    LockTableStripe *stripe = GetStripe(target);
+    std::lock_guard<std::mutex> guard(stripe->latch_);
+    auto queue = stripe->lock_table_.find(target);
+    if (queue != stripe->lock_table_.end()) {
+      queue->second.cv_.notify_all();
+    }
+  }
+}
+
+bool LockManager::DetectDeadlock(Transaction *txn, const LockRequestQueue &queue,
+                                 std::list<LockRequest>::iterator request, std::vector<Transaction *> *victims) {
+  std::vector<txn_id_t> holders;
+  for (auto it = queue.request_queue_.begin(); it != request; ++it) {
+    if (Conflicts(*it, *request)) {
+      holders.push_back(it->txn_id_);
+    }
+  }
+
+  std::lock_guard<std::mutex> graph_guard(latch_);
+  RemoveWaitsFor(txn->GetTransactionId());
+  waiters_[txn->GetTransactionId()] = txn;
+  for (auto holder : holders) {
+    InsertEdge(txn->GetTransactionId(), holder);
+  }
+  // Any new cycle goes through the edges just added, so searching from txn finds it right away.
+  std::unordered_set<txn_id_t> visited;
+  txn_id_t victim;
+  while (SearchCycle(txn->GetTransactionId(), &visited, CYCLE_SEARCH_LIMIT, &victim)) {
+    if (victim == txn->GetTransactionId()) {
+      return false;
+    }
+    // Only blocked transactions have outgoing edges, so the victim wakes up to withdraw its request.
+    Transaction *victim_txn = waiters_[victim];
+    victim_txn->SetState(TransactionState::ABORTED);
+    victims->push_back(victim_txn);
+    RemoveWaitsFor(victim);
+    visited.clear();
+  }
+  return true;
+}
+
+void LockManager::DropEdgesTo(const LockRequestQueue &queue, txn_id_t txn_id) {
+  if (!Detection()) {
+    return;
+  }
+  std::lock_guard<std::mutex> graph_guard(latch_);
+  for (const auto &request : queue.request_queue_) {
+    if (!request.granted_) {
+      EraseEdge(request.txn_id_, txn_id);
+    }
+  }
+}
+
+void LockManager::InsertEdge(txn_id_t t1, txn_id_t t2) {
+  // Edges are kept sorted, so that searches visit transactions in a deterministic order.
+  auto &edges = waits_for_[t1];
+  auto position = std::lower_bound(edges.begin(), edges.end(), t2);
+  if (position == edges.end() || *position != t2) {
+    edges.insert(position, t2);
+  }
+}
+
+void LockManager::EraseEdge(txn_id_t t1, txn_id_t t2) {
+  auto edges = waits_for_.find(t1);
+  if (edges == waits_for_.end()) {
+    return;
+  }
+  auto position = std::lower_bound(edges->second.begin(), edges->second.end(), t2);
+  if (position != edges->second.end() && *position == t2) {
+    edges->second.erase(position);
+  }
+  if (edges->second.empty()) {
+    waits_for_.erase(edges);
+  }
+}
+
+void LockManager::RemoveWaitsFor(txn_id_t txn_id) {
+  waits_for_.erase(txn_id);
+  waiters_.erase(txn_id);
+}
+
+bool LockManager::SearchCycle(txn_id_t source, std::unordered_set<txn_id_t> *visited, size_t limit,
+                              txn_id_t *txn_id) {
+  if (!visited->insert(source).second) {
+    return false;
+  }
+  // An iterative depth-first search, path holds the current chain of waiters and the next edge to follow.
+  std::vector<std::pair<txn_id_t, size_t>> path{{source, 0}};
+  std::unordered_set<txn_id_t> on_path{source};
+  size_t num_visited = 1;
+  while (!path.empty()) {
+    auto &[current, next_edge] = path.back();
+    auto edges = waits_for_.find(current);
+    if (edges == waits_for_.end() || next_edge == edges->second.size()) {
+      on_path.erase(current);
+      path.pop_back();
+      continue;
+    }
+    txn_id_t next = edges->second[next_edge++];
+    if (on_path.count(next) > 0) {
+      txn_id_t newest = next;
+      for (auto it = path.rbegin(); it->first != next; ++it) {
+        newest = std::max(newest, it->first);
+      }
+      *txn_id = newest;
+      return true;
+    }
+    if (visited->insert(next).second) {
+      if (++num_visited > limit) {
+        // Leave huge graphs to the background detection.
+        return false;
+      }
+      path.emplace_back(next, 0);
+      on_path.insert(next);
+    }
+  }
+  return false;
+}
+
+void LockManager::AddEdge(txn_id_t t1, txn_id_t t2) {
+  BUSTUB_ASSERT(Detection(), "Detection should be enabled!");
+  std::lock_guard<std::mutex> graph_guard(latch_);
+  InsertEdge(t1, t2);
+}
+
+void LockManager::RemoveEdge(txn_id_t t1, txn_id_t t2) {
+  BUSTUB_ASSERT(Detection(), "Detection should be enabled!");
+  std::lock_guard<std::mutex> graph_guard(latch_);
+  EraseEdge(t1, t2);
+}
 
 bool LockManager::HasCycle(txn_id_t *txn_id) {
   BUSTUB_ASSERT(Detection(), "Detection should be enabled!");
+  std::lock_guard<std::mutex> graph_guard(latch_);
+  return FindCycle(txn_id);
+}
+
+/*
+ * The search starts from the lowest transaction id, so that the same graph always yields the same victim.
+ */
+bool LockManager::FindCycle(txn_id_t *txn_id) {
+  std::vector<txn_id_t> sources;
+  for (const auto &edges : waits_for_) {
+    sources.push_back(edges.first);
+  }
+  std::sort(sources.begin(), sources.end());
+  std::unordered_set<txn_id_t> visited;
+  for (auto source : sources) {
+    if (SearchCycle(source, &visited, std::numeric_limits<size_t>::max(), txn_id)) {
+      return true;
+    }
+  }
   return false;
 }
 
 std::vector<std::pair<txn_id_t, txn_id_t>> LockManager::GetEdgeList() {
   BUSTUB_ASSERT(Detection(), "Detection should be enabled!");
-  return {};
+  std::lock_guard<std::mutex> graph_guard(latch_);
+  std::vector<std::pair<txn_id_t, txn_id_t>> edge_list;
+  for (const auto &[source, edges] : waits_for_) {
+    for (auto target : edges) {
+      edge_list.emplace_back(source, target);
+    }
+  }
+  return edge_list;
 }
 
 void LockManager::RunCycleDetection() {
   BUSTUB_ASSERT(Detection(), "Detection should be enabled!");
   while (enable_cycle_detection_) {
     std::this_thread::sleep_for(cycle_detection_interval);
+    std::vector<Transaction *> victims;
     {
       std::unique_lock<std::mutex> l(latch_);
-      // TODO(student): remove the continue and add your cycle detection and abort code here
-      continue;
+      txn_id_t victim;
+      while (FindCycle(&victim)) {
+        auto victim_txn = waiters_.find(victim);
+        if (victim_txn == waiters_.end()) {
+          // The edges were added through AddEdge, there is no blocked transaction to abort.
+          break;
+        }
+        victim_txn->second->SetState(TransactionState::ABORTED);
+        victims.push_back(victim_txn->second);
+        RemoveWaitsFor(victim);
+      }
     }
+    WakeUp(victims);
   }
 }
 
@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tid_table.cpp
+//
+// Identification: src/concurrency/tid_table.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "concurrency/tid_table.h"
+
+#include <thread>  // NOLINT
+
+namespace bustub {
+
+TidTable::TidTable(size_t num_stripes) : num_stripes_(num_stripes), stripes_(new Stripe[num_stripes]) {
+  BUSTUB_ASSERT(num_stripes > 0, "The TID table needs at least one stripe.");
+}
+
+TidTable::Stripe *TidTable::GetStripe(const RID &rid) {
+  // Tuples of one page differ only in their low bits, so mix all bits into the ones that are used.
+  uint64_t hash = static_cast<uint64_t>(rid.Get()) * 0x9E3779B97F4A7C15ULL;
+  return &stripes_[(hash >> 32) % num_stripes_];
+}
+
+uint64_t TidTable::Read(const RID &rid) {
+  Stripe *stripe = GetStripe(rid);
+  while (true) {
+    {
+      std::lock_guard<std::mutex> guard(stripe->latch_);
+      auto it = stripe->tids_.find(rid);
+      if (it == stripe->tids_.end()) {
+        return 0;
+      }
+      if ((it->second & LOCK_BIT) == 0) {
+        return it->second;
+      }
+    }
+    // The word is only locked while a transaction installs its writes.
+    std::this_thread::yield();
+  }
+}
+
+uint64_t TidTable::Get(const RID &rid) {
+  Stripe *stripe = GetStripe(rid);
+  std::lock_guard<std::mutex> guard(stripe->latch_);
+  auto it = stripe->tids_.find(rid);
+  return it == stripe->tids_.end() ? 0 : it->second;
+}
+
+void TidTable::Lock(const RID &rid) {
+  Stripe *stripe = GetStripe(rid);
+  while (true) {
+    {
+      std::lock_guard<std::mutex> guard(stripe->latch_);
+      uint64_t &tid = stripe->tids_[rid];
+      if ((tid & LOCK_BIT) == 0) {
+        tid |= LOCK_BIT;
+        return;
+      }
+    }
+    std::this_thread::yield();
+  }
+}
+
+void TidTable::Unlock(const RID &rid) {
+  Stripe *stripe = GetStripe(rid);
+  std::lock_guard<std::mutex> guard(stripe->latch_);
+  stripe->tids_[rid] &= ~LOCK_BIT;
+}
+
+void TidTable::Install(const RID &rid, bool is_absent) {
+  Stripe *stripe = GetStripe(rid);
+  std::lock_guard<std::mutex> guard(stripe->latch_);
+  uint64_t &tid = stripe->tids_[rid];
+  tid = ((tid & VERSION_MASK) + 1) | (is_absent ? ABSENT_BIT : 0);
+}
+
+}  // namespace bustub
@@ -12,37 +12,73 @@
 
 #include "concurrency/transaction_manager.h"
 
+#include <algorithm>
+#include <deque>
+#include <functional>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "storage/table/table_heap.h"
 
 namespace bustub {
 
-std::unordered_map<txn_id_t, Transaction *> TransactionManager::txn_map = {};
-
-Transaction *TransactionManager::Begin(Transaction *txn) {
-  // Acquire the global transaction latch in shared mode.
-  global_txn_latch_.RLock();
+Transaction *TransactionManager::Begin(Transaction *txn, ConcurrencyMode concurrency_mode) {
+  // Acquire the global transaction latch in shared mode. The transaction may end on another thread, which releases
+  // the same slot.
+  size_t latch_slot = global_txn_latch_.RLock();
 
   if (txn == nullptr) {
-    txn = new Transaction(next_txn_id_++);
+    std::unique_lock<std::mutex> pool_lock(txn_pool_latch_);
+    if (txn_pool_.empty()) {
+      pool_lock.unlock();
+      txn = new Transaction(next_txn_id_++, concurrency_mode);
+    } else {
+      txn = txn_pool_.back();
+      txn_pool_.pop_back();
+      pool_lock.unlock();
+      txn->Reset(next_txn_id_++, concurrency_mode);
+    }
+  }
+  txn->SetGlobalLatchSlot(latch_slot);
+
+  if (version_store_ != nullptr) {
+    std::lock_guard<std::mutex> guard(ts_latch_);
+    txn->SetReadTs(last_commit_ts_);
+    active_read_ts_.insert(last_commit_ts_);
   }
 
   if (enable_logging) {
-    // TODO(student): Add logging here.
+    LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::BEGIN);
+    txn->SetPrevLSN(log_manager_->AppendLogRecord(&log_record));
   }
 
-  txn_map[txn->GetTransactionId()] = txn;
+  txn_registry_.Insert(txn);
   return txn;
 }
 
-void TransactionManager::Commit(Transaction *txn) {
+bool TransactionManager::Commit(Transaction *txn) {
+  if (txn->GetState() == TransactionState::ABORTED) {
+    // An older transaction wounded this one, possibly after it took its last lock.
+    Abort(txn);
+    return false;
+  }
+  std::vector<std::pair<TableHeap *, RID>> locked_tids;
+  if (txn->GetConcurrencyMode() == ConcurrencyMode::OPTIMISTIC && !ValidateAndInstall(txn, &locked_tids)) {
+    Abort(txn);
+    // The rolled back tuples are consistent again.
+    for (const auto &[table, rid] : locked_tids) {
+      table->GetTidTable()->Unlock(rid);
+    }
+    return false;
+  }
   txn->SetState(TransactionState::COMMITTED);
 
-  // Perform all deletes before we commit.
+  // Perform all deletes before we commit. Under snapshot isolation, deleted tuples stay in the table until no
+  // snapshot sees them any more, see GarbageCollect().
   auto write_set = txn->GetWriteSet();
-  while (!write_set->empty()) {
+  while (version_store_ == nullptr && !write_set->empty()) {
     auto &item = write_set->back();
     auto table = item.table_;
     if (item.wtype_ == WType::DELETE) {
@@ -51,50 +87,180 @@ void TransactionManager::Commit(Transaction *txn) {
     }
     write_set->pop_back();
   }
-  write_set->clear();
 
   if (enable_logging) {
-    // TODO(student): add logging here
+    LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::COMMIT);
+    txn->SetPrevLSN(log_manager_->AppendLogRecord(&log_record));
+    // The transaction is only committed once its commit record is durable.
+    log_manager_->Flush();
   }
 
   // Release all the locks.
   ReleaseLocks(txn);
+
+  if (version_store_ != nullptr) {
+    // The writes become visible to the snapshots taken from now on.
+    std::lock_guard<std::mutex> guard(ts_latch_);
+    txn->SetCommitTs(last_commit_ts_ + 1);
+    version_store_->Commit(txn, txn->GetCommitTs());
+    last_commit_ts_ = txn->GetCommitTs();
+    active_read_ts_.erase(active_read_ts_.find(txn->GetReadTs()));
+  }
+  // The installed writes become visible to optimistic readers.
+  for (const auto &[table, rid] : locked_tids) {
+    table->GetTidTable()->Install(rid, false);
+  }
+  write_set->clear();
+  txn->GetReadSet()->clear();
+  txn_registry_.Erase(txn->GetTransactionId());
   // Release the global transaction latch.
-  global_txn_latch_.RUnlock();
+  global_txn_latch_.RUnlock(txn->GetGlobalLatchSlot());
+  return true;
+}
+
+bool TransactionManager::ValidateAndInstall(Transaction *txn, std::vector<std::pair<TableHeap *, RID>> *locked_tids) {
+  auto write_set = txn->GetWriteSet();
+  std::deque<WriteRecord> buffered;
+  buffered.swap(*write_set);
+  // Inserts are in the tables already, so they stay in the write set.
+  std::vector<std::pair<TableHeap *, RID>> inserted;
+  for (const auto &item : buffered) {
+    locked_tids->emplace_back(item.table_, item.rid_);
+    if (item.wtype_ == WType::INSERT) {
+      write_set->push_back(item);
+      inserted.emplace_back(item.table_, item.rid_);
+    }
+  }
+
+  // Lock in a global order, so that committing transactions never wait for each other in a cycle.
+  auto less = [](const std::pair<TableHeap *, RID> &a, const std::pair<TableHeap *, RID> &b) {
+    return std::less<TableHeap *>()(a.first, b.first) || (a.first == b.first && a.second.Get() < b.second.Get());
+  };
+  std::sort(locked_tids->begin(), locked_tids->end(), less);
+  locked_tids->erase(std::unique(locked_tids->begin(), locked_tids->end()), locked_tids->end());
+  std::sort(inserted.begin(), inserted.end(), less);
+  for (const auto &[table, rid] : *locked_tids) {
+    table->GetTidTable()->Lock(rid);
+  }
+
+  // Every tuple read must still have the version that was read, and must not be locked by another transaction.
+  for (const auto &item : *txn->GetReadSet()) {
+    uint64_t tid = item.table_->GetTidTable()->Get(item.rid_);
+    if ((tid & ~TidTable::LOCK_BIT) != item.tid_ ||
+        ((tid & TidTable::LOCK_BIT) != 0 &&
+         !std::binary_search(locked_tids->begin(), locked_tids->end(), std::make_pair(item.table_, item.rid_), less))) {
+      return false;
+    }
+  }
+  // Tuples whose inserts have not committed cannot be changed by anyone but their inserter.
+  for (const auto &item : buffered) {
+    if (item.wtype_ != WType::INSERT &&
+        (item.table_->GetTidTable()->Get(item.rid_) & TidTable::ABSENT_BIT) != 0 &&
+        !std::binary_search(inserted.begin(), inserted.end(), std::make_pair(item.table_, item.rid_), less)) {
+      return false;
+    }
+  }
+
+  // The tables write through for a committed transaction, and record the undo information in the write set.
+  txn->SetState(TransactionState::COMMITTED);
+  for (const auto &item : buffered) {
+    if ((item.wtype_ == WType::UPDATE && !item.table_->UpdateTuple(item.tuple_, item.rid_, txn)) ||
+        (item.wtype_ == WType::DELETE && !item.table_->MarkDelete(item.rid_, txn))) {
+      return false;
+    }
+  }
+  return true;
 }
 
 void TransactionManager::Abort(Transaction *txn) {
+  if (txn->GetConcurrencyMode() == ConcurrencyMode::OPTIMISTIC && txn->GetState() != TransactionState::COMMITTED) {
+    // The buffered writes never reached the tables, only the inserts did.
+    auto write_set = txn->GetWriteSet();
+    write_set->erase(std::remove_if(write_set->begin(), write_set->end(),
+                                    [](const WriteRecord &item) { return item.wtype_ != WType::INSERT; }),
+                     write_set->end());
+  }
   txn->SetState(TransactionState::ABORTED);
 
-  // Rollback before releasing the lock.
+  // Rollback before releasing the lock. Rolling back does not add to the write set of an aborted transaction.
   auto write_set = txn->GetWriteSet();
-  while (!write_set->empty()) {
-    auto &item = write_set->back();
-    auto table = item.table_;
-    if (item.wtype_ == WType::DELETE) {
-      table->RollbackDelete(item.rid_, txn);
-    } else if (item.wtype_ == WType::INSERT) {
+  for (auto item = write_set->rbegin(); item != write_set->rend(); ++item) {
+    auto table = item->table_;
+    if (item->wtype_ == WType::DELETE) {
+      table->RollbackDelete(item->rid_, txn);
+    } else if (item->wtype_ == WType::INSERT) {
       // Note that this also releases the lock when holding the page latch.
-      table->ApplyDelete(item.rid_, txn);
-    } else if (item.wtype_ == WType::UPDATE) {
-      table->UpdateTuple(item.tuple_, item.rid_, txn);
+      table->ApplyDelete(item->rid_, txn);
+      if (txn->GetConcurrencyMode() == ConcurrencyMode::OPTIMISTIC) {
+        table->GetTidTable()->Install(item->rid_, false);
+      }
+    } else if (item->wtype_ == WType::UPDATE) {
+      table->UpdateTuple(item->tuple_, item->rid_, txn);
     }
-    write_set->pop_back();
+  }
+  if (version_store_ != nullptr) {
+    // Snapshots read the old versions until the table is rolled back.
+    version_store_->Abort(txn);
+    std::lock_guard<std::mutex> guard(ts_latch_);
+    active_read_ts_.erase(active_read_ts_.find(txn->GetReadTs()));
   }
   write_set->clear();
+  txn->GetReadSet()->clear();
 
   if (enable_logging) {
-    // TODO(student): add logging here
+    LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::ABORT);
+    txn->SetPrevLSN(log_manager_->AppendLogRecord(&log_record));
   }
 
   // Release all the locks.
   ReleaseLocks(txn);
+  txn_registry_.Erase(txn->GetTransactionId());
   // Release the global transaction latch.
-  global_txn_latch_.RUnlock();
+  global_txn_latch_.RUnlock(txn->GetGlobalLatchSlot());
+}
+
+void TransactionManager::Recycle(Transaction *txn) {
+  epoch_manager_.Retire([this, txn] {
+    std::lock_guard<std::mutex> guard(txn_pool_latch_);
+    txn_pool_.push_back(txn);
+  });
 }
 
 void TransactionManager::BlockAllTransactions() { global_txn_latch_.WLock(); }
 
 void TransactionManager::ResumeTransactions() { global_txn_latch_.WUnlock(); }
 
+timestamp_t TransactionManager::GetWatermark() {
+  std::lock_guard<std::mutex> guard(ts_latch_);
+  return active_read_ts_.empty() ? last_commit_ts_ : *active_read_ts_.begin();
+}
+
+void TransactionManager::GarbageCollect() {
+  std::vector<std::pair<TableHeap *, RID>> dead;
+  version_store_->GarbageCollect(GetWatermark(), &dead);
+  if (dead.empty()) {
+    return;
+  }
+  // Removing the deleted tuples is a write like any other, so it runs in a transaction of its own.
+  Transaction *txn = Begin();
+  for (const auto &[table, rid] : dead) {
+    if (!table->LockRow(rid, LockMode::EXCLUSIVE, txn)) {
+      // The tuples left behind stay marked deleted, which every snapshot reads as absent.
+      break;
+    }
+    table->ApplyDelete(rid, txn);
+  }
+  Commit(txn);
+  Recycle(txn);
+}
+
+void TransactionManager::RunGarbageCollection() {
+  std::unique_lock<std::mutex> lock(gc_latch_);
+  while (!gc_cv_.wait_for(lock, gc_interval, [this] { return !enable_gc_; })) {
+    lock.unlock();
+    GarbageCollect();
+    lock.lock();
+  }
+}
+
 }  // namespace bustub
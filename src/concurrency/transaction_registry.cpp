@@ -0,0 +1,50 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// transaction_registry.cpp
+//
+// Identification: src/concurrency/transaction_registry.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "concurrency/transaction_registry.h"
+
+namespace bustub {
+
+TransactionRegistry::TransactionRegistry(size_t num_stripes)
+    : num_stripes_(num_stripes), stripes_(new Stripe[num_stripes]) {
+  BUSTUB_ASSERT(num_stripes > 0, "The transaction registry needs at least one stripe.");
+}
+
+void TransactionRegistry::Insert(Transaction *txn) {
+  Stripe *stripe = GetStripe(txn->GetTransactionId());
+  std::lock_guard<std::mutex> guard(stripe->latch_);
+  stripe->txns_[txn->GetTransactionId()] = txn;
+}
+
+void TransactionRegistry::Erase(txn_id_t txn_id) {
+  Stripe *stripe = GetStripe(txn_id);
+  std::lock_guard<std::mutex> guard(stripe->latch_);
+  stripe->txns_.erase(txn_id);
+}
+
+Transaction *TransactionRegistry::Find(txn_id_t txn_id) {
+  Stripe *stripe = GetStripe(txn_id);
+  std::lock_guard<std::mutex> guard(stripe->latch_);
+  auto it = stripe->txns_.find(txn_id);
+  return it == stripe->txns_.end() ? nullptr : it->second;
+}
+
+size_t TransactionRegistry::GetNumTransactions() {
+  size_t num_txns = 0;
+  for (size_t i = 0; i < num_stripes_; i++) {
+    std::lock_guard<std::mutex> guard(stripes_[i].latch_);
+    num_txns += stripes_[i].txns_.size();
+  }
+  return num_txns;
+}
+
+}  // namespace bustub
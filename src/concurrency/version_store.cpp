@@ -0,0 +1,183 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// version_store.cpp
+//
+// Identification: src/concurrency/version_store.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "concurrency/version_store.h"
+
+#include "common/macros.h"
+
+namespace bustub {
+
+VersionStore::VersionStore(size_t num_stripes) : num_stripes_(num_stripes), stripes_(new Stripe[num_stripes]) {
+  BUSTUB_ASSERT(num_stripes > 0, "The version store needs at least one stripe.");
+}
+
+VersionStore::Stripe *VersionStore::GetStripe(const RID &rid) {
+  // Tuples of one page differ only in their low bits, so mix all bits into the ones that are used.
+  uint64_t hash = static_cast<uint64_t>(rid.Get()) * 0x9E3779B97F4A7C15ULL;
+  return &stripes_[(hash >> 32) % num_stripes_];
+}
+
+void VersionStore::DropVersions(std::unique_ptr<Version> versions) {
+  while (versions != nullptr) {
+    versions = std::move(versions->prev_);
+  }
+}
+
+bool VersionStore::Read(const RID &rid, Transaction *txn, bool in_heap, Tuple *tuple) {
+  Stripe *stripe = GetStripe(rid);
+  std::lock_guard<std::mutex> guard(stripe->latch_);
+  auto it = stripe->chains_.find(rid);
+  if (it == stripe->chains_.end()) {
+    return in_heap;
+  }
+  const VersionChain &chain = it->second;
+  if (chain.writer_ == txn->GetTransactionId() ||
+      (chain.writer_ == INVALID_TXN_ID && chain.ts_ <= txn->GetReadTs())) {
+    return in_heap;
+  }
+  for (const Version *version = chain.undo_.get(); version != nullptr; version = version->prev_.get()) {
+    if (version->ts_ <= txn->GetReadTs()) {
+      if (version->is_delete_) {
+        return false;
+      }
+      *tuple = version->tuple_;
+      return true;
+    }
+  }
+  // The tuple was inserted after the snapshot was taken.
+  return false;
+}
+
+bool VersionStore::CanWrite(const RID &rid, Transaction *txn) {
+  Stripe *stripe = GetStripe(rid);
+  std::lock_guard<std::mutex> guard(stripe->latch_);
+  auto it = stripe->chains_.find(rid);
+  if (it == stripe->chains_.end()) {
+    return true;
+  }
+  const VersionChain &chain = it->second;
+  if (chain.writer_ != INVALID_TXN_ID) {
+    return chain.writer_ == txn->GetTransactionId();
+  }
+  return chain.ts_ <= txn->GetReadTs();
+}
+
+void VersionStore::RecordWrite(TableHeap *table, const RID &rid, Transaction *txn, const Tuple *old_tuple,
+                               bool is_delete) {
+  Stripe *stripe = GetStripe(rid);
+  std::lock_guard<std::mutex> guard(stripe->latch_);
+  if (old_tuple == nullptr) {
+    // A new tuple gets a fresh chain. A chain left at its slot belongs to an insert that is being rolled back, which
+    // no other transaction could see.
+    VersionChain &chain = stripe->chains_[rid];
+    chain.table_ = table;
+    chain.writer_ = txn->GetTransactionId();
+    chain.ts_ = 0;
+    chain.is_delete_ = false;
+    DropVersions(std::move(chain.undo_));
+    chain.undo_.reset(new Version{Tuple{}, true, 0, nullptr});
+    return;
+  }
+  VersionChain &chain = stripe->chains_[rid];
+  chain.table_ = table;
+  if (chain.writer_ != txn->GetTransactionId()) {
+    BUSTUB_ASSERT(chain.writer_ == INVALID_TXN_ID, "Only one transaction may write a tuple at a time.");
+    chain.undo_.reset(new Version{*old_tuple, chain.is_delete_, chain.ts_, std::move(chain.undo_)});
+    chain.writer_ = txn->GetTransactionId();
+  }
+  chain.is_delete_ = is_delete;
+}
+
+void VersionStore::Commit(Transaction *txn, timestamp_t commit_ts) {
+  for (const auto &item : *txn->GetWriteSet()) {
+    Stripe *stripe = GetStripe(item.rid_);
+    std::lock_guard<std::mutex> guard(stripe->latch_);
+    auto it = stripe->chains_.find(item.rid_);
+    if (it != stripe->chains_.end() && it->second.writer_ == txn->GetTransactionId()) {
+      it->second.writer_ = INVALID_TXN_ID;
+      it->second.ts_ = commit_ts;
+    }
+  }
+}
+
+void VersionStore::Abort(Transaction *txn) {
+  for (const auto &item : *txn->GetWriteSet()) {
+    Stripe *stripe = GetStripe(item.rid_);
+    std::lock_guard<std::mutex> guard(stripe->latch_);
+    auto it = stripe->chains_.find(item.rid_);
+    if (it == stripe->chains_.end() || it->second.writer_ != txn->GetTransactionId()) {
+      continue;
+    }
+    VersionChain &chain = it->second;
+    std::unique_ptr<Version> restored = std::move(chain.undo_);
+    chain.undo_ = std::move(restored->prev_);
+    chain.writer_ = INVALID_TXN_ID;
+    chain.ts_ = restored->ts_;
+    chain.is_delete_ = restored->is_delete_;
+    if (chain.undo_ == nullptr && chain.ts_ == 0) {
+      // Either the tuple was never committed, or it was committed before every snapshot.
+      stripe->chains_.erase(it);
+    }
+  }
+}
+
+void VersionStore::GarbageCollect(timestamp_t watermark, std::vector<std::pair<TableHeap *, RID>> *dead) {
+  for (size_t i = 0; i < num_stripes_; i++) {
+    Stripe *stripe = &stripes_[i];
+    std::lock_guard<std::mutex> guard(stripe->latch_);
+    for (auto it = stripe->chains_.begin(); it != stripe->chains_.end();) {
+      VersionChain &chain = it->second;
+      if (chain.writer_ == INVALID_TXN_ID && chain.ts_ <= watermark) {
+        // Every snapshot sees the heap version.
+        if (chain.is_delete_) {
+          dead->emplace_back(chain.table_, it->first);
+        }
+        DropVersions(std::move(chain.undo_));
+        it = stripe->chains_.erase(it);
+        continue;
+      }
+      // The oldest snapshot stops at the first version it can see, nobody reads past that one.
+      Version *version = chain.undo_.get();
+      while (version != nullptr && version->ts_ > watermark) {
+        version = version->prev_.get();
+      }
+      if (version != nullptr) {
+        DropVersions(std::move(version->prev_));
+      }
+      ++it;
+    }
+  }
+}
+
+size_t VersionStore::GetNumChains() {
+  size_t num_chains = 0;
+  for (size_t i = 0; i < num_stripes_; i++) {
+    std::lock_guard<std::mutex> guard(stripes_[i].latch_);
+    num_chains += stripes_[i].chains_.size();
+  }
+  return num_chains;
+}
+
+size_t VersionStore::GetNumVersions() {
+  size_t num_versions = 0;
+  for (size_t i = 0; i < num_stripes_; i++) {
+    std::lock_guard<std::mutex> guard(stripes_[i].latch_);
+    for (const auto &item : stripes_[i].chains_) {
+      for (const Version *version = item.second.undo_.get(); version != nullptr; version = version->prev_.get()) {
+        num_versions++;
+      }
+    }
+  }
+  return num_versions;
+}
+
+}  // namespace bustub
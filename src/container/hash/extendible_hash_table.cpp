@@ -0,0 +1,278 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table.cpp
+//
+// Identification: src/container/hash/extendible_hash_table.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/rid.h"
+#include "container/hash/extendible_hash_table.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+EXTENDIBLE_HASH_TABLE_TYPE::ExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                                                const KeyComparator &comparator, HashFn hash_fn)
+    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
+  // The directory starts out with global depth 0, its single entry points to an empty bucket of local depth 0.
+  auto *dir_page = reinterpret_cast<HashTableDirectoryPage *>(NewPage(&directory_page_id_)->GetData());
+  dir_page->SetPageId(directory_page_id_);
+  page_id_t bucket_page_id;
+  NewPage(&bucket_page_id);
+  dir_page->SetBucketPageId(0, bucket_page_id);
+  dir_page->SetLocalDepth(0, 0);
+  buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+bool EXTENDIBLE_HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key,
+                                          std::vector<ValueType> *result) {
+  table_latch_.RLock();
+  auto *dir_page = reinterpret_cast<HashTableDirectoryPage *>(FetchPage(directory_page_id_)->GetData());
+  uint64_t hash = hash_fn_.GetHash(key);
+  page_id_t bucket_page_id = dir_page->GetBucketPageId(DirectoryHash(hash) & dir_page->GetGlobalDepthMask());
+  Page *page = FetchPage(bucket_page_id);
+  page->RLatch();
+  auto *bucket = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(page->GetData());
+  bool found = bucket->GetValue(key, HASH_TABLE_BUCKET_TYPE::Fingerprint(hash), comparator_, result);
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  return found;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+bool EXTENDIBLE_HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  uint64_t hash = hash_fn_.GetHash(key);
+  while (true) {
+    table_latch_.RLock();
+    auto *dir_page = reinterpret_cast<HashTableDirectoryPage *>(FetchPage(directory_page_id_)->GetData());
+    page_id_t bucket_page_id = dir_page->GetBucketPageId(DirectoryHash(hash) & dir_page->GetGlobalDepthMask());
+    Page *page = FetchPage(bucket_page_id);
+    page->WLatch();
+    auto *bucket = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(page->GetData());
+    bool inserted = bucket->Insert(key, value, HASH_TABLE_BUCKET_TYPE::Fingerprint(hash), comparator_);
+    bool full = !inserted && bucket->IsFull();
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(bucket_page_id, inserted);
+    buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+    table_latch_.RUnlock();
+    // A bucket with room that rejects the pair holds it already.
+    if (!full) {
+      return inserted;
+    }
+    if (!SplitBucket(DirectoryHash(hash))) {
+      return false;
+    }
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+bool EXTENDIBLE_HASH_TABLE_TYPE::SplitBucket(uint32_t hash) {
+  table_latch_.WLock();
+  auto *dir_page = reinterpret_cast<HashTableDirectoryPage *>(FetchPage(directory_page_id_)->GetData());
+  bool split = true;
+  // All keys of the bucket may land in the same half, so the bucket of the key is split until it has room.
+  while (true) {
+    uint32_t bucket_idx = hash & dir_page->GetGlobalDepthMask();
+    page_id_t bucket_page_id = dir_page->GetBucketPageId(bucket_idx);
+    Page *page = FetchPage(bucket_page_id);
+    auto *bucket = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(page->GetData());
+    if (!bucket->IsFull()) {
+      buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+      break;
+    }
+    uint32_t local_depth = dir_page->GetLocalDepth(bucket_idx);
+    if (local_depth == dir_page->GetGlobalDepth()) {
+      if (dir_page->Size() == DIRECTORY_ARRAY_SIZE) {
+        buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+        split = false;
+        break;
+      }
+      dir_page->IncrGlobalDepth();
+    }
+
+    // The split image starts out as a copy of the bucket, then each pair is kept in the half its next hash bit
+    // selects.
+    page_id_t image_page_id;
+    Page *image_page = NewPage(&image_page_id);
+    std::memcpy(image_page->GetData(), page->GetData(), PAGE_SIZE);
+    auto *image = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(image_page->GetData());
+    uint32_t high_bit = 1U << local_depth;
+    for (slot_offset_t slot = 0; slot < BUCKET_ARRAY_SIZE; slot++) {
+      if ((DirectoryHash(hash_fn_.GetHash(bucket->KeyAt(slot))) & high_bit) != 0) {
+        bucket->RemoveAt(slot);
+      } else {
+        image->RemoveAt(slot);
+      }
+    }
+    for (uint32_t i = 0; i < dir_page->Size(); i++) {
+      if (dir_page->GetBucketPageId(i) == bucket_page_id) {
+        dir_page->SetLocalDepth(i, local_depth + 1);
+        if ((i & high_bit) != 0) {
+          dir_page->SetBucketPageId(i, image_page_id);
+        }
+      }
+    }
+    buffer_pool_manager_->UnpinPage(image_page_id, true);
+    buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+  table_latch_.WUnlock();
+  return split;
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+bool EXTENDIBLE_HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  uint64_t hash = hash_fn_.GetHash(key);
+  table_latch_.RLock();
+  auto *dir_page = reinterpret_cast<HashTableDirectoryPage *>(FetchPage(directory_page_id_)->GetData());
+  page_id_t bucket_page_id = dir_page->GetBucketPageId(DirectoryHash(hash) & dir_page->GetGlobalDepthMask());
+  Page *page = FetchPage(bucket_page_id);
+  page->WLatch();
+  auto *bucket = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(page->GetData());
+  bool removed = bucket->Remove(key, value, HASH_TABLE_BUCKET_TYPE::Fingerprint(hash), comparator_);
+  bool empty = removed && bucket->IsEmpty();
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, removed);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  if (empty) {
+    MergeBucket(DirectoryHash(hash));
+  }
+  return removed;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+void EXTENDIBLE_HASH_TABLE_TYPE::MergeBucket(uint32_t hash) {
+  table_latch_.WLock();
+  auto *dir_page = reinterpret_cast<HashTableDirectoryPage *>(FetchPage(directory_page_id_)->GetData());
+  bool merged = false;
+  while (true) {
+    uint32_t bucket_idx = hash & dir_page->GetGlobalDepthMask();
+    uint32_t local_depth = dir_page->GetLocalDepth(bucket_idx);
+    // Only buckets of the same local depth are split images of each other.
+    if (local_depth == 0) {
+      break;
+    }
+    uint32_t image_idx = dir_page->GetSplitImageIndex(bucket_idx);
+    if (dir_page->GetLocalDepth(image_idx) != local_depth) {
+      break;
+    }
+    page_id_t bucket_page_id = dir_page->GetBucketPageId(bucket_idx);
+    page_id_t image_page_id = dir_page->GetBucketPageId(image_idx);
+    bool bucket_empty = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(FetchPage(bucket_page_id)->GetData())->IsEmpty();
+    bool image_empty = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(FetchPage(image_page_id)->GetData())->IsEmpty();
+    buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+    buffer_pool_manager_->UnpinPage(image_page_id, false);
+    // Another thread may have inserted into the bucket before the table latch was taken.
+    if (!bucket_empty && !image_empty) {
+      break;
+    }
+    page_id_t kept_page_id = bucket_empty ? image_page_id : bucket_page_id;
+    page_id_t deleted_page_id = bucket_empty ? bucket_page_id : image_page_id;
+    for (uint32_t i = 0; i < dir_page->Size(); i++) {
+      if (dir_page->GetBucketPageId(i) == bucket_page_id || dir_page->GetBucketPageId(i) == image_page_id) {
+        dir_page->SetBucketPageId(i, kept_page_id);
+        dir_page->SetLocalDepth(i, local_depth - 1);
+      }
+    }
+    buffer_pool_manager_->DeletePage(deleted_page_id);
+    merged = true;
+  }
+  while (dir_page->GetGlobalDepth() > 0 && dir_page->CanShrink()) {
+    dir_page->DecrGlobalDepth();
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, merged);
+  table_latch_.WUnlock();
+}
+
+/*****************************************************************************
+ * GETGLOBALDEPTH
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+uint32_t EXTENDIBLE_HASH_TABLE_TYPE::GetGlobalDepth() {
+  table_latch_.RLock();
+  auto *dir_page = reinterpret_cast<HashTableDirectoryPage *>(FetchPage(directory_page_id_)->GetData());
+  uint32_t global_depth = dir_page->GetGlobalDepth();
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  return global_depth;
+}
+
+/*****************************************************************************
+ * VERIFY INTEGRITY
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+void EXTENDIBLE_HASH_TABLE_TYPE::VerifyIntegrity() {
+  table_latch_.RLock();
+  auto *dir_page = reinterpret_cast<HashTableDirectoryPage *>(FetchPage(directory_page_id_)->GetData());
+  dir_page->VerifyIntegrity();
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+}
+
+/*****************************************************************************
+ * UTILITIES
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+Page *EXTENDIBLE_HASH_TABLE_TYPE::FetchPage(page_id_t page_id) {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch a hash table page, the buffer pool is full.");
+  }
+  return page;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+Page *EXTENDIBLE_HASH_TABLE_TYPE::NewPage(page_id_t *page_id) {
+  Page *page = buffer_pool_manager_->NewPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate a hash table page, the buffer pool is full.");
+  }
+  return page;
+}
+
+template class ExtendibleHashTable<int, int, IntComparator>;
+
+template class ExtendibleHashTable<GenericKey<4>, RID, GenericComparator<4>>;
+template class ExtendibleHashTable<GenericKey<8>, RID, GenericComparator<8>>;
+template class ExtendibleHashTable<GenericKey<16>, RID, GenericComparator<16>>;
+template class ExtendibleHashTable<GenericKey<32>, RID, GenericComparator<32>>;
+template class ExtendibleHashTable<GenericKey<64>, RID, GenericComparator<64>>;
+
+template class ExtendibleHashTable<GenericKey<4>, RID, GenericComparator<4>, Crc32cHashFunction<GenericKey<4>>>;
+template class ExtendibleHashTable<GenericKey<8>, RID, GenericComparator<8>, Crc32cHashFunction<GenericKey<8>>>;
+template class ExtendibleHashTable<GenericKey<16>, RID, GenericComparator<16>, Crc32cHashFunction<GenericKey<16>>>;
+template class ExtendibleHashTable<GenericKey<32>, RID, GenericComparator<32>, Crc32cHashFunction<GenericKey<32>>>;
+template class ExtendibleHashTable<GenericKey<64>, RID, GenericComparator<64>, Crc32cHashFunction<GenericKey<64>>>;
+template class ExtendibleHashTable<GenericKey<4>, RID, GenericComparator<4>, WyHashFunction<GenericKey<4>>>;
+template class ExtendibleHashTable<GenericKey<8>, RID, GenericComparator<8>, WyHashFunction<GenericKey<8>>>;
+template class ExtendibleHashTable<GenericKey<16>, RID, GenericComparator<16>, WyHashFunction<GenericKey<16>>>;
+template class ExtendibleHashTable<GenericKey<32>, RID, GenericComparator<32>, WyHashFunction<GenericKey<32>>>;
+template class ExtendibleHashTable<GenericKey<64>, RID, GenericComparator<64>, WyHashFunction<GenericKey<64>>>;
+
+}  // namespace bustub
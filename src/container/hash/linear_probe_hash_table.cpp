@@ -10,6 +10,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <string>
 #include <utility>
@@ -22,47 +24,740 @@
 
 namespace bustub {
 
-template <typename KeyType, typename ValueType, typename KeyComparator>
+namespace {
+
+/**
+ * @param free the free slots of a run, as bits of a group
+ * @param slots the slots of the run
+ * @return the slots of the run a probe passes before it reaches the first free slot
+ */
+inline uint32_t SlotsBefore(uint32_t free, uint32_t slots) {
+  return free == 0 ? slots : slots & ((free & (0U - free)) - 1);
+}
+
+}  // namespace
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
 HASH_TABLE_TYPE::LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
-                                      const KeyComparator &comparator, size_t num_buckets,
-                                      HashFunction<KeyType> hash_fn)
-    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {}
+                                      const KeyComparator &comparator, size_t num_buckets, HashFn hash_fn,
+                                      size_t filter_bits_per_bucket)
+    : buffer_pool_manager_(buffer_pool_manager),
+      comparator_(comparator),
+      hash_fn_(std::move(hash_fn)),
+      filter_bits_per_bucket_(filter_bits_per_bucket) {
+  // A full table has a key per bucket, setting ln 2 times the bits per key minimizes its false positives.
+  filter_key_bits_ =
+      filter_bits_per_bucket == 0
+          ? 0
+          : std::clamp<size_t>(std::lround(filter_bits_per_bucket * std::log(2.0)), 1, FILTER_MAX_KEY_BITS);
+  header_page_id_ = CreateTable(num_buckets);
+  BUSTUB_ASSERT(header_page_id_ != INVALID_PAGE_ID, "The blocks of the hash table do not fit into its header page.");
+}
 
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
-template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
 bool HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) {
-  return false;
+  size_t num_found = result->size();
+  size_t num_old = num_found;
+  uint64_t hash = hash_fn_.GetHash(key);
+  uint8_t fingerprint = HASH_TABLE_BLOCK_TYPE::Fingerprint(hash);
+  auto collect = [&](HASH_TABLE_BLOCK_TYPE *block, size_t group, uint32_t slots) {
+    return CollectValues(block, group, slots, key, fingerprint, result, num_found, num_old);
+  };
+
+  table_latch_.RLock();
+  // Pairs only move from the old table to the new one, so probing the old table first finds every pair.
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    if (FilterMayContain(old_header_page_id_, hash)) {
+      Probe(old_header_page_id_, hash, false, collect);
+    }
+    num_old = result->size();
+  }
+  if (FilterMayContain(header_page_id_, hash)) {
+    Probe(header_page_id_, hash, false, collect);
+  }
+  bool finished = MigrateChunk();
+  page_id_t old_header_page_id = old_header_page_id_;
+  table_latch_.RUnlock();
+  if (finished) {
+    FinishMigration(old_header_page_id);
+  }
+  return result->size() > num_found;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+size_t HASH_TABLE_TYPE::GetValues(Transaction *transaction, const std::vector<KeyType> &keys,
+                                  std::vector<std::vector<ValueType>> *results) {
+  results->resize(keys.size());
+  std::vector<uint64_t> hashes(keys.size());
+  std::vector<size_t> num_found(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    hashes[i] = hash_fn_.GetHash(keys[i]);
+    num_found[i] = (*results)[i].size();
+  }
+  std::vector<size_t> num_old = num_found;
+
+  table_latch_.RLock();
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    ProbeBatch(old_header_page_id_, keys, hashes, results, num_found, num_old);
+    for (size_t i = 0; i < keys.size(); i++) {
+      num_old[i] = (*results)[i].size();
+    }
+  }
+  ProbeBatch(header_page_id_, keys, hashes, results, num_found, num_old);
+  bool finished = MigrateChunk();
+  page_id_t old_header_page_id = old_header_page_id_;
+  table_latch_.RUnlock();
+  if (finished) {
+    FinishMigration(old_header_page_id);
+  }
+
+  size_t num_keys_found = 0;
+  for (size_t i = 0; i < keys.size(); i++) {
+    num_keys_found += (*results)[i].size() > num_found[i] ? 1 : 0;
+  }
+  return num_keys_found;
 }
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+void HASH_TABLE_TYPE::ProbeBatch(page_id_t header_page_id, const std::vector<KeyType> &keys,
+                                 const std::vector<uint64_t> &hashes, std::vector<std::vector<ValueType>> *results,
+                                 const std::vector<size_t> &num_found, const std::vector<size_t> &num_old) {
+  auto *header_page = reinterpret_cast<HashTableHeaderPage *>(FetchPage(header_page_id)->GetData());
+  size_t size = header_page->GetSize();
+  // The buckets of the keys and the indexes of the keys, in bucket order
+  std::vector<std::pair<size_t, size_t>> order;
+  order.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    if (FilterMayContain(header_page_id, hashes[i])) {
+      order.emplace_back(hashes[i] % size, i);
+    }
+  }
+  std::sort(order.begin(), order.end());
+
+  std::vector<Page *> pages;
+  std::vector<HASH_TABLE_BLOCK_TYPE *> blocks;
+  // The keys whose probe sequences leave their block page
+  std::vector<size_t> unfinished;
+  for (size_t begin = 0; begin < order.size();) {
+    // Latches the block pages of the next keys and prefetches their slots; fetching the next block page overlaps with
+    // the prefetches of the keys before.
+    size_t end = begin;
+    pages.clear();
+    blocks.clear();
+    for (; end < order.size(); end++) {
+      page_id_t block_page_id = header_page->GetBlockPageId(order[end].first / BLOCK_ARRAY_SIZE);
+      if (pages.empty() || pages.back()->GetPageId() != block_page_id) {
+        if (pages.size() == HASH_TABLE_BATCH_BLOCKS) {
+          break;
+        }
+        pages.push_back(FetchPage(block_page_id));
+        pages.back()->RLatch();
+      }
+      blocks.push_back(reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(pages.back()->GetData()));
+      blocks.back()->Prefetch(order[end].first % BLOCK_ARRAY_SIZE);
+    }
+
+    // Probes each key up to the end of its block page.
+    for (size_t k = begin; k < end; k++) {
+      size_t bucket = order[k].first;
+      size_t i = order[k].second;
+      uint8_t fingerprint = HASH_TABLE_BLOCK_TYPE::Fingerprint(hashes[i]);
+      size_t block_end = std::min<size_t>((bucket / BLOCK_ARRAY_SIZE + 1) * BLOCK_ARRAY_SIZE, size);
+      bool stopped = false;
+      while (!stopped && bucket < block_end) {
+        size_t slot = bucket % BLOCK_ARRAY_SIZE;
+        size_t group = slot / BLOCK_GROUP_SIZE;
+        size_t run = std::min<size_t>((group + 1) * BLOCK_GROUP_SIZE, block_end - bucket + slot) - slot;
+        uint32_t slots = (run == BLOCK_GROUP_SIZE ? ~0U : (1U << run) - 1) << (slot % BLOCK_GROUP_SIZE);
+        stopped = CollectValues(blocks[k - begin], group, slots, keys[i], fingerprint, &(*results)[i], num_found[i],
+                                num_old[i]);
+        bucket += run;
+      }
+      if (!stopped) {
+        unfinished.push_back(i);
+      }
+    }
+    for (Page *page : pages) {
+      page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    }
+    begin = end;
+  }
+
+  // Probing the rest of the table one block page at a time visits the start of the sequence again.
+  for (size_t i : unfinished) {
+    auto *result = &(*results)[i];
+    result->resize(num_old[i]);
+    uint8_t fingerprint = HASH_TABLE_BLOCK_TYPE::Fingerprint(hashes[i]);
+    Probe(header_page_id, hashes[i], false, [&](HASH_TABLE_BLOCK_TYPE *block, size_t group, uint32_t slots) {
+      return CollectValues(block, group, slots, keys[i], fingerprint, result, num_found[i], num_old[i]);
+    });
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id, false);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+bool HASH_TABLE_TYPE::CollectValues(HASH_TABLE_BLOCK_TYPE *block, size_t group, uint32_t slots, const KeyType &key,
+                                    uint8_t fingerprint, std::vector<ValueType> *result, size_t num_found,
+                                    size_t num_old) {
+  uint32_t free;
+  uint32_t match = block->MatchGroup(group, fingerprint, &free);
+  free &= slots;
+  for (match &= SlotsBefore(free, slots); match != 0; match &= match - 1) {
+    slot_offset_t slot = group * BLOCK_GROUP_SIZE + __builtin_ctz(match);
+    if (comparator_(block->KeyAt(slot), key) == 0) {
+      ValueType value = block->ValueAt(slot);
+      // A pair that moved out of the old table while it was probed is found in both tables.
+      if (std::find(result->begin() + num_found, result->begin() + num_old, value) == result->begin() + num_old) {
+        result->push_back(value);
+      }
+    }
+  }
+  return free != 0;
+}
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
-template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
 bool HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) {
-  return false;
+  while (true) {
+    bool inserted = false;
+    table_latch_.RLock();
+    page_id_t header_page_id = header_page_id_;
+    page_id_t old_header_page_id = old_header_page_id_;
+    bool done = (old_header_page_id != INVALID_PAGE_ID && FindPair(old_header_page_id, key, value, false)) ||
+                TryInsert(header_page_id, key, value, &inserted);
+    bool finished = MigrateChunk();
+    table_latch_.RUnlock();
+    if (finished) {
+      FinishMigration(old_header_page_id);
+    }
+    if (done) {
+      return inserted;
+    }
+    if (!Grow(header_page_id)) {
+      return false;
+    }
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+bool HASH_TABLE_TYPE::TryInsert(page_id_t header_page_id, const KeyType &key, const ValueType &value,
+                                bool *inserted) {
+  uint64_t hash = hash_fn_.GetHash(key);
+  uint8_t fingerprint = HASH_TABLE_BLOCK_TYPE::Fingerprint(hash);
+  // The bits are set before the pair becomes readable, and stay set if the pair is there already.
+  FilterInsert(header_page_id, hash);
+  return Probe(header_page_id, hash, true, [&](HASH_TABLE_BLOCK_TYPE *block, size_t group, uint32_t slots) {
+    while (true) {
+      uint32_t free;
+      uint32_t match = block->MatchGroup(group, fingerprint, &free);
+      free &= slots;
+      for (match &= SlotsBefore(free, slots); match != 0; match &= match - 1) {
+        slot_offset_t slot = group * BLOCK_GROUP_SIZE + __builtin_ctz(match);
+        if (comparator_(block->KeyAt(slot), key) == 0 && block->ValueAt(slot) == value) {
+          return true;
+        }
+      }
+      if (free == 0) {
+        return false;
+      }
+      if (block->Insert(group * BLOCK_GROUP_SIZE + __builtin_ctz(free), key, value, fingerprint)) {
+        *inserted = true;
+        return true;
+      }
+      // Another insert claimed the slot first, the group is matched again.
+    }
+  });
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+void HASH_TABLE_TYPE::BulkInsert(Transaction *transaction, const std::vector<MappingType> &pairs) {
+  table_latch_.WLock();
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    CompleteMigration();
+  }
+  auto *header_page = reinterpret_cast<HashTableHeaderPage *>(FetchPage(header_page_id_)->GetData());
+  size_t size = header_page->GetSize();
+  size_t num_blocks = header_page->NumBlocks();
+
+  // Partitions the pairs by block page (counting sort), block_begin[b] is the first pair of block page b.
+  std::vector<uint64_t> hashes(pairs.size());
+  std::vector<size_t> block_begin(num_blocks + 1);
+  for (size_t i = 0; i < pairs.size(); i++) {
+    hashes[i] = hash_fn_.GetHash(pairs[i].first);
+    block_begin[hashes[i] % size / BLOCK_ARRAY_SIZE + 1]++;
+  }
+  for (size_t block_index = 0; block_index < num_blocks; block_index++) {
+    block_begin[block_index + 1] += block_begin[block_index];
+  }
+  std::vector<size_t> partitioned(pairs.size());
+  std::vector<size_t> next_pair(block_begin.begin(), block_begin.end() - 1);
+  for (size_t i = 0; i < pairs.size(); i++) {
+    partitioned[next_pair[hashes[i] % size / BLOCK_ARRAY_SIZE]++] = i;
+  }
+
+  // The pairs that found no free slot up to the end of the previous block page, and of this one
+  std::vector<size_t> carry;
+  std::vector<size_t> next_carry;
+  for (size_t block_index = 0; block_index < num_blocks; block_index++) {
+    if (carry.empty() && block_begin[block_index] == block_begin[block_index + 1]) {
+      continue;
+    }
+    Page *page = FetchPage(header_page->GetBlockPageId(block_index));
+    page->WLatch();
+    auto *block = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(page->GetData());
+    size_t block_size = std::min<size_t>(BLOCK_ARRAY_SIZE, size - block_index * BLOCK_ARRAY_SIZE);
+    // Inserts a pair into the first free slot from slot on, as a probe would find it.
+    auto place = [&](size_t i, size_t slot) {
+      for (size_t group = slot / BLOCK_GROUP_SIZE; group * BLOCK_GROUP_SIZE < block_size; group++) {
+        uint32_t free;
+        block->MatchGroup(group, 0, &free);
+        if (group == slot / BLOCK_GROUP_SIZE) {
+          free &= ~0U << (slot % BLOCK_GROUP_SIZE);
+        }
+        if ((group + 1) * BLOCK_GROUP_SIZE > block_size) {
+          free &= (1U << (block_size - group * BLOCK_GROUP_SIZE)) - 1;
+        }
+        if (free != 0) {
+          FilterInsert(header_page_id_, hashes[i]);
+          block->Insert(group * BLOCK_GROUP_SIZE + __builtin_ctz(free), pairs[i].first, pairs[i].second,
+                        HASH_TABLE_BLOCK_TYPE::Fingerprint(hashes[i]));
+          return;
+        }
+      }
+      next_carry.push_back(i);
+    };
+    next_carry.clear();
+    for (size_t i : carry) {
+      place(i, 0);
+    }
+    for (size_t k = block_begin[block_index]; k < block_begin[block_index + 1]; k++) {
+      place(partitioned[k], hashes[partitioned[k]] % size % BLOCK_ARRAY_SIZE);
+    }
+    carry.swap(next_carry);
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  table_latch_.WUnlock();
+
+  // The probe sequences of these pairs wrap around to the first block page, or the table is full.
+  for (size_t i : carry) {
+    Insert(transaction, pairs[i].first, pairs[i].second);
+  }
 }
 
 /*****************************************************************************
  * REMOVE
  *****************************************************************************/
-template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
 bool HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) {
-  return false;
+  table_latch_.RLock();
+  page_id_t old_header_page_id = old_header_page_id_;
+  // A pair that is being migrated is removed from the new table once its old block page is unlatched.
+  bool removed = (old_header_page_id != INVALID_PAGE_ID && FindPair(old_header_page_id, key, value, true)) ||
+                 FindPair(header_page_id_, key, value, true);
+  bool finished = MigrateChunk();
+  table_latch_.RUnlock();
+  if (finished) {
+    FinishMigration(old_header_page_id);
+  }
+  return removed;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+bool HASH_TABLE_TYPE::FindPair(page_id_t header_page_id, const KeyType &key, const ValueType &value, bool remove) {
+  bool found = false;
+  uint64_t hash = hash_fn_.GetHash(key);
+  if (!FilterMayContain(header_page_id, hash)) {
+    return false;
+  }
+  uint8_t fingerprint = HASH_TABLE_BLOCK_TYPE::Fingerprint(hash);
+  Probe(header_page_id, hash, remove, [&](HASH_TABLE_BLOCK_TYPE *block, size_t group, uint32_t slots) {
+    uint32_t free;
+    uint32_t match = block->MatchGroup(group, fingerprint, &free);
+    free &= slots;
+    for (match &= SlotsBefore(free, slots); match != 0; match &= match - 1) {
+      slot_offset_t slot = group * BLOCK_GROUP_SIZE + __builtin_ctz(match);
+      // Of concurrent removes of the pair only one clears the readable bit.
+      if (comparator_(block->KeyAt(slot), key) == 0 && block->ValueAt(slot) == value &&
+          (!remove || block->Remove(slot))) {
+        found = true;
+        return true;
+      }
+    }
+    return free != 0;
+  });
+  return found;
+}
+
+/*****************************************************************************
+ * BLOOM FILTER
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+bool HASH_TABLE_TYPE::MayContain(const KeyType &key) {
+  uint64_t hash = hash_fn_.GetHash(key);
+  table_latch_.RLock();
+  bool may_contain = (old_header_page_id_ != INVALID_PAGE_ID && FilterMayContain(old_header_page_id_, hash)) ||
+                     FilterMayContain(header_page_id_, hash);
+  table_latch_.RUnlock();
+  return may_contain;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+bool HASH_TABLE_TYPE::FilterMayContain(page_id_t header_page_id, uint64_t hash) {
+  size_t line;
+  HashTableFilterPage *filter_page = FilterLine(header_page_id, hash, &line);
+  return filter_page == nullptr || filter_page->MayContain(line, HashUtil::HashInteger(hash), filter_key_bits_);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+void HASH_TABLE_TYPE::FilterInsert(page_id_t header_page_id, uint64_t hash) {
+  size_t line;
+  HashTableFilterPage *filter_page = FilterLine(header_page_id, hash, &line);
+  if (filter_page != nullptr) {
+    filter_page->Insert(line, HashUtil::HashInteger(hash), filter_key_bits_);
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+HashTableFilterPage *HASH_TABLE_TYPE::FilterLine(page_id_t header_page_id, uint64_t hash, size_t *line) {
+  if (filter_key_bits_ == 0) {
+    return nullptr;
+  }
+  for (const auto &filter : filters_) {
+    if (filter.header_page_id_ == header_page_id) {
+      // The high bits of the hash pick the line, the bits within it come from a rehash.
+      uint64_t num_lines = filter.pages_.size() * FILTER_PAGE_LINES;
+      uint64_t filter_line = ((hash >> 32) * num_lines) >> 32;
+      *line = filter_line % FILTER_PAGE_LINES;
+      return reinterpret_cast<HashTableFilterPage *>(filter.pages_[filter_line / FILTER_PAGE_LINES]->GetData());
+    }
+  }
+  return nullptr;
 }
 
 /*****************************************************************************
  * RESIZE
  *****************************************************************************/
-template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::Resize(size_t initial_size) {}
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+void HASH_TABLE_TYPE::Resize(size_t initial_size) {
+  table_latch_.WLock();
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    CompleteMigration();
+  }
+  if (old_header_page_id_ == INVALID_PAGE_ID && GetSize(header_page_id_) < 2 * initial_size &&
+      StartMigration(2 * initial_size)) {
+    CompleteMigration();
+  }
+  table_latch_.WUnlock();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+bool HASH_TABLE_TYPE::Grow(page_id_t header_page_id) {
+  table_latch_.WLock();
+  bool grown = true;
+  // Another insert that found the table full may have grown it already.
+  if (header_page_id_ == header_page_id) {
+    if (old_header_page_id_ != INVALID_PAGE_ID) {
+      // The new table filled up before the old one was drained, both are rehashed into a larger one right away.
+      grown = Rebuild(0);
+    } else {
+      // A table full of tombstones is migrated into one of its size, a table full of pairs doubles.
+      grown = StartMigration(GetSize(header_page_id_));
+    }
+  }
+  table_latch_.WUnlock();
+  return grown;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+bool HASH_TABLE_TYPE::StartMigration(size_t num_buckets) {
+  size_t num_pairs = 0;
+  auto *header_page = reinterpret_cast<HashTableHeaderPage *>(FetchPage(header_page_id_)->GetData());
+  for (size_t block_index = 0; block_index < header_page->NumBlocks(); block_index++) {
+    page_id_t block_page_id = header_page->GetBlockPageId(block_index);
+    num_pairs += reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(FetchPage(block_page_id)->GetData())->NumReadable();
+    buffer_pool_manager_->UnpinPage(block_page_id, false);
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+
+  page_id_t new_header_page_id = CreateTable(std::max(num_buckets, 2 * num_pairs));
+  if (new_header_page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  old_header_page_id_ = header_page_id_;
+  old_size_ = GetSize(old_header_page_id_);
+  header_page_id_ = new_header_page_id;
+  next_migrate_bucket_ = 0;
+  num_migrated_buckets_ = 0;
+  migration_overflow_ = false;
+  return true;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+bool HASH_TABLE_TYPE::MigrateChunk() {
+  if (old_header_page_id_ == INVALID_PAGE_ID) {
+    return false;
+  }
+  size_t begin = next_migrate_bucket_.fetch_add(HASH_TABLE_MIGRATION_CHUNK);
+  if (begin >= old_size_) {
+    return false;
+  }
+  size_t end = std::min<size_t>(begin + HASH_TABLE_MIGRATION_CHUNK, old_size_);
+  MigrateBuckets(begin, end);
+  return num_migrated_buckets_.fetch_add(end - begin) + (end - begin) == old_size_;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+void HASH_TABLE_TYPE::MigrateBuckets(size_t begin, size_t end) {
+  auto *header_page = reinterpret_cast<HashTableHeaderPage *>(FetchPage(old_header_page_id_)->GetData());
+  for (size_t bucket = begin; bucket < end;) {
+    size_t block_index = bucket / BLOCK_ARRAY_SIZE;
+    size_t block_end = std::min<size_t>(end, (block_index + 1) * BLOCK_ARRAY_SIZE);
+    Page *page = FetchPage(header_page->GetBlockPageId(block_index));
+    page->WLatch();
+    auto *block = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(page->GetData());
+    for (; bucket < block_end; bucket++) {
+      slot_offset_t slot = bucket % BLOCK_ARRAY_SIZE;
+      if (!block->IsReadable(slot)) {
+        continue;
+      }
+      bool inserted;
+      if (TryInsert(header_page_id_, block->KeyAt(slot), block->ValueAt(slot), &inserted)) {
+        block->Remove(slot);
+      } else {
+        // The pair stays in the old table, which is then rehashed together with the new one.
+        migration_overflow_ = true;
+      }
+    }
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+  }
+  buffer_pool_manager_->UnpinPage(old_header_page_id_, false);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+void HASH_TABLE_TYPE::FinishMigration(page_id_t old_header_page_id) {
+  table_latch_.WLock();
+  if (old_header_page_id_ == old_header_page_id) {
+    CompleteMigration();
+  }
+  table_latch_.WUnlock();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+void HASH_TABLE_TYPE::CompleteMigration() {
+  size_t begin = std::min(next_migrate_bucket_.load(), old_size_);
+  MigrateBuckets(begin, old_size_);
+  next_migrate_bucket_ = old_size_;
+  if (migration_overflow_) {
+    // If the rehash does not fit either, both tables stay and the next insert that finds no room fails.
+    Rebuild(0);
+    return;
+  }
+  DeleteTable(old_header_page_id_);
+  old_header_page_id_ = INVALID_PAGE_ID;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+bool HASH_TABLE_TYPE::Rebuild(size_t num_buckets) {
+  std::vector<MappingType> pairs;
+  for (page_id_t header_page_id : {old_header_page_id_, header_page_id_}) {
+    if (header_page_id == INVALID_PAGE_ID) {
+      continue;
+    }
+    auto *header_page = reinterpret_cast<HashTableHeaderPage *>(FetchPage(header_page_id)->GetData());
+    for (size_t block_index = 0; block_index < header_page->NumBlocks(); block_index++) {
+      page_id_t block_page_id = header_page->GetBlockPageId(block_index);
+      auto *block = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(FetchPage(block_page_id)->GetData());
+      for (slot_offset_t slot = 0; slot < BLOCK_ARRAY_SIZE; slot++) {
+        if (block->IsReadable(slot)) {
+          pairs.emplace_back(block->KeyAt(slot), block->ValueAt(slot));
+        }
+      }
+      buffer_pool_manager_->UnpinPage(block_page_id, false);
+    }
+    buffer_pool_manager_->UnpinPage(header_page_id, false);
+  }
+
+  page_id_t new_header_page_id = CreateTable(std::max(num_buckets, 2 * pairs.size()));
+  if (new_header_page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  for (const auto &pair : pairs) {
+    bool inserted;
+    TryInsert(new_header_page_id, pair.first, pair.second, &inserted);
+  }
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    DeleteTable(old_header_page_id_);
+    old_header_page_id_ = INVALID_PAGE_ID;
+  }
+  DeleteTable(header_page_id_);
+  header_page_id_ = new_header_page_id;
+  return true;
+}
 
 /*****************************************************************************
  * GETSIZE
  *****************************************************************************/
-template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
 size_t HASH_TABLE_TYPE::GetSize() {
-  return 0;
+  table_latch_.RLock();
+  size_t size = GetSize(header_page_id_);
+  table_latch_.RUnlock();
+  return size;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+bool HASH_TABLE_TYPE::IsEmpty() {
+  table_latch_.RLock();
+  bool empty = true;
+  // The old table is visited first, a pair that is migrated meanwhile is found in the new one.
+  for (page_id_t header_page_id : {old_header_page_id_, header_page_id_}) {
+    if (header_page_id == INVALID_PAGE_ID) {
+      continue;
+    }
+    auto *header_page = reinterpret_cast<HashTableHeaderPage *>(FetchPage(header_page_id)->GetData());
+    for (size_t block_index = 0; empty && block_index < header_page->NumBlocks(); block_index++) {
+      page_id_t block_page_id = header_page->GetBlockPageId(block_index);
+      empty = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(FetchPage(block_page_id)->GetData())->NumReadable() == 0;
+      buffer_pool_manager_->UnpinPage(block_page_id, false);
+    }
+    buffer_pool_manager_->UnpinPage(header_page_id, false);
+  }
+  table_latch_.RUnlock();
+  return empty;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+size_t HASH_TABLE_TYPE::GetSize(page_id_t header_page_id) {
+  auto *header_page = reinterpret_cast<HashTableHeaderPage *>(FetchPage(header_page_id)->GetData());
+  size_t size = header_page->GetSize();
+  buffer_pool_manager_->UnpinPage(header_page_id, false);
+  return size;
+}
+
+/*****************************************************************************
+ * UTILITIES
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+template <typename Visitor>
+bool HASH_TABLE_TYPE::Probe(page_id_t header_page_id, uint64_t hash, bool is_write, Visitor visit) {
+  auto *header_page = reinterpret_cast<HashTableHeaderPage *>(FetchPage(header_page_id)->GetData());
+  size_t size = header_page->GetSize();
+  size_t bucket = hash % size;
+  Page *page = nullptr;
+  HASH_TABLE_BLOCK_TYPE *block = nullptr;
+  bool stopped = false;
+  for (size_t remaining = size; remaining > 0 && !stopped;) {
+    size_t block_index = bucket / BLOCK_ARRAY_SIZE;
+    size_t slot = bucket % BLOCK_ARRAY_SIZE;
+    if (page == nullptr || slot == 0) {
+      if (page != nullptr) {
+        page->RUnlatch();
+        buffer_pool_manager_->UnpinPage(page->GetPageId(), is_write);
+      }
+      page = FetchPage(header_page->GetBlockPageId(block_index));
+      page->RLatch();
+      block = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(page->GetData());
+    }
+    // The run ends at the end of the group, of the block, of the table or of the probe sequence.
+    size_t group = slot / BLOCK_GROUP_SIZE;
+    size_t run_end = std::min<size_t>((group + 1) * BLOCK_GROUP_SIZE, BLOCK_ARRAY_SIZE);
+    size_t run = std::min({run_end - slot, size - bucket, remaining});
+    uint32_t slots = (run == BLOCK_GROUP_SIZE ? ~0U : (1U << run) - 1) << (slot % BLOCK_GROUP_SIZE);
+    stopped = visit(block, group, slots);
+    remaining -= run;
+    bucket += run;
+    if (bucket == size) {
+      bucket = 0;
+      // The last block may be partially used, the probe continues in the first block.
+      page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), is_write);
+      page = nullptr;
+    }
+  }
+  if (page != nullptr) {
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), is_write);
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id, false);
+  return stopped;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+page_id_t HASH_TABLE_TYPE::CreateTable(size_t num_buckets) {
+  // A rebuild of a table that holds no pairs asks for no buckets.
+  num_buckets = std::max<size_t>(num_buckets, 1);
+  size_t num_blocks = (num_buckets - 1) / BLOCK_ARRAY_SIZE + 1;
+  size_t num_filter_pages =
+      filter_bits_per_bucket_ == 0 ? 0 : (num_buckets * filter_bits_per_bucket_ - 1) / FILTER_PAGE_BITS + 1;
+  if (num_blocks + num_filter_pages > HASH_TABLE_HEADER_MAX_BLOCKS) {
+    return INVALID_PAGE_ID;
+  }
+  page_id_t header_page_id;
+  auto *header_page = reinterpret_cast<HashTableHeaderPage *>(NewPage(&header_page_id)->GetData());
+  header_page->SetPageId(header_page_id);
+  header_page->SetSize(num_buckets);
+  for (size_t block_index = 0; block_index < num_blocks; block_index++) {
+    page_id_t block_page_id;
+    NewPage(&block_page_id);
+    header_page->AddBlockPageId(block_page_id);
+    buffer_pool_manager_->UnpinPage(block_page_id, true);
+  }
+  // New pages are zeroed, the filter is empty. The filter pages stay pinned.
+  TableFilter filter{header_page_id, {}};
+  for (size_t filter_index = 0; filter_index < num_filter_pages; filter_index++) {
+    page_id_t filter_page_id;
+    filter.pages_.push_back(NewPage(&filter_page_id));
+    header_page->AddFilterPageId(filter_page_id);
+  }
+  if (num_filter_pages > 0) {
+    filters_.push_back(std::move(filter));
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id, true);
+  return header_page_id;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+void HASH_TABLE_TYPE::DeleteTable(page_id_t header_page_id) {
+  auto *header_page = reinterpret_cast<HashTableHeaderPage *>(FetchPage(header_page_id)->GetData());
+  for (size_t block_index = 0; block_index < header_page->NumBlocks(); block_index++) {
+    buffer_pool_manager_->DeletePage(header_page->GetBlockPageId(block_index));
+  }
+  for (size_t filter_index = 0; filter_index < header_page->NumFilterPages(); filter_index++) {
+    buffer_pool_manager_->UnpinPage(header_page->GetFilterPageId(filter_index), true);
+    buffer_pool_manager_->DeletePage(header_page->GetFilterPageId(filter_index));
+  }
+  filters_.erase(std::remove_if(filters_.begin(), filters_.end(),
+                                [&](const TableFilter &filter) { return filter.header_page_id_ == header_page_id; }),
+                 filters_.end());
+  buffer_pool_manager_->UnpinPage(header_page_id, false);
+  buffer_pool_manager_->DeletePage(header_page_id);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+Page *HASH_TABLE_TYPE::FetchPage(page_id_t page_id) {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch a hash table page, the buffer pool is full.");
+  }
+  return page;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+Page *HASH_TABLE_TYPE::NewPage(page_id_t *page_id) {
+  Page *page = buffer_pool_manager_->NewPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate a hash table page, the buffer pool is full.");
+  }
+  return page;
 }
 
 template class LinearProbeHashTable<int, int, IntComparator>;
@@ -73,4 +768,15 @@ template class LinearProbeHashTable<GenericKey<16>, RID, GenericComparator<16>>;
 template class LinearProbeHashTable<GenericKey<32>, RID, GenericComparator<32>>;
 template class LinearProbeHashTable<GenericKey<64>, RID, GenericComparator<64>>;
 
+template class LinearProbeHashTable<GenericKey<4>, RID, GenericComparator<4>, Crc32cHashFunction<GenericKey<4>>>;
+template class LinearProbeHashTable<GenericKey<8>, RID, GenericComparator<8>, Crc32cHashFunction<GenericKey<8>>>;
+template class LinearProbeHashTable<GenericKey<16>, RID, GenericComparator<16>, Crc32cHashFunction<GenericKey<16>>>;
+template class LinearProbeHashTable<GenericKey<32>, RID, GenericComparator<32>, Crc32cHashFunction<GenericKey<32>>>;
+template class LinearProbeHashTable<GenericKey<64>, RID, GenericComparator<64>, Crc32cHashFunction<GenericKey<64>>>;
+template class LinearProbeHashTable<GenericKey<4>, RID, GenericComparator<4>, WyHashFunction<GenericKey<4>>>;
+template class LinearProbeHashTable<GenericKey<8>, RID, GenericComparator<8>, WyHashFunction<GenericKey<8>>>;
+template class LinearProbeHashTable<GenericKey<16>, RID, GenericComparator<16>, WyHashFunction<GenericKey<16>>>;
+template class LinearProbeHashTable<GenericKey<32>, RID, GenericComparator<32>, WyHashFunction<GenericKey<32>>>;
+template class LinearProbeHashTable<GenericKey<64>, RID, GenericComparator<64>, WyHashFunction<GenericKey<64>>>;
+
 }  // namespace bustub
@@ -1,22 +1,63 @@
-//===----------------------------------------------------------------------===//
-//
-//                         BusTub
-//
-// seq_scan_executor.cpp
-//
-// Identification: src/execution/seq_scan_executor.cpp
-//
-// Copyright (c) 2015-19, Carnegie Mellon University Database Group
-//
-//===----------------------------------------------------------------------===//
-#include "execution/executors/seq_scan_executor.h"
-
-namespace bustub {
-
-SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan) : AbstractExecutor(exec_ctx) {}
-
-void SeqScanExecutor::Init() {}
-
-bool SeqScanExecutor::Next(Tuple *tuple) { return false; }
-
-}  // namespace bustub
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// seq_scan_executor.cpp
+//
+// Identification: src/execution/seq_scan_executor.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#include "execution/executors/seq_scan_executor.h"
+
+#include <vector>
+
+namespace bustub {
+
+SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan)
+    : AbstractExecutor(exec_ctx), plan_(plan), table_info_(exec_ctx->GetCatalog()->GetTable(plan->GetTableOid())) {}
+
+void SeqScanExecutor::Init() { table_info_->table_->GetFirstRid(&next_rid_); }
+
+bool SeqScanExecutor::Next(Tuple *tuple) {
+  Transaction *txn = GetExecutorContext()->GetTransaction();
+  LockManager *lock_manager = GetExecutorContext()->GetLockManager();
+  bool locks = lock_manager != nullptr && txn->GetConcurrencyMode() == ConcurrencyMode::PESSIMISTIC;
+  const Schema *schema = &table_info_->schema_;
+  table_oid_t oid = plan_->GetTableOid();
+  if (locks && !lock_manager->LockTable(txn, oid, LockMode::INTENTION_SHARED, plan_->GetLockWaitPolicy())) {
+    return false;
+  }
+  while (next_rid_.GetPageId() != INVALID_PAGE_ID) {
+    RID rid = next_rid_;
+    table_info_->table_->GetNextRid(rid, &next_rid_);
+    // The row is locked before it is read, so that a locked row is skipped without waiting for it.
+    if (locks && !lock_manager->LockRow(txn, oid, rid, LockMode::SHARED, plan_->GetLockWaitPolicy())) {
+      if (txn->GetState() == TransactionState::ABORTED) {
+        return false;
+      }
+      continue;
+    }
+    Tuple row;
+    if (!table_info_->table_->GetTuple(rid, &row, txn)) {
+      if (txn->GetState() == TransactionState::ABORTED) {
+        return false;
+      }
+      continue;
+    }
+    if (plan_->GetPredicate() != nullptr && !plan_->GetPredicate()->Evaluate(&row, schema).GetAs<bool>()) {
+      continue;
+    }
+    std::vector<Value> values;
+    values.reserve(GetOutputSchema()->GetColumnCount());
+    for (const auto &column : GetOutputSchema()->GetColumns()) {
+      values.push_back(column.GetExpr()->Evaluate(&row, schema));
+    }
+    *tuple = Tuple(values, GetOutputSchema());
+    return true;
+  }
+  return false;
+}
+
+}  // namespace bustub
@@ -152,6 +152,13 @@ class BufferPoolManager {
    */
   void FlushAllPagesImpl();
 
+  /**
+   * Writes the page held in the given frame back to disk and clears its dirty flag, forcing the log first if the page
+   * carries changes that are not yet durable. The caller must hold latch_.
+   * @param frame_id the frame holding the page to be written
+   */
+  void FlushFrame(frame_id_t frame_id);
+
   /** Number of pages in the buffer pool. */
   size_t pool_size_;
   /** Array of buffer pool pages. */
@@ -159,14 +166,14 @@ class BufferPoolManager {
   /** Pointer to the disk manager. */
   DiskManager *disk_manager_ __attribute__((__unused__));
   /** Pointer to the log manager. */
-  LogManager *log_manager_ __attribute__((__unused__));
+  LogManager *log_manager_;
   /** Page table for keeping track of buffer pool pages. */
   std::unordered_map<page_id_t, frame_id_t> page_table_;
   /** Replacer to find unpinned pages for replacement. */
   Replacer *replacer_;
   /** List of free pages. */
   std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
+  /** This latch protects the page table, the free list, the replacer and the page metadata (pin count, dirty flag). */
   std::mutex latch_;
 };
 }  // namespace bustub
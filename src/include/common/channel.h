@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// channel.h
+//
+// Identification: src/include/common/channel.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <mutex>               // NOLINT
+#include <queue>
+#include <utility>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * Channel is a bounded, thread-safe FIFO queue used to hand work from producer threads to consumer threads.
+ * Put blocks while the channel is full and Get blocks while it is empty.
+ */
+template <class T>
+class Channel {
+ public:
+  /**
+   * Creates a new channel.
+   * @param capacity the maximum number of elements buffered in the channel
+   */
+  explicit Channel(size_t capacity) : capacity_(capacity) {
+    BUSTUB_ASSERT(capacity > 0, "A channel must be able to hold at least one element.");
+  }
+
+  ~Channel() = default;
+
+  DISALLOW_COPY_AND_MOVE(Channel);
+
+  /**
+   * Appends an element to the channel, blocking while the channel is full.
+   * @param element the element to be appended
+   */
+  void Put(T element) {
+    std::unique_lock<std::mutex> lock(latch_);
+    not_full_.wait(lock, [this] { return queue_.size() < capacity_; });
+    queue_.push(std::move(element));
+    lock.unlock();
+    not_empty_.notify_one();
+  }
+
+  /**
+   * Removes the oldest element from the channel, blocking while the channel is empty.
+   * @return the removed element
+   */
+  T Get() {
+    std::unique_lock<std::mutex> lock(latch_);
+    not_empty_.wait(lock, [this] { return !queue_.empty(); });
+    T element = std::move(queue_.front());
+    queue_.pop();
+    lock.unlock();
+    not_full_.notify_one();
+    return element;
+  }
+
+ private:
+  size_t capacity_;
+  std::mutex latch_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+  std::queue<T> queue_;
+};
+
+}  // namespace bustub
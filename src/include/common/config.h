@@ -21,6 +21,9 @@ namespace bustub {
 /** Cycle detection is performed every CYCLE_DETECTION_INTERVAL milliseconds. */
 extern std::chrono::milliseconds cycle_detection_interval;
 
+/** Old tuple versions are garbage collected every GC_INTERVAL milliseconds. */
+extern std::chrono::milliseconds gc_interval;
+
 /** True if logging should be enabled, false otherwise. */
 extern std::atomic<bool> enable_logging;
 
@@ -30,17 +33,30 @@ extern std::chrono::duration<int64_t> log_timeout;
 static constexpr int INVALID_PAGE_ID = -1;                                    // invalid page id
 static constexpr int INVALID_TXN_ID = -1;                                     // invalid transaction id
 static constexpr int INVALID_LSN = -1;                                        // invalid log sequence number
+static constexpr int INVALID_TS = -1;                                         // invalid timestamp
 static constexpr int HEADER_PAGE_ID = 0;                                      // the header page id
 static constexpr int PAGE_SIZE = 4096;                                        // size of a data page in byte
 static constexpr int BUFFER_POOL_SIZE = 10;                                   // size of buffer pool
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * PAGE_SIZE);  // size of a log buffer in byte
+static constexpr int LOG_READ_BUFFER_SIZE = 256 * PAGE_SIZE;                  // size of a recovery read in byte
+static constexpr int LOG_SEGMENT_SIZE = 16 * 1024 * 1024;                     // size of a log segment file in byte
 static constexpr int BUCKET_SIZE = 50;                                        // size of extendible hash bucket
+static constexpr int LOCK_TABLE_STRIPES = 64;                                 // number of lock table partitions
+static constexpr int LOCK_ESCALATION_THRESHOLD = 5000;                        // row locks per table before escalation
+static constexpr int CACHE_LINE_SIZE = 64;                                    // size of a CPU cache line in byte
+static constexpr int EPOCH_MAX_THREADS = 256;                                 // threads that can enter an epoch
+static constexpr int HASH_TABLE_MIGRATION_CHUNK = 64;                         // buckets migrated per hash table op
+static constexpr int HASH_TABLE_BATCH_BLOCKS = 8;                             // blocks latched at once by batch lookup
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
 using txn_id_t = int32_t;      // transaction id type
 using lsn_t = int32_t;         // log sequence number type
+using timestamp_t = int64_t;   // commit timestamp type
 using slot_offset_t = size_t;  // slot offset type
 using oid_t = uint16_t;
+using table_oid_t = uint32_t;  // table id type
+
+static constexpr table_oid_t INVALID_TABLE_OID = UINT32_MAX;  // table outside the catalog
 
 }  // namespace bustub
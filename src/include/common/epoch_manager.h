@@ -0,0 +1,110 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// epoch_manager.h
+//
+// Identification: src/include/common/epoch_manager.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <utility>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * EpochManager defers freeing objects until no thread can still be reading them.
+ *
+ * A thread that reads shared objects without holding the latches that protect them enters an epoch first, and exits
+ * it when it no longer uses the objects. An object is retired after it has been unlinked, so that no thread can find it
+ * any more. Its reclaim function runs once every thread that was inside an epoch at that time has exited.
+ *
+ * Entering and exiting an epoch only touch the cache line of the calling thread. Each retire advances the global epoch,
+ * and every reclaim_batch retires the manager scans the threads for the oldest epoch still in use.
+ */
+class EpochManager {
+ public:
+  /**
+   * Creates a new epoch manager.
+   * @param reclaim_batch the number of retired objects after which reclaiming is attempted
+   */
+  explicit EpochManager(size_t reclaim_batch = 16);
+
+  /** Runs the reclaim functions of all retired objects. No thread may be inside an epoch. */
+  ~EpochManager();
+
+  DISALLOW_COPY_AND_MOVE(EpochManager);
+
+  /**
+   * Enters an epoch on the calling thread. Epochs nest. Throws if EPOCH_MAX_THREADS other threads use epochs already.
+   */
+  void Enter();
+
+  /** Exits the epoch of the calling thread. */
+  void Exit();
+
+  /**
+   * Retires an object that no thread can find any more.
+   * @param reclaim the function freeing or recycling the object, run once no thread can be reading it
+   */
+  void Retire(std::function<void()> reclaim);
+
+  /**
+   * Runs the reclaim functions of the retired objects that no thread can be reading any more.
+   * @return the number of objects reclaimed
+   */
+  size_t Reclaim();
+
+  /** @return the number of retired objects that were not reclaimed yet */
+  size_t GetNumRetired();
+
+ private:
+  /** The epoch of a thread that is not inside an epoch. */
+  static constexpr uint64_t INACTIVE = std::numeric_limits<uint64_t>::max();
+
+  /** The epoch of one thread, only written by that thread. */
+  struct alignas(CACHE_LINE_SIZE) Slot {
+    std::atomic<uint64_t> epoch_{INACTIVE};
+    /** The number of nested epochs the thread is in. */
+    size_t depth_{0};
+  };
+
+  /** @return the oldest epoch a thread is in, INACTIVE if none is */
+  uint64_t GetMinEpoch();
+
+  std::atomic<uint64_t> global_epoch_{0};
+  std::unique_ptr<Slot[]> slots_;
+  size_t reclaim_batch_;
+  /** Protects the retired objects. */
+  std::mutex retired_latch_;
+  /** The retired objects with the epochs they were retired in, oldest first. */
+  std::deque<std::pair<uint64_t, std::function<void()>>> retired_;
+};
+
+/** EpochGuard keeps the calling thread inside an epoch for its lifetime. */
+class EpochGuard {
+ public:
+  explicit EpochGuard(EpochManager *epoch_manager) : epoch_manager_(epoch_manager) { epoch_manager_->Enter(); }
+
+  ~EpochGuard() { epoch_manager_->Exit(); }
+
+  DISALLOW_COPY_AND_MOVE(EpochGuard);
+
+ private:
+  EpochManager *epoch_manager_;
+};
+
+}  // namespace bustub
@@ -12,25 +12,27 @@
 
 #pragma once
 
-#include <climits>
-#include <condition_variable>  // NOLINT
-#include <mutex>               // NOLINT
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>  // NOLINT
 
+#include "common/config.h"
 #include "common/macros.h"
 
 namespace bustub {
 
 /**
- * Reader-Writer latch backed by std::mutex.
+ * Reader-Writer latch on a single atomic word.
+ *
+ * Uncontended latching is one compare-and-swap on the word; threads that have to wait spin briefly and then sleep on
+ * the word (a futex on Linux). The latch prefers writers: once a writer has entered, new readers wait until it leaves,
+ * so a thread must not take the read latch again while it holds it.
  */
 class ReaderWriterLatch {
-  using mutex_t = std::mutex;
-  using cond_t = std::condition_variable;
-  static const uint32_t MAX_READERS = UINT_MAX;
-
  public:
   ReaderWriterLatch() = default;
-  ~ReaderWriterLatch() { std::lock_guard<mutex_t> guard(mutex_); }
+  ~ReaderWriterLatch() = default;
 
   DISALLOW_COPY(ReaderWriterLatch);
 
@@ -38,13 +40,9 @@ class ReaderWriterLatch {
    * Acquire a write latch.
    */
   void WLock() {
-    std::unique_lock<mutex_t> latch(mutex_);
-    while (writer_entered_) {
-      reader_.wait(latch);
-    }
-    writer_entered_ = true;
-    while (reader_count_ > 0) {
-      writer_.wait(latch);
+    uint32_t expected = 0;
+    if (!state_.compare_exchange_weak(expected, WRITER, std::memory_order_acquire)) {
+      WLockSlow();
     }
   }
 
@@ -52,45 +50,131 @@ class ReaderWriterLatch {
    * Release a write latch.
    */
   void WUnlock() {
-    std::lock_guard<mutex_t> guard(mutex_);
-    writer_entered_ = false;
-    reader_.notify_all();
+    if ((state_.fetch_and(~(WRITER | WAITERS), std::memory_order_release) & WAITERS) != 0) {
+      WakeAll();
+    }
   }
 
   /**
    * Acquire a read latch.
    */
   void RLock() {
-    std::unique_lock<mutex_t> latch(mutex_);
-    while (writer_entered_ || reader_count_ == MAX_READERS) {
-      reader_.wait(latch);
+    uint32_t state = state_.load(std::memory_order_relaxed);
+    if ((state & WRITER) != 0 || (state & READER_MASK) == READER_MASK ||
+        !state_.compare_exchange_weak(state, state + 1, std::memory_order_acquire)) {
+      RLockSlow();
     }
-    reader_count_++;
   }
 
   /**
    * Release a read latch.
    */
   void RUnlock() {
-    std::lock_guard<mutex_t> guard(mutex_);
-    reader_count_--;
-    if (writer_entered_) {
-      if (reader_count_ == 0) {
-        writer_.notify_one();
-      }
-    } else {
-      if (reader_count_ == MAX_READERS - 1) {
-        reader_.notify_one();
-      }
+    uint32_t state = state_.fetch_sub(1, std::memory_order_release) - 1;
+    // Only a writer can be waiting for the readers to leave.
+    if ((state & (READER_MASK | WAITERS)) == WAITERS) {
+      RUnlockSlow();
+    }
+  }
+
+ private:
+  /** A writer has entered; it holds the latch once the reader count is 0. */
+  static constexpr uint32_t WRITER = 1U << 31;
+  /** Some thread sleeps on the word. */
+  static constexpr uint32_t WAITERS = 1U << 30;
+  /** The number of readers holding the latch. */
+  static constexpr uint32_t READER_MASK = WAITERS - 1;
+
+  void WLockSlow();
+  void RLockSlow();
+  void RUnlockSlow();
+
+  /**
+   * Sleeps until the word changes, after marking that a thread sleeps on it.
+   * @param state the last value seen
+   */
+  void Wait(uint32_t state);
+
+  /** Wakes all threads sleeping on the word. */
+  void WakeAll();
+
+  std::atomic<uint32_t> state_{0};
+};
+
+/**
+ * Reader-Writer latch for latches that are read latched all the time and write latched rarely, such as the global
+ * transaction latch.
+ *
+ * Readers only count themselves in a counter of their own thread's slot, so that readers on different cores do not
+ * contend on one cache line. A writer announces itself and waits until every slot has drained, which makes write
+ * latching expensive. Like ReaderWriterLatch, the latch prefers writers.
+ */
+class DistributedReaderWriterLatch {
+ public:
+  /** The number of reader counters. */
+  static constexpr size_t NUM_SLOTS = 32;
+
+  DistributedReaderWriterLatch() : slots_(new Slot[NUM_SLOTS]) {}
+  ~DistributedReaderWriterLatch() = default;
+
+  DISALLOW_COPY(DistributedReaderWriterLatch);
+
+  /**
+   * Acquire a write latch.
+   */
+  void WLock();
+
+  /**
+   * Release a write latch.
+   */
+  void WUnlock();
+
+  /**
+   * Acquire a read latch.
+   * @return the slot the reader is counted in, which RUnlock(slot) releases from any thread
+   */
+  size_t RLock() {
+    size_t slot = GetSlotIndex();
+    std::atomic<uint32_t> &readers = slots_[slot].readers_;
+    // Sequentially consistent, so that either the writer sees this reader or this reader sees the writer.
+    readers.fetch_add(1);
+    if (writer_.load() != 0) {
+      RLockSlow(&readers);
     }
+    return slot;
   }
 
+  /**
+   * Release a read latch acquired by the calling thread.
+   */
+  void RUnlock() { RUnlock(GetSlotIndex()); }
+
+  /**
+   * Release a read latch, possibly acquired by another thread.
+   * @param slot the slot returned by RLock
+   */
+  void RUnlock(size_t slot) { slots_[slot].readers_.fetch_sub(1, std::memory_order_release); }
+
  private:
-  mutex_t mutex_;
-  cond_t writer_;
-  cond_t reader_;
-  uint32_t reader_count_{0};
-  bool writer_entered_{false};
+  struct alignas(CACHE_LINE_SIZE) Slot {
+    std::atomic<uint32_t> readers_{0};
+  };
+
+  /** @return the slot of the calling thread; threads are spread over the slots in the order they first latch */
+  static size_t GetSlotIndex() {
+    static std::atomic<size_t> next_index{0};
+    static thread_local size_t index = next_index.fetch_add(1, std::memory_order_relaxed) % NUM_SLOTS;
+    return index;
+  }
+
+  /** Backs off while a writer holds or waits for the latch, then counts the reader again. */
+  void RLockSlow(std::atomic<uint32_t> *readers);
+
+  std::unique_ptr<Slot[]> slots_;
+  /** Non-zero while a writer holds or waits for the latch; readers sleep on it. */
+  std::atomic<uint32_t> writer_{0};
+  /** Serializes the writers. */
+  std::mutex writer_latch_;
 };
 
 }  // namespace bustub
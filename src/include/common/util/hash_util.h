@@ -12,8 +12,15 @@
 
 #pragma once
 
+#ifdef __SSE4_2__
+#include <nmmintrin.h>
+#endif
+
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <string>
 
@@ -24,37 +31,172 @@ namespace bustub {
 
 using hash_t = std::size_t;
 
+/** Builds the byte-at-a-time lookup table for the reflected CRC32C polynomial 0x82F63B78. */
+constexpr std::array<uint32_t, 256> MakeCrc32cTable() {
+  std::array<uint32_t, 256> table{};
+  for (uint32_t i = 0; i < 256; i++) {
+    uint32_t crc = i;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc & 1) != 0 ? (crc >> 1) ^ 0x82F63B78 : crc >> 1;
+    }
+    table[i] = crc;
+  }
+  return table;
+}
+
 class HashUtil {
  private:
   static const hash_t prime_factor = 10000019;
 
+  static constexpr std::array<uint32_t, 256> CRC32C_TABLE = MakeCrc32cTable();
+
+  static constexpr std::array<uint64_t, 4> WYHASH_SECRET = {0xa0761d6478bd642fULL, 0xe7037ed1a0b428dbULL,
+                                                             0x8ebc6af09c88c6e3ULL, 0x589965cc75374cc3ULL};
+
+  /** @return the xor of the low and the high half of the 128-bit product of a and b */
+  static inline uint64_t Mum(uint64_t a, uint64_t b) {
+    __uint128_t product = static_cast<__uint128_t>(a) * b;
+    return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+  }
+
+  static inline uint64_t Read64(const uint8_t *p) {
+    uint64_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+  }
+
+  static inline uint64_t Read32(const uint8_t *p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+  }
+
  public:
-  static inline hash_t HashBytes(const char *bytes, size_t length) {
-    // https://github.com/greenplum-db/gpos/blob/b53c1acd6285de94044ff91fbee91589543feba1/libgpos/src/utils.cpp#L126
-    hash_t hash = length;
-    for (size_t i = 0; i < length; ++i) {
-      hash = ((hash << 5) ^ (hash >> 27)) ^ bytes[i];
+  /**
+   * Hashes a byte range, see WyHash.
+   * @param bytes the bytes to hash
+   * @param length the number of bytes
+   * @return the hash of the bytes
+   */
+  static inline hash_t HashBytes(const char *bytes, size_t length) { return WyHash(bytes, length); }
+
+  /**
+   * Hashes a byte range with the wyhash algorithm (https://github.com/wangyi-fudan/wyhash, final version 4), which
+   * reads 8 or 16 bytes at a time and mixes them with 64x64->128 bit multiplications. Much faster than a byte at a
+   * time for all but the shortest inputs, and passes SMHasher.
+   * @param bytes the bytes to hash
+   * @param length the number of bytes
+   * @param seed the seed, different seeds give independent hash functions
+   * @return the 64-bit hash of the bytes
+   */
+  static inline uint64_t WyHash(const char *bytes, size_t length, uint64_t seed = 0) {
+    const auto *p = reinterpret_cast<const uint8_t *>(bytes);
+    seed ^= Mum(seed ^ WYHASH_SECRET[0], WYHASH_SECRET[1]);
+    uint64_t a;
+    uint64_t b;
+    if (length <= 16) {
+      if (length >= 4) {
+        size_t middle = (length >> 3) << 2;
+        a = (Read32(p) << 32) | Read32(p + middle);
+        b = (Read32(p + length - 4) << 32) | Read32(p + length - 4 - middle);
+      } else if (length > 0) {
+        a = (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[length >> 1]) << 8) | p[length - 1];
+        b = 0;
+      } else {
+        a = 0;
+        b = 0;
+      }
+    } else {
+      size_t i = length;
+      if (i > 48) {
+        uint64_t see1 = seed;
+        uint64_t see2 = seed;
+        do {
+          seed = Mum(Read64(p) ^ WYHASH_SECRET[1], Read64(p + 8) ^ seed);
+          see1 = Mum(Read64(p + 16) ^ WYHASH_SECRET[2], Read64(p + 24) ^ see1);
+          see2 = Mum(Read64(p + 32) ^ WYHASH_SECRET[3], Read64(p + 40) ^ see2);
+          p += 48;
+          i -= 48;
+        } while (i > 48);
+        seed ^= see1 ^ see2;
+      }
+      while (i > 16) {
+        seed = Mum(Read64(p) ^ WYHASH_SECRET[1], Read64(p + 8) ^ seed);
+        p += 16;
+        i -= 16;
+      }
+      a = Read64(p + i - 16);
+      b = Read64(p + i - 8);
     }
-    return hash;
+    a ^= WYHASH_SECRET[1];
+    b ^= seed;
+    __uint128_t product = static_cast<__uint128_t>(a) * b;
+    a = static_cast<uint64_t>(product);
+    b = static_cast<uint64_t>(product >> 64);
+    return Mum(a ^ WYHASH_SECRET[0] ^ length, b ^ WYHASH_SECRET[1]);
   }
 
-  static inline hash_t CombineHashes(hash_t l, hash_t r) {
-    hash_t both[2];
-    both[0] = l;
-    both[1] = r;
-    return HashBytes(reinterpret_cast<char *>(both), sizeof(hash_t) * 2);
+  /**
+   * Hashes a 64-bit integer with a single multiplication, the way WyHash mixes its input.
+   * @param value the integer to hash
+   * @return the 64-bit hash of the integer
+   */
+  static inline uint64_t HashInteger(uint64_t value) {
+    return Mum(value ^ WYHASH_SECRET[0], WYHASH_SECRET[1] ^ 8);
+  }
+
+  /**
+   * Computes the CRC32C (Castagnoli) checksum of a byte range with the SSE4.2 crc32 instruction, falling back to a
+   * lookup table when the target does not support SSE4.2.
+   * @param bytes the bytes to checksum
+   * @param length the number of bytes
+   * @param crc the checksum of the preceding bytes, which allows checksumming a range piece by piece
+   * @return the checksum of all the bytes so far
+   */
+  static inline uint32_t Crc32c(const char *bytes, size_t length, uint32_t crc = 0) {
+#ifdef __SSE4_2__
+    uint64_t crc64 = ~crc;
+    for (; length >= sizeof(uint64_t); bytes += sizeof(uint64_t), length -= sizeof(uint64_t)) {
+      uint64_t word;
+      memcpy(&word, bytes, sizeof(uint64_t));
+      crc64 = _mm_crc32_u64(crc64, word);
+    }
+    auto crc32 = static_cast<uint32_t>(crc64);
+    for (; length > 0; bytes++, length--) {
+      crc32 = _mm_crc32_u8(crc32, static_cast<uint8_t>(*bytes));
+    }
+    return ~crc32;
+#else
+    return Crc32cPortable(bytes, length, crc);
+#endif
   }
 
+  /** Table driven CRC32C, used when SSE4.2 is not available. Takes the same arguments as Crc32c. */
+  static inline uint32_t Crc32cPortable(const char *bytes, size_t length, uint32_t crc = 0) {
+    crc = ~crc;
+    for (size_t i = 0; i < length; ++i) {
+      crc = CRC32C_TABLE[(crc ^ static_cast<uint8_t>(bytes[i])) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+  }
+
+  static inline hash_t CombineHashes(hash_t l, hash_t r) { return Mum(l ^ WYHASH_SECRET[2], r ^ WYHASH_SECRET[3]); }
+
   static inline hash_t SumHashes(hash_t l, hash_t r) { return (l % prime_factor + r % prime_factor) % prime_factor; }
 
   template <typename T>
   static inline hash_t Hash(const T *ptr) {
+    if (sizeof(T) <= sizeof(uint64_t)) {
+      uint64_t value = 0;
+      memcpy(&value, ptr, sizeof(T));
+      return HashInteger(value);
+    }
     return HashBytes(reinterpret_cast<const char *>(ptr), sizeof(T));
   }
 
   template <typename T>
   static inline hash_t HashPtr(const T *ptr) {
-    return HashBytes(reinterpret_cast<const char *>(&ptr), sizeof(void *));
+    return HashInteger(reinterpret_cast<uintptr_t>(ptr));
   }
 
   /** @return the hash of the value */
@@ -18,9 +18,11 @@
 #include <memory>
 #include <mutex>  // NOLINT
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "common/config.h"
 #include "common/rid.h"
 #include "concurrency/transaction.h"
 
@@ -34,16 +36,56 @@ enum class TwoPLMode { REGULAR, STRICT };
 /** Deadlock mode. */
 enum class DeadlockMode { PREVENTION, DETECTION };
 
+/**
+ * Deadlock prevention policy. Transaction ids serve as timestamps, i.e. a lower id is an older transaction.
+ * WOUND_WAIT: an older requester aborts the younger transactions it would wait for, a younger requester waits.
+ * WAIT_DIE: an older requester waits, a younger requester aborts itself instead of waiting for an older transaction.
+ */
+enum class PreventionPolicy { WOUND_WAIT, WAIT_DIE };
+
+/**
+ * What a lock request does if it cannot be granted right away.
+ * BLOCK: wait until it is granted, or abort the transaction once its lock timeout expires, if it has one.
+ * NOWAIT: abort the transaction instead of waiting.
+ * SKIP_LOCKED: fail without aborting the transaction, so that the caller can move on, e.g. to the next row.
+ */
+enum class LockWaitPolicy { BLOCK, NOWAIT, SKIP_LOCKED };
+
 /**
  * LockManager handles transactions asking for locks on records.
  */
 class LockManager {
-  enum class LockMode { SHARED, EXCLUSIVE };
+  /** A lockable resource. Tables, pages and rows are identified by their oid, page id and RID respectively. */
+  struct LockTarget {
+    enum class Granularity : uint8_t { TABLE, PAGE, ROW };
+
+    static LockTarget Table(table_oid_t oid) { return LockTarget{Granularity::TABLE, oid}; }
+    static LockTarget Page(page_id_t page_id) { return LockTarget{Granularity::PAGE, page_id}; }
+    static LockTarget Row(const RID &rid) { return LockTarget{Granularity::ROW, rid.Get()}; }
+
+    bool operator==(const LockTarget &other) const {
+      return granularity_ == other.granularity_ && id_ == other.id_;
+    }
+
+    Granularity granularity_;
+    int64_t id_;
+  };
+
+  struct LockTargetHash {
+    size_t operator()(const LockTarget &target) const {
+      // Neighbouring rows and pages differ only in their low bits, so mix all bits into the ones that are used.
+      uint64_t hash = (static_cast<uint64_t>(target.id_) * 4 + static_cast<uint64_t>(target.granularity_)) *
+                      0x9E3779B97F4A7C15ULL;
+      return hash >> 32;
+    }
+  };
 
   class LockRequest {
    public:
-    LockRequest(txn_id_t txn_id, LockMode lock_mode) : txn_id_(txn_id), lock_mode_(lock_mode), granted_(false) {}
+    LockRequest(Transaction *txn, LockMode lock_mode)
+        : txn_(txn), txn_id_(txn->GetTransactionId()), lock_mode_(lock_mode), granted_(false) {}
 
+    Transaction *txn_;
     txn_id_t txn_id_;
     LockMode lock_mode_;
     bool granted_;
@@ -56,14 +98,32 @@ class LockManager {
     bool upgrading_ = false;
   };
 
+  /**
+   * A partition of the lock table with its own latch, so that transactions locking different RIDs rarely contend.
+   * Stripes are aligned to cache lines so that latching one stripe does not invalidate its neighbours.
+   */
+  struct alignas(CACHE_LINE_SIZE) LockTableStripe {
+    std::mutex latch_;
+    std::unordered_map<LockTarget, LockRequestQueue, LockTargetHash> lock_table_;
+  };
+
  public:
   /**
    * Creates a new lock manager configured for the given type of 2-phase locking and deadlock policy.
    * @param two_pl_mode 2-phase locking mode
    * @param deadlock_mode deadlock policy
+   * @param prevention_policy how deadlocks are prevented, used in DeadlockMode::PREVENTION only
+   * @param num_stripes the number of partitions of the lock table
    */
-  explicit LockManager(TwoPLMode two_pl_mode, DeadlockMode deadlock_mode = DeadlockMode::PREVENTION)
-      : two_pl_mode_(two_pl_mode), deadlock_mode_(deadlock_mode) {
+  explicit LockManager(TwoPLMode two_pl_mode, DeadlockMode deadlock_mode = DeadlockMode::PREVENTION,
+                       PreventionPolicy prevention_policy = PreventionPolicy::WOUND_WAIT,
+                       size_t num_stripes = LOCK_TABLE_STRIPES)
+      : two_pl_mode_(two_pl_mode),
+        deadlock_mode_(deadlock_mode),
+        prevention_policy_(prevention_policy),
+        num_stripes_(num_stripes),
+        stripes_(new LockTableStripe[num_stripes]) {
+    BUSTUB_ASSERT(num_stripes > 0, "The lock table needs at least one stripe.");
     // If Detection() is enabled, we should launch a background cycle detection thread.
     if (Detection()) {
       enable_cycle_detection_ = true;
@@ -84,7 +144,7 @@ class LockManager {
   /*
    * [LOCK_NOTE]: For all locking functions, we:
    * 1. return false if the transaction is aborted; and
-   * 2. block on wait, return true when the lock request is granted; and
+   * 2. block on wait, return true when the lock request is granted, unless the wait policy says otherwise; and
    * 3. it is undefined behavior to try locking an already locked RID in the same transaction, i.e. the transaction
    *    is responsible for keeping track of its current locks.
    */
@@ -93,25 +153,29 @@ class LockManager {
    * Acquire a lock on RID in shared mode. See [LOCK_NOTE] in header file.
    * @param txn the transaction requesting the shared lock
    * @param rid the RID to be locked in shared mode
+   * @param wait_policy what to do if the lock cannot be granted right away
    * @return true if the lock is granted, false otherwise
    */
-  bool LockShared(Transaction *txn, const RID &rid);
+  bool LockShared(Transaction *txn, const RID &rid, LockWaitPolicy wait_policy = LockWaitPolicy::BLOCK);
 
   /**
    * Acquire a lock on RID in exclusive mode. See [LOCK_NOTE] in header file.
    * @param txn the transaction requesting the exclusive lock
    * @param rid the RID to be locked in exclusive mode
+   * @param wait_policy what to do if the lock cannot be granted right away
    * @return true if the lock is granted, false otherwise
    */
-  bool LockExclusive(Transaction *txn, const RID &rid);
+  bool LockExclusive(Transaction *txn, const RID &rid, LockWaitPolicy wait_policy = LockWaitPolicy::BLOCK);
 
   /**
    * Upgrade a lock from a shared lock to an exclusive lock.
    * @param txn the transaction requesting the lock upgrade
    * @param rid the RID that should already be locked in shared mode by the requesting transaction
+   * @param wait_policy what to do if the upgrade cannot be granted right away; the shared lock is kept if the upgrade
+   * fails without waiting
    * @return true if the upgrade is successful, false otherwise
    */
-  bool LockUpgrade(Transaction *txn, const RID &rid);
+  bool LockUpgrade(Transaction *txn, const RID &rid, LockWaitPolicy wait_policy = LockWaitPolicy::BLOCK);
 
   /**
    * Release the lock held by the transaction.
@@ -121,6 +185,83 @@ class LockManager {
    */
   bool Unlock(Transaction *txn, const RID &rid);
 
+  /*
+   * [HIERARCHY_NOTE]: Tables, their pages and rows form a hierarchy. Before locking a page or row, a transaction must
+   * hold a table lock that permits it: any table lock for IS and S requests, IX, SIX or X for the other requests.
+   * Table, page and row locks that follow this protocol are released by the transaction manager. The RID-only
+   * functions above lock rows outside of the hierarchy; TableHeap uses them only for tables outside the catalog, which
+   * nobody can lock as a whole.
+   */
+
+  /**
+   * Acquire a lock on a table, or strengthen the held one to cover lock_mode as well. See [LOCK_NOTE].
+   * Table locks in S, SIX or X mode cover the pages and rows of the table, e.g. a scan needs a single lock.
+   * @param txn the transaction requesting the lock
+   * @param oid the table to be locked
+   * @param lock_mode the requested lock mode
+   * @param wait_policy what to do if the lock cannot be granted right away
+   * @return true if the lock is granted, false otherwise
+   */
+  bool LockTable(Transaction *txn, table_oid_t oid, LockMode lock_mode,
+                 LockWaitPolicy wait_policy = LockWaitPolicy::BLOCK);
+
+  /**
+   * Acquire a lock on a page of a table, or strengthen the held one. See [LOCK_NOTE] and [HIERARCHY_NOTE].
+   * @param txn the transaction requesting the lock
+   * @param oid the table the page belongs to
+   * @param page_id the page to be locked
+   * @param lock_mode the requested lock mode
+   * @param wait_policy what to do if the lock cannot be granted right away
+   * @return true if the lock is granted, false otherwise
+   */
+  bool LockPage(Transaction *txn, table_oid_t oid, page_id_t page_id, LockMode lock_mode,
+                LockWaitPolicy wait_policy = LockWaitPolicy::BLOCK);
+
+  /**
+   * Acquire a lock on a row of a table. See [LOCK_NOTE] and [HIERARCHY_NOTE].
+   * No request is made if a lock on the table or page already covers the row. A shared row lock is upgraded. The rows
+   * of a table outside the catalog, INVALID_TABLE_OID, cannot be covered and are locked like the RID-only functions do.
+   * @param txn the transaction requesting the lock
+   * @param oid the table the row belongs to, INVALID_TABLE_OID if it has none
+   * @param rid the row to be locked
+   * @param lock_mode SHARED or EXCLUSIVE
+   * @param wait_policy what to do if the lock cannot be granted right away
+   * @return true if the lock is granted, false otherwise
+   */
+  bool LockRow(Transaction *txn, table_oid_t oid, const RID &rid, LockMode lock_mode,
+               LockWaitPolicy wait_policy = LockWaitPolicy::BLOCK);
+
+  /**
+   * Release a table lock held by the transaction. The locks below the table should be released first.
+   * @return true if the unlock is successful, false otherwise
+   */
+  bool UnlockTable(Transaction *txn, table_oid_t oid);
+
+  /**
+   * Release a page lock held by the transaction. The row locks below the page should be released first.
+   * @return true if the unlock is successful, false otherwise
+   */
+  bool UnlockPage(Transaction *txn, page_id_t page_id);
+
+  /**
+   * Sets the number of row locks a transaction may hold on one table before they are escalated to a table lock.
+   * Escalation only happens through LockRow, and only if the table lock can be granted without waiting.
+   * @param threshold the maximum number of row locks per table and transaction
+   */
+  void SetEscalationThreshold(size_t threshold) {
+    BUSTUB_ASSERT(threshold > 0, "The escalation threshold must be positive.");
+    escalation_threshold_ = threshold;
+  }
+
+  /** @return the number of lock escalations so far */
+  size_t GetNumEscalations() { return num_escalations_; }
+
+  /** @return the number of granted and waiting lock requests */
+  size_t GetNumLockRequests();
+
+  /** @return an estimate of the memory used by the lock table in bytes */
+  size_t GetLockTableMemory();
+
   /*** Graph API ***/
   /**
    * Adds edge t1->t2
@@ -142,24 +283,180 @@ class LockManager {
   /** @return the set of all edges in the graph, used for testing only! */
   std::vector<std::pair<txn_id_t, txn_id_t>> GetEdgeList();
 
-  /** Runs cycle detection in the background. */
+  /**
+   * Runs cycle detection in the background. Deadlocks are normally broken as soon as they form, when the last of their
+   * transactions blocks. Every cycle_detection_interval this catches the cycles whose search was cut short.
+   */
   void RunCycleDetection();
 
  private:
   TwoPLMode two_pl_mode_ __attribute__((__unused__));
   DeadlockMode deadlock_mode_;
+  PreventionPolicy prevention_policy_;
 
   bool Detection() { return deadlock_mode_ == DeadlockMode::DETECTION; }
   bool Prevention() { return deadlock_mode_ == DeadlockMode::PREVENTION; }
 
+  /** @return the lock table stripe responsible for target */
+  LockTableStripe *GetStripe(const LockTarget &target);
+
+  /** @return true if a lock held in mode held grants everything a lock in mode requested does */
+  static bool Covers(LockMode held, LockMode requested);
+
+  /** @return the weakest lock mode that covers both held and requested */
+  static LockMode Combine(LockMode held, LockMode requested);
+
+  /** @return true if the transaction holds a table lock that permits locking below the table in lock_mode */
+  static bool HoldsIntention(Transaction *txn, table_oid_t oid, LockMode lock_mode);
+
+  /**
+   * Acquires or strengthens a table or page lock and records it in the transaction's lock map.
+   * @return true if the lock is granted
+   */
+  template <typename Key>
+  bool LockGranule(Transaction *txn, const LockTarget &target, std::unordered_map<Key, LockMode> *lock_map, Key key,
+                   LockMode lock_mode, LockWaitPolicy wait_policy);
+
+  /**
+   * Strengthens a granted request. A blocking upgrade loses the held lock if it fails, the others keep it.
+   * @return true if the stronger lock is granted
+   */
+  bool Strengthen(Transaction *txn, const LockTarget &target, LockMode lock_mode, LockWaitPolicy wait_policy);
+
+  /**
+   * Replaces the row locks the transaction holds on a table with a table lock, if it can be granted right away. Other
+   * transactions reach the table's rows only under an intention lock, which conflicts with the table lock instead.
+   */
+  void Escalate(Transaction *txn, table_oid_t oid);
+
+  /**
+   * Strengthens a granted request in place if that does not conflict with other granted requests.
+   * @return false if the stronger lock would have to wait, in which case nothing changes
+   */
+  bool TryUpgrade(Transaction *txn, const LockTarget &target, LockMode lock_mode);
+
+  /**
+   * Removes the transaction's request for target, moving a growing transaction to the shrinking phase.
+   * @return true if the transaction had a request
+   */
+  bool Release(Transaction *txn, const LockTarget &target);
+
+  /**
+   * Removes the transaction's request for target and wakes up the requests behind it.
+   * @return true if the transaction had a request
+   */
+  bool RemoveRequest(Transaction *txn, const LockTarget &target);
+
+  /**
+   * Checks that the transaction may acquire new locks, aborting it if it is already shrinking.
+   * @return true if the transaction is growing
+   */
+  bool CanLock(Transaction *txn);
+
+  /**
+   * Enqueues a lock request and blocks until it is granted or the transaction is aborted. A request that does not block
+   * is withdrawn right away if it cannot be granted.
+   * @return true if the lock is granted
+   */
+  bool Acquire(Transaction *txn, const LockTarget &target, LockMode lock_mode, LockWaitPolicy wait_policy);
+
+  /**
+   * Fails a lock request that could not be granted without waiting, aborting the transaction unless it skips locked
+   * resources.
+   * @return false
+   */
+  static bool FailWithoutWaiting(Transaction *txn, LockWaitPolicy wait_policy);
+
+  /**
+   * Replaces the transaction's granted request with a stronger one, which goes ahead of all waiting requests, and
+   * blocks until it is granted. The held lock is lost if the upgrade fails.
+   * @return true if the stronger lock is granted
+   */
+  bool Upgrade(Transaction *txn, const LockTarget &target, LockMode lock_mode);
+
+  /**
+   * Blocks until the given request is granted or its transaction is aborted, removing the request in the latter case.
+   * The transaction is aborted if its lock timeout expires first.
+   * @param guard the held latch of the stripe containing the queue
+   * @param upgrade true if the request is the pending upgrade of the queue
+   * @return true if the request is granted
+   */
+  bool WaitForGrant(Transaction *txn, const LockTarget &target, std::list<LockRequest>::iterator request,
+                    std::unique_lock<std::mutex> *guard, bool upgrade = false);
+
+  /** @return true if the request is compatible with every request ahead of it in the queue */
+  static bool IsGrantable(const LockRequestQueue &queue, std::list<LockRequest>::iterator request);
+
+  /** @return true if the two requests cannot be granted at the same time */
+  static bool Conflicts(const LockRequest &a, const LockRequest &b);
+
+  /**
+   * Applies the prevention policy to a request that cannot be granted yet.
+   * @param[out] wounded the younger transactions that were aborted so that txn can go ahead
+   * @return false if txn has to abort instead of waiting
+   */
+  bool PreventDeadlock(Transaction *txn, const LockRequestQueue &queue, std::list<LockRequest>::iterator request,
+                       std::vector<Transaction *> *wounded);
+
+  /**
+   * Updates the waits-for edges of a blocked request and breaks the cycles they close, aborting the newest transaction
+   * of each cycle.
+   * @param[out] victims the other transactions that were aborted
+   * @return false if txn has to abort itself
+   */
+  bool DetectDeadlock(Transaction *txn, const LockRequestQueue &queue, std::list<LockRequest>::iterator request,
+                      std::vector<Transaction *> *victims);
+
+  /** Removes the edges of the waiters in the queue to a transaction whose request left the queue. */
+  void DropEdgesTo(const LockRequestQueue &queue, txn_id_t txn_id);
+
+  /*
+   * The graph functions below expect latch_ to be held.
+   */
+
+  /** Adds an edge from t1 -> t2. */
+  void InsertEdge(txn_id_t t1, txn_id_t t2);
+
+  /** Removes an edge from t1 -> t2. */
+  void EraseEdge(txn_id_t t1, txn_id_t t2);
+
+  /** Removes the outgoing edges of a transaction that stopped waiting. */
+  void RemoveWaitsFor(txn_id_t txn_id);
+
+  /**
+   * Searches the graph depth-first from source, skipping and adding to visited transactions.
+   * @param limit the maximum number of transactions to visit before giving up
+   * @param[out] txn_id if a cycle is found, will contain the newest transaction ID in the cycle
+   * @return true if a cycle is found
+   */
+  bool SearchCycle(txn_id_t source, std::unordered_set<txn_id_t> *visited, size_t limit, txn_id_t *txn_id);
+
+  /** Searches the whole graph, see HasCycle. */
+  bool FindCycle(txn_id_t *txn_id);
+
+  /** Wakes up the given aborted transactions if they are blocked on a lock, so that they can give up waiting. */
+  void WakeUp(const std::vector<Transaction *> &txns);
+
+  /** The maximum number of transactions visited by the deadlock search when a transaction blocks. */
+  static constexpr size_t CYCLE_SEARCH_LIMIT = 1024;
+
+  /** Protects the waits-for graph. Latched after a stripe latch, if both are needed. */
   std::mutex latch_;
   std::atomic<bool> enable_cycle_detection_;
   std::thread *cycle_detection_thread_;
 
-  /** Lock table for lock requests. */
-  std::unordered_map<RID, LockRequestQueue> lock_table_;
-  /** Waits-for graph representation. */
+  /** Lock table for lock requests, partitioned by RID. */
+  size_t num_stripes_;
+  size_t escalation_threshold_{LOCK_ESCALATION_THRESHOLD};
+  std::atomic<size_t> num_escalations_{0};
+  std::unique_ptr<LockTableStripe[]> stripes_;
+  /** Waits-for graph representation, maintained as transactions block and stop waiting. Edge lists are sorted. */
   std::unordered_map<txn_id_t, std::vector<txn_id_t>> waits_for_;
+  /** The blocked transactions with outgoing edges. */
+  std::unordered_map<txn_id_t, Transaction *> waiters_;
+  /** The resource each blocked transaction waits for. Latched after a stripe latch, if both are needed. */
+  std::mutex blocked_latch_;
+  std::unordered_map<txn_id_t, LockTarget> blocked_on_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,99 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tid_table.h
+//
+// Identification: src/include/concurrency/tid_table.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "common/rid.h"
+
+namespace bustub {
+
+/**
+ * TidTable holds the TID words of the tuples of a table for optimistic concurrency control, in the style of Silo.
+ *
+ * A TID word is a version number that grows with every committed write of the tuple, a lock bit that a committing
+ * transaction holds while it validates and installs its writes, and an absent bit for tuples whose insert has not
+ * committed yet. Tuples that were never written by an optimistic transaction have version 0.
+ *
+ * Only committing transactions lock TID words, and they lock them in a fixed order, so waiting for a locked word
+ * cannot deadlock.
+ */
+class TidTable {
+ public:
+  /** Set while a committing transaction installs a write of the tuple. */
+  static constexpr uint64_t LOCK_BIT = 1ULL << 63;
+  /** Set while the insert of the tuple has not committed. */
+  static constexpr uint64_t ABSENT_BIT = 1ULL << 62;
+  /** The bits of the version number. */
+  static constexpr uint64_t VERSION_MASK = ABSENT_BIT - 1;
+
+  /**
+   * Creates a new TID table.
+   * @param num_stripes the number of partitions of the TID words, each with its own latch
+   */
+  explicit TidTable(size_t num_stripes = LOCK_TABLE_STRIPES);
+
+  ~TidTable() = default;
+
+  DISALLOW_COPY_AND_MOVE(TidTable);
+
+  /**
+   * Reads the TID word of a tuple, waiting while it is locked.
+   * @param rid the tuple
+   * @return the TID word, without the lock bit
+   */
+  uint64_t Read(const RID &rid);
+
+  /**
+   * @param rid the tuple
+   * @return the TID word of a tuple, locked or not
+   */
+  uint64_t Get(const RID &rid);
+
+  /**
+   * Locks the TID word of a tuple, waiting while another transaction holds it.
+   * @param rid the tuple
+   */
+  void Lock(const RID &rid);
+
+  /**
+   * Unlocks the TID word of a tuple without changing its version, used if the write was not installed.
+   * @param rid the tuple
+   */
+  void Unlock(const RID &rid);
+
+  /**
+   * Moves the TID word of a tuple to the next version, which also unlocks it.
+   * @param rid the tuple
+   * @param is_absent whether the tuple is absent in the new version
+   */
+  void Install(const RID &rid, bool is_absent);
+
+ private:
+  struct alignas(CACHE_LINE_SIZE) Stripe {
+    std::mutex latch_;
+    std::unordered_map<RID, uint64_t> tids_;
+  };
+
+  /** @return the stripe holding the TID word of rid */
+  Stripe *GetStripe(const RID &rid);
+
+  size_t num_stripes_;
+  std::unique_ptr<Stripe[]> stripes_;
+};
+
+}  // namespace bustub
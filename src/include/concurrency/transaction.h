@@ -13,10 +13,13 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>  // NOLINT
 #include <deque>
 #include <memory>
 #include <thread>  // NOLINT
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "common/config.h"
 #include "common/logger.h"
@@ -36,6 +39,24 @@ namespace bustub {
  **/
 enum class TransactionState { GROWING, SHRINKING, COMMITTED, ABORTED };
 
+/**
+ * Lock modes. Rows are locked in SHARED or EXCLUSIVE mode. Tables and pages may also be locked with an intention to
+ * lock rows below them in shared mode (IS), exclusive mode (IX), or to read all and update some of them (SIX).
+ */
+enum class LockMode {
+  INTENTION_SHARED,
+  INTENTION_EXCLUSIVE,
+  SHARED,
+  SHARED_INTENTION_EXCLUSIVE,
+  EXCLUSIVE,
+};
+
+/**
+ * Concurrency control of a transaction. A pessimistic transaction locks the rows it accesses. An optimistic transaction
+ * reads without locks, buffers its writes, and is validated when it commits.
+ */
+enum class ConcurrencyMode { PESSIMISTIC, OPTIMISTIC };
+
 /**
  * Type of write operation.
  */
@@ -53,26 +74,43 @@ class WriteRecord {
 
   RID rid_;
   WType wtype_;
-  /** The tuple is only used for the update operation. */
+  /** The tuple is only used for the update operation: the old tuple, or the new one if the write is buffered. */
   Tuple tuple_;
   /** The table heap specifies which table this write record is for. */
   TableHeap *table_;
 };
 
+/**
+ * ReadRecord tracks a tuple read by an optimistic transaction, with the TID word it had when it was read.
+ */
+class ReadRecord {
+ public:
+  ReadRecord(RID rid, uint64_t tid, TableHeap *table) : rid_(rid), tid_(tid), table_(table) {}
+
+  RID rid_;
+  uint64_t tid_;
+  TableHeap *table_;
+};
+
 /**
  * Transaction tracks information related to a transaction.
  */
 class Transaction {
  public:
-  explicit Transaction(txn_id_t txn_id)
+  explicit Transaction(txn_id_t txn_id, ConcurrencyMode concurrency_mode = ConcurrencyMode::PESSIMISTIC)
       : state_(TransactionState::GROWING),
         thread_id_(std::this_thread::get_id()),
         txn_id_(txn_id),
+        concurrency_mode_(concurrency_mode),
         prev_lsn_(INVALID_LSN),
         shared_lock_set_{new std::unordered_set<RID>},
-        exclusive_lock_set_{new std::unordered_set<RID>} {
+        exclusive_lock_set_{new std::unordered_set<RID>},
+        table_lock_map_{new std::unordered_map<table_oid_t, LockMode>},
+        page_lock_map_{new std::unordered_map<page_id_t, LockMode>},
+        row_lock_map_{new std::unordered_map<table_oid_t, std::vector<RID>>} {
     // Initialize the sets that will be tracked.
     write_set_ = std::make_shared<std::deque<WriteRecord>>();
+    read_set_ = std::make_shared<std::vector<ReadRecord>>();
     page_set_ = std::make_shared<std::deque<bustub::Page *>>();
     deleted_page_set_ = std::make_shared<std::unordered_set<page_id_t>>();
   }
@@ -81,6 +119,31 @@ class Transaction {
 
   DISALLOW_COPY(Transaction);
 
+  /**
+   * Prepares an ended transaction to be reused as a new one. The sets keep their memory.
+   * @param txn_id the id of the new transaction
+   * @param concurrency_mode whether the new transaction locks or validates
+   */
+  void Reset(txn_id_t txn_id, ConcurrencyMode concurrency_mode) {
+    state_ = TransactionState::GROWING;
+    thread_id_ = std::this_thread::get_id();
+    txn_id_ = txn_id;
+    concurrency_mode_ = concurrency_mode;
+    prev_lsn_ = INVALID_LSN;
+    read_ts_ = 0;
+    commit_ts_ = INVALID_TS;
+    lock_timeout_ = std::chrono::milliseconds::zero();
+    write_set_->clear();
+    read_set_->clear();
+    page_set_->clear();
+    deleted_page_set_->clear();
+    shared_lock_set_->clear();
+    exclusive_lock_set_->clear();
+    table_lock_map_->clear();
+    page_lock_map_->clear();
+    row_lock_map_->clear();
+  }
+
   /** @return the id of the thread running the transaction */
   inline std::thread::id GetThreadId() const { return thread_id_; }
 
@@ -90,6 +153,12 @@ class Transaction {
   /** @return the list of of write records of this transaction */
   inline std::shared_ptr<std::deque<WriteRecord>> GetWriteSet() { return write_set_; }
 
+  /** @return the tuples read by this transaction, if it is optimistic */
+  inline std::shared_ptr<std::vector<ReadRecord>> GetReadSet() { return read_set_; }
+
+  /** @return whether this transaction locks or validates */
+  inline ConcurrencyMode GetConcurrencyMode() const { return concurrency_mode_; }
+
   /** @return the page set */
   inline std::shared_ptr<std::deque<Page *>> GetPageSet() { return page_set_; }
 
@@ -114,6 +183,15 @@ class Transaction {
   /** @return the set of resources under an exclusive lock */
   inline std::shared_ptr<std::unordered_set<RID>> GetExclusiveLockSet() { return exclusive_lock_set_; }
 
+  /** @return the tables locked by this transaction and their lock modes */
+  inline std::shared_ptr<std::unordered_map<table_oid_t, LockMode>> GetTableLockMap() { return table_lock_map_; }
+
+  /** @return the pages locked by this transaction and their lock modes */
+  inline std::shared_ptr<std::unordered_map<page_id_t, LockMode>> GetPageLockMap() { return page_lock_map_; }
+
+  /** @return the rows locked by this transaction through LockManager::LockRow, by table */
+  inline std::shared_ptr<std::unordered_map<table_oid_t, std::vector<RID>>> GetRowLockMap() { return row_lock_map_; }
+
   /** @return true if rid is shared locked by this transaction */
   bool IsSharedLocked(const RID &rid) { return shared_lock_set_->find(rid) != shared_lock_set_->end(); }
 
@@ -129,6 +207,16 @@ class Transaction {
    */
   inline void SetState(TransactionState state) { state_ = state; }
 
+  /**
+   * Atomically changes the state of the transaction if it is in the expected state.
+   * @param expected the state the transaction has to be in
+   * @param state new state
+   * @return true if the state was changed
+   */
+  inline bool CompareAndSetState(TransactionState expected, TransactionState state) {
+    return state_.compare_exchange_strong(expected, state);
+  }
+
   /** @return the previous LSN */
   inline lsn_t GetPrevLSN() { return prev_lsn_; }
 
@@ -138,18 +226,65 @@ class Transaction {
    */
   inline void SetPrevLSN(lsn_t prev_lsn) { prev_lsn_ = prev_lsn; }
 
+  /** @return the timestamp of the snapshot read by the transaction */
+  inline timestamp_t GetReadTs() const { return read_ts_; }
+
+  /**
+   * Set the timestamp of the snapshot read by the transaction.
+   * @param read_ts the timestamp of the last commit visible to the transaction
+   */
+  inline void SetReadTs(timestamp_t read_ts) { read_ts_ = read_ts; }
+
+  /** @return how long a lock request of the transaction waits before the transaction aborts, 0 if forever */
+  inline std::chrono::milliseconds GetLockTimeout() const { return lock_timeout_; }
+
+  /**
+   * Set how long a lock request of the transaction may wait.
+   * @param lock_timeout the time after which a waiting lock request aborts the transaction, 0 to wait forever
+   */
+  inline void SetLockTimeout(std::chrono::milliseconds lock_timeout) { lock_timeout_ = lock_timeout; }
+
+  /** @return the commit timestamp of the transaction, INVALID_TS until it commits */
+  inline timestamp_t GetCommitTs() const { return commit_ts_; }
+
+  /**
+   * Set the commit timestamp of the transaction.
+   * @param commit_ts the commit timestamp
+   */
+  inline void SetCommitTs(timestamp_t commit_ts) { commit_ts_ = commit_ts; }
+
+  /** @return the slot of the global transaction latch the transaction holds, see DistributedReaderWriterLatch */
+  inline size_t GetGlobalLatchSlot() const { return global_latch_slot_; }
+
+  /**
+   * Set the slot of the global transaction latch the transaction holds.
+   * @param global_latch_slot the slot returned when the latch was acquired
+   */
+  inline void SetGlobalLatchSlot(size_t global_latch_slot) { global_latch_slot_ = global_latch_slot; }
+
  private:
-  /** The current transaction state. */
-  TransactionState state_;
+  /** The current transaction state, changed by other transactions when they abort this one. */
+  std::atomic<TransactionState> state_;
   /** The thread ID, used in single-threaded transactions. */
   std::thread::id thread_id_;
   /** The ID of this transaction. */
   txn_id_t txn_id_;
 
-  /** The undo set of the transaction. */
+  ConcurrencyMode concurrency_mode_;
+
+  /** The undo set of the transaction. An optimistic transaction keeps its buffered writes here instead. */
   std::shared_ptr<std::deque<WriteRecord>> write_set_;
+  /** The read set of an optimistic transaction. */
+  std::shared_ptr<std::vector<ReadRecord>> read_set_;
   /** The LSN of the last record written by the transaction. */
   lsn_t prev_lsn_;
+  /** Under snapshot isolation, the transaction sees the versions committed at or before its read timestamp. */
+  timestamp_t read_ts_{0};
+  timestamp_t commit_ts_{INVALID_TS};
+  /** How long a lock request may wait, 0 if forever. */
+  std::chrono::milliseconds lock_timeout_{0};
+  /** The slot of the global transaction latch taken by Begin, released by Commit or Abort on any thread. */
+  size_t global_latch_slot_{0};
 
   /** Concurrent index: the pages that were latched during index operation. */
   std::shared_ptr<std::deque<Page *>> page_set_;
@@ -160,6 +295,12 @@ class Transaction {
   std::shared_ptr<std::unordered_set<RID>> shared_lock_set_;
   /** LockManager: the set of exclusive-locked tuples held by this transaction. */
   std::shared_ptr<std::unordered_set<RID>> exclusive_lock_set_;
+  /** LockManager: the tables locked by this transaction. */
+  std::shared_ptr<std::unordered_map<table_oid_t, LockMode>> table_lock_map_;
+  /** LockManager: the pages locked by this transaction. */
+  std::shared_ptr<std::unordered_map<page_id_t, LockMode>> page_lock_map_;
+  /** LockManager: the rows locked per table, which may include rows unlocked since, for lock escalation. */
+  std::shared_ptr<std::unordered_map<table_oid_t, std::vector<RID>>> row_lock_map_;
 };
 
 }  // namespace bustub
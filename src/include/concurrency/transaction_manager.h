@@ -13,12 +13,21 @@
 #pragma once
 
 #include <atomic>
-#include <unordered_map>
+#include <condition_variable>  // NOLINT
+#include <mutex>               // NOLINT
+#include <set>
+#include <thread>  // NOLINT
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "common/config.h"
+#include "common/epoch_manager.h"
+#include "common/logger.h"
 #include "concurrency/lock_manager.h"
 #include "concurrency/transaction.h"
+#include "concurrency/transaction_registry.h"
+#include "concurrency/version_store.h"
 #include "recovery/log_manager.h"
 
 namespace bustub {
@@ -26,26 +35,67 @@ class LockManager;
 
 /**
  * TransactionManager keeps track of all the transactions running in the system.
+ *
+ * The running transactions are kept in a striped registry. Transactions handed back through Recycle() are reused by
+ * later ones, once no thread that may have looked them up is inside an epoch any more.
+ *
+ * With a version store, transactions run under snapshot isolation: each one reads the snapshot of the last commit
+ * before it began, and a background thread garbage collects the versions that no snapshot can see any more.
  */
 class TransactionManager {
  public:
-  explicit TransactionManager(LockManager *lock_manager, LogManager *log_manager = nullptr)
-      : lock_manager_(lock_manager), log_manager_(log_manager) {}
+  /**
+   * Creates a new transaction manager.
+   * @param lock_manager the lock manager
+   * @param log_manager the log manager
+   * @param version_store the old tuple versions for snapshot isolation, nullptr to run under two-phase locking
+   */
+  explicit TransactionManager(LockManager *lock_manager, LogManager *log_manager = nullptr,
+                              VersionStore *version_store = nullptr)
+      : lock_manager_(lock_manager), log_manager_(log_manager), version_store_(version_store) {
+    if (version_store_ != nullptr) {
+      enable_gc_ = true;
+      gc_thread_ = new std::thread(&TransactionManager::RunGarbageCollection, this);
+      LOG_INFO("Garbage collection thread launched");
+    }
+  }
 
-  ~TransactionManager() = default;
+  ~TransactionManager() {
+    if (version_store_ != nullptr) {
+      {
+        std::lock_guard<std::mutex> guard(gc_latch_);
+        enable_gc_ = false;
+      }
+      gc_cv_.notify_one();
+      gc_thread_->join();
+      delete gc_thread_;
+      LOG_INFO("Garbage collection thread stopped");
+    }
+    // No thread looks up transactions any more, so all recycled transactions reach the pool.
+    epoch_manager_.Reclaim();
+    for (auto *txn : txn_pool_) {
+      delete txn;
+    }
+  }
 
   /**
    * Begins a new transaction.
-   * @param txn an optional transaction object to be initialized, otherwise a new transaction is created
+   * @param txn an optional transaction object to be initialized, otherwise a transaction is taken from the pool of
+   * recycled transactions, or created; hand it back with Recycle() once it has ended
+   * @param concurrency_mode whether a new transaction locks or validates
    * @return an initialized transaction
    */
-  Transaction *Begin(Transaction *txn = nullptr);
+  Transaction *Begin(Transaction *txn = nullptr, ConcurrencyMode concurrency_mode = ConcurrencyMode::PESSIMISTIC);
 
   /**
-   * Commits a transaction.
+   * Commits a transaction. An optimistic transaction is validated first: it locks the TID words of the tuples it
+   * writes in a fixed order, checks that the tuples it read did not change since, installs its writes and moves the
+   * written tuples to their next versions. A transaction that was aborted meanwhile, e.g. wounded by an older one, is
+   * rolled back instead.
    * @param txn the transaction to commit
+   * @return false if the transaction was aborted already or failed validation, and was aborted instead
    */
-  void Commit(Transaction *txn);
+  bool Commit(Transaction *txn);
 
   /**
    * Aborts a transaction
@@ -54,23 +104,25 @@ class TransactionManager {
   void Abort(Transaction *txn);
 
   /**
-   * Global list of running transactions
+   * Hands an ended transaction created by Begin() back to the transaction manager. It is reused by a later Begin()
+   * once no thread that may have looked it up is inside an epoch any more.
+   * @param txn the committed or aborted transaction
    */
-
-  /** The transaction map is a global list of all the running transactions in the system. */
-  static std::unordered_map<txn_id_t, Transaction *> txn_map;
+  void Recycle(Transaction *txn);
 
   /**
-   * Locates and returns the transaction with the given transaction ID.
-   * @param txn_id the id of the transaction to be found, it must exist!
-   * @return the transaction with the given transaction id
+   * Locates a running transaction. The caller must stay inside an epoch of GetEpochManager() while it uses the
+   * transaction, which may end concurrently.
+   * @param txn_id the id of the transaction to be found
+   * @return the transaction with the given transaction id, nullptr if it is not running
    */
-  static Transaction *GetTransaction(txn_id_t txn_id) {
-    assert(TransactionManager::txn_map.find(txn_id) != TransactionManager::txn_map.end());
-    auto *res = TransactionManager::txn_map[txn_id];
-    assert(res != nullptr);
-    return res;
-  }
+  Transaction *GetTransaction(txn_id_t txn_id) { return txn_registry_.Find(txn_id); }
+
+  /** @return the number of running transactions */
+  size_t GetNumTransactions() { return txn_registry_.GetNumTransactions(); }
+
+  /** @return the epoch manager that recycled transactions go through */
+  EpochManager *GetEpochManager() { return &epoch_manager_; }
 
   /** Prevents all transactions from performing operations, used for checkpointing. */
   void BlockAllTransactions();
@@ -78,30 +130,90 @@ class TransactionManager {
   /** Resumes all transactions, used for checkpointing. */
   void ResumeTransactions();
 
+  /** @return the read timestamp of the oldest running transaction, or of the next one if none is running */
+  timestamp_t GetWatermark();
+
+  /**
+   * Drops the tuple versions that no running transaction can see, and removes the tuples whose deletes every
+   * transaction sees from their tables. Runs every gc_interval in the background.
+   */
+  void GarbageCollect();
+
  private:
+  /** Runs garbage collection until the transaction manager is destroyed. */
+  void RunGarbageCollection();
+
+  /**
+   * Validates an optimistic transaction and installs its buffered writes. The write set then holds the undo records
+   * of the installed writes and the inserts, as for a pessimistic transaction.
+   * @param txn the committing transaction
+   * @param[out] locked_tids the tuples whose TID words were locked, in locking order
+   * @return false if validation or an install failed; the transaction must then be aborted, before the TID words are
+   * unlocked
+   */
+  bool ValidateAndInstall(Transaction *txn, std::vector<std::pair<TableHeap *, RID>> *locked_tids);
+
   /**
    * Releases all the locks held by the given transaction.
    * @param txn the transaction whose locks should be released
    */
   void ReleaseLocks(Transaction *txn) {
+    // A row is locked in one mode only. The sets are taken over, so that unlocking does not erase from them.
     std::unordered_set<RID> lock_set;
-    for (auto item : *txn->GetExclusiveLockSet()) {
-      lock_set.emplace(item);
-    }
-    for (auto item : *txn->GetSharedLockSet()) {
-      lock_set.emplace(item);
+    lock_set.swap(*txn->GetExclusiveLockSet());
+    for (const auto &locked_rid : lock_set) {
+      lock_manager_->Unlock(txn, locked_rid);
     }
-    for (auto locked_rid : lock_set) {
+    lock_set.clear();
+    lock_set.swap(*txn->GetSharedLockSet());
+    for (const auto &locked_rid : lock_set) {
       lock_manager_->Unlock(txn, locked_rid);
     }
+    txn->GetRowLockMap()->clear();
+    // Coarser locks go last, they cover the finer ones.
+    std::unordered_set<page_id_t> page_set;
+    for (auto item : *txn->GetPageLockMap()) {
+      page_set.emplace(item.first);
+    }
+    for (auto page_id : page_set) {
+      lock_manager_->UnlockPage(txn, page_id);
+    }
+    std::unordered_set<table_oid_t> table_set;
+    for (auto item : *txn->GetTableLockMap()) {
+      table_set.emplace(item.first);
+    }
+    for (auto oid : table_set) {
+      lock_manager_->UnlockTable(txn, oid);
+    }
   }
 
   std::atomic<txn_id_t> next_txn_id_{0};
   LockManager *lock_manager_ __attribute__((__unused__));
-  LogManager *log_manager_ __attribute__((__unused__));
-
-  /** The global transaction latch is used for checkpointing. */
-  ReaderWriterLatch global_txn_latch_;
+  LogManager *log_manager_;
+
+  /** The global transaction latch is used for checkpointing. Every transaction read latches it. */
+  DistributedReaderWriterLatch global_txn_latch_;
+
+  /** The running transactions. */
+  TransactionRegistry txn_registry_;
+  /** Delays the reuse of recycled transactions until nobody can have looked them up. */
+  EpochManager epoch_manager_;
+  /** Protects the pool. */
+  std::mutex txn_pool_latch_;
+  /** Ended transactions to be reused by Begin(). */
+  std::vector<Transaction *> txn_pool_;
+
+  VersionStore *version_store_;
+  /** Protects the timestamps. A transaction commits under this latch, so that it is seen by all or no snapshots. */
+  std::mutex ts_latch_;
+  timestamp_t last_commit_ts_{0};
+  /** The read timestamps of the running transactions. */
+  std::multiset<timestamp_t> active_read_ts_;
+  /** Wakes up the garbage collection thread when the transaction manager is destroyed. */
+  std::mutex gc_latch_;
+  std::condition_variable gc_cv_;
+  bool enable_gc_{false};
+  std::thread *gc_thread_{nullptr};
 };
 
 }  // namespace bustub
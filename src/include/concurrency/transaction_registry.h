@@ -0,0 +1,79 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// transaction_registry.h
+//
+// Identification: src/include/concurrency/transaction_registry.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "concurrency/transaction.h"
+
+namespace bustub {
+
+/**
+ * TransactionRegistry maps the ids of the running transactions to the transactions.
+ *
+ * The map is split into stripes, each with its own latch, so that transactions beginning and ending on different
+ * threads rarely touch the same latch. The registry does not own the transactions. A transaction found in it may end
+ * and be freed at any time, unless the transactions are freed through an EpochManager and the finder stays inside an
+ * epoch while it uses the transaction.
+ */
+class TransactionRegistry {
+ public:
+  /**
+   * Creates a new transaction registry.
+   * @param num_stripes the number of partitions of the registry, each with its own latch
+   */
+  explicit TransactionRegistry(size_t num_stripes = LOCK_TABLE_STRIPES);
+
+  ~TransactionRegistry() = default;
+
+  DISALLOW_COPY_AND_MOVE(TransactionRegistry);
+
+  /**
+   * Registers a running transaction.
+   * @param txn the transaction
+   */
+  void Insert(Transaction *txn);
+
+  /**
+   * Removes an ended transaction.
+   * @param txn_id the id of the transaction
+   */
+  void Erase(txn_id_t txn_id);
+
+  /**
+   * @param txn_id the id of a transaction
+   * @return the running transaction with the id, nullptr if there is none
+   */
+  Transaction *Find(txn_id_t txn_id);
+
+  /** @return the number of running transactions */
+  size_t GetNumTransactions();
+
+ private:
+  struct alignas(CACHE_LINE_SIZE) Stripe {
+    std::mutex latch_;
+    std::unordered_map<txn_id_t, Transaction *> txns_;
+  };
+
+  /** @return the stripe holding txn_id, transaction ids are sequential so they spread evenly */
+  Stripe *GetStripe(txn_id_t txn_id) { return &stripes_[static_cast<uint32_t>(txn_id) % num_stripes_]; }
+
+  size_t num_stripes_;
+  std::unique_ptr<Stripe[]> stripes_;
+};
+
+}  // namespace bustub
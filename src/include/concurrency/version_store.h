@@ -0,0 +1,156 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// version_store.h
+//
+// Identification: src/include/concurrency/version_store.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "common/rid.h"
+#include "concurrency/transaction.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+class TableHeap;
+
+/**
+ * VersionStore keeps the old versions of tuples for multi-version concurrency control with snapshot isolation.
+ *
+ * The table heap always holds the newest version of a tuple, committed or not. Every tuple that was written since the
+ * oldest running snapshot has a version chain: the commit timestamp of the heap version, or the transaction that is
+ * writing it, and the images of the tuple before each change, newest first. Tuples without a chain were committed
+ * before every snapshot. A transaction reads the newest version committed at or before its read timestamp, and never
+ * takes a lock to do so.
+ *
+ * Writes follow first-updater-wins: a transaction may only change a tuple whose heap version it can see, so it aborts
+ * if another transaction is writing the tuple or has committed a newer version of it since the snapshot was taken.
+ *
+ * The table heap checks and records writes while it holds the page latch of the tuple, and reads the chain while it
+ * holds the page latch as well. A reader therefore sees the heap version and its chain in the same state.
+ */
+class VersionStore {
+ public:
+  /**
+   * Creates a new version store.
+   * @param num_stripes the number of partitions of the version chains, each with its own latch
+   */
+  explicit VersionStore(size_t num_stripes = LOCK_TABLE_STRIPES);
+
+  ~VersionStore() = default;
+
+  DISALLOW_COPY_AND_MOVE(VersionStore);
+
+  /**
+   * Finds the version of a tuple that a transaction sees.
+   * @param rid the tuple
+   * @param txn the reading transaction
+   * @param in_heap whether the heap holds a tuple that is not marked deleted at rid
+   * @param[in,out] tuple the heap tuple, replaced by an older version if the transaction cannot see the heap version
+   * @return true if the transaction sees the tuple
+   */
+  bool Read(const RID &rid, Transaction *txn, bool in_heap, Tuple *tuple);
+
+  /**
+   * Checks whether a transaction may change a tuple.
+   * @param rid the tuple
+   * @param txn the writing transaction
+   * @return false if another transaction is writing the tuple or committed it after the snapshot of txn
+   */
+  bool CanWrite(const RID &rid, Transaction *txn);
+
+  /**
+   * Records a change to a tuple in its version chain. The first change of a transaction saves the old image, the
+   * later ones overwrite the version that only the transaction itself can see.
+   * @param table the table of the tuple
+   * @param rid the tuple
+   * @param txn the writing transaction
+   * @param old_tuple the tuple before the change, nullptr if it was inserted
+   * @param is_delete whether the change deletes the tuple
+   */
+  void RecordWrite(TableHeap *table, const RID &rid, Transaction *txn, const Tuple *old_tuple, bool is_delete);
+
+  /**
+   * Stamps the versions written by a transaction with its commit timestamp.
+   * Must be called before the write set of the transaction is cleared.
+   * @param txn the committing transaction
+   * @param commit_ts the commit timestamp
+   */
+  void Commit(Transaction *txn, timestamp_t commit_ts);
+
+  /**
+   * Drops the versions written by a transaction. Must be called after the table heap was rolled back, and before the
+   * write set of the transaction is cleared.
+   * @param txn the aborting transaction
+   */
+  void Abort(Transaction *txn);
+
+  /**
+   * Drops the versions that no snapshot can see any more.
+   * @param watermark the read timestamp of the oldest running transaction
+   * @param[out] dead the tuples whose deletes every snapshot sees; their chains are gone and they can be applied
+   */
+  void GarbageCollect(timestamp_t watermark, std::vector<std::pair<TableHeap *, RID>> *dead);
+
+  /** @return the number of tuples that have a version chain */
+  size_t GetNumChains();
+
+  /** @return the number of old versions kept */
+  size_t GetNumVersions();
+
+ private:
+  /** An old version of a tuple. */
+  struct Version {
+    /** The image of the tuple, unused if the version is a delete. */
+    Tuple tuple_;
+    /** Whether the tuple did not exist in this version. */
+    bool is_delete_;
+    /** The commit timestamp of the version. */
+    timestamp_t ts_;
+    /** The version before this one. */
+    std::unique_ptr<Version> prev_;
+  };
+
+  /** The versions of one tuple. */
+  struct VersionChain {
+    TableHeap *table_{nullptr};
+    /** The transaction writing the heap version, INVALID_TXN_ID once it has committed. */
+    txn_id_t writer_{INVALID_TXN_ID};
+    /** The commit timestamp of the heap version; 0 if it was committed before every snapshot. */
+    timestamp_t ts_{0};
+    /** Whether the heap version is a delete. */
+    bool is_delete_{false};
+    /** The versions before the heap version, newest first. */
+    std::unique_ptr<Version> undo_;
+  };
+
+  struct alignas(CACHE_LINE_SIZE) Stripe {
+    std::mutex latch_;
+    std::unordered_map<RID, VersionChain> chains_;
+  };
+
+  /** Frees a list of versions one by one, so that long lists do not overflow the stack. */
+  static void DropVersions(std::unique_ptr<Version> versions);
+
+  /** @return the stripe holding the chain of rid */
+  Stripe *GetStripe(const RID &rid);
+
+  size_t num_stripes_;
+  std::unique_ptr<Stripe[]> stripes_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,134 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table.h
+//
+// Identification: src/include/container/hash/extendible_hash_table.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "concurrency/transaction.h"
+#include "container/hash/hash_function.h"
+#include "container/hash/hash_table.h"
+#include "storage/page/hash_table_bucket_page.h"
+#include "storage/page/hash_table_directory_page.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+
+#define EXTENDIBLE_HASH_TABLE_TYPE ExtendibleHashTable<KeyType, ValueType, KeyComparator, HashFn>
+
+/**
+ * Implementation of extendible hash table that is backed by a buffer pool manager. Non-unique keys are supported.
+ * Supports insert and delete. The table grows one bucket at a time: a full bucket is split in two, doubling the
+ * directory if the bucket is pointed to by a single entry. A bucket that becomes empty is merged with its split image,
+ * and the directory halves once no bucket needs all of its entries.
+ *
+ * Inserts, removes and lookups run concurrently: they share the table latch and latch the bucket page they touch.
+ * Splits and merges take the table latch exclusively, so the directory page is only read while no thread modifies it.
+ *
+ * The directory has at most DIRECTORY_ARRAY_SIZE entries. An insert into a full bucket that cannot be split any more,
+ * because all of its keys share the low bits of their hashes, fails.
+ *
+ * HashFn is the hash function class, HashFunction or one of the faster alternatives in hash_function.h.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn = HashFunction<KeyType>>
+class ExtendibleHashTable : public HashTable<KeyType, ValueType, KeyComparator> {
+ public:
+  /**
+   * Creates a new ExtendibleHashTable
+   *
+   * @param buffer_pool_manager buffer pool manager to be used
+   * @param comparator comparator for keys
+   * @param hash_fn the hash function
+   */
+  explicit ExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                               const KeyComparator &comparator, HashFn hash_fn);
+
+  /**
+   * Inserts a key-value pair into the hash table.
+   * @param transaction the current transaction
+   * @param key the key to create
+   * @param value the value to be associated with the key
+   * @return true if insert succeeded, false otherwise
+   */
+  bool Insert(Transaction *transaction, const KeyType &key, const ValueType &value) override;
+
+  /**
+   * Deletes the associated value for the given key.
+   * @param transaction the current transaction
+   * @param key the key to delete
+   * @param value the value to delete
+   * @return true if remove succeeded, false otherwise
+   */
+  bool Remove(Transaction *transaction, const KeyType &key, const ValueType &value) override;
+
+  /**
+   * Performs a point query on the hash table.
+   * @param transaction the current transaction
+   * @param key the key to look up
+   * @param[out] result the value(s) associated with a given key
+   * @return the value(s) associated with the given key
+   */
+  bool GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) override;
+
+  /**
+   * @return the global depth of the directory
+   */
+  uint32_t GetGlobalDepth();
+
+  /**
+   * Asserts the integrity of the directory, see HashTableDirectoryPage::VerifyIntegrity.
+   */
+  void VerifyIntegrity();
+
+ private:
+  /**
+   * @param hash the hash of a key
+   * @return the bits of the hash the directory is indexed with; the bucket pages take the fingerprint from the top
+   */
+  static uint32_t DirectoryHash(uint64_t hash) { return static_cast<uint32_t>(hash); }
+
+  /**
+   * Splits the bucket of a hash until it has room for another pair, unless another thread did so already.
+   * @param hash the directory hash of the key whose bucket was full
+   * @return false if the bucket cannot be split any more
+   */
+  bool SplitBucket(uint32_t hash);
+
+  /**
+   * Merges the bucket of a hash with its split image while either of the two is empty, unless another thread did so
+   * already, and then shrinks the directory as far as possible.
+   * @param hash the directory hash of the key whose bucket became empty
+   */
+  void MergeBucket(uint32_t hash);
+
+  /** Fetches a page, throws if the buffer pool has no free frame. */
+  Page *FetchPage(page_id_t page_id);
+
+  /** Allocates a page, throws if the buffer pool has no free frame. */
+  Page *NewPage(page_id_t *page_id);
+
+  // member variable
+  page_id_t directory_page_id_;
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+
+  // Readers includes inserts, removes and lookups, writers split and merge buckets
+  ReaderWriterLatch table_latch_;
+
+  // Hash function
+  HashFn hash_fn_;
+};
+
+}  // namespace bustub
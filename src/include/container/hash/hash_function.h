@@ -14,6 +14,7 @@
 
 #include <cstdint>
 
+#include "common/util/hash_util.h"
 #include "murmur3/MurmurHash3.h"
 
 namespace bustub {
@@ -33,4 +34,39 @@ class HashFunction {
   }
 };
 
+/*
+ * The hash functions below are faster alternatives to HashFunction. The hash tables take their hash function as a
+ * template parameter, which defaults to HashFunction.
+ */
+
+/**
+ * Hashes small fixed size keys with the CRC32C instruction, eight bytes per instruction. The 32-bit checksum is
+ * spread over 64 bits with HashUtil::HashInteger, so that both the low bits (bucket and directory indexes) and the
+ * high bits (fingerprints) of the hash depend on every key bit.
+ */
+template <typename KeyType>
+class Crc32cHashFunction {
+ public:
+  /**
+   * @param key the key to be hashed
+   * @return the hashed value
+   */
+  uint64_t GetHash(const KeyType &key) const {
+    return HashUtil::HashInteger(HashUtil::Crc32c(reinterpret_cast<const char *>(&key), sizeof(KeyType)));
+  }
+};
+
+/** Hashes keys with the 64-bit wyhash algorithm, see HashUtil::WyHash. */
+template <typename KeyType>
+class WyHashFunction {
+ public:
+  /**
+   * @param key the key to be hashed
+   * @return the hashed value
+   */
+  uint64_t GetHash(const KeyType &key) const {
+    return HashUtil::WyHash(reinterpret_cast<const char *>(&key), sizeof(KeyType));
+  }
+};
+
 }  // namespace bustub
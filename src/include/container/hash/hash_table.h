@@ -52,6 +52,24 @@ class HashTable {
    * @return the value(s) associated with the given key
    */
   virtual bool GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) = 0;
+
+  /**
+   * Performs point queries for a batch of keys. Tables that can overlap the lookups override it, by default the keys
+   * are looked up one at a time.
+   * @param transaction the current transaction
+   * @param keys the keys to look up
+   * @param[out] results the values associated with keys[i] are appended to (*results)[i]
+   * @return the number of keys that have values
+   */
+  virtual size_t GetValues(Transaction *transaction, const std::vector<KeyType> &keys,
+                           std::vector<std::vector<ValueType>> *results) {
+    results->resize(keys.size());
+    size_t num_found = 0;
+    for (size_t i = 0; i < keys.size(); i++) {
+      num_found += GetValue(transaction, keys[i], &(*results)[i]) ? 1 : 0;
+    }
+    return num_found;
+  }
 };
 
 }  // namespace bustub
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <queue>
 #include <string>
 #include <vector>
@@ -21,19 +22,44 @@
 #include "container/hash/hash_function.h"
 #include "container/hash/hash_table.h"
 #include "storage/page/hash_table_block_page.h"
+#include "storage/page/hash_table_filter_page.h"
 #include "storage/page/hash_table_header_page.h"
 #include "storage/page/hash_table_page_defs.h"
 
 namespace bustub {
 
-#define HASH_TABLE_TYPE LinearProbeHashTable<KeyType, ValueType, KeyComparator>
+#define HASH_TABLE_TYPE LinearProbeHashTable<KeyType, ValueType, KeyComparator, HashFn>
 
 /**
  * Implementation of linear probing hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
  * table dynamically grows once full.
+ *
+ * Inserts, removes and lookups run concurrently: they share the table latch and read latch the block pages they
+ * probe, and inserts claim free slots with compare-and-swap on the occupied bitmaps of the block pages. A slot keeps
+ * its pair until the table is rebuilt, removes only leave a tombstone. So a probe stops at the first slot that was
+ * never occupied.
+ *
+ * Once the table is full, it is resized incrementally: a new table is allocated and receives all inserts, and every
+ * operation migrates the next HASH_TABLE_MIGRATION_CHUNK buckets of the old table into it, leaving the tombstones
+ * behind. Until the old table is drained, lookups and removes consult the old table first and then the new one. A
+ * bucket range is migrated with its old block page write latched, so that removes of the pairs in it wait. Only
+ * switching to the new table and freeing the drained one take the table latch exclusively.
+ *
+ * Concurrent inserts of the same key and value may both succeed; an index never inserts the same RID twice.
+ *
+ * Batched lookups hash all keys first and visit them in the order of their buckets. They latch up to
+ * HASH_TABLE_BATCH_BLOCKS block pages at once, fetching each of them once for all of its keys, and prefetch the slots
+ * of the keys before they probe any, so that the cache misses of the keys overlap (group prefetching).
+ *
+ * A table can keep a blocked Bloom filter of its keys in filter pages, which lookups and removes consult before they
+ * probe, so that looking up a key the table does not hold rarely probes. Removes leave the bits of their keys set;
+ * the filter of the new table a resize allocates holds only the pairs that move into it. The filter pages of a table
+ * stay pinned until the table is freed, so consulting the filter takes no buffer pool lookup.
+ *
+ * HashFn is the hash function class, HashFunction or one of the faster alternatives in hash_function.h.
  */
-template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn = HashFunction<KeyType>>
 class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator> {
  public:
   /**
@@ -43,9 +69,12 @@ class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator>
    * @param comparator comparator for keys
    * @param num_buckets initial number of buckets contained by this hash table
    * @param hash_fn the hash function
+   * @param filter_bits_per_bucket the size of the Bloom filter in bits per bucket, 0 for no filter; a full table has
+   * one key per bucket, a table that just grew one per two buckets
    */
   explicit LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
-                                const KeyComparator &comparator, size_t num_buckets, HashFunction<KeyType> hash_fn);
+                                const KeyComparator &comparator, size_t num_buckets, HashFn hash_fn,
+                                size_t filter_bits_per_bucket = 0);
 
   /**
    * Inserts a key-value pair into the hash table.
@@ -56,6 +85,16 @@ class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator>
    */
   bool Insert(Transaction *transaction, const KeyType &key, const ValueType &value) override;
 
+  /**
+   * Inserts many key-value pairs at once, fetching and latching every block page once: the pairs are partitioned by
+   * the block page of their bucket and placed block by block, and pairs that run past the end of a block move on to
+   * the next one. The table latch is held exclusively meanwhile. Pairs that run past the end of the table are inserted
+   * one at a time afterwards, which grows the table if it is full; a table with enough buckets does not grow.
+   * @param transaction the current transaction
+   * @param pairs the pairs to insert, none of which the table holds already
+   */
+  void BulkInsert(Transaction *transaction, const std::vector<MappingType> &pairs);
+
   /**
    * Deletes the associated value for the given key.
    * @param transaction the current transaction
@@ -74,6 +113,23 @@ class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator>
    */
   bool GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) override;
 
+  /**
+   * Performs point queries for a batch of keys.
+   * @param transaction the current transaction
+   * @param keys the keys to look up
+   * @param[out] results the values associated with keys[i] are appended to (*results)[i]
+   * @return the number of keys that have values
+   */
+  size_t GetValues(Transaction *transaction, const std::vector<KeyType> &keys,
+                   std::vector<std::vector<ValueType>> *results) override;
+
+  /**
+   * Consults the Bloom filter.
+   * @param key the key to look up
+   * @return false if the table does not hold the key, true if it may
+   */
+  bool MayContain(const KeyType &key);
+
   /**
    * Resizes the table to at least twice the initial size provided.
    * @param initial_size the initial size of the hash table
@@ -86,17 +142,192 @@ class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator>
    */
   size_t GetSize();
 
+  /** @return true if the table holds no pairs */
+  bool IsEmpty();
+
  private:
+  /**
+   * Visits the slots of the probe sequence of a key in order, starting at the bucket it hashes to, with the block page
+   * read latched. The slots are visited in runs that lie within one group of a block page. Must be called with the
+   * table latch held.
+   * @param header_page_id the header page of the table to probe
+   * @param hash the hash of the key to probe for
+   * @param is_write whether visit may modify the block pages
+   * @param visit called with a block page, a group in it and the slots of the run as bits of the group, returns true
+   * to stop probing
+   * @return true if visit stopped probing, false if it visited every slot of the table
+   */
+  template <typename Visitor>
+  bool Probe(page_id_t header_page_id, uint64_t hash, bool is_write, Visitor visit);
+
+  /**
+   * Appends the values of a key in a run of slots to a result, unless they are in [num_found, num_old) of it.
+   * @param block the block page of the run
+   * @param group the group of the run in the block page
+   * @param slots the slots of the run, as bits of the group
+   * @param key the key to look for
+   * @param fingerprint the fingerprint of the key
+   * @param[out] result the values are appended to it
+   * @param num_found the size of result before the lookup
+   * @param num_old the size of result after the old table was probed, num_found if it was not
+   * @return true if the run has a free slot, i.e. the probe stops
+   */
+  bool CollectValues(HASH_TABLE_BLOCK_TYPE *block, size_t group, uint32_t slots, const KeyType &key,
+                     uint8_t fingerprint, std::vector<ValueType> *result, size_t num_found, size_t num_old);
+
+  /**
+   * Probes a table for a batch of keys, see GetValues. Must be called with the table latch held.
+   * @param header_page_id the header page of the table to probe
+   * @param keys the keys to look up
+   * @param hashes the hashes of the keys
+   * @param[out] results the values of keys[i] are appended to (*results)[i]
+   * @param num_found the sizes of the results before the lookup
+   * @param num_old the sizes of the results after the old table was probed, num_found if it was not
+   */
+  void ProbeBatch(page_id_t header_page_id, const std::vector<KeyType> &keys, const std::vector<uint64_t> &hashes,
+                  std::vector<std::vector<ValueType>> *results, const std::vector<size_t> &num_found,
+                  const std::vector<size_t> &num_old);
+
+  /**
+   * Inserts a key-value pair unless the table holds it already. Must be called with the table latch held.
+   * @param header_page_id the header page of the table to insert into
+   * @param key the key to insert
+   * @param value the value to insert
+   * @param[out] inserted whether the pair was inserted
+   * @return false if the table has no free slot left
+   */
+  bool TryInsert(page_id_t header_page_id, const KeyType &key, const ValueType &value, bool *inserted);
+
+  /**
+   * Looks for a key-value pair. Must be called with the table latch held.
+   * @param header_page_id the header page of the table to look in
+   * @param key the key to look for
+   * @param value the value to look for
+   * @param remove whether to remove the pair
+   * @return true if the table holds the pair, or if remove is set, if this call removed it
+   */
+  bool FindPair(page_id_t header_page_id, const KeyType &key, const ValueType &value, bool remove);
+
+  /**
+   * Consults the Bloom filter of a table. Must be called with the table latch held.
+   * @param header_page_id the header page of the table
+   * @param hash the hash of the key to look for
+   * @return false if the table does not hold the key
+   */
+  bool FilterMayContain(page_id_t header_page_id, uint64_t hash);
+
+  /**
+   * Adds a key to the Bloom filter of a table. Must be called with the table latch held.
+   * @param header_page_id the header page of the table
+   * @param hash the hash of the key to add
+   */
+  void FilterInsert(page_id_t header_page_id, uint64_t hash);
+
+  /**
+   * Locates the line of a key in the Bloom filter of a table.
+   * @param header_page_id the header page of the table
+   * @param hash the hash of the key
+   * @param[out] line the line of the key in its filter page
+   * @return the filter page of the key, nullptr if the table has no filter
+   */
+  HashTableFilterPage *FilterLine(page_id_t header_page_id, uint64_t hash, size_t *line);
+
+  /**
+   * Allocates the header page and the block pages of an empty table.
+   * @param num_buckets the number of buckets of the table; a table gets at least one
+   * @return the page id of the header page, INVALID_PAGE_ID if the blocks and the filter pages do not fit into one
+   * header page
+   */
+  page_id_t CreateTable(size_t num_buckets);
+
+  /** Frees the header page, the block pages and the filter pages of a table. */
+  void DeleteTable(page_id_t header_page_id);
+
+  /** @return the number of buckets of a table */
+  size_t GetSize(page_id_t header_page_id);
+
+  /**
+   * Makes room for inserts into a table that had no free slot left, unless another thread did so already.
+   * @param header_page_id the header page of the table that was full
+   * @return false if the table cannot grow any more
+   */
+  bool Grow(page_id_t header_page_id);
+
+  /**
+   * Allocates a new table of at least num_buckets buckets, and at least twice as many buckets as the current table
+   * holds pairs, and starts migrating the current table into it. Must be called with the table latch held exclusively
+   * while no migration is running.
+   * @param num_buckets the minimum number of buckets of the new table
+   * @return false if the new table would be too large
+   */
+  bool StartMigration(size_t num_buckets);
+
+  /**
+   * Migrates the next chunk of buckets of the old table, if a migration is running. Must be called with the table
+   * latch held.
+   * @return true if this call migrated the last chunk, the caller then finishes the migration
+   */
+  bool MigrateChunk();
+
+  /**
+   * Moves the readable pairs of the old buckets [begin, end) into the new table. Must be called with the table latch
+   * held.
+   */
+  void MigrateBuckets(size_t begin, size_t end);
+
+  /** Finishes the migration out of the given old table unless another thread did so already. */
+  void FinishMigration(page_id_t old_header_page_id);
+
+  /**
+   * Migrates what is left of the old table and frees it. Must be called with the table latch held exclusively.
+   */
+  void CompleteMigration();
+
+  /**
+   * Rehashes the readable pairs of the table, and of the old table if a migration is running, into a new table of at
+   * least num_buckets buckets, and at least twice as many buckets as pairs. Must be called with the table latch held
+   * exclusively.
+   * @param num_buckets the minimum number of buckets of the new table
+   * @return false if the new table would be too large
+   */
+  bool Rebuild(size_t num_buckets);
+
+  /** Fetches a page, throws if the buffer pool has no free frame. */
+  Page *FetchPage(page_id_t page_id);
+
+  /** Allocates a page, throws if the buffer pool has no free frame. */
+  Page *NewPage(page_id_t *page_id);
+
   // member variable
   page_id_t header_page_id_;
+  // The table being migrated into header_page_id_, INVALID_PAGE_ID if there is none
+  page_id_t old_header_page_id_{INVALID_PAGE_ID};
+  size_t old_size_{0};
+  // The next bucket of the old table to migrate, and the number of buckets migrated
+  std::atomic<size_t> next_migrate_bucket_{0};
+  std::atomic<size_t> num_migrated_buckets_{0};
+  // Whether the new table had no room for a pair of the old table
+  std::atomic<bool> migration_overflow_{false};
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
 
-  // Readers includes inserts and removes, writer is only resize
+  // Readers includes inserts, removes and migrating chunks, writers only switch tables
   ReaderWriterLatch table_latch_;
 
   // Hash function
-  HashFunction<KeyType> hash_fn_;
+  HashFn hash_fn_;
+
+  // The size of the Bloom filters, and the number of bits a key sets in them, 0 if there are none
+  size_t filter_bits_per_bucket_;
+  size_t filter_key_bits_;
+
+  /** The filter pages of a table, pinned from its creation until it is freed. */
+  struct TableFilter {
+    page_id_t header_page_id_;
+    std::vector<Page *> pages_;
+  };
+  // The filters of the tables, changed with the table latch held exclusively
+  std::vector<TableFilter> filters_;
 };
 
 }  // namespace bustub
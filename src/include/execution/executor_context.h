@@ -31,9 +31,11 @@ class ExecutorContext {
    * @param transaction the transaction executing the query
    * @param catalog the catalog that the executor should use
    * @param bpm the buffer pool manager that the executor should use
+   * @param lock_manager the lock manager that the executors lock rows with, nullptr if they do not lock
    */
-  ExecutorContext(Transaction *transaction, SimpleCatalog *catalog, BufferPoolManager *bpm)
-      : transaction_(transaction), catalog_{catalog}, bpm_{bpm} {}
+  ExecutorContext(Transaction *transaction, SimpleCatalog *catalog, BufferPoolManager *bpm,
+                  LockManager *lock_manager = nullptr)
+      : transaction_(transaction), catalog_{catalog}, bpm_{bpm}, lock_manager_{lock_manager} {}
 
   DISALLOW_COPY_AND_MOVE(ExecutorContext);
 
@@ -51,13 +53,14 @@ class ExecutorContext {
   /** @return the log manager - don't worry about it for now */
   LogManager *GetLogManager() { return nullptr; }
 
-  /** @return the lock manager - don't worry about it for now */
-  LockManager *GetLockManager() { return nullptr; }
+  /** @return the lock manager, nullptr if the executors do not lock */
+  LockManager *GetLockManager() { return lock_manager_; }
 
  private:
   Transaction *transaction_;
   SimpleCatalog *catalog_;
   BufferPoolManager *bpm_;
+  LockManager *lock_manager_;
 };
 
 }  // namespace bustub
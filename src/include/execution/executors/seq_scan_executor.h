@@ -23,6 +23,12 @@ namespace bustub {
 
 /**
  * SeqScanExecutor executes a sequential scan over a table.
+ *
+ * With a lock manager in the executor context, a pessimistic transaction takes IS on the table and share locks each
+ * row before it reads it, following the lock wait policy of the plan for both. Under SKIP_LOCKED, rows locked by other
+ * transactions are left out, so that workers scanning a queue table each get rows nobody else is working on; a table
+ * locked by another transaction yields no rows. If a lock fails otherwise, the transaction is aborted and the scan
+ * ends.
  */
 class SeqScanExecutor : public AbstractExecutor {
  public:
@@ -42,5 +48,9 @@ class SeqScanExecutor : public AbstractExecutor {
  private:
   /** The sequential scan plan node to be executed. */
   const SeqScanPlanNode *plan_;
+  /** The table being scanned. */
+  TableMetadata *table_info_;
+  /** The next slot of the table to be looked at, an invalid RID at the end of the table. */
+  RID next_rid_;
 };
 }  // namespace bustub
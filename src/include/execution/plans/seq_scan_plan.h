@@ -13,6 +13,7 @@
 #pragma once
 
 #include "catalog/simple_catalog.h"
+#include "concurrency/lock_manager.h"
 #include "execution/expressions/abstract_expression.h"
 #include "execution/plans/abstract_plan.h"
 
@@ -27,9 +28,15 @@ class SeqScanPlanNode : public AbstractPlanNode {
    * @param output the output format of this scan plan node
    * @param predicate the predicate to scan with, tuples are returned if predicate(tuple) = true or predicate = nullptr
    * @param table_oid the identifier of table to be scanned
+   * @param lock_wait_policy what the scan does with rows that are locked by other transactions, e.g. SKIP_LOCKED to
+   * leave them out of the result
    */
-  SeqScanPlanNode(const Schema *output, const AbstractExpression *predicate, table_oid_t table_oid)
-      : AbstractPlanNode(output, {}), predicate_{predicate}, table_oid_(table_oid) {}
+  SeqScanPlanNode(const Schema *output, const AbstractExpression *predicate, table_oid_t table_oid,
+                  LockWaitPolicy lock_wait_policy = LockWaitPolicy::BLOCK)
+      : AbstractPlanNode(output, {}),
+        predicate_{predicate},
+        table_oid_(table_oid),
+        lock_wait_policy_(lock_wait_policy) {}
 
   PlanType GetType() const override { return PlanType::SeqScan; }
 
@@ -39,11 +46,16 @@ class SeqScanPlanNode : public AbstractPlanNode {
   /** @return the identifier of the table that should be scanned */
   table_oid_t GetTableOid() const { return table_oid_; }
 
+  /** @return what the scan does with rows that are locked by other transactions */
+  LockWaitPolicy GetLockWaitPolicy() const { return lock_wait_policy_; }
+
  private:
   /** The predicate that all returned tuples must satisfy. */
   const AbstractExpression *predicate_;
   /** The table whose tuples should be scanned. */
   table_oid_t table_oid_;
+  /** How the rows are locked. */
+  LockWaitPolicy lock_wait_policy_;
 };
 
 }  // namespace bustub
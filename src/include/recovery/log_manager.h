@@ -16,6 +16,7 @@
 #include <condition_variable>  // NOLINT
 #include <future>              // NOLINT
 #include <mutex>               // NOLINT
+#include <thread>              // NOLINT
 
 #include "recovery/log_record.h"
 #include "storage/disk/disk_manager.h"
@@ -46,13 +47,37 @@ class LogManager {
 
   lsn_t AppendLogRecord(LogRecord *log_record);
 
+  /**
+   * Forces every log record appended so far to disk, blocking until it is durable. Used for group commit and by the
+   * buffer pool manager before it writes out a page whose LSN is not yet persistent.
+   */
+  void Flush();
+
+  /**
+   * Drops the log segments that are no longer needed to recover from redo_lsn on.
+   * @param redo_lsn the oldest LSN that recovery may still need
+   * @return the number of segments dropped
+   */
+  inline size_t TruncateLog(lsn_t redo_lsn) { return disk_manager_->TruncateLog(redo_lsn); }
+
+  /**
+   * Continues the LSNs of an existing log, which recovery does before it appends records of its own.
+   * @param next_lsn the LSN following the last record in the log, every record before it being on disk
+   */
+  void ResetLSN(lsn_t next_lsn);
+
   inline lsn_t GetNextLSN() { return next_lsn_; }
   inline lsn_t GetPersistentLSN() { return persistent_lsn_; }
   inline void SetPersistentLSN(lsn_t lsn) { persistent_lsn_ = lsn; }
   inline char *GetLogBuffer() { return log_buffer_; }
 
  private:
-  // TODO(students): you may add your own member variables
+  /**
+   * Swaps the log buffer with the flush buffer and writes the latter out. The latch is released during the write so
+   * that appends can continue into the fresh log buffer.
+   * @param lock the held latch_
+   */
+  void SwapAndFlush(std::unique_lock<std::mutex> *lock);
 
   /** The atomic counter which records the next log sequence number. */
   std::atomic<lsn_t> next_lsn_;
@@ -61,14 +86,26 @@ class LogManager {
 
   char *log_buffer_;
   char *flush_buffer_;
-
+  /** Number of bytes used in log_buffer_. */
+  int offset_{0};
+  /** LSN of the first record in log_buffer_. */
+  lsn_t buffer_first_lsn_{INVALID_LSN};
+  /** True while the flush buffer is being written out. */
+  bool flushing_{false};
+  /** True if someone is waiting for the log buffer to be flushed before the timeout. */
+  bool need_flush_{false};
+
+  /** Protects the log buffer, offset_ and the flush flags. */
   std::mutex latch_;
 
-  std::thread *flush_thread_ __attribute__((__unused__));
+  std::thread *flush_thread_{nullptr};
 
+  /** Wakes up the flush thread. */
   std::condition_variable cv_;
+  /** Notified whenever a flush completes, waking appenders waiting for space and threads waiting in Flush(). */
+  std::condition_variable flushed_cv_;
 
-  DiskManager *disk_manager_ __attribute__((__unused__));
+  DiskManager *disk_manager_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,76 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// log_reader.h
+//
+// Identification: src/include/recovery/log_reader.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * LogReader serves random reads of the log from an LRU cache of fixed-size log blocks. Undo follows prevLSN chains
+ * backwards, and the records of concurrent transactions sit next to each other in the log, so most reads hit a block
+ * that another chain has loaded already. A LogReader can be shared by any number of threads.
+ *
+ * Blocks are cached as they were on disk when first read. Only read log records that were completely on disk at that
+ * time, i.e. do not read records that are appended while the reader is in use.
+ */
+class LogReader {
+ public:
+  /** Size of a cached log block in bytes. */
+  static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+  /**
+   * Creates a new log reader.
+   * @param disk_manager the disk manager holding the log
+   * @param num_blocks the maximum number of blocks to cache
+   */
+  explicit LogReader(DiskManager *disk_manager, size_t num_blocks = 256);
+
+  ~LogReader() = default;
+
+  /**
+   * Reads a piece of the log.
+   * @param[out] data output buffer
+   * @param size the number of bytes to read
+   * @param offset logical offset in the log to read from
+   * @return false if the log ends before offset, in which case data is untouched
+   */
+  bool Read(char *data, size_t size, size_t offset);
+
+  /** @return the number of blocks read from disk so far */
+  size_t GetNumBlockReads();
+
+ private:
+  using Block = std::shared_ptr<const std::vector<char>>;
+
+  /** @return the block with the given number, read from disk if it is not cached; nullptr if it is past the log end */
+  Block GetBlock(size_t block_no);
+
+  DiskManager *disk_manager_;
+  size_t num_blocks_;
+  size_t num_block_reads_{0};
+  /** Protects the cache. */
+  std::mutex latch_;
+  /** Cached block numbers, most recently used first. */
+  std::list<size_t> lru_list_;
+  std::unordered_map<size_t, std::pair<Block, std::list<size_t>::iterator>> blocks_;
+};
+
+}  // namespace bustub
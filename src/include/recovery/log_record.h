@@ -14,8 +14,10 @@
 
 #include <cassert>
 #include <string>
+#include <vector>
 
 #include "common/config.h"
+#include "common/util/hash_util.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -32,15 +34,19 @@ enum class LogRecordType {
   ABORT,
   /** Creating a new page in the table heap. */
   NEWPAGE,
+  /** Compensation log record, written for every change undone during recovery. */
+  CLR,
 };
 
 /**
  * For every write operation on the table page, you should write ahead a corresponding log record.
  *
- * For EACH log record, HEADER is like (5 fields in common, 20 bytes in total).
- *---------------------------------------------
- * | size | LSN | transID | prevLSN | LogType |
- *---------------------------------------------
+ * For EACH log record, HEADER is like (6 fields in common, 24 bytes in total).
+ *--------------------------------------------------------
+ * | size | LSN | transID | prevLSN | LogType | checksum |
+ *--------------------------------------------------------
+ * The checksum is the CRC32C of the whole record, skipping the checksum field itself. It lets recovery tell a torn
+ * or corrupted record at the end of the log from a valid one.
  * For insert type log record
  *---------------------------------------------------------------
  * | HEADER | tuple_rid | tuple_size | tuple_data(char[] array) |
@@ -49,14 +55,26 @@ enum class LogRecordType {
  *----------------------------------------------------------------
  * | HEADER | tuple_rid | tuple_size | tuple_data(char[] array) |
  *---------------------------------------------------------------
- * For update type log record
- *-----------------------------------------------------------------------------------
- * | HEADER | tuple_rid | tuple_size | old_tuple_data | tuple_size | new_tuple_data |
- *-----------------------------------------------------------------------------------
+ * For update type log record, only the byte ranges in which the old and new tuple differ are logged
+ *-------------------------------------------------------------------------------------
+ * | HEADER | tuple_rid | old_size | new_size | range_count | range_1 | ... | range_n |
+ *-------------------------------------------------------------------------------------
+ * where every range is
+ *--------------------------------------------------------
+ * | offset | old_length | new_length | old_data | new_data |
+ *--------------------------------------------------------
+ * Sizes, counts, offsets and lengths are 16 bits wide, and offsets refer to the old tuple. Tuples of equal size get
+ * one range per run of changed bytes, tuples of different size one range between their common prefix and suffix.
+ * Redo rebuilds the new tuple from the old one on the page, and undo rebuilds the old tuple from the new one.
  * For new page type log record
- *--------------------------
- * | HEADER | prev_page_id |
- *--------------------------
+ *------------------------------------
+ * | HEADER | prev_page_id | page_id |
+ *------------------------------------
+ * For compensation log record, the body is that of the INSERT, delete or UPDATE record describing the compensating
+ * change, e.g. an APPLYDELETE for an undone INSERT. Undo never undoes a CLR, it continues at undo_next_lsn instead.
+ *-----------------------------------------------------------------
+ * | HEADER | undo_next_lsn | compensation_type | compensation body |
+ *-----------------------------------------------------------------
  */
 class LogRecord {
   friend class LogManager;
@@ -94,21 +112,37 @@ class LogRecord {
         update_rid_(update_rid),
         old_tuple_(old_tuple),
         new_tuple_(new_tuple) {
+    EncodeUpdateDelta(old_tuple, new_tuple, &update_delta_);
     // calculate log record size
-    size_ = HEADER_SIZE + sizeof(RID) + old_tuple.GetLength() + new_tuple.GetLength() + 2 * sizeof(int32_t);
+    size_ = HEADER_SIZE + sizeof(RID) + update_delta_.size();
   }
 
   // constructor for NEWPAGE type
-  LogRecord(txn_id_t txn_id, lsn_t prev_lsn, LogRecordType log_record_type, page_id_t prev_page_id)
+  LogRecord(txn_id_t txn_id, lsn_t prev_lsn, LogRecordType log_record_type, page_id_t prev_page_id,
+            page_id_t page_id)
       : size_(HEADER_SIZE),
         txn_id_(txn_id),
         prev_lsn_(prev_lsn),
         log_record_type_(log_record_type),
-        prev_page_id_(prev_page_id) {
+        prev_page_id_(prev_page_id),
+        page_id_(page_id) {
     // calculate log record size, header size + sizeof(prev_page_id) + sizeof(page_id)
     size_ = HEADER_SIZE + sizeof(page_id_t) * 2;
   }
 
+  // constructor for CLR type, wrapping the record of the compensating change
+  LogRecord(txn_id_t txn_id, lsn_t prev_lsn, const LogRecord &compensation, lsn_t undo_next_lsn)
+      : LogRecord(compensation) {
+    assert(compensation.log_record_type_ != LogRecordType::CLR);
+    lsn_ = INVALID_LSN;
+    txn_id_ = txn_id;
+    prev_lsn_ = prev_lsn;
+    log_record_type_ = LogRecordType::CLR;
+    compensation_type_ = compensation.log_record_type_;
+    undo_next_lsn_ = undo_next_lsn;
+    size_ = compensation.size_ + sizeof(lsn_t) + sizeof(LogRecordType);
+  }
+
   ~LogRecord() = default;
 
   inline RID &GetDeleteRID() { return delete_rid_; }
@@ -119,8 +153,41 @@ class LogRecord {
 
   inline page_id_t GetNewPageRecord() { return prev_page_id_; }
 
+  inline page_id_t GetNewPageId() { return page_id_; }
+
+  inline RID &GetUpdateRID() { return update_rid_; }
+
+  inline Tuple &GetDeleteTuple() { return delete_tuple_; }
+
+  /** @return the old tuple of an update; empty for records read back from the log, use ApplyUpdateDelta instead */
+  inline Tuple &GetOriginalTuple() { return old_tuple_; }
+
+  /** @return the new tuple of an update; empty for records read back from the log, use ApplyUpdateDelta instead */
+  inline Tuple &GetUpdateTuple() { return new_tuple_; }
+
+  /**
+   * Rebuilds one side of an update from the other side and the logged byte ranges.
+   * @param base the new tuple if redo is false, the old tuple otherwise
+   * @param redo true to rebuild the new tuple, false to rebuild the old tuple
+   * @param[out] result the rebuilt tuple
+   * @return false if base does not match the update: it has a different size, or differs from the logged side of the
+   * update in one of the changed byte ranges
+   */
+  bool ApplyUpdateDelta(const Tuple &base, bool redo, Tuple *result) const;
+
   inline int32_t GetSize() { return size_; }
 
+  /**
+   * Computes the checksum of a serialized log record.
+   * @param data the serialized record, starting with its header
+   * @param size the size of the record
+   * @return the CRC32C of every byte of the record except the checksum field
+   */
+  static inline uint32_t ComputeChecksum(const char *data, int32_t size) {
+    uint32_t crc = HashUtil::Crc32c(data, CHECKSUM_OFFSET);
+    return HashUtil::Crc32c(data + HEADER_SIZE, size - HEADER_SIZE, crc);
+  }
+
   inline lsn_t GetLSN() { return lsn_; }
 
   inline txn_id_t GetTxnId() { return txn_id_; }
@@ -129,6 +196,13 @@ class LogRecord {
 
   inline LogRecordType &GetLogRecordType() { return log_record_type_; }
 
+  /** @return the change this record makes to its page: its own type, or the compensating change for a CLR */
+  inline LogRecordType GetOperationType() const {
+    return log_record_type_ == LogRecordType::CLR ? compensation_type_ : log_record_type_;
+  }
+
+  inline lsn_t GetUndoNextLSN() { return undo_next_lsn_; }
+
   // For debug purpose
   inline std::string ToString() const {
     std::ostringstream os;
@@ -159,15 +233,27 @@ class LogRecord {
   RID insert_rid_;
   Tuple insert_tuple_;
 
-  // case3: for update opeartion
+  // case3: for update opeartion, update_delta_ is what is written to the log
   RID update_rid_;
   Tuple old_tuple_;
   Tuple new_tuple_;
+  std::vector<char> update_delta_;
 
   // case4: for new page opeartion
   page_id_t prev_page_id_{INVALID_PAGE_ID};
   page_id_t page_id_{INVALID_PAGE_ID};
-  static const int HEADER_SIZE = 20;
+
+  // case5: for compensation log records
+  LogRecordType compensation_type_{LogRecordType::INVALID};
+  lsn_t undo_next_lsn_{INVALID_LSN};
+
+  static const int CHECKSUM_OFFSET = 20;
+  static const int HEADER_SIZE = 24;
+  /** Size of the fixed part of an update delta, and of the fixed part of every range in it. */
+  static const int DELTA_HEADER_SIZE = 3 * sizeof(uint16_t);
+
+  /** Serializes the byte ranges in which new_tuple differs from old_tuple into delta. */
+  static void EncodeUpdateDelta(const Tuple &old_tuple, const Tuple &new_tuple, std::vector<char> *delta);
 };  // namespace bustub
 
 }  // namespace bustub
@@ -13,23 +13,50 @@
 #pragma once
 
 #include <algorithm>
+#include <memory>
 #include <mutex>  // NOLINT
+#include <thread>  // NOLINT
 #include <unordered_map>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
+#include "common/channel.h"
 #include "concurrency/lock_manager.h"
+#include "recovery/log_manager.h"
+#include "recovery/log_reader.h"
 #include "recovery/log_record.h"
 
 namespace bustub {
 
 /**
  * Read log file from disk, redo and undo.
+ *
+ * Redo is a pipeline: the calling thread reads the log with large sequential reads, deserializes the records and
+ * builds active_txn_ and lsn_mapping_, while a pool of redo workers applies the records. Every record is routed to the
+ * worker owning its page (page id modulo the number of workers), so the records of one page are replayed in LSN order
+ * by a single thread and different pages are replayed in parallel.
+ *
+ * Undo splits the loser transactions among the same number of workers (transaction id modulo the number of workers).
+ * The workers follow the prevLSN chains of their transactions through a shared, cached LogReader. If a log manager is
+ * given, every undone change is logged in a compensation log record (CLR) and every rolled back transaction ends
+ * with an ABORT record, so that undo picks up where it left off if the system crashes again during recovery.
  */
 class LogRecovery {
  public:
-  LogRecovery(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager)
-      : disk_manager_(disk_manager), buffer_pool_manager_(buffer_pool_manager), offset_(0) {
-    log_buffer_ = new char[LOG_BUFFER_SIZE];
+  /**
+   * Creates a new LogRecovery.
+   * @param disk_manager the disk manager holding the log
+   * @param buffer_pool_manager the buffer pool manager that pages are recovered into
+   * @param log_manager the log manager used to write compensation log records; nullptr to undo without logging
+   * @param num_workers the number of threads applying redo and undo, capped so that every worker can pin its pages
+   */
+  LogRecovery(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, LogManager *log_manager = nullptr,
+              size_t num_workers = std::thread::hardware_concurrency())
+      : disk_manager_(disk_manager),
+        buffer_pool_manager_(buffer_pool_manager),
+        log_manager_(log_manager),
+        num_workers_(std::max<size_t>(1, std::min(num_workers, buffer_pool_manager->GetPoolSize() / 2))) {
+    log_buffer_ = new char[LOG_READ_BUFFER_SIZE];
   }
 
   ~LogRecovery() {
@@ -38,19 +65,81 @@ class LogRecovery {
   }
 
   void Redo();
-  void Undo();
+
+  /**
+   * Rolls back the loser transactions Redo() found, and logs an ABORT for every one rolled back completely.
+   * @return false if a change of some loser could not be read or undone; that loser is left without an ABORT, so the
+   * next recovery continues rolling it back after its last CLR
+   */
+  bool Undo();
   bool DeserializeLogRecord(const char *data, LogRecord *log_record);
 
+  /** @return the number of log records read by the last Redo() */
+  inline size_t GetNumRedoRecords() const { return lsn_mapping_.size(); }
+
+  /** @return the number of threads applying redo and undo */
+  inline size_t GetNumWorkers() const { return num_workers_; }
+
  private:
-  DiskManager *disk_manager_ __attribute__((__unused__));
-  BufferPoolManager *buffer_pool_manager_ __attribute__((__unused__));
+  /** Records are handed to the redo workers in batches to keep channel synchronization off the critical path. */
+  using RedoBatch = std::vector<std::unique_ptr<LogRecord>>;
+  static constexpr size_t REDO_BATCH_SIZE = 256;
+  /** Maximum number of batches queued per worker before the log reader blocks. */
+  static constexpr size_t REDO_QUEUE_DEPTH = 16;
+
+  /** Body of a redo worker: applies every batch it receives until it receives an empty batch. */
+  void RedoWorker(size_t worker_id, Channel<RedoBatch> *queue);
+
+  /**
+   * Applies a single log record to the pages owned by the given worker, skipping pages that already contain it.
+   * @param log_record the record to be redone
+   * @param worker_id the worker applying the record
+   */
+  void RedoLogRecord(LogRecord *log_record, size_t worker_id);
+
+  /**
+   * Rolls back a loser transaction, skipping over changes that CLRs show to be undone already.
+   * @param txn_id the loser transaction
+   * @param last_lsn the LSN of the last log record of the transaction
+   * @return true if every change back to BEGIN was undone and the ABORT logged, false if undo stopped at a change it
+   * could not read or undo
+   */
+  bool UndoTransaction(txn_id_t txn_id, lsn_t last_lsn);
+
+  /**
+   * Reverts the effect of a single log record on its page, and logs a CLR for it if there is a log manager.
+   * @param log_record the record to be undone
+   * @param[in,out] prev_lsn the LSN of the last log record of the transaction, updated to the CLR's LSN
+   * @return false if the change could not be reverted, e.g. the page has no room for a deleted tuple
+   */
+  bool UndoLogRecord(LogRecord *log_record, lsn_t *prev_lsn);
+
+  /**
+   * Reads the record with the given LSN back from the log through log_reader_. Safe to call from several threads.
+   * @return true if the record could be read and deserialized
+   */
+  bool ReadLogRecord(lsn_t lsn, LogRecord *log_record);
+
+  /** @return the redo worker owning the given page */
+  inline size_t RedoPartition(page_id_t page_id) const { return static_cast<size_t>(page_id) % num_workers_; }
+
+  /** @return the page modified by a tuple-level log record */
+  static page_id_t GetTuplePageId(const LogRecord &log_record);
+
+  DiskManager *disk_manager_;
+  BufferPoolManager *buffer_pool_manager_;
+  LogManager *log_manager_;
+  size_t num_workers_;
+  /** Serves the random log reads of the undo workers while Undo() runs. */
+  std::unique_ptr<LogReader> log_reader_;
 
   /** Maintain active transactions and its corresponding latest lsn. */
   std::unordered_map<txn_id_t, lsn_t> active_txn_;
-  /** Mapping the log sequence number to log file offset for undos. */
-  std::unordered_map<lsn_t, int> lsn_mapping_;
+  /** Mapping the log sequence number to log file offset for undos. LSNs are dense, so lsn - first_lsn_ is the index. */
+  std::vector<size_t> lsn_mapping_;
+  /** The LSN of the first record in the log. */
+  lsn_t first_lsn_{INVALID_LSN};
 
-  int offset_ __attribute__((__unused__));
   char *log_buffer_;
 };
 
@@ -15,6 +15,8 @@
 #include <atomic>
 #include <fstream>
 #include <future>  // NOLINT
+#include <map>
+#include <mutex>  // NOLINT
 #include <string>
 
 #include "common/config.h"
@@ -24,6 +26,10 @@ namespace bustub {
 /**
  * DiskManager takes care of the allocation and deallocation of pages within a database. It performs the reading and
  * writing of pages to and from disk, providing a logical file layer within the context of a database management system.
+ *
+ * The log is stored as a sequence of segment files named <db>.log.<segment number>. Each segment starts with a header
+ * recording the LSN of its first log record and the logical offset of its first byte, so that the segments together
+ * form one contiguous logical log even after old segments have been truncated away.
  */
 class DiskManager {
  public:
@@ -55,20 +61,55 @@ class DiskManager {
   void ReadPage(page_id_t page_id, char *page_data);
 
   /**
-   * Flush the entire log buffer into disk.
+   * Flush the entire log buffer into disk. A new segment is started first if the current one cannot take the whole
+   * buffer, so every segment begins at a log record boundary.
    * @param log_data raw log data
    * @param size size of log entry
+   * @param first_lsn LSN of the first log record in log_data
    */
-  void WriteLog(char *log_data, int size);
+  void WriteLog(char *log_data, int size, lsn_t first_lsn);
 
   /**
    * Read a log entry from the log file.
    * @param[out] log_data output buffer
    * @param size size of the log entry
-   * @param offset offset of the log entry in the file
+   * @param offset logical offset of the log entry in the log
    * @return true if the read was successful, false otherwise
    */
-  bool ReadLog(char *log_data, int size, int offset);
+  bool ReadLog(char *log_data, int size, size_t offset);
+
+  /** @return the logical offset of the oldest log record still on disk */
+  size_t GetLogStartOffset();
+
+  /**
+   * Drops every log segment that only holds records older than redo_lsn. The segment currently being written to is
+   * never dropped. Dropped segments are moved to the archive directory if one is set, and deleted otherwise.
+   * @param redo_lsn the oldest LSN that recovery may still need
+   * @return the number of segments dropped
+   */
+  size_t TruncateLog(lsn_t redo_lsn);
+
+  /**
+   * Cuts off the log from the given offset on, e.g. to drop a torn write found during recovery. The next log write
+   * starts a new segment right after the remaining log.
+   * @param offset logical offset of the first byte to drop
+   */
+  void TruncateLogTail(size_t offset);
+
+  /**
+   * Sets the size at which the log moves on to a new segment file.
+   * @param log_segment_size the segment size in bytes, excluding the segment header
+   */
+  void SetLogSegmentSize(size_t log_segment_size);
+
+  /**
+   * Makes TruncateLog move old segments into the given directory instead of deleting them.
+   * @param archive_dir the archive directory, which is created if needed; empty to disable archiving
+   */
+  void SetLogArchiveDirectory(const std::string &archive_dir);
+
+  /** @return the number of log segments on disk, not counting archived ones */
+  size_t GetNumLogSegments();
 
   /**
    * Allocate a page on disk.
@@ -101,10 +142,46 @@ class DiskManager {
   inline bool HasFlushLogFuture() { return flush_log_f_ != nullptr; }
 
  private:
-  int GetFileSize(const std::string &file_name);
-  // stream to write log file
+  /** On-disk header at the beginning of every log segment file. */
+  struct LogSegmentHeader {
+    uint32_t magic_;
+    uint32_t segment_no_;
+    lsn_t first_lsn_;
+    uint32_t checksum_;
+    uint64_t start_offset_;
+  };
+
+  /** In-memory description of a log segment file. */
+  struct LogSegment {
+    uint32_t segment_no_;
+    lsn_t first_lsn_;
+    /** Number of log bytes in the segment, excluding the header. */
+    size_t size_;
+  };
+
+  static constexpr uint32_t LOG_SEGMENT_MAGIC = 0x4C4F4753;
+
+  int64_t GetFileSize(const std::string &file_name);
+  std::string GetLogSegmentFileName(uint32_t segment_no) const;
+  static uint32_t LogSegmentChecksum(const LogSegmentHeader &header);
+  /** Finds the log segments left behind by a previous run. */
+  void LoadLogSegments();
+  /** Closes the current log segment and starts a new one whose first record has the given LSN. */
+  void StartLogSegment(lsn_t first_lsn);
+
+  // stream to write the current log segment
   std::fstream log_io_;
+  // stream to read log segments, positioned in segment read_segment_no_
+  std::ifstream log_read_io_;
+  uint32_t read_segment_no_{0};
   std::string log_name_;
+  /** Log segments on disk, keyed by the logical offset of their first byte. */
+  std::map<size_t, LogSegment> log_segments_;
+  uint32_t next_segment_no_{0};
+  size_t log_segment_size_{LOG_SEGMENT_SIZE};
+  std::string log_archive_dir_;
+  /** Protects the log segments and log streams. */
+  std::mutex log_latch_;
   // stream to write db file
   std::fstream db_io_;
   std::string file_name_;
@@ -0,0 +1,197 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree.h
+//
+// Identification: src/include/storage/index/b_plus_tree.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/rwlatch.h"
+#include "concurrency/transaction.h"
+#include "storage/index/index_iterator.h"
+#include "storage/page/b_plus_tree_internal_page.h"
+#include "storage/page/b_plus_tree_leaf_page.h"
+
+namespace bustub {
+
+#define BPLUSTREE_TYPE BPlusTree<KeyType, ValueType, KeyComparator>
+
+/**
+ * Main class providing the API for the interactive B+ tree, backed by a buffer pool manager. Only supports unique
+ * keys. Supports insert and remove, and the tree grows and shrinks dynamically. Leaves are linked to their next
+ * sibling, which iterators follow for range scans.
+ *
+ * Concurrent operations latch the pages on their way down (latch crabbing). Lookups read latch each page and release
+ * its parent. Inserts and removes first descend the same way and only write latch the leaf; if the leaf would split
+ * or underflow, they release it and descend again from the root with write latches, keeping the latches of the pages
+ * above that may change, i.e. up to the last page that can absorb the change. The root page id is protected by a
+ * latch of its own that is held like the latch of a parent of the root.
+ *
+ * Pages are latched top-down, and siblings left to right: a page that underflows is unlatched before its left
+ * sibling is latched, which is safe because its parent stays write latched.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class BPlusTree {
+  using InternalPage = BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>;
+  using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+
+ public:
+  /**
+   * Creates a new, empty B+ tree.
+   * @param name the name of the index
+   * @param buffer_pool_manager buffer pool manager to be used
+   * @param comparator comparator for keys
+   * @param leaf_max_size the number of entries a leaf holds before it splits
+   * @param internal_max_size the number of children an internal page holds before it splits, at least 3
+   */
+  explicit BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
+                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE);
+
+  /** @return true if the tree holds no key */
+  bool IsEmpty();
+
+  /**
+   * Inserts a key-value pair into the tree.
+   * @return false if the tree holds the key already
+   */
+  bool Insert(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
+
+  /**
+   * Removes a key and its value from the tree.
+   * @return true if the tree held the key
+   */
+  bool Remove(const KeyType &key, Transaction *transaction = nullptr);
+
+  /**
+   * Performs a point query on the tree.
+   * @param key the key to look up
+   * @param[out] result the value of key is appended to it
+   * @return true if the tree holds the key
+   */
+  bool GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr);
+
+  /** @return an iterator at the smallest key */
+  INDEXITERATOR_TYPE Begin();
+
+  /** @return an iterator at the smallest key that is not smaller than key */
+  INDEXITERATOR_TYPE Begin(const KeyType &key);
+
+  /** @return an iterator at the end */
+  INDEXITERATOR_TYPE End();
+
+  /**
+   * Builds the tree bottom-up from sorted input, filling every page but spreading the entries evenly over the pages
+   * of a level, so that none underflows.
+   * @param items the key-value pairs, in strictly increasing key order
+   * @return false if the tree is not empty or the keys are not in strictly increasing order
+   */
+  bool BulkLoad(const std::vector<MappingType> &items);
+
+  /** @return the page id of the root, INVALID_PAGE_ID for an empty tree */
+  page_id_t GetRootPageId();
+
+  /**
+   * Asserts that the keys of every page are in order and within the separators of the parent, that every page other
+   * than the root holds at least its minimum size, that all leaves are at the same depth and that the sibling links
+   * chain the leaves in key order. Must not run concurrently with other operations.
+   */
+  void VerifyIntegrity();
+
+ private:
+  enum class Operation { INSERT, REMOVE };
+
+  /** The pages a modifying operation holds write latched, from the topmost page that may change down to the leaf. */
+  struct LatchedPath {
+    std::vector<Page *> pages_;
+    // Whether the root latch is held, the first page is the root then
+    bool root_latched_{false};
+  };
+
+  /**
+   * Descends to the leaf that holds a key, read latching the pages on the way. Must be called with the root latch
+   * read latched and a non-empty tree, releases it.
+   * @param key the key to look for, nullptr for the leftmost leaf
+   * @param write_leaf whether to write latch the leaf instead
+   * @param[out] is_root whether the leaf is the root
+   * @return the page of the leaf, pinned and latched
+   */
+  Page *FindLeaf(const KeyType *key, bool write_leaf, bool *is_root);
+
+  /**
+   * Descends to the leaf that holds a key, write latching the pages on the way, and releasing the latches of the
+   * pages above a page that is safe for the operation.
+   * @param[out] path the pages that stay latched, the leaf last
+   * @return the page of the leaf, nullptr if the tree is empty; the root latch is held then
+   */
+  Page *FindLeafPessimistic(const KeyType &key, Operation op, LatchedPath *path);
+
+  /** @return true if the page absorbs the operation without splitting or underflowing */
+  bool IsSafe(const BPlusTreePage *node, Operation op, bool is_root) const;
+
+  /** Unlatches and unpins the pages of the path, and releases the root latch if held. */
+  void ReleasePath(LatchedPath *path, bool is_dirty);
+
+  /** Inserts a key, descending with write latches. */
+  bool InsertPessimistic(const KeyType &key, const ValueType &value);
+
+  /**
+   * Links a new page into the parent of a page that split, splitting the parent as well if it overflows.
+   * @param path the latched path
+   * @param level the index of the page that split in the path
+   * @param key the separator of the new page
+   * @param new_page_id the new page, the next sibling of the page that split
+   */
+  void InsertIntoParent(LatchedPath *path, size_t level, const KeyType &key, page_id_t new_page_id);
+
+  /** Removes a key, descending with write latches. */
+  bool RemovePessimistic(const KeyType &key);
+
+  /**
+   * Merges a page that underflowed with a sibling, or moves an entry over from the sibling, and continues with the
+   * parent if it underflows in turn. Shrinks the tree by a level if the root is left with a single child.
+   * @param path the latched path
+   * @param level the index of the page in the path
+   * @param[out] deleted_page_ids the pages to delete once the path is released
+   */
+  void HandleUnderflow(LatchedPath *path, size_t level, std::vector<page_id_t> *deleted_page_ids);
+
+  /**
+   * Checks the subtree of a page, see VerifyIntegrity.
+   * @param lower the smallest key the subtree may hold, nullptr for no bound
+   * @param upper the key all keys of the subtree are smaller than, nullptr for no bound
+   * @param[out] leaves the leaves of the subtree are appended to it in order
+   * @return the height of the subtree
+   */
+  int VerifySubtree(page_id_t page_id, const KeyType *lower, const KeyType *upper, bool is_root,
+                    std::vector<page_id_t> *leaves);
+
+  /** Fetches a page, throws if the buffer pool has no free frame. */
+  Page *FetchPage(page_id_t page_id);
+
+  /** Allocates a page, throws if the buffer pool has no free frame. */
+  Page *NewPage(page_id_t *page_id);
+
+  // member variable
+  std::string index_name_;
+  page_id_t root_page_id_{INVALID_PAGE_ID};
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+  int leaf_max_size_;
+  int internal_max_size_;
+
+  // Protects root_page_id_
+  ReaderWriterLatch root_latch_;
+};
+
+}  // namespace bustub
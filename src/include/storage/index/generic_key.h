@@ -12,10 +12,13 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstring>
+#include <string>
 
 #include "storage/table/tuple.h"
 #include "type/value.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
@@ -25,42 +28,76 @@ namespace bustub {
  * This key type uses an fixed length array to hold data for indexing
  * purposes, the actual size of which is specified and instantiated
  * with a template argument.
+ *
+ * The columns of the key are stored one after the other in a normalized encoding, so that comparing two keys with
+ * memcmp orders them like comparing their values column by column, and equal keys have equal bytes:
+ *  - integers are stored big-endian, signed integers with the sign bit flipped;
+ *  - timestamps are stored big-endian plus one, so that the NULL timestamp, the largest one in a tuple, wraps to zero;
+ *  - decimals are stored as their IEEE 754 bits, big-endian, with the sign bit flipped for positive numbers and all
+ *    bits flipped for negative ones; -0.0 is stored as 0.0;
+ *  - varchars are stored as a byte that is 0 for NULL and 1 otherwise, followed by a prefix of the string padded with
+ *    zero bytes. The varchar columns share the bytes left by the other columns in equal parts.
+ * Other NULL values are the smallest value of their type, as in a tuple, so NULL sorts first. A key that does not fit
+ * into KeySize is truncated and compares by its prefix.
  */
 template <size_t KeySize>
 class GenericKey {
  public:
-  inline void SetFromKey(const Tuple &tuple) {
+  /**
+   * Encodes a key.
+   * @param tuple the key tuple
+   * @param key_schema the schema of the key tuple
+   */
+  inline void SetFromKey(const Tuple &tuple, const Schema *key_schema) {
     // intialize to 0
     memset(data_, 0, KeySize);
-    memcpy(data_, tuple.GetData(), tuple.GetLength());
+    uint32_t varchar_width = VarcharWidth(key_schema);
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < key_schema->GetColumnCount() && offset < KeySize; i++) {
+      const Column &col = key_schema->GetColumn(i);
+      uint32_t width = col.IsInlined() ? col.GetFixedLength() : varchar_width;
+      // a column that does not fit is truncated
+      EncodeValue(tuple.GetValue(key_schema, i), col.GetType(), width, std::min<uint32_t>(width, KeySize - offset),
+                  data_ + offset);
+      offset += width;
+    }
   }
 
   // NOTE: for test purpose only
+  // encodes key as a single BIGINT column
   inline void SetFromInteger(int64_t key) {
     memset(data_, 0, KeySize);
-    memcpy(data_, &key, sizeof(int64_t));
+    EncodeValue(ValueFactory::GetBigIntValue(key), TypeId::BIGINT, sizeof(int64_t), std::min(sizeof(int64_t), KeySize),
+                data_);
   }
 
   inline Value ToValue(Schema *schema, uint32_t column_idx) const {
-    const char *data_ptr;
-    const auto &col = schema->GetColumn(column_idx);
-    const TypeId column_type = col.GetType();
-    const bool is_inlined = col.IsInlined();
-    if (is_inlined) {
-      data_ptr = (data_ + col.GetOffset());
-    } else {
-      int32_t offset = *reinterpret_cast<int32_t *>(const_cast<char *>(data_ + col.GetOffset()));
-      data_ptr = (data_ + offset);
+    uint32_t varchar_width = VarcharWidth(schema);
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < column_idx; i++) {
+      const Column &col = schema->GetColumn(i);
+      offset += col.IsInlined() ? col.GetFixedLength() : varchar_width;
+    }
+    const Column &col = schema->GetColumn(column_idx);
+    uint32_t width = col.IsInlined() ? col.GetFixedLength() : varchar_width;
+    // the truncated bytes of a column decode as zero bytes
+    char encoded[KeySize + sizeof(uint64_t)] = {};
+    if (offset < KeySize) {
+      memcpy(encoded, data_ + offset, std::min<uint32_t>(width, KeySize - offset));
     }
-    return Value::DeserializeFrom(data_ptr, column_type);
+    return DecodeValue(encoded, col.GetType(), width);
   }
 
   // NOTE: for test purpose only
-  // interpret the first 8 bytes as int64_t from data vector
-  inline int64_t ToString() const { return *reinterpret_cast<int64_t *>(const_cast<char *>(data_)); }
+  // interpret the first 8 bytes as a BIGINT column
+  inline int64_t ToString() const {
+    char encoded[sizeof(int64_t)] = {};
+    memcpy(encoded, data_, std::min(sizeof(int64_t), KeySize));
+    return DecodeValue(encoded, TypeId::BIGINT, sizeof(int64_t)).template GetAs<int64_t>();
+  }
 
   // NOTE: for test purpose only
-  // interpret the first 8 bytes as int64_t from data vector
+  // interpret the first 8 bytes as a BIGINT column
   friend std::ostream &operator<<(std::ostream &os, const GenericKey &key) {
     os << key.ToString();
     return os;
@@ -68,39 +105,158 @@ class GenericKey {
 
   // actual location of data, extends past the end.
   char data_[KeySize];
+
+ private:
+  /** @return the number of bytes each varchar column of a key takes */
+  static uint32_t VarcharWidth(const Schema *schema) {
+    uint32_t fixed_length = 0;
+    uint32_t num_varchars = 0;
+    for (const Column &col : schema->GetColumns()) {
+      if (col.IsInlined()) {
+        fixed_length += col.GetFixedLength();
+      } else {
+        num_varchars++;
+      }
+    }
+    return num_varchars == 0 || fixed_length >= KeySize ? 0 : (KeySize - fixed_length) / num_varchars;
+  }
+
+  /** @return the bits of an integer or decimal value of type, transformed to compare as unsigned integers */
+  static uint64_t OrderedBits(const char *storage, TypeId type) {
+    switch (type) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+        return static_cast<uint8_t>(*storage) ^ 0x80U;
+      case TypeId::SMALLINT: {
+        uint16_t bits;
+        memcpy(&bits, storage, sizeof(bits));
+        return bits ^ 0x8000U;
+      }
+      case TypeId::INTEGER: {
+        uint32_t bits;
+        memcpy(&bits, storage, sizeof(bits));
+        return bits ^ 0x80000000U;
+      }
+      case TypeId::BIGINT: {
+        uint64_t bits;
+        memcpy(&bits, storage, sizeof(bits));
+        return bits ^ (1ULL << 63);
+      }
+      case TypeId::DECIMAL: {
+        uint64_t bits;
+        memcpy(&bits, storage, sizeof(bits));
+        if (bits == 1ULL << 63) {
+          // -0.0 equals 0.0
+          bits = 0;
+        }
+        return (bits >> 63) != 0 ? ~bits : bits ^ (1ULL << 63);
+      }
+      case TypeId::TIMESTAMP: {
+        uint64_t bits;
+        memcpy(&bits, storage, sizeof(bits));
+        return bits + 1;
+      }
+      default: {
+        uint64_t bits;
+        memcpy(&bits, storage, sizeof(bits));
+        return bits;
+      }
+    }
+  }
+
+  /** Stores the native representation of a value of type, given the bits returned by OrderedBits. */
+  static void NativeBits(uint64_t bits, TypeId type, char *storage) {
+    switch (type) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+        *storage = static_cast<char>(bits ^ 0x80U);
+        break;
+      case TypeId::SMALLINT: {
+        auto native = static_cast<uint16_t>(bits ^ 0x8000U);
+        memcpy(storage, &native, sizeof(native));
+        break;
+      }
+      case TypeId::INTEGER: {
+        auto native = static_cast<uint32_t>(bits ^ 0x80000000U);
+        memcpy(storage, &native, sizeof(native));
+        break;
+      }
+      case TypeId::BIGINT:
+        bits ^= 1ULL << 63;
+        memcpy(storage, &bits, sizeof(bits));
+        break;
+      case TypeId::DECIMAL:
+        bits = (bits >> 63) != 0 ? bits ^ (1ULL << 63) : ~bits;
+        memcpy(storage, &bits, sizeof(bits));
+        break;
+      case TypeId::TIMESTAMP:
+        bits -= 1;
+        memcpy(storage, &bits, sizeof(bits));
+        break;
+      default:
+        memcpy(storage, &bits, sizeof(bits));
+        break;
+    }
+  }
+
+  /**
+   * Encodes a value of type, which takes width bytes, and stores the first length bytes of the encoding into out.
+   * @param length the number of bytes of out, at most width
+   */
+  static void EncodeValue(const Value &value, TypeId type, uint32_t width, uint32_t length, char *out) {
+    if (type == TypeId::VARCHAR) {
+      if (length == 0) {
+        return;
+      }
+      memset(out, 0, length);
+      if (!value.IsNull()) {
+        out[0] = 1;
+        memcpy(out + 1, value.GetData(), std::min(value.GetLength() - 1, length - 1));
+      }
+      return;
+    }
+    char storage[sizeof(uint64_t)];
+    value.SerializeTo(storage);
+    uint64_t bits = OrderedBits(storage, type);
+    for (uint32_t i = 0; i < length; i++) {
+      out[i] = static_cast<char>(bits >> (8 * (width - 1 - i)));
+    }
+  }
+
+  /** Decodes a value of type from width bytes of in. */
+  static Value DecodeValue(const char *in, TypeId type, uint32_t width) {
+    if (type == TypeId::VARCHAR) {
+      if (width == 0 || in[0] == 0) {
+        return ValueFactory::GetNullValueByType(TypeId::VARCHAR);
+      }
+      return ValueFactory::GetVarcharValue(std::string(in + 1, strnlen(in + 1, width - 1)));
+    }
+    uint64_t bits = 0;
+    for (uint32_t i = 0; i < width; i++) {
+      bits = (bits << 8) | static_cast<uint8_t>(in[i]);
+    }
+    char storage[sizeof(uint64_t)];
+    NativeBits(bits, type, storage);
+    return Value::DeserializeFrom(storage, type);
+  }
 };
 
 /**
  * Function object returns true if lhs < rhs, used for trees
+ *
+ * Generic keys are normalized, so they compare as bytes and the comparator does not look at the key schema.
  */
 template <size_t KeySize>
 class GenericComparator {
  public:
   inline int operator()(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const {
-    uint32_t column_count = key_schema_->GetColumnCount();
-
-    for (uint32_t i = 0; i < column_count; i++) {
-      Value lhs_value = (lhs.ToValue(key_schema_, i));
-      Value rhs_value = (rhs.ToValue(key_schema_, i));
-
-      if (lhs_value.CompareLessThan(rhs_value) == CmpBool::CmpTrue) {
-        return -1;
-      }
-      if (lhs_value.CompareGreaterThan(rhs_value) == CmpBool::CmpTrue) {
-        return 1;
-      }
-    }
-    // equals
-    return 0;
+    return memcmp(lhs.data_, rhs.data_, KeySize);
   }
 
-  GenericComparator(const GenericComparator &other) : key_schema_{other.key_schema_} {}
+  GenericComparator(const GenericComparator &other) = default;
 
   // constructor
-  explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema) {}
-
- private:
-  Schema *key_schema_;
+  explicit GenericComparator(Schema *key_schema) {}
 };
 
 }  // namespace bustub
@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_iterator.h
+//
+// Identification: src/include/storage/index/index_iterator.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/macros.h"
+#include "storage/page/b_plus_tree_leaf_page.h"
+
+namespace bustub {
+
+#define INDEXITERATOR_TYPE IndexIterator<KeyType, ValueType, KeyComparator>
+
+/**
+ * Iterator over the entries of a B+ tree in key order, for range scans.
+ *
+ * The iterator keeps the leaf it points into pinned and read latched, and moves to the next leaf through the sibling
+ * link, latching the next leaf before it releases the current one. Writers wait for the leaf the iterator is on, so
+ * a thread must not modify the tree while it holds an iterator that is not at the end.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class IndexIterator {
+ public:
+  /** Creates an iterator at the end. */
+  IndexIterator() = default;
+
+  /**
+   * Creates an iterator at an entry of a leaf, or at the first entry after it if index is past the end of the leaf.
+   * @param buffer_pool_manager the buffer pool manager of the tree
+   * @param page the page of the leaf, pinned and read latched; the iterator takes over the pin and the latch
+   * @param index the index of the entry in the leaf
+   */
+  IndexIterator(BufferPoolManager *buffer_pool_manager, Page *page, int index);
+
+  /** Releases the leaf the iterator points into. */
+  ~IndexIterator();
+
+  IndexIterator(IndexIterator &&other) noexcept;
+  IndexIterator &operator=(IndexIterator &&other) noexcept;
+  DISALLOW_COPY(IndexIterator);
+
+  /** @return true if the iterator is past the last entry */
+  bool IsEnd() const;
+
+  /** @return the key and value the iterator points to */
+  const MappingType &operator*() const;
+
+  /** Advances the iterator to the next entry. */
+  IndexIterator &operator++();
+
+  bool operator==(const IndexIterator &itr) const;
+
+  bool operator!=(const IndexIterator &itr) const;
+
+ private:
+  /** Moves on to the following leaves until the iterator points to an entry or is at the end. */
+  void SkipEmptyLeaves();
+
+  /** Unlatches and unpins the leaf, the iterator is at the end afterwards. */
+  void Release();
+
+  BufferPoolManager *buffer_pool_manager_{nullptr};
+  // The page of the leaf the iterator points into, nullptr at the end
+  Page *page_{nullptr};
+  B_PLUS_TREE_LEAF_PAGE_TYPE *leaf_{nullptr};
+  int index_{0};
+};
+
+}  // namespace bustub
@@ -19,6 +19,7 @@
 #include "container/hash/hash_function.h"
 #include "container/hash/linear_probe_hash_table.h"
 #include "storage/index/index.h"
+#include "storage/table/table_heap.h"
 
 namespace bustub {
 
@@ -38,6 +39,24 @@ class LinearProbeHashTableIndex : public Index {
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  void ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *results,
+                Transaction *transaction) override;
+
+  /**
+   * Inserts an entry for every tuple of a table, e.g. to build the index of an existing table. The table is scanned
+   * once, the keys are built by a thread per core, and the hash table is resized to twice as many buckets as the table
+   * has tuples, the load factor it grows to by itself, before the entries are bulk inserted; so it does not grow while
+   * they are inserted.
+   * @param table_heap the indexed table
+   * @param table_schema the schema of the tuples of the table
+   * @param transaction the current transaction
+   * @return false if the index is not empty
+   */
+  bool BulkLoad(TableHeap *table_heap, const Schema *table_schema, Transaction *transaction);
+
+  /** @return the number of buckets of the hash table */
+  size_t GetNumBuckets() { return container_.GetSize(); }
+
  protected:
   // comparator for key
   KeyComparator comparator_;
@@ -0,0 +1,121 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_internal_page.h
+//
+// Identification: src/include/storage/page/b_plus_tree_internal_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+#define B_PLUS_TREE_INTERNAL_PAGE_TYPE BPlusTreeInternalPage<KeyType, ValueType, KeyComparator>
+#define INTERNAL_PAGE_HEADER_SIZE 20
+/** The default maximum size of an internal page. One slot is left free, a page holds one child too many until it
+ * splits. */
+#define INTERNAL_PAGE_SIZE ((PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / sizeof(MappingType) - 1)
+
+/**
+ * Store n indexed keys and n+1 child pointers (page_id) within internal page. Pointer PAGE_ID(i) points to a subtree
+ * in which all keys K satisfy: K(i) <= K < K(i+1).
+ *
+ * NOTE: since the number of keys does not equal to number of child pointers, the first key always remains invalid.
+ * That is to say, any search/lookup should ignore the first key. The size of an internal page is its number of
+ * children.
+ *
+ * Internal page format (keys are stored in increasing order):
+ *  --------------------------------------------------------------------------
+ * | HEADER | KEY(1)+PAGE_ID(1) | KEY(2)+PAGE_ID(2) | ... | KEY(n)+PAGE_ID(n) |
+ *  --------------------------------------------------------------------------
+ *
+ * Moving entries between pages keeps one convention: after a page hands entries to a sibling, the first key of the
+ * page on the right is the separator its parent has to store for it.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class BPlusTreeInternalPage : public BPlusTreePage {
+ public:
+  /**
+   * Initializes a new, empty internal page.
+   * @param page_id the page id of the page
+   * @param max_size the number of children the page holds before it splits
+   */
+  void Init(page_id_t page_id, int max_size);
+
+  /** @return the key at index */
+  KeyType KeyAt(int index) const;
+
+  /** Sets the key at index. */
+  void SetKeyAt(int index, const KeyType &key);
+
+  /** @return the child at index */
+  ValueType ValueAt(int index) const;
+
+  /** @return the index of a child, GetSize() if the page does not point to it */
+  int ValueIndex(const ValueType &value) const;
+
+  /**
+   * @param key the key to look for
+   * @param comparator comparator for keys
+   * @return the child whose subtree holds key
+   */
+  ValueType Lookup(const KeyType &key, const KeyComparator &comparator) const;
+
+  /** Turns the empty page into a new root with two children. */
+  void PopulateNewRoot(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value);
+
+  /**
+   * Inserts a child right after an existing child. The page may hold one child more than its maximum size afterwards.
+   * @param old_value the existing child
+   * @param new_key the separator of the new child
+   * @param new_value the new child
+   */
+  void InsertNodeAfter(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value);
+
+  /** Removes the key and child at index. */
+  void Remove(int index);
+
+  /** Removes the only child of the page and returns it. */
+  ValueType RemoveAndReturnOnlyChild();
+
+  /** Moves the upper half of the children to recipient, an empty page that becomes the next sibling. */
+  void MoveHalfTo(BPlusTreeInternalPage *recipient);
+
+  /**
+   * Moves all children to the end of recipient, the previous sibling.
+   * @param middle_key the separator of this page in the parent
+   */
+  void MoveAllTo(BPlusTreeInternalPage *recipient, const KeyType &middle_key);
+
+  /**
+   * Moves the first child to the end of recipient, the previous sibling.
+   * @param middle_key the separator of this page in the parent
+   */
+  void MoveFirstToEndOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key);
+
+  /**
+   * Moves the last child to the front of recipient, the next sibling.
+   * @param middle_key the separator of recipient in the parent
+   */
+  void MoveLastToFrontOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key);
+
+  /**
+   * Appends children to the page.
+   * @param items the separators and children, the first separator is the one of the first child
+   * @param size the number of children
+   */
+  void CopyNFrom(const MappingType *items, int size);
+
+ private:
+  MappingType array_[0];
+};
+
+}  // namespace bustub
@@ -0,0 +1,117 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_leaf_page.h
+//
+// Identification: src/include/storage/page/b_plus_tree_leaf_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+#define B_PLUS_TREE_LEAF_PAGE_TYPE BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>
+#define LEAF_PAGE_HEADER_SIZE 24
+/** The default maximum size of a leaf page. One slot is left free, a leaf holds one entry too many until it splits. */
+#define LEAF_PAGE_SIZE ((PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType) - 1)
+
+/**
+ * Store indexed key and record id (record id = page id combined with slot id, see include/common/rid.h for detailed
+ * implementation) together within leaf page. Only support unique key.
+ *
+ * Leaf page format (keys are stored in order):
+ *  ----------------------------------------------------------------------
+ * | HEADER | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
+ *  ----------------------------------------------------------------------
+ *
+ *  Header format (size in byte, 24 bytes in total):
+ *  ---------------------------------------------------------------------
+ * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) |
+ *  ---------------------------------------------------------------------
+ *  -----------------------------------------------
+ * | PageId (4) | NextPageId (4)
+ *  -----------------------------------------------
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class BPlusTreeLeafPage : public BPlusTreePage {
+ public:
+  /**
+   * Initializes a new, empty leaf page.
+   * @param page_id the page id of the page
+   * @param max_size the number of entries the page holds before it splits
+   */
+  void Init(page_id_t page_id, int max_size);
+
+  /** @return the page id of the next leaf, INVALID_PAGE_ID for the last leaf */
+  page_id_t GetNextPageId() const;
+
+  /** Sets the page id of the next leaf. */
+  void SetNextPageId(page_id_t next_page_id);
+
+  /** @return the key at index */
+  KeyType KeyAt(int index) const;
+
+  /** @return the key and value at index */
+  const MappingType &GetItem(int index) const;
+
+  /**
+   * @param key the key to look for
+   * @param comparator comparator for keys
+   * @return the index of the first key that is not smaller than key, GetSize() if there is none
+   */
+  int KeyIndex(const KeyType &key, const KeyComparator &comparator) const;
+
+  /**
+   * @param key the key to look up
+   * @param[out] value the value of key
+   * @param comparator comparator for keys
+   * @return true if the page holds key
+   */
+  bool Lookup(const KeyType &key, ValueType *value, const KeyComparator &comparator) const;
+
+  /**
+   * Inserts a key and value in key order. The page may hold one entry more than its maximum size afterwards.
+   * @return false if the page holds key already
+   */
+  bool Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator);
+
+  /**
+   * Removes a key and its value.
+   * @return false if the page does not hold key
+   */
+  bool Remove(const KeyType &key, const KeyComparator &comparator);
+
+  /** Moves the upper half of the entries to recipient, an empty page that becomes the next leaf. */
+  void MoveHalfTo(BPlusTreeLeafPage *recipient);
+
+  /** Moves all entries to the end of recipient, the previous leaf, which takes over the next page id. */
+  void MoveAllTo(BPlusTreeLeafPage *recipient);
+
+  /** Moves the first entry to the end of recipient, the previous leaf. */
+  void MoveFirstToEndOf(BPlusTreeLeafPage *recipient);
+
+  /** Moves the last entry to the front of recipient, the next leaf. */
+  void MoveLastToFrontOf(BPlusTreeLeafPage *recipient);
+
+  /**
+   * Appends entries to the page.
+   * @param items the entries, in key order and larger than the keys of the page
+   * @param size the number of entries
+   */
+  void CopyNFrom(const MappingType *items, int size);
+
+ private:
+  page_id_t next_page_id_;
+  MappingType array_[0];
+};
+
+}  // namespace bustub
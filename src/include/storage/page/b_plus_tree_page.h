@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_page.h
+//
+// Identification: src/include/storage/page/b_plus_tree_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+
+#include "common/config.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+#define MappingType std::pair<KeyType, ValueType>
+
+enum class IndexPageType { INVALID_INDEX_PAGE = 0, LEAF_PAGE, INTERNAL_PAGE };
+
+/**
+ * Both internal and leaf page are inherited from this page.
+ *
+ * It actually serves as a header part for each B+ tree page and contains information shared by both leaf page and
+ * internal page. Pages do not point to their parents: a thread that modifies the tree keeps the path it came down
+ * latched instead, so that splitting or merging a node never has to touch the children it moves.
+ *
+ * Header format (size in byte, 20 bytes in total):
+ * ----------------------------------------------------------------------------
+ * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) | PageId(4) |
+ * ----------------------------------------------------------------------------
+ */
+class BPlusTreePage {
+ public:
+  /** @return true if the page is a leaf page */
+  bool IsLeafPage() const;
+
+  /** Sets the type of the page. */
+  void SetPageType(IndexPageType page_type);
+
+  /** @return the number of entries of a leaf page, or of children of an internal page */
+  int GetSize() const;
+
+  /** Sets the number of entries of the page. */
+  void SetSize(int size);
+
+  /** Adds amount to the number of entries of the page. */
+  void IncreaseSize(int amount);
+
+  /** @return the number of entries the page holds before it splits */
+  int GetMaxSize() const;
+
+  /** Sets the number of entries the page holds before it splits. */
+  void SetMaxSize(int max_size);
+
+  /** @return the number of entries a page other than the root holds at least */
+  int GetMinSize() const;
+
+  /** @return the page ID of this page */
+  page_id_t GetPageId() const;
+
+  /** Sets the page ID of this page. */
+  void SetPageId(page_id_t page_id);
+
+  /** Sets the LSN of this page. */
+  void SetLSN(lsn_t lsn = INVALID_LSN);
+
+ private:
+  // member variable, attributes that both internal and leaf page share
+  IndexPageType page_type_;
+  lsn_t lsn_;
+  int size_;
+  int max_size_;
+  page_id_t page_id_;
+};
+
+}  // namespace bustub
@@ -13,6 +13,7 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
 #include <utility>
 #include <vector>
 
@@ -32,6 +33,9 @@ namespace bustub {
  *
  *  Here '+' means concatenation.
  *
+ * The pairs are preceded by the occupied and readable bitmaps, and by a one byte fingerprint of the hash of every key.
+ * Lookups match the fingerprints of a group of BLOCK_GROUP_SIZE slots at once and only compare the keys of the slots
+ * whose fingerprints match.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class HashTableBlockPage {
@@ -64,18 +68,21 @@ class HashTableBlockPage {
    * @param bucket_ind index to write the key and value to
    * @param key key to insert
    * @param value value to insert
+   * @param fingerprint the fingerprint of the hash of key
    * @return If the value is inserted successfully, it returns true. If the
    * index is marked as occupied before the key and value can be inserted,
    * Insert returns false.
    */
-  bool Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value);
+  bool Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value, uint8_t fingerprint);
 
   /**
-   * Removes a key and value at index.
+   * Removes a key and value at index. The index stays occupied as a tombstone. The remove is thread safe, of
+   * concurrent removes of the same index only one succeeds.
    *
    * @param bucket_ind ind to remove the value
+   * @return true if this call removed the key and value, false if the index was not readable
    */
-  void Remove(slot_offset_t bucket_ind);
+  bool Remove(slot_offset_t bucket_ind);
 
   /**
    * Returns whether or not an index is occupied (key/value pair or tombstone)
@@ -93,11 +100,42 @@ class HashTableBlockPage {
    */
   bool IsReadable(slot_offset_t bucket_ind) const;
 
+  /**
+   * @return the number of readable indexes in the block
+   */
+  size_t NumReadable() const;
+
+  /**
+   * Matches the fingerprints of a group of slots.
+   *
+   * @param group the index of the group, i.e. of the slots [group * BLOCK_GROUP_SIZE, (group + 1) * BLOCK_GROUP_SIZE)
+   * @param fingerprint the fingerprint to look for
+   * @param[out] free the slots of the group that were never occupied, one bit per slot
+   * @return the readable slots of the group with the fingerprint, one bit per slot
+   */
+  uint32_t MatchGroup(size_t group, uint8_t fingerprint, uint32_t *free) const;
+
+  /**
+   * Prefetches the flags and the fingerprints of the group of an index, and its key and value, into the CPU cache.
+   *
+   * @param bucket_ind the index a lookup is going to start at
+   */
+  void Prefetch(slot_offset_t bucket_ind) const;
+
+  /**
+   * @param hash the hash of a key
+   * @return the fingerprint of the key
+   */
+  static uint8_t Fingerprint(uint64_t hash) { return static_cast<uint8_t>(hash >> 56); }
+
  private:
-  std::atomic_char occupied_[(BLOCK_ARRAY_SIZE - 1) / 8 + 1];
+  std::atomic<uint32_t> occupied_[BLOCK_NUM_GROUPS];
 
   // 0 if tombstone/brand new (never occupied), 1 otherwise.
-  std::atomic_char readable_[(BLOCK_ARRAY_SIZE - 1) / 8 + 1];
+  std::atomic<uint32_t> readable_[BLOCK_NUM_GROUPS];
+
+  // Written before the slot becomes readable, and only read for readable slots.
+  uint8_t fingerprints_[BLOCK_NUM_GROUPS * BLOCK_GROUP_SIZE];
   MappingType array_[0];
 };
 
@@ -0,0 +1,138 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_bucket_page.h
+//
+// Identification: src/include/storage/page/hash_table_bucket_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/index/int_comparator.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+/**
+ * Store indexed key and value together within a bucket page of an extendible hash table. Supports non-unique keys,
+ * but not duplicate key-value pairs.
+ *
+ * Bucket page format (keys are stored in no particular order):
+ *  ----------------------------------------------------------------
+ * | KEY(1) + VALUE(1) | KEY(2) + VALUE(2) | ... | KEY(n) + VALUE(n)
+ *  ----------------------------------------------------------------
+ *
+ *  Here '+' means concatenation.
+ *
+ * The pairs are preceded by a readable bitmap and by a one byte fingerprint of the hash of every key, so that lookups
+ * only compare the keys whose fingerprints match. Unlike a block page of the linear probe hash table, a bucket keeps no
+ * tombstones, a removed slot is free again right away. The bucket page is not thread safe, callers latch the page.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class HashTableBucketPage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  HashTableBucketPage() = delete;
+
+  /**
+   * Collects the values of a key.
+   *
+   * @param key the key to look up
+   * @param fingerprint the fingerprint of the hash of key
+   * @param cmp the comparator for keys
+   * @param[out] result the values associated with key are appended to it
+   * @return true if the bucket holds the key
+   */
+  bool GetValue(const KeyType &key, uint8_t fingerprint, KeyComparator cmp, std::vector<ValueType> *result) const;
+
+  /**
+   * Inserts a key-value pair into the first free slot.
+   *
+   * @param key key to insert
+   * @param value value to insert
+   * @param fingerprint the fingerprint of the hash of key
+   * @param cmp the comparator for keys
+   * @return false if the bucket holds the pair already or is full
+   */
+  bool Insert(const KeyType &key, const ValueType &value, uint8_t fingerprint, KeyComparator cmp);
+
+  /**
+   * Removes a key-value pair.
+   *
+   * @param key key to remove
+   * @param value value to remove
+   * @param fingerprint the fingerprint of the hash of key
+   * @param cmp the comparator for keys
+   * @return true if the bucket held the pair
+   */
+  bool Remove(const KeyType &key, const ValueType &value, uint8_t fingerprint, KeyComparator cmp);
+
+  /**
+   * Gets the key at an index in the bucket.
+   *
+   * @param bucket_idx the index in the bucket to get the key at
+   * @return key at index bucket_idx of the bucket
+   */
+  KeyType KeyAt(slot_offset_t bucket_idx) const;
+
+  /**
+   * Gets the value at an index in the bucket.
+   *
+   * @param bucket_idx the index in the bucket to get the value at
+   * @return value at index bucket_idx of the bucket
+   */
+  ValueType ValueAt(slot_offset_t bucket_idx) const;
+
+  /**
+   * Removes the key-value pair at an index.
+   *
+   * @param bucket_idx the index to remove the pair at
+   */
+  void RemoveAt(slot_offset_t bucket_idx);
+
+  /**
+   * Returns whether or not an index is readable (valid key/value pair)
+   *
+   * @param bucket_idx index to look at
+   * @return true if the index is readable, false otherwise
+   */
+  bool IsReadable(slot_offset_t bucket_idx) const;
+
+  /**
+   * @return true if every index of the bucket is readable
+   */
+  bool IsFull() const;
+
+  /**
+   * @return the number of readable indexes in the bucket
+   */
+  size_t NumReadable() const;
+
+  /**
+   * @return true if no index of the bucket is readable
+   */
+  bool IsEmpty() const;
+
+  /**
+   * @param hash the hash of a key
+   * @return the fingerprint of the key
+   */
+  static uint8_t Fingerprint(uint64_t hash) { return static_cast<uint8_t>(hash >> 56); }
+
+ private:
+  // 0 if free, 1 if the index holds a key-value pair.
+  char readable_[(BUCKET_ARRAY_SIZE - 1) / 8 + 1];
+  // Only meaningful for readable indexes.
+  uint8_t fingerprints_[BUCKET_ARRAY_SIZE];
+  MappingType array_[0];
+};
+
+}  // namespace bustub
@@ -0,0 +1,143 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_directory_page.h
+//
+// Identification: src/include/storage/page/hash_table_directory_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+#include "common/config.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+
+/**
+ *
+ * Directory Page for extendible hash table.
+ *
+ * Directory format (size in byte):
+ * --------------------------------------------------------------------------------------------
+ * | LSN (4) | PageId(4) | GlobalDepth(4) | LocalDepths(512) | BucketPageIds(2048) | Free(1524)
+ * --------------------------------------------------------------------------------------------
+ *
+ * Entry i of the directory points to the bucket of the keys whose hashes end in the global depth low bits of i. A
+ * bucket with local depth d is pointed to by all the 2^(global depth - d) entries that share its d low bits.
+ */
+class HashTableDirectoryPage {
+ public:
+  /**
+   * @return the page ID of this page
+   */
+  page_id_t GetPageId() const;
+
+  /**
+   * Sets the page ID of this page
+   *
+   * @param page_id the page id for the page id field to be set to
+   */
+  void SetPageId(page_id_t page_id);
+
+  /**
+   * @return the lsn of this page
+   */
+  lsn_t GetLSN() const;
+
+  /**
+   * Sets the LSN of this page
+   *
+   * @param lsn the log sequence number for the lsn field to be set to
+   */
+  void SetLSN(lsn_t lsn);
+
+  /**
+   * @param bucket_idx the index in the directory
+   * @return the page id of the bucket the entry points to
+   */
+  page_id_t GetBucketPageId(uint32_t bucket_idx) const;
+
+  /**
+   * Points an entry of the directory to a bucket.
+   *
+   * @param bucket_idx the index in the directory
+   * @param bucket_page_id the page id of the bucket
+   */
+  void SetBucketPageId(uint32_t bucket_idx, page_id_t bucket_page_id);
+
+  /**
+   * @param bucket_idx the index in the directory
+   * @return the index of the entry that differs from bucket_idx only in the highest bit of its local depth, i.e. the
+   * entry of the bucket the bucket of bucket_idx was split from or merges with
+   */
+  uint32_t GetSplitImageIndex(uint32_t bucket_idx) const;
+
+  /**
+   * @return a mask of global depth low bits, to be applied to hashes
+   */
+  uint32_t GetGlobalDepthMask() const;
+
+  /**
+   * @return the global depth of the directory
+   */
+  uint32_t GetGlobalDepth() const;
+
+  /**
+   * Doubles the directory. The entries of the new upper half point to the buckets of the lower half.
+   */
+  void IncrGlobalDepth();
+
+  /**
+   * Halves the directory. Only allowed if CanShrink().
+   */
+  void DecrGlobalDepth();
+
+  /**
+   * @return true if every local depth is smaller than the global depth
+   */
+  bool CanShrink() const;
+
+  /**
+   * @return the number of entries of the directory, 2^global depth
+   */
+  uint32_t Size() const;
+
+  /**
+   * @param bucket_idx the index in the directory
+   * @return the local depth of the bucket the entry points to
+   */
+  uint32_t GetLocalDepth(uint32_t bucket_idx) const;
+
+  /**
+   * @param bucket_idx the index in the directory
+   * @param local_depth the local depth of the bucket the entry points to
+   */
+  void SetLocalDepth(uint32_t bucket_idx, uint8_t local_depth);
+
+  /**
+   * @param bucket_idx the index in the directory
+   * @return a mask of local depth low bits
+   */
+  uint32_t GetLocalDepthMask(uint32_t bucket_idx) const;
+
+  /**
+   * Asserts that every local depth is at most the global depth, that the entries of a bucket agree on its local depth
+   * and that every bucket is pointed to by exactly 2^(global depth - local depth) entries.
+   */
+  void VerifyIntegrity() const;
+
+ private:
+  lsn_t lsn_;
+  page_id_t page_id_;
+  uint32_t global_depth_;
+  uint8_t local_depths_[DIRECTORY_ARRAY_SIZE];
+  page_id_t bucket_page_ids_[DIRECTORY_ARRAY_SIZE];
+};
+
+}  // namespace bustub
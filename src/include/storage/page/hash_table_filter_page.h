@@ -0,0 +1,74 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_filter_page.h
+//
+// Identification: src/include/storage/page/hash_table_filter_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/** The number of 64 bit words of a filter line, one cache line. */
+static constexpr size_t FILTER_LINE_WORDS = CACHE_LINE_SIZE / sizeof(uint64_t);
+
+/** The number of lines of a filter page. */
+static constexpr size_t FILTER_PAGE_LINES = PAGE_SIZE / CACHE_LINE_SIZE;
+
+/** The number of bits of a filter page. */
+static constexpr size_t FILTER_PAGE_BITS = 8 * PAGE_SIZE;
+
+/** The largest number of bits a key sets in a filter line. */
+static constexpr size_t FILTER_MAX_KEY_BITS = 16;
+
+/**
+ * A page of the blocked Bloom filter of a linear probe hash table. The filter is made of lines of one cache line each.
+ * A key picks one line and sets a few bits in it, so that looking it up touches a single cache line.
+ *
+ * Bits are set with atomic or and never cleared, so inserts and lookups run concurrently without latching the page.
+ */
+class HashTableFilterPage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  HashTableFilterPage() = delete;
+
+  /**
+   * Sets the bits of a key.
+   *
+   * @param line the line of the key in this page
+   * @param bit_hash a hash of the key that picks the bits in the line, independent of the line
+   * @param num_bits the number of bits per key, at most FILTER_MAX_KEY_BITS
+   */
+  void Insert(size_t line, uint64_t bit_hash, size_t num_bits);
+
+  /**
+   * Tests the bits of a key.
+   *
+   * @param line the line of the key in this page
+   * @param bit_hash a hash of the key that picks the bits in the line, independent of the line
+   * @param num_bits the number of bits per key, at most FILTER_MAX_KEY_BITS
+   * @return false if a bit of the key is not set, i.e. the key was never inserted
+   */
+  bool MayContain(size_t line, uint64_t bit_hash, size_t num_bits) const;
+
+ private:
+  /**
+   * Computes which bits of a line a key sets, by double hashing.
+   * @param[out] masks the bits of the key in each word of the line
+   */
+  static void KeyMasks(uint64_t bit_hash, size_t num_bits, uint64_t masks[FILTER_LINE_WORDS]);
+
+  std::atomic<uint64_t> words_[FILTER_PAGE_LINES * FILTER_LINE_WORDS];
+};
+
+}  // namespace bustub
@@ -17,6 +17,7 @@
 #include <cstdlib>
 #include <string>
 
+#include "common/macros.h"
 #include "storage/index/generic_key.h"
 #include "storage/page/hash_table_page_defs.h"
 
@@ -26,10 +27,13 @@ namespace bustub {
  *
  * Header Page for linear probing hash table.
  *
- * Header format (size in byte, 16 bytes in total):
+ * Header format (size in byte, 40 bytes in total with padding):
  * -------------------------------------------------------------
- * | LSN (4) | Size (4) | PageId(4) | NextBlockIndex(4)
+ * | LSN (4) | Size (8) | PageId(4) | NextBlockIndex(8) | NumFilterPages(8)
  * -------------------------------------------------------------
+ *
+ * The header is followed by the block page ids, in order, and by the filter page ids, which fill the page from its
+ * end.
  */
 class HashTableHeaderPage {
  public:
@@ -89,12 +93,36 @@ class HashTableHeaderPage {
    */
   size_t NumBlocks();
 
+  /**
+   * Adds a filter page_id to the header page
+   *
+   * @param page_id page_id to be added
+   */
+  void AddFilterPageId(page_id_t page_id);
+
+  /**
+   * Returns the page_id of the index-th filter page
+   *
+   * @param index the index of the filter page
+   * @return the page_id for the filter page
+   */
+  page_id_t GetFilterPageId(size_t index);
+
+  /**
+   * @return the number of filter pages currently stored in the header page
+   */
+  size_t NumFilterPages();
+
  private:
-  __attribute__((unused)) lsn_t lsn_;
-  __attribute__((unused)) size_t size_;
-  __attribute__((unused)) page_id_t page_id_;
-  __attribute__((unused)) size_t next_ind_;
-  __attribute__((unused)) page_id_t block_page_ids_[0];
+  lsn_t lsn_;
+  size_t size_;
+  page_id_t page_id_;
+  size_t next_ind_;
+  size_t num_filter_pages_;
+  page_id_t block_page_ids_[0];
 };
 
+/** The number of block and filter page ids that fit into a header page. */
+static constexpr size_t HASH_TABLE_HEADER_MAX_BLOCKS = (PAGE_SIZE - sizeof(HashTableHeaderPage)) / sizeof(page_id_t);
+
 }  // namespace bustub
@@ -14,11 +14,28 @@
 
 #define MappingType std::pair<KeyType, ValueType>
 
-/** BLOCK_ARRAY_SIZE is the number of (key, value) pairs that can be stored in   * a block page. It is an approximate
+/** BLOCK_ARRAY_SIZE is the number of (key, value) pairs that can be stored in a block page. It is an approximate
  * calculation based on the size of MappingType (which is a std::pair of KeyType and ValueType). For each key/value
- * pair, we need two additional bits for occupied_ and readable_. 4 * PAGE_SIZE / (4 * sizeof (MappingType) + 1) =
- * PAGE_SIZE/(sizeof (MappingType) + 0.25) because 0.25 bytes = 2 bits is the space required to maintain the occupied
- * and readable flags for a key value pair.*/
-#define BLOCK_ARRAY_SIZE (4 * PAGE_SIZE / (4 * sizeof(MappingType) + 1))
+ * pair, we need two additional bits for occupied_ and readable_ and a one byte fingerprint, i.e. 1.25 bytes:
+ * 4 * PAGE_SIZE / (4 * sizeof (MappingType) + 5) = PAGE_SIZE / (sizeof (MappingType) + 1.25). The bitmaps and the
+ * fingerprints are rounded up to whole groups of BLOCK_GROUP_SIZE slots, 64 bytes are set aside for that. */
+#define BLOCK_ARRAY_SIZE (4 * (PAGE_SIZE - 64) / (4 * sizeof(MappingType) + 5))
+
+/** The number of slots of a block page whose flags are kept in one bitmap word, and whose fingerprints are compared
+ * at once. */
+#define BLOCK_GROUP_SIZE 32
+
+/** The number of groups of a block page. */
+#define BLOCK_NUM_GROUPS ((BLOCK_ARRAY_SIZE - 1) / BLOCK_GROUP_SIZE + 1)
 
 #define HASH_TABLE_BLOCK_TYPE HashTableBlockPage<KeyType, ValueType, KeyComparator>
+
+/** BUCKET_ARRAY_SIZE is the number of (key, value) pairs that can be stored in a bucket page of an extendible hash
+ * table. Next to each key/value pair, a bucket keeps a readable bit and a one byte fingerprint:
+ * 8 * (PAGE_SIZE - 1) / (8 * sizeof (MappingType) + 9) leaves room for the bitmap rounded up to whole bytes. */
+#define BUCKET_ARRAY_SIZE (8 * (PAGE_SIZE - 1) / (8 * sizeof(MappingType) + 9))
+
+/** The maximum number of directory entries of an extendible hash table, i.e. its global depth is at most 9. */
+#define DIRECTORY_ARRAY_SIZE 512
+
+#define HASH_TABLE_BUCKET_TYPE HashTableBucketPage<KeyType, ValueType, KeyComparator>
@@ -13,6 +13,8 @@
 #pragma once
 
 #include "buffer/buffer_pool_manager.h"
+#include "concurrency/tid_table.h"
+#include "concurrency/version_store.h"
 #include "recovery/log_manager.h"
 #include "storage/page/table_page.h"
 #include "storage/table/table_iterator.h"
@@ -23,6 +25,14 @@ namespace bustub {
 /**
  * TableHeap represents a physical table on disk.
  * This is just a doubly-linked list of pages.
+ *
+ * A table created through the catalog knows its oid. Its rows are locked under an intention lock on the table, which
+ * is taken before a page is latched, so that table locks, e.g. those that lock escalation leaves, cover them. The rows
+ * of other tables are locked on their own. Either way, rows are only locked while logging is enabled.
+ *
+ * Optimistic transactions read the table without locks and buffer their updates and deletes in their write sets.
+ * TransactionManager::Commit validates them against the TID words of the table and installs the writes. Optimistic
+ * and pessimistic transactions must not use the same table at the same time.
  */
 class TableHeap {
   friend class TableIterator;
@@ -36,9 +46,11 @@ class TableHeap {
    * @param lock_manager the lock manager
    * @param log_manager the log manager
    * @param first_page_id the id of the first page
+   * @param version_store the old tuple versions for snapshot isolation, nullptr if the table is locked instead
+   * @param oid the catalog's id of the table, INVALID_TABLE_OID if it is not in a catalog
    */
   TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-            page_id_t first_page_id);
+            page_id_t first_page_id, VersionStore *version_store = nullptr, table_oid_t oid = INVALID_TABLE_OID);
 
   /**
    * Create a table heap with a transaction. (create table)
@@ -46,9 +58,11 @@ class TableHeap {
    * @param lock_manager the lock manager
    * @param log_manager the log manager
    * @param txn the creating transaction
+   * @param version_store the old tuple versions for snapshot isolation, nullptr if the table is locked instead
+   * @param oid the catalog's id of the table, INVALID_TABLE_OID if it is not in a catalog
    */
   TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-            Transaction *txn);
+            Transaction *txn, VersionStore *version_store = nullptr, table_oid_t oid = INVALID_TABLE_OID);
 
   /**
    * Insert a tuple into the table. If the tuple is too large (>= page_size), return false.
@@ -91,7 +105,8 @@ class TableHeap {
   void RollbackDelete(const RID &rid, Transaction *txn);
 
   /**
-   * Read a tuple from the table.
+   * Read a tuple from the table. Under snapshot isolation, this reads the version in the snapshot of the transaction
+   * without locking the tuple.
    * @param rid rid of the tuple to read
    * @param tuple output variable for the tuple
    * @param txn transaction performing the read
@@ -99,6 +114,28 @@ class TableHeap {
    */
   bool GetTuple(const RID &rid, Tuple *tuple, Transaction *txn);
 
+  /**
+   * Locks a row without reading it, under an intention lock on the table if the table is in a catalog.
+   * @param rid the row to lock
+   * @param lock_mode SHARED or EXCLUSIVE
+   * @param txn the locking transaction
+   * @return true if the row is locked, or logging is disabled
+   */
+  bool LockRow(const RID &rid, LockMode lock_mode, Transaction *txn);
+
+  /**
+   * Finds the first tuple slot of the table without reading the tuple, e.g. so that a scan can lock it first.
+   * @param[out] rid the first slot, an invalid RID if the table is empty
+   */
+  void GetFirstRid(RID *rid);
+
+  /**
+   * Finds the tuple slot following rid without reading the tuple.
+   * @param rid a slot of the table
+   * @param[out] next_rid the following slot, an invalid RID at the end of the table
+   */
+  void GetNextRid(const RID &rid, RID *next_rid);
+
   /** @return the begin iterator of this table */
   TableIterator Begin(Transaction *txn);
 
@@ -108,11 +145,59 @@ class TableHeap {
   /** @return the id of the first page of this table */
   inline page_id_t GetFirstPageId() const { return first_page_id_; }
 
+  /** @return the catalog's id of this table, INVALID_TABLE_OID if it is not in a catalog */
+  inline table_oid_t GetTableOid() const { return oid_; }
+
+  /** @return the TID words of the tuples, for optimistic transactions */
+  inline TidTable *GetTidTable() { return &tids_; }
+
  private:
+  /**
+   * Takes the intention lock on the table that locking one of its rows needs, before a page of the table is latched.
+   * @param lock_mode the mode the row will be locked in, SHARED or EXCLUSIVE
+   * @param txn the locking transaction
+   * @return true if the lock is held, or there is none to take
+   */
+  bool LockIntention(LockMode lock_mode, Transaction *txn);
+
+  /**
+   * Checks that a transaction may change a tuple under snapshot isolation, and aborts it otherwise.
+   * @param rid the tuple, whose page must be write latched
+   * @param txn the writing transaction
+   * @return true if the table is not versioned or the write does not conflict
+   */
+  bool CanWrite(const RID &rid, Transaction *txn);
+
+  /**
+   * Reads a tuple for an optimistic transaction and adds it to the read set of the transaction.
+   * @param rid rid of the tuple to read
+   * @param tuple output variable for the tuple
+   * @param txn the optimistic transaction performing the read
+   * @return true if the tuple exists, counting the buffered writes of the transaction
+   */
+  bool GetTupleOptimistic(const RID &rid, Tuple *tuple, Transaction *txn);
+
+  /**
+   * Moves on from a latched and pinned page to the first slot of the following pages, unless found, and releases the
+   * page it stops at.
+   * @param page the page rid was looked up in
+   * @param found whether rid was found in the page
+   * @param[out] rid the slot found, an invalid RID if there is none
+   */
+  void FindRid(TablePage *page, bool found, RID *rid);
+
+  /** @return whether the writes of a transaction are buffered until it commits */
+  static bool IsBuffered(Transaction *txn) {
+    return txn->GetConcurrencyMode() == ConcurrencyMode::OPTIMISTIC && txn->GetState() == TransactionState::GROWING;
+  }
+
   BufferPoolManager *buffer_pool_manager_;
   LockManager *lock_manager_;
   LogManager *log_manager_;
   page_id_t first_page_id_{};
+  VersionStore *version_store_;
+  table_oid_t oid_;
+  TidTable tids_;
 };
 
 }  // namespace bustub
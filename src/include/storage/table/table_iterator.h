@@ -49,6 +49,15 @@ class TableIterator {
   TableIterator operator++(int);
 
  private:
+  /** @return whether the iterator skips the tuples that the transaction cannot read, instead of returning them */
+  bool SkipsInvisible();
+
+  /**
+   * Moves to the next tuple of the table.
+   * @return false if the tuple could not be read, true if it was read or the end of the table was reached
+   */
+  bool Advance();
+
   TableHeap *table_heap_;
   Tuple *tuple_;
   Transaction *txn_;
@@ -22,33 +22,156 @@ namespace bustub {
  *
  * This thread runs forever until system shutdown/StopFlushThread
  */
-void LogManager::RunFlushThread() {}
+void LogManager::RunFlushThread() {
+  if (enable_logging) {
+    return;
+  }
+  enable_logging = true;
+  flush_thread_ = new std::thread([this] {
+    std::unique_lock<std::mutex> lock(latch_);
+    while (enable_logging) {
+      cv_.wait_for(lock, log_timeout, [this] { return need_flush_ || !enable_logging; });
+      SwapAndFlush(&lock);
+    }
+    // Whatever was appended before shutdown still has to reach the disk.
+    SwapAndFlush(&lock);
+  });
+}
 
 /*
  * Stop and join the flush thread, set enable_logging = false
  */
-void LogManager::StopFlushThread() {}
+void LogManager::StopFlushThread() {
+  if (!enable_logging) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> guard(latch_);
+    enable_logging = false;
+  }
+  cv_.notify_one();
+  flush_thread_->join();
+  delete flush_thread_;
+  flush_thread_ = nullptr;
+}
+
+void LogManager::SwapAndFlush(std::unique_lock<std::mutex> *lock) {
+  if (offset_ == 0) {
+    need_flush_ = false;
+    flushed_cv_.notify_all();
+    return;
+  }
+  // Every record up to next_lsn_ - 1 lives in the buffer we are about to write.
+  lsn_t last_lsn = next_lsn_ - 1;
+  lsn_t first_lsn = buffer_first_lsn_;
+  int size = offset_;
+  std::swap(log_buffer_, flush_buffer_);
+  offset_ = 0;
+  need_flush_ = false;
+  flushing_ = true;
+
+  lock->unlock();
+  disk_manager_->WriteLog(flush_buffer_, size, first_lsn);
+  lock->lock();
+
+  flushing_ = false;
+  persistent_lsn_ = last_lsn;
+  flushed_cv_.notify_all();
+}
+
+void LogManager::Flush() {
+  std::unique_lock<std::mutex> lock(latch_);
+  lsn_t target = next_lsn_ - 1;
+  while (persistent_lsn_ < target) {
+    if (!enable_logging) {
+      // Nobody is running the flush thread, so do it ourselves.
+      if (flushing_) {
+        flushed_cv_.wait(lock);
+      } else {
+        SwapAndFlush(&lock);
+      }
+      continue;
+    }
+    need_flush_ = true;
+    cv_.notify_one();
+    flushed_cv_.wait(lock);
+  }
+}
+
+void LogManager::ResetLSN(lsn_t next_lsn) {
+  std::lock_guard<std::mutex> guard(latch_);
+  BUSTUB_ASSERT(offset_ == 0 && !flushing_, "The LSNs cannot change under buffered log records.");
+  next_lsn_ = next_lsn;
+  persistent_lsn_ = next_lsn - 1;
+}
 
 /*
  * append a log record into log buffer
  * you MUST set the log record's lsn within this method
  * @return: lsn that is assigned to this log record
- *
- *
- * example below
- * // First, serialize the must have fields(20 bytes in total)
- * log_record.lsn_ = next_lsn_++;
- * memcpy(log_buffer_ + offset_, &log_record, 20);
- * int pos = offset_ + 20;
- *
- * if (log_record.log_record_type_ == LogRecordType::INSERT) {
- *    memcpy(log_buffer_ + pos, &log_record.insert_rid_, sizeof(RID));
- *    pos += sizeof(RID);
- *    // we have provided serialize function for tuple class
- *    log_record.insert_tuple_.SerializeTo(log_buffer_ + pos);
- *  }
- *
  */
-lsn_t LogManager::AppendLogRecord(LogRecord *log_record) { return INVALID_LSN; }
+lsn_t LogManager::AppendLogRecord(LogRecord *log_record) {
+  BUSTUB_ASSERT(log_record->size_ <= LOG_BUFFER_SIZE, "A log record cannot be larger than the log buffer.");
+  std::unique_lock<std::mutex> lock(latch_);
+  // Wait for the flush thread to hand us an empty buffer if this record does not fit.
+  while (offset_ + log_record->size_ > LOG_BUFFER_SIZE) {
+    if (!enable_logging && !flushing_) {
+      // Nobody is running the flush thread (e.g. during recovery), so do it ourselves.
+      SwapAndFlush(&lock);
+      continue;
+    }
+    need_flush_ = true;
+    cv_.notify_one();
+    flushed_cv_.wait(lock);
+  }
+
+  log_record->lsn_ = next_lsn_++;
+  if (offset_ == 0) {
+    buffer_first_lsn_ = log_record->lsn_;
+  }
+  char *pos = log_buffer_ + offset_;
+
+  // First, serialize the must have fields (24 bytes in total). The checksum is filled in last.
+  char *record = pos;
+  memcpy(pos, &log_record->size_, sizeof(int32_t));
+  memcpy(pos + 4, &log_record->lsn_, sizeof(lsn_t));
+  memcpy(pos + 8, &log_record->txn_id_, sizeof(txn_id_t));
+  memcpy(pos + 12, &log_record->prev_lsn_, sizeof(lsn_t));
+  memcpy(pos + 16, &log_record->log_record_type_, sizeof(LogRecordType));
+  pos += LogRecord::HEADER_SIZE;
+  if (log_record->log_record_type_ == LogRecordType::CLR) {
+    memcpy(pos, &log_record->undo_next_lsn_, sizeof(lsn_t));
+    memcpy(pos + sizeof(lsn_t), &log_record->compensation_type_, sizeof(LogRecordType));
+    pos += sizeof(lsn_t) + sizeof(LogRecordType);
+  }
+
+  switch (log_record->GetOperationType()) {
+    case LogRecordType::INSERT:
+      memcpy(pos, &log_record->insert_rid_, sizeof(RID));
+      log_record->insert_tuple_.SerializeTo(pos + sizeof(RID));
+      break;
+    case LogRecordType::MARKDELETE:
+    case LogRecordType::APPLYDELETE:
+    case LogRecordType::ROLLBACKDELETE:
+      memcpy(pos, &log_record->delete_rid_, sizeof(RID));
+      log_record->delete_tuple_.SerializeTo(pos + sizeof(RID));
+      break;
+    case LogRecordType::UPDATE:
+      memcpy(pos, &log_record->update_rid_, sizeof(RID));
+      memcpy(pos + sizeof(RID), log_record->update_delta_.data(), log_record->update_delta_.size());
+      break;
+    case LogRecordType::NEWPAGE:
+      memcpy(pos, &log_record->prev_page_id_, sizeof(page_id_t));
+      memcpy(pos + sizeof(page_id_t), &log_record->page_id_, sizeof(page_id_t));
+      break;
+    default:
+      break;
+  }
+  uint32_t checksum = LogRecord::ComputeChecksum(record, log_record->size_);
+  memcpy(record + LogRecord::CHECKSUM_OFFSET, &checksum, sizeof(uint32_t));
+
+  offset_ += log_record->size_;
+  return log_record->lsn_;
+}
 
 }  // namespace bustub
@@ -0,0 +1,86 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// log_reader.cpp
+//
+// Identification: src/recovery/log_reader.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "recovery/log_reader.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+LogReader::LogReader(DiskManager *disk_manager, size_t num_blocks)
+    : disk_manager_(disk_manager), num_blocks_(num_blocks) {
+  BUSTUB_ASSERT(num_blocks > 0, "The log reader must be able to cache at least one block.");
+}
+
+bool LogReader::Read(char *data, size_t size, size_t offset) {
+  // Blocks are shared, so copying out of them needs no latch once they are found.
+  size_t copied = 0;
+  while (copied < size) {
+    size_t position = offset + copied;
+    Block block = GetBlock(position / BLOCK_SIZE);
+    if (block == nullptr) {
+      if (copied == 0) {
+        return false;
+      }
+      // the log ends within the requested range, like DiskManager::ReadLog
+      memset(data + copied, 0, size - copied);
+      break;
+    }
+    size_t block_offset = position % BLOCK_SIZE;
+    size_t count = std::min(size - copied, BLOCK_SIZE - block_offset);
+    memcpy(data + copied, block->data() + block_offset, count);
+    copied += count;
+  }
+  return true;
+}
+
+size_t LogReader::GetNumBlockReads() {
+  std::lock_guard<std::mutex> guard(latch_);
+  return num_block_reads_;
+}
+
+LogReader::Block LogReader::GetBlock(size_t block_no) {
+  std::lock_guard<std::mutex> guard(latch_);
+  auto it = blocks_.find(block_no);
+  if (it != blocks_.end()) {
+    lru_list_.splice(lru_list_.begin(), lru_list_, it->second.second);
+    return it->second.first;
+  }
+
+  auto data = std::make_shared<std::vector<char>>(BLOCK_SIZE);
+  // ReadLog zero-fills the part of the block beyond the end of the log.
+  size_t block_start = block_no * BLOCK_SIZE;
+  if (!disk_manager_->ReadLog(data->data(), BLOCK_SIZE, block_start)) {
+    // The log may start in the middle of this block after old segments were truncated.
+    size_t log_start = disk_manager_->GetLogStartOffset();
+    if (log_start <= block_start || log_start >= block_start + BLOCK_SIZE ||
+        !disk_manager_->ReadLog(data->data() + (log_start - block_start), block_start + BLOCK_SIZE - log_start,
+                                log_start)) {
+      return nullptr;
+    }
+  }
+  num_block_reads_++;
+
+  if (blocks_.size() == num_blocks_) {
+    blocks_.erase(lru_list_.back());
+    lru_list_.pop_back();
+  }
+  lru_list_.push_front(block_no);
+  Block block = std::move(data);
+  blocks_.emplace(block_no, std::make_pair(block, lru_list_.begin()));
+  return block;
+}
+
+}  // namespace bustub
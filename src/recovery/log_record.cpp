@@ -0,0 +1,168 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// log_record.cpp
+//
+// Identification: src/recovery/log_record.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "recovery/log_record.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace bustub {
+
+static_assert(PAGE_SIZE <= UINT16_MAX, "Update deltas store tuple offsets and sizes in 16 bits.");
+
+static void AppendUint16(std::vector<char> *delta, uint32_t value) {
+  auto narrow = static_cast<uint16_t>(value);
+  const char *bytes = reinterpret_cast<const char *>(&narrow);
+  delta->insert(delta->end(), bytes, bytes + sizeof(uint16_t));
+}
+
+static uint16_t ReadUint16(const char *data) {
+  uint16_t value;
+  memcpy(&value, data, sizeof(uint16_t));
+  return value;
+}
+
+/*
+ * Changed bytes that are separated by fewer unchanged bytes than half a range header are put in the same range, since
+ * logging the unchanged bytes twice is cheaper than starting a new range
+ */
+void LogRecord::EncodeUpdateDelta(const Tuple &old_tuple, const Tuple &new_tuple, std::vector<char> *delta) {
+  const char *old_data = old_tuple.GetData();
+  const char *new_data = new_tuple.GetData();
+  uint32_t old_size = old_tuple.GetLength();
+  uint32_t new_size = new_tuple.GetLength();
+
+  struct Range {
+    uint32_t offset_;
+    uint32_t old_length_;
+    uint32_t new_length_;
+  };
+  std::vector<Range> ranges;
+  if (old_size == new_size) {
+    uint32_t i = 0;
+    while (i < old_size) {
+      // skip unchanged words quickly, most of a wide tuple is untouched
+      while (i + sizeof(uint64_t) <= old_size && memcmp(old_data + i, new_data + i, sizeof(uint64_t)) == 0) {
+        i += sizeof(uint64_t);
+      }
+      while (i < old_size && old_data[i] == new_data[i]) {
+        i++;
+      }
+      if (i == old_size) {
+        break;
+      }
+      uint32_t end = i + 1;
+      for (uint32_t j = end; j < old_size && j - end < DELTA_HEADER_SIZE / 2; j++) {
+        if (old_data[j] != new_data[j]) {
+          end = j + 1;
+        }
+      }
+      ranges.push_back(Range{i, end - i, end - i});
+      i = end;
+    }
+  } else {
+    uint32_t min_size = std::min(old_size, new_size);
+    uint32_t prefix = 0;
+    while (prefix < min_size && old_data[prefix] == new_data[prefix]) {
+      prefix++;
+    }
+    uint32_t suffix = 0;
+    while (suffix < min_size - prefix && old_data[old_size - suffix - 1] == new_data[new_size - suffix - 1]) {
+      suffix++;
+    }
+    ranges.push_back(Range{prefix, old_size - prefix - suffix, new_size - prefix - suffix});
+  }
+
+  size_t delta_size = DELTA_HEADER_SIZE;
+  for (const auto &range : ranges) {
+    delta_size += DELTA_HEADER_SIZE + range.old_length_ + range.new_length_;
+  }
+  delta->clear();
+  delta->reserve(delta_size);
+  AppendUint16(delta, old_size);
+  AppendUint16(delta, new_size);
+  AppendUint16(delta, ranges.size());
+  for (const auto &range : ranges) {
+    AppendUint16(delta, range.offset_);
+    AppendUint16(delta, range.old_length_);
+    AppendUint16(delta, range.new_length_);
+    delta->insert(delta->end(), old_data + range.offset_, old_data + range.offset_ + range.old_length_);
+    delta->insert(delta->end(), new_data + range.offset_, new_data + range.offset_ + range.new_length_);
+  }
+}
+
+bool LogRecord::ApplyUpdateDelta(const Tuple &base, bool redo, Tuple *result) const {
+  const char *delta = update_delta_.data();
+  size_t delta_size = update_delta_.size();
+  if (delta_size < static_cast<size_t>(DELTA_HEADER_SIZE)) {
+    return false;
+  }
+  uint32_t old_size = ReadUint16(delta);
+  uint32_t new_size = ReadUint16(delta + sizeof(uint16_t));
+  uint32_t range_count = ReadUint16(delta + 2 * sizeof(uint16_t));
+  uint32_t base_size = redo ? old_size : new_size;
+  uint32_t result_size = redo ? new_size : old_size;
+  if (base.GetLength() != base_size) {
+    return false;
+  }
+
+  // Build the serialized form of the result, | size | data |, so that the tuple can deserialize itself from it.
+  std::vector<char> storage(sizeof(int32_t) + result_size);
+  memcpy(storage.data(), &result_size, sizeof(int32_t));
+  char *out = storage.data() + sizeof(int32_t);
+  const char *base_data = base.GetData();
+  uint32_t base_pos = 0;
+  uint32_t out_pos = 0;
+  // ranges are logged with old tuple offsets, which shift by the size changes of the ranges before them
+  int64_t shift = 0;
+  size_t pos = DELTA_HEADER_SIZE;
+  for (uint32_t i = 0; i < range_count; i++) {
+    if (pos + DELTA_HEADER_SIZE > delta_size) {
+      return false;
+    }
+    uint32_t offset = ReadUint16(delta + pos);
+    uint32_t old_length = ReadUint16(delta + pos + sizeof(uint16_t));
+    uint32_t new_length = ReadUint16(delta + pos + 2 * sizeof(uint16_t));
+    pos += DELTA_HEADER_SIZE;
+    if (pos + old_length + new_length > delta_size) {
+      return false;
+    }
+    int64_t base_offset = redo ? offset : offset + shift;
+    uint32_t base_length = redo ? old_length : new_length;
+    uint32_t replace_length = redo ? new_length : old_length;
+    const char *replaced = delta + pos + (redo ? 0 : old_length);
+    const char *replacement = delta + pos + (redo ? old_length : 0);
+    if (base_offset < base_pos || base_offset + base_length > base_size ||
+        out_pos + (base_offset - base_pos) + replace_length > result_size) {
+      return false;
+    }
+    // the base must hold the bytes the update replaced, e.g. redo must not run on the new tuple once more
+    if (memcmp(base_data + base_offset, replaced, base_length) != 0) {
+      return false;
+    }
+    memcpy(out + out_pos, base_data + base_pos, base_offset - base_pos);
+    out_pos += base_offset - base_pos;
+    memcpy(out + out_pos, replacement, replace_length);
+    out_pos += replace_length;
+    base_pos = base_offset + base_length;
+    shift += static_cast<int64_t>(new_length) - old_length;
+    pos += old_length + new_length;
+  }
+  if (out_pos + (base_size - base_pos) != result_size) {
+    return false;
+  }
+  memcpy(out + out_pos, base_data + base_pos, base_size - base_pos);
+  result->DeserializeFrom(storage.data());
+  return true;
+}
+
+}  // namespace bustub
@@ -12,15 +12,86 @@
 
 #include "recovery/log_recovery.h"
 
+#include <atomic>
+#include <utility>
+
 #include "storage/page/table_page.h"
 
 namespace bustub {
 /*
  * deserialize a log record from log buffer
  * @return: true means deserialize succeed, otherwise can't deserialize cause
- * incomplete log record
+ * incomplete log record or the checksum does not match
  */
-bool LogRecovery::DeserializeLogRecord(const char *data, LogRecord *log_record) { return false; }
+bool LogRecovery::DeserializeLogRecord(const char *data, LogRecord *log_record) {
+  int32_t size;
+  LogRecordType type;
+  uint32_t checksum;
+  memcpy(&size, data, sizeof(int32_t));
+  memcpy(&type, data + 16, sizeof(LogRecordType));
+  memcpy(&checksum, data + LogRecord::CHECKSUM_OFFSET, sizeof(uint32_t));
+  // A zeroed or garbage header means we ran past the end of the log, a bad checksum that the record is torn.
+  if (size < LogRecord::HEADER_SIZE || size > LOG_BUFFER_SIZE || type <= LogRecordType::INVALID ||
+      type > LogRecordType::CLR || checksum != LogRecord::ComputeChecksum(data, size)) {
+    return false;
+  }
+
+  log_record->size_ = size;
+  log_record->log_record_type_ = type;
+  memcpy(&log_record->lsn_, data + 4, sizeof(lsn_t));
+  memcpy(&log_record->txn_id_, data + 8, sizeof(txn_id_t));
+  memcpy(&log_record->prev_lsn_, data + 12, sizeof(lsn_t));
+  const char *pos = data + LogRecord::HEADER_SIZE;
+  if (type == LogRecordType::CLR) {
+    memcpy(&log_record->undo_next_lsn_, pos, sizeof(lsn_t));
+    memcpy(&log_record->compensation_type_, pos + sizeof(lsn_t), sizeof(LogRecordType));
+    pos += sizeof(lsn_t) + sizeof(LogRecordType);
+    LogRecordType compensation_type = log_record->compensation_type_;
+    if (compensation_type < LogRecordType::INSERT || compensation_type > LogRecordType::UPDATE) {
+      return false;
+    }
+  }
+
+  switch (log_record->GetOperationType()) {
+    case LogRecordType::INSERT:
+      memcpy(&log_record->insert_rid_, pos, sizeof(RID));
+      log_record->insert_tuple_.DeserializeFrom(pos + sizeof(RID));
+      break;
+    case LogRecordType::MARKDELETE:
+    case LogRecordType::APPLYDELETE:
+    case LogRecordType::ROLLBACKDELETE:
+      memcpy(&log_record->delete_rid_, pos, sizeof(RID));
+      log_record->delete_tuple_.DeserializeFrom(pos + sizeof(RID));
+      break;
+    case LogRecordType::UPDATE:
+      memcpy(&log_record->update_rid_, pos, sizeof(RID));
+      pos += sizeof(RID);
+      log_record->update_delta_.assign(pos, data + size);
+      break;
+    case LogRecordType::NEWPAGE:
+      memcpy(&log_record->prev_page_id_, pos, sizeof(page_id_t));
+      memcpy(&log_record->page_id_, pos + sizeof(page_id_t), sizeof(page_id_t));
+      break;
+    default:
+      break;
+  }
+  return true;
+}
+
+page_id_t LogRecovery::GetTuplePageId(const LogRecord &log_record) {
+  switch (log_record.GetOperationType()) {
+    case LogRecordType::INSERT:
+      return log_record.insert_rid_.GetPageId();
+    case LogRecordType::MARKDELETE:
+    case LogRecordType::APPLYDELETE:
+    case LogRecordType::ROLLBACKDELETE:
+      return log_record.delete_rid_.GetPageId();
+    case LogRecordType::UPDATE:
+      return log_record.update_rid_.GetPageId();
+    default:
+      return INVALID_PAGE_ID;
+  }
+}
 
 /*
  *redo phase on TABLE PAGE level(table/table_page.h)
@@ -29,12 +100,334 @@ bool LogRecovery::DeserializeLogRecord(const char *data, LogRecord *log_record)
  *LSN with log_record's sequence number, and also build active_txn_ table &
  *lsn_mapping_ table
  */
-void LogRecovery::Redo() {}
+void LogRecovery::Redo() {
+  active_txn_.clear();
+  lsn_mapping_.clear();
+  first_lsn_ = INVALID_LSN;
+
+  std::vector<std::unique_ptr<Channel<RedoBatch>>> queues;
+  std::vector<RedoBatch> pending(num_workers_);
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < num_workers_; i++) {
+    queues.emplace_back(std::make_unique<Channel<RedoBatch>>(REDO_QUEUE_DEPTH));
+    workers.emplace_back(&LogRecovery::RedoWorker, this, i, queues.back().get());
+  }
+
+  auto dispatch = [&](size_t worker_id, std::unique_ptr<LogRecord> &&log_record) {
+    pending[worker_id].push_back(std::move(log_record));
+    if (pending[worker_id].size() == REDO_BATCH_SIZE) {
+      queues[worker_id]->Put(std::move(pending[worker_id]));
+      pending[worker_id] = RedoBatch();
+      pending[worker_id].reserve(REDO_BATCH_SIZE);
+    }
+  };
+
+  // The log is consumed one large sequential read at a time. A record straddling the end of the buffer is read again
+  // at the start of the next chunk. Segments dropped by earlier checkpoints are no longer needed.
+  size_t file_offset = disk_manager_->GetLogStartOffset();
+  bool end_of_log = false;
+  while (!end_of_log && disk_manager_->ReadLog(log_buffer_, LOG_READ_BUFFER_SIZE, file_offset)) {
+    int pos = 0;
+    while (pos + LogRecord::HEADER_SIZE <= LOG_READ_BUFFER_SIZE) {
+      int32_t size;
+      memcpy(&size, log_buffer_ + pos, sizeof(int32_t));
+      if (size < LogRecord::HEADER_SIZE || size > LOG_BUFFER_SIZE) {
+        end_of_log = true;
+        break;
+      }
+      if (pos + size > LOG_READ_BUFFER_SIZE) {
+        break;
+      }
+      auto log_record = std::make_unique<LogRecord>();
+      if (!DeserializeLogRecord(log_buffer_ + pos, log_record.get())) {
+        end_of_log = true;
+        break;
+      }
+
+      if (first_lsn_ == INVALID_LSN) {
+        first_lsn_ = log_record->lsn_;
+      }
+      BUSTUB_ASSERT(static_cast<size_t>(log_record->lsn_ - first_lsn_) == lsn_mapping_.size(), "LSNs must be dense.");
+      lsn_mapping_.push_back(file_offset + pos);
+      pos += size;
+
+      switch (log_record->log_record_type_) {
+        case LogRecordType::BEGIN:
+          active_txn_[log_record->txn_id_] = log_record->lsn_;
+          break;
+        case LogRecordType::COMMIT:
+        case LogRecordType::ABORT:
+          active_txn_.erase(log_record->txn_id_);
+          break;
+        case LogRecordType::NEWPAGE: {
+          active_txn_[log_record->txn_id_] = log_record->lsn_;
+          // Linking the new page into the table touches the previous page, which may belong to another worker.
+          size_t owner = RedoPartition(log_record->page_id_);
+          if (log_record->prev_page_id_ != INVALID_PAGE_ID && RedoPartition(log_record->prev_page_id_) != owner) {
+            dispatch(RedoPartition(log_record->prev_page_id_), std::make_unique<LogRecord>(*log_record));
+          }
+          dispatch(owner, std::move(log_record));
+          break;
+        }
+        default:
+          active_txn_[log_record->txn_id_] = log_record->lsn_;
+          dispatch(RedoPartition(GetTuplePageId(*log_record)), std::move(log_record));
+          break;
+      }
+    }
+    if (pos == 0) {
+      break;
+    }
+    file_offset += pos;
+  }
+  // Whatever follows the last valid record was torn by a crash. Cut it off so that new log records directly follow
+  // the valid ones.
+  if (end_of_log) {
+    disk_manager_->TruncateLogTail(file_offset);
+  }
+  // Compensation log records written by Undo continue where the log left off.
+  if (log_manager_ != nullptr && first_lsn_ != INVALID_LSN) {
+    log_manager_->ResetLSN(first_lsn_ + static_cast<lsn_t>(lsn_mapping_.size()));
+  }
+
+  // Drain the partially filled batches, then tell every worker to stop with an empty batch.
+  for (size_t i = 0; i < num_workers_; i++) {
+    if (!pending[i].empty()) {
+      queues[i]->Put(std::move(pending[i]));
+    }
+    queues[i]->Put(RedoBatch());
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+}
+
+void LogRecovery::RedoWorker(size_t worker_id, Channel<RedoBatch> *queue) {
+  for (RedoBatch batch = queue->Get(); !batch.empty(); batch = queue->Get()) {
+    for (auto &log_record : batch) {
+      RedoLogRecord(log_record.get(), worker_id);
+    }
+  }
+}
+
+void LogRecovery::RedoLogRecord(LogRecord *log_record, size_t worker_id) {
+  if (log_record->log_record_type_ == LogRecordType::NEWPAGE) {
+    page_id_t page_id = log_record->page_id_;
+    page_id_t prev_page_id = log_record->prev_page_id_;
+    if (RedoPartition(page_id) == worker_id) {
+      auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+      BUSTUB_ASSERT(page != nullptr, "Every redo worker must be able to pin its pages.");
+      page->WLatch();
+      bool redo = page->GetTablePageId() != page_id || page->GetLSN() < log_record->lsn_;
+      if (redo) {
+        page->Init(page_id, PAGE_SIZE, prev_page_id, nullptr, nullptr);
+        page->SetLSN(log_record->lsn_);
+      }
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page_id, redo);
+    }
+    if (prev_page_id != INVALID_PAGE_ID && RedoPartition(prev_page_id) == worker_id) {
+      auto prev_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(prev_page_id));
+      BUSTUB_ASSERT(prev_page != nullptr, "Every redo worker must be able to pin its pages.");
+      prev_page->WLatch();
+      bool redo = prev_page->GetNextPageId() == INVALID_PAGE_ID;
+      if (redo) {
+        prev_page->SetNextPageId(page_id);
+      }
+      prev_page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(prev_page_id, redo);
+    }
+    return;
+  }
+
+  page_id_t page_id = GetTuplePageId(*log_record);
+  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  BUSTUB_ASSERT(page != nullptr, "Every redo worker must be able to pin its pages.");
+  page->WLatch();
+  bool redo = page->GetLSN() < log_record->lsn_;
+  if (redo) {
+    switch (log_record->GetOperationType()) {
+      case LogRecordType::INSERT: {
+        RID rid;
+        page->InsertTuple(log_record->insert_tuple_, &rid, nullptr, nullptr, nullptr);
+        BUSTUB_ASSERT(rid == log_record->insert_rid_, "Redo must place the tuple in its original slot.");
+        break;
+      }
+      case LogRecordType::MARKDELETE:
+        page->MarkDelete(log_record->delete_rid_, nullptr, nullptr, nullptr);
+        break;
+      case LogRecordType::APPLYDELETE:
+        page->ApplyDelete(log_record->delete_rid_, nullptr, nullptr);
+        break;
+      case LogRecordType::ROLLBACKDELETE:
+        page->RollbackDelete(log_record->delete_rid_, nullptr, nullptr);
+        break;
+      case LogRecordType::UPDATE: {
+        // The page holds the old tuple, since it has not seen this update yet.
+        Tuple old_tuple;
+        Tuple new_tuple;
+        if (page->GetTuple(log_record->update_rid_, &old_tuple, nullptr, nullptr) &&
+            log_record->ApplyUpdateDelta(old_tuple, true, &new_tuple)) {
+          page->UpdateTuple(new_tuple, &old_tuple, log_record->update_rid_, nullptr, nullptr, nullptr);
+        }
+        break;
+      }
+      default:
+        break;
+    }
+    page->SetLSN(log_record->lsn_);
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, redo);
+}
+
+bool LogRecovery::ReadLogRecord(lsn_t lsn, LogRecord *log_record) {
+  size_t index = static_cast<size_t>(lsn - first_lsn_);
+  if (lsn < first_lsn_ || index >= lsn_mapping_.size()) {
+    return false;
+  }
+  // Read the header first to learn how large the record is, then the whole record.
+  char header[LogRecord::HEADER_SIZE];
+  int32_t size;
+  if (!log_reader_->Read(header, LogRecord::HEADER_SIZE, lsn_mapping_[index])) {
+    return false;
+  }
+  memcpy(&size, header, sizeof(int32_t));
+  if (size < LogRecord::HEADER_SIZE || size > LOG_BUFFER_SIZE) {
+    return false;
+  }
+  std::vector<char> data(size);
+  if (!log_reader_->Read(data.data(), size, lsn_mapping_[index])) {
+    return false;
+  }
+  return DeserializeLogRecord(data.data(), log_record);
+}
 
 /*
  *undo phase on TABLE PAGE level(table/table_page.h)
  *iterate through active txn map and undo each operation
  */
-void LogRecovery::Undo() {}
+bool LogRecovery::Undo() {
+  // Every worker rolls back its own subset of the losers. Strict 2PL kept the losers off each other's tuples, so
+  // their changes can be undone independently; within a transaction they are undone newest first.
+  log_reader_ = std::make_unique<LogReader>(disk_manager_);
+  std::vector<std::vector<std::pair<txn_id_t, lsn_t>>> partitions(num_workers_);
+  for (const auto &txn : active_txn_) {
+    partitions[static_cast<size_t>(txn.first) % num_workers_].push_back(txn);
+  }
+  std::atomic<bool> complete{true};
+  std::vector<std::thread> workers;
+  for (const auto &partition : partitions) {
+    if (partition.empty()) {
+      continue;
+    }
+    workers.emplace_back([this, &partition, &complete] {
+      for (const auto &txn : partition) {
+        if (!UndoTransaction(txn.first, txn.second)) {
+          complete = false;
+        }
+      }
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  if (log_manager_ != nullptr) {
+    log_manager_->Flush();
+  }
+  log_reader_.reset();
+  active_txn_.clear();
+  return complete;
+}
+
+bool LogRecovery::UndoTransaction(txn_id_t txn_id, lsn_t last_lsn) {
+  lsn_t prev_lsn = last_lsn;
+  lsn_t lsn = last_lsn;
+  while (lsn != INVALID_LSN) {
+    LogRecord log_record;
+    if (!ReadLogRecord(lsn, &log_record)) {
+      return false;
+    }
+    if (log_record.log_record_type_ == LogRecordType::BEGIN) {
+      break;
+    }
+    if (log_record.log_record_type_ == LogRecordType::CLR) {
+      // Undone before an earlier crash, skip ahead to what was left to do.
+      lsn = log_record.undo_next_lsn_;
+      continue;
+    }
+    if (!UndoLogRecord(&log_record, &prev_lsn)) {
+      // The changes before it stay in place too, the transaction is still a loser.
+      return false;
+    }
+    lsn = log_record.prev_lsn_;
+  }
+  if (log_manager_ != nullptr) {
+    // The transaction is finished, so the next recovery does not consider it a loser.
+    LogRecord abort(txn_id, prev_lsn, LogRecordType::ABORT);
+    log_manager_->AppendLogRecord(&abort);
+  }
+  return true;
+}
+
+bool LogRecovery::UndoLogRecord(LogRecord *log_record, lsn_t *prev_lsn) {
+  page_id_t page_id = GetTuplePageId(*log_record);
+  if (page_id == INVALID_PAGE_ID) {
+    // BEGIN and NEWPAGE records leave nothing to revert; an empty page stays linked into its table.
+    return true;
+  }
+  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  BUSTUB_ASSERT(page != nullptr, "Undo must be able to pin the page.");
+  page->WLatch();
+  // The compensating change, which is logged in a CLR.
+  LogRecord compensation;
+  bool undone = true;
+  switch (log_record->log_record_type_) {
+    case LogRecordType::INSERT:
+      page->ApplyDelete(log_record->insert_rid_, nullptr, nullptr);
+      compensation = LogRecord(log_record->txn_id_, INVALID_LSN, LogRecordType::APPLYDELETE, log_record->insert_rid_,
+                               log_record->insert_tuple_);
+      break;
+    case LogRecordType::MARKDELETE:
+      page->RollbackDelete(log_record->delete_rid_, nullptr, nullptr);
+      compensation = LogRecord(log_record->txn_id_, INVALID_LSN, LogRecordType::ROLLBACKDELETE,
+                               log_record->delete_rid_, log_record->delete_tuple_);
+      break;
+    case LogRecordType::APPLYDELETE: {
+      RID rid;
+      undone = page->InsertTuple(log_record->delete_tuple_, &rid, nullptr, nullptr, nullptr);
+      compensation =
+          LogRecord(log_record->txn_id_, INVALID_LSN, LogRecordType::INSERT, rid, log_record->delete_tuple_);
+      break;
+    }
+    case LogRecordType::ROLLBACKDELETE:
+      undone = page->MarkDelete(log_record->delete_rid_, nullptr, nullptr, nullptr);
+      compensation = LogRecord(log_record->txn_id_, INVALID_LSN, LogRecordType::MARKDELETE, log_record->delete_rid_,
+                               log_record->delete_tuple_);
+      break;
+    case LogRecordType::UPDATE: {
+      Tuple old_tuple;
+      Tuple new_tuple;
+      undone = page->GetTuple(log_record->update_rid_, &new_tuple, nullptr, nullptr) &&
+               log_record->ApplyUpdateDelta(new_tuple, false, &old_tuple) &&
+               page->UpdateTuple(old_tuple, &new_tuple, log_record->update_rid_, nullptr, nullptr, nullptr);
+      if (undone) {
+        compensation = LogRecord(log_record->txn_id_, INVALID_LSN, LogRecordType::UPDATE, log_record->update_rid_,
+                                 new_tuple, old_tuple);
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  if (undone && log_manager_ != nullptr) {
+    LogRecord clr(log_record->txn_id_, *prev_lsn, compensation, log_record->prev_lsn_);
+    *prev_lsn = log_manager_->AppendLogRecord(&clr);
+    page->SetLSN(*prev_lsn);
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, true);
+  return undone;
+}
 
 }  // namespace bustub
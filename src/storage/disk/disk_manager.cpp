@@ -11,13 +11,18 @@
 //===----------------------------------------------------------------------===//
 
 #include <sys/stat.h>
+#include <algorithm>
 #include <cassert>
+#include <cstdio>
 #include <cstring>
+#include <filesystem>
 #include <iostream>
+#include <iterator>
 #include <string>
 #include <thread>  // NOLINT
 
 #include "common/logger.h"
+#include "common/util/hash_util.h"
 #include "storage/disk/disk_manager.h"
 
 namespace bustub {
@@ -25,7 +30,7 @@ namespace bustub {
 static char *buffer_used;
 
 /**
- * Constructor: open/create a single database file & log file
+ * Constructor: open/create a single database file & find the existing log segments
  * @input db_file: database file name
  */
 DiskManager::DiskManager(const std::string &db_file)
@@ -36,17 +41,8 @@ DiskManager::DiskManager(const std::string &db_file)
     return;
   }
   log_name_ = file_name_.substr(0, n) + ".log";
-
-  log_io_.open(log_name_, std::ios::binary | std::ios::in | std::ios::app | std::ios::out);
-  // directory or file does not exist
-  if (!log_io_.is_open()) {
-    log_io_.clear();
-    // create a new file
-    log_io_.open(log_name_, std::ios::binary | std::ios::trunc | std::ios::app | std::ios::out);
-    log_io_.close();
-    // reopen with original mode
-    log_io_.open(log_name_, std::ios::binary | std::ios::in | std::ios::app | std::ios::out);
-  }
+  // Segment files are only created once the first log record is written.
+  LoadLogSegments();
 
   db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out | std::ios::out);
   // directory or file does not exist
@@ -66,7 +62,9 @@ DiskManager::DiskManager(const std::string &db_file)
  */
 void DiskManager::ShutDown() {
   db_io_.close();
+  std::lock_guard<std::mutex> guard(log_latch_);
   log_io_.close();
+  log_read_io_.close();
 }
 
 /**
@@ -91,11 +89,12 @@ void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
  * Read the contents of the specified page into the given memory area
  */
 void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
-  int offset = page_id * PAGE_SIZE;
+  size_t offset = static_cast<size_t>(page_id) * PAGE_SIZE;
   // check if read beyond file length
-  if (offset > GetFileSize(file_name_)) {
+  if (static_cast<int64_t>(offset) > GetFileSize(file_name_)) {
     LOG_DEBUG("I/O error while reading");
-    // std::cerr << "I/O error while reading" << std::endl;
+    // a page that was never written reads back as zeroes
+    memset(page_data, 0, PAGE_SIZE);
   } else {
     // set read cursor to offset
     db_io_.seekp(offset);
@@ -105,6 +104,7 @@ void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
     if (read_count < PAGE_SIZE) {
       LOG_DEBUG("Read less than a page");
       // std::cerr << "Read less than a page" << std::endl;
+      db_io_.clear();
       memset(page_data + read_count, 0, PAGE_SIZE - read_count);
     }
   }
@@ -114,7 +114,7 @@ void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
  * Write the contents of the log into disk file
  * Only return when sync is done, and only perform sequence write
  */
-void DiskManager::WriteLog(char *log_data, int size) {
+void DiskManager::WriteLog(char *log_data, int size, lsn_t first_lsn) {
   // enforce swap log buffer
   assert(log_data != buffer_used);
   buffer_used = log_data;
@@ -130,7 +130,16 @@ void DiskManager::WriteLog(char *log_data, int size) {
     assert(flush_log_f_->wait_for(std::chrono::seconds(10)) == std::future_status::ready);
   }
 
+  std::lock_guard<std::mutex> guard(log_latch_);
   num_flushes_ += 1;
+  // The segment being written to is always the last one. Move on to a new segment rather than splitting the buffer,
+  // so that every segment starts with a whole log record.
+  LogSegment *segment = log_io_.is_open() ? &std::prev(log_segments_.end())->second : nullptr;
+  if (segment == nullptr || (segment->size_ > 0 && segment->size_ + size > log_segment_size_)) {
+    StartLogSegment(first_lsn);
+    segment = &std::prev(log_segments_.end())->second;
+  }
+
   // sequence write
   log_io_.write(log_data, size);
 
@@ -141,32 +150,148 @@ void DiskManager::WriteLog(char *log_data, int size) {
   }
   // needs to flush to keep disk file in sync
   log_io_.flush();
+  segment->size_ += size;
   flush_log_ = false;
 }
 
 /**
  * Read the contents of the log into the given memory area
- * Always read from the beginning and perform sequence read
+ * Reads may span several segments, and stop early at a hole left by a missing segment
  * @return: false means already reach the end
  */
-bool DiskManager::ReadLog(char *log_data, int size, int offset) {
-  if (offset >= GetFileSize(log_name_)) {
-    // LOG_DEBUG("end of log file");
-    // LOG_DEBUG("file size is %d", GetFileSize(log_name_));
+bool DiskManager::ReadLog(char *log_data, int size, size_t offset) {
+  std::lock_guard<std::mutex> guard(log_latch_);
+  auto segment = log_segments_.upper_bound(offset);
+  if (segment == log_segments_.begin()) {
     return false;
   }
-  log_io_.seekp(offset);
-  log_io_.read(log_data, size);
-  // if log file ends before reading "size"
-  int read_count = log_io_.gcount();
-  if (read_count < size) {
-    log_io_.clear();
-    memset(log_data + read_count, 0, size - read_count);
+  --segment;
+  if (offset >= segment->first + segment->second.size_) {
+    return false;
   }
 
+  int read_count = 0;
+  size_t position = offset;
+  while (read_count < size && segment != log_segments_.end() && segment->first <= position) {
+    size_t segment_end = segment->first + segment->second.size_;
+    if (position < segment_end) {
+      if (!log_read_io_.is_open() || read_segment_no_ != segment->second.segment_no_) {
+        log_read_io_.close();
+        log_read_io_.clear();
+        log_read_io_.open(GetLogSegmentFileName(segment->second.segment_no_), std::ios::binary);
+        read_segment_no_ = segment->second.segment_no_;
+      }
+      auto chunk = static_cast<int>(std::min<size_t>(size - read_count, segment_end - position));
+      log_read_io_.seekg(sizeof(LogSegmentHeader) + position - segment->first);
+      log_read_io_.read(log_data + read_count, chunk);
+      int count = log_read_io_.gcount();
+      // the segment may be shorter than expected if it is still being written
+      log_read_io_.clear();
+      read_count += count;
+      position += count;
+      if (count < chunk) {
+        break;
+      }
+    }
+    ++segment;
+  }
+  memset(log_data + read_count, 0, size - read_count);
   return true;
 }
 
+size_t DiskManager::GetLogStartOffset() {
+  std::lock_guard<std::mutex> guard(log_latch_);
+  return log_segments_.empty() ? 0 : log_segments_.begin()->first;
+}
+
+/**
+ * Drop (or archive) the oldest segments as long as the next segment starts at or before the redo point
+ */
+size_t DiskManager::TruncateLog(lsn_t redo_lsn) {
+  std::lock_guard<std::mutex> guard(log_latch_);
+  size_t num_dropped = 0;
+  while (log_segments_.size() > 1) {
+    auto segment = log_segments_.begin();
+    // every record in a segment precedes the first record of the following segment
+    if (std::next(segment)->second.first_lsn_ > redo_lsn) {
+      break;
+    }
+    if (log_read_io_.is_open() && read_segment_no_ == segment->second.segment_no_) {
+      log_read_io_.close();
+    }
+
+    std::string segment_file = GetLogSegmentFileName(segment->second.segment_no_);
+    std::error_code ec;
+    if (log_archive_dir_.empty()) {
+      std::filesystem::remove(segment_file, ec);
+    } else {
+      std::filesystem::path target =
+          std::filesystem::path(log_archive_dir_) / std::filesystem::path(segment_file).filename();
+      std::filesystem::rename(segment_file, target, ec);
+      if (ec) {
+        // rename does not work across file systems
+        ec.clear();
+        std::filesystem::copy_file(segment_file, target, std::filesystem::copy_options::overwrite_existing, ec);
+        if (!ec) {
+          std::filesystem::remove(segment_file, ec);
+        }
+      }
+    }
+    if (ec) {
+      LOG_DEBUG("failed to drop log segment %s", segment_file.c_str());
+      break;
+    }
+    log_segments_.erase(segment);
+    num_dropped++;
+  }
+  return num_dropped;
+}
+
+/**
+ * Drop the log segments after offset and shorten the one containing it
+ */
+void DiskManager::TruncateLogTail(size_t offset) {
+  std::lock_guard<std::mutex> guard(log_latch_);
+  if (log_io_.is_open()) {
+    log_io_.close();
+  }
+  log_read_io_.close();
+  while (!log_segments_.empty()) {
+    auto segment = std::prev(log_segments_.end());
+    if (segment->first + segment->second.size_ <= offset) {
+      break;
+    }
+    std::string segment_file = GetLogSegmentFileName(segment->second.segment_no_);
+    std::error_code ec;
+    if (segment->first < offset) {
+      segment->second.size_ = offset - segment->first;
+      std::filesystem::resize_file(segment_file, sizeof(LogSegmentHeader) + segment->second.size_, ec);
+      break;
+    }
+    std::filesystem::remove(segment_file, ec);
+    log_segments_.erase(segment);
+  }
+}
+
+void DiskManager::SetLogSegmentSize(size_t log_segment_size) {
+  std::lock_guard<std::mutex> guard(log_latch_);
+  log_segment_size_ = log_segment_size;
+}
+
+void DiskManager::SetLogArchiveDirectory(const std::string &archive_dir) {
+  std::lock_guard<std::mutex> guard(log_latch_);
+  log_archive_dir_ = archive_dir;
+  if (!log_archive_dir_.empty()) {
+    std::error_code ec;
+    std::filesystem::create_directories(log_archive_dir_, ec);
+  }
+}
+
+size_t DiskManager::GetNumLogSegments() {
+  std::lock_guard<std::mutex> guard(log_latch_);
+  return log_segments_.size();
+}
+
 /**
  * Allocate new page (operations like create index/table)
  * For now just keep an increasing counter
@@ -198,10 +323,80 @@ bool DiskManager::GetFlushState() const { return flush_log_; }
 /**
  * Private helper function to get disk file size
  */
-int DiskManager::GetFileSize(const std::string &file_name) {
+int64_t DiskManager::GetFileSize(const std::string &file_name) {
   struct stat stat_buf;
   int rc = stat(file_name.c_str(), &stat_buf);
-  return rc == 0 ? static_cast<int>(stat_buf.st_size) : -1;
+  return rc == 0 ? static_cast<int64_t>(stat_buf.st_size) : -1;
+}
+
+/**
+ * Private helper function to get the file name of a log segment, e.g. test.log.00000003
+ */
+std::string DiskManager::GetLogSegmentFileName(uint32_t segment_no) const {
+  char suffix[16];
+  snprintf(suffix, sizeof(suffix), ".%08u", segment_no);
+  return log_name_ + suffix;
+}
+
+uint32_t DiskManager::LogSegmentChecksum(const LogSegmentHeader &header) {
+  LogSegmentHeader copy = header;
+  copy.checksum_ = 0;
+  return HashUtil::Crc32c(reinterpret_cast<const char *>(&copy), sizeof(copy));
+}
+
+/**
+ * Private helper function to rebuild the segment map from the segment files in the log directory
+ * Segments with a damaged header are ignored
+ */
+void DiskManager::LoadLogSegments() {
+  std::filesystem::path log_path(log_name_);
+  std::filesystem::path log_dir = log_path.has_parent_path() ? log_path.parent_path() : std::filesystem::path(".");
+  std::string prefix = log_path.filename().string() + ".";
+
+  std::error_code ec;
+  for (const auto &entry : std::filesystem::directory_iterator(log_dir, ec)) {
+    std::string name = entry.path().filename().string();
+    if (name.size() == prefix.size() || name.compare(0, prefix.size(), prefix) != 0 ||
+        name.find_first_not_of("0123456789", prefix.size()) != std::string::npos) {
+      continue;
+    }
+    std::ifstream segment_io(entry.path(), std::ios::binary);
+    LogSegmentHeader header;
+    segment_io.read(reinterpret_cast<char *>(&header), sizeof(header));
+    if (segment_io.gcount() != sizeof(header) || header.magic_ != LOG_SEGMENT_MAGIC ||
+        header.checksum_ != LogSegmentChecksum(header)) {
+      LOG_DEBUG("ignoring damaged log segment %s", name.c_str());
+      continue;
+    }
+    auto size = static_cast<size_t>(GetFileSize(entry.path().string())) - sizeof(header);
+    log_segments_[header.start_offset_] = LogSegment{header.segment_no_, header.first_lsn_, size};
+    next_segment_no_ = std::max(next_segment_no_, header.segment_no_ + 1);
+  }
+}
+
+/**
+ * Private helper function to close the current log segment and open the next one, appending it to the logical log
+ * Requires log_latch_ to be held
+ */
+void DiskManager::StartLogSegment(lsn_t first_lsn) {
+  size_t start_offset = 0;
+  if (!log_segments_.empty()) {
+    auto last = std::prev(log_segments_.end());
+    start_offset = last->first + last->second.size_;
+  }
+  if (log_io_.is_open()) {
+    log_io_.close();
+  }
+
+  LogSegmentHeader header{LOG_SEGMENT_MAGIC, next_segment_no_, first_lsn, 0, start_offset};
+  header.checksum_ = LogSegmentChecksum(header);
+  log_io_.clear();
+  log_io_.open(GetLogSegmentFileName(next_segment_no_), std::ios::binary | std::ios::trunc | std::ios::out);
+  log_io_.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  log_io_.flush();
+
+  log_segments_[start_offset] = LogSegment{next_segment_no_, first_lsn, 0};
+  next_segment_no_++;
 }
 
 }  // namespace bustub
@@ -0,0 +1,564 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree.cpp
+//
+// Identification: src/storage/index/b_plus_tree.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/rid.h"
+#include "storage/index/b_plus_tree.h"
+
+namespace bustub {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+BPLUSTREE_TYPE::BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
+                          int leaf_max_size, int internal_max_size)
+    : index_name_(std::move(name)),
+      buffer_pool_manager_(buffer_pool_manager),
+      comparator_(comparator),
+      leaf_max_size_(leaf_max_size),
+      internal_max_size_(internal_max_size) {
+  BUSTUB_ASSERT(leaf_max_size >= 2 && leaf_max_size <= static_cast<int>(LEAF_PAGE_SIZE),
+                "A leaf must hold at least 2 entries and fit into a page.");
+  BUSTUB_ASSERT(internal_max_size >= 3 && internal_max_size <= static_cast<int>(INTERNAL_PAGE_SIZE),
+                "An internal page must hold at least 3 children and fit into a page.");
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool BPLUSTREE_TYPE::IsEmpty() {
+  root_latch_.RLock();
+  bool is_empty = root_page_id_ == INVALID_PAGE_ID;
+  root_latch_.RUnlock();
+  return is_empty;
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction) {
+  root_latch_.RLock();
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    root_latch_.RUnlock();
+    return false;
+  }
+  bool is_root;
+  Page *page = FindLeaf(&key, false, &is_root);
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  ValueType value;
+  bool found = leaf->Lookup(key, &value, comparator_);
+  if (found) {
+    result->push_back(value);
+  }
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  return found;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) {
+  // Most inserts only change a leaf, try with read latches on the way down first.
+  root_latch_.RLock();
+  if (root_page_id_ != INVALID_PAGE_ID) {
+    bool is_root;
+    Page *page = FindLeaf(&key, true, &is_root);
+    auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    ValueType existing;
+    bool exists = leaf->Lookup(key, &existing, comparator_);
+    bool safe = IsSafe(leaf, Operation::INSERT, is_root);
+    if (!exists && safe) {
+      leaf->Insert(key, value, comparator_);
+    }
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), !exists && safe);
+    if (exists || safe) {
+      return !exists;
+    }
+  } else {
+    root_latch_.RUnlock();
+  }
+  return InsertPessimistic(key, value);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool BPLUSTREE_TYPE::InsertPessimistic(const KeyType &key, const ValueType &value) {
+  LatchedPath path;
+  Page *page = FindLeafPessimistic(key, Operation::INSERT, &path);
+  if (page == nullptr) {
+    // The tree is empty, start a new one with a single leaf as its root.
+    page_id_t root_page_id;
+    auto *root = reinterpret_cast<LeafPage *>(NewPage(&root_page_id)->GetData());
+    root->Init(root_page_id, leaf_max_size_);
+    root->Insert(key, value, comparator_);
+    buffer_pool_manager_->UnpinPage(root_page_id, true);
+    root_page_id_ = root_page_id;
+    ReleasePath(&path, true);
+    return true;
+  }
+
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  if (!leaf->Insert(key, value, comparator_)) {
+    ReleasePath(&path, false);
+    return false;
+  }
+  if (leaf->GetSize() > leaf->GetMaxSize()) {
+    // The new leaf is only reachable through the latched leaf and parent, it does not have to be latched itself.
+    page_id_t new_page_id;
+    auto *new_leaf = reinterpret_cast<LeafPage *>(NewPage(&new_page_id)->GetData());
+    new_leaf->Init(new_page_id, leaf_max_size_);
+    leaf->MoveHalfTo(new_leaf);
+    new_leaf->SetNextPageId(leaf->GetNextPageId());
+    leaf->SetNextPageId(new_page_id);
+    KeyType separator = new_leaf->KeyAt(0);
+    buffer_pool_manager_->UnpinPage(new_page_id, true);
+    InsertIntoParent(&path, path.pages_.size() - 1, separator, new_page_id);
+  }
+  ReleasePath(&path, true);
+  return true;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void BPLUSTREE_TYPE::InsertIntoParent(LatchedPath *path, size_t level, const KeyType &key, page_id_t new_page_id) {
+  page_id_t old_page_id = path->pages_[level]->GetPageId();
+  if (level == 0) {
+    // Only a page that may split keeps the root latch, so the page is the root and the tree grows by a level.
+    BUSTUB_ASSERT(path->root_latched_ && old_page_id == root_page_id_, "Only the root has no latched parent.");
+    page_id_t root_page_id;
+    auto *root = reinterpret_cast<InternalPage *>(NewPage(&root_page_id)->GetData());
+    root->Init(root_page_id, internal_max_size_);
+    root->PopulateNewRoot(old_page_id, key, new_page_id);
+    buffer_pool_manager_->UnpinPage(root_page_id, true);
+    root_page_id_ = root_page_id;
+    return;
+  }
+
+  auto *parent = reinterpret_cast<InternalPage *>(path->pages_[level - 1]->GetData());
+  parent->InsertNodeAfter(old_page_id, key, new_page_id);
+  if (parent->GetSize() <= parent->GetMaxSize()) {
+    return;
+  }
+  page_id_t new_parent_page_id;
+  auto *new_parent = reinterpret_cast<InternalPage *>(NewPage(&new_parent_page_id)->GetData());
+  new_parent->Init(new_parent_page_id, internal_max_size_);
+  parent->MoveHalfTo(new_parent);
+  KeyType separator = new_parent->KeyAt(0);
+  buffer_pool_manager_->UnpinPage(new_parent_page_id, true);
+  InsertIntoParent(path, level - 1, separator, new_parent_page_id);
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
+  // Most removes only change a leaf, try with read latches on the way down first.
+  root_latch_.RLock();
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    root_latch_.RUnlock();
+    return false;
+  }
+  bool is_root;
+  Page *page = FindLeaf(&key, true, &is_root);
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  ValueType existing;
+  bool exists = leaf->Lookup(key, &existing, comparator_);
+  bool safe = IsSafe(leaf, Operation::REMOVE, is_root);
+  if (exists && safe) {
+    leaf->Remove(key, comparator_);
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), exists && safe);
+  if (!exists || safe) {
+    return exists;
+  }
+  return RemovePessimistic(key);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool BPLUSTREE_TYPE::RemovePessimistic(const KeyType &key) {
+  LatchedPath path;
+  Page *page = FindLeafPessimistic(key, Operation::REMOVE, &path);
+  if (page == nullptr) {
+    ReleasePath(&path, false);
+    return false;
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  if (!leaf->Remove(key, comparator_)) {
+    ReleasePath(&path, false);
+    return false;
+  }
+  std::vector<page_id_t> deleted_page_ids;
+  HandleUnderflow(&path, path.pages_.size() - 1, &deleted_page_ids);
+  ReleasePath(&path, true);
+  for (page_id_t page_id : deleted_page_ids) {
+    buffer_pool_manager_->DeletePage(page_id);
+  }
+  return true;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void BPLUSTREE_TYPE::HandleUnderflow(LatchedPath *path, size_t level, std::vector<page_id_t> *deleted_page_ids) {
+  Page *page = path->pages_[level];
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  if (level == 0) {
+    // The topmost latched page is either safe, or the root, which may shrink down to a single entry.
+    if (!path->root_latched_) {
+      return;
+    }
+    if (node->IsLeafPage() && node->GetSize() == 0) {
+      root_page_id_ = INVALID_PAGE_ID;
+      deleted_page_ids->push_back(page->GetPageId());
+    } else if (!node->IsLeafPage() && node->GetSize() == 1) {
+      root_page_id_ = reinterpret_cast<InternalPage *>(node)->RemoveAndReturnOnlyChild();
+      deleted_page_ids->push_back(page->GetPageId());
+    }
+    return;
+  }
+  if (node->GetSize() >= node->GetMinSize()) {
+    return;
+  }
+
+  auto *parent = reinterpret_cast<InternalPage *>(path->pages_[level - 1]->GetData());
+  int index = parent->ValueIndex(page->GetPageId());
+  int sibling_index = index == 0 ? 1 : index - 1;
+  Page *sibling_page = FetchPage(parent->ValueAt(sibling_index));
+  if (sibling_index < index) {
+    // Leaves are latched left to right by iterators as well; the parent keeps other writers away meanwhile.
+    page->WUnlatch();
+    sibling_page->WLatch();
+    page->WLatch();
+  } else {
+    sibling_page->WLatch();
+  }
+  auto *sibling = reinterpret_cast<BPlusTreePage *>(sibling_page->GetData());
+  int right_index = std::max(index, sibling_index);
+  BPlusTreePage *left = sibling_index < index ? sibling : node;
+  BPlusTreePage *right = sibling_index < index ? node : sibling;
+
+  if (left->GetSize() + right->GetSize() <= node->GetMaxSize()) {
+    // Merges the right page into the left one.
+    if (node->IsLeafPage()) {
+      reinterpret_cast<LeafPage *>(right)->MoveAllTo(reinterpret_cast<LeafPage *>(left));
+    } else {
+      reinterpret_cast<InternalPage *>(right)->MoveAllTo(reinterpret_cast<InternalPage *>(left),
+                                                          parent->KeyAt(right_index));
+    }
+    parent->Remove(right_index);
+    deleted_page_ids->push_back(right->GetPageId());
+  } else {
+    // Moves one entry over from the sibling.
+    if (node->IsLeafPage() && sibling_index < index) {
+      reinterpret_cast<LeafPage *>(left)->MoveLastToFrontOf(reinterpret_cast<LeafPage *>(right));
+    } else if (node->IsLeafPage()) {
+      reinterpret_cast<LeafPage *>(right)->MoveFirstToEndOf(reinterpret_cast<LeafPage *>(left));
+    } else if (sibling_index < index) {
+      reinterpret_cast<InternalPage *>(left)->MoveLastToFrontOf(reinterpret_cast<InternalPage *>(right),
+                                                                 parent->KeyAt(right_index));
+    } else {
+      reinterpret_cast<InternalPage *>(right)->MoveFirstToEndOf(reinterpret_cast<InternalPage *>(left),
+                                                                 parent->KeyAt(right_index));
+    }
+    KeyType separator = node->IsLeafPage() ? reinterpret_cast<LeafPage *>(right)->KeyAt(0)
+                                           : reinterpret_cast<InternalPage *>(right)->KeyAt(0);
+    parent->SetKeyAt(right_index, separator);
+  }
+  sibling_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(sibling_page->GetPageId(), true);
+  HandleUnderflow(path, level - 1, deleted_page_ids);
+}
+
+/*****************************************************************************
+ * INDEX ITERATOR
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin() {
+  root_latch_.RLock();
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    root_latch_.RUnlock();
+    return INDEXITERATOR_TYPE();
+  }
+  bool is_root;
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, FindLeaf(nullptr, false, &is_root), 0);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) {
+  root_latch_.RLock();
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    root_latch_.RUnlock();
+    return INDEXITERATOR_TYPE();
+  }
+  bool is_root;
+  Page *page = FindLeaf(&key, false, &is_root);
+  int index = reinterpret_cast<LeafPage *>(page->GetData())->KeyIndex(key, comparator_);
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, page, index);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::End() {
+  return INDEXITERATOR_TYPE();
+}
+
+/*****************************************************************************
+ * BULK LOADING
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool BPLUSTREE_TYPE::BulkLoad(const std::vector<MappingType> &items) {
+  for (size_t i = 1; i < items.size(); i++) {
+    if (comparator_(items[i - 1].first, items[i].first) >= 0) {
+      return false;
+    }
+  }
+  root_latch_.WLock();
+  if (root_page_id_ != INVALID_PAGE_ID) {
+    root_latch_.WUnlock();
+    return false;
+  }
+  if (items.empty()) {
+    root_latch_.WUnlock();
+    return true;
+  }
+
+  // The first key and the page id of each page of the level built last; the first key of a page is its separator.
+  std::vector<std::pair<KeyType, page_id_t>> level;
+  size_t num_leaves = (items.size() + leaf_max_size_ - 1) / leaf_max_size_;
+  LeafPage *prev_leaf = nullptr;
+  for (size_t i = 0; i < num_leaves; i++) {
+    size_t begin = items.size() * i / num_leaves;
+    size_t end = items.size() * (i + 1) / num_leaves;
+    page_id_t page_id;
+    auto *leaf = reinterpret_cast<LeafPage *>(NewPage(&page_id)->GetData());
+    leaf->Init(page_id, leaf_max_size_);
+    leaf->CopyNFrom(items.data() + begin, end - begin);
+    if (prev_leaf != nullptr) {
+      prev_leaf->SetNextPageId(page_id);
+      buffer_pool_manager_->UnpinPage(prev_leaf->GetPageId(), true);
+    }
+    prev_leaf = leaf;
+    level.emplace_back(items[begin].first, page_id);
+  }
+  buffer_pool_manager_->UnpinPage(prev_leaf->GetPageId(), true);
+
+  while (level.size() > 1) {
+    std::vector<std::pair<KeyType, page_id_t>> parents;
+    size_t num_pages = (level.size() + internal_max_size_ - 1) / internal_max_size_;
+    for (size_t i = 0; i < num_pages; i++) {
+      size_t begin = level.size() * i / num_pages;
+      size_t end = level.size() * (i + 1) / num_pages;
+      page_id_t page_id;
+      auto *internal = reinterpret_cast<InternalPage *>(NewPage(&page_id)->GetData());
+      internal->Init(page_id, internal_max_size_);
+      internal->CopyNFrom(level.data() + begin, end - begin);
+      buffer_pool_manager_->UnpinPage(page_id, true);
+      parents.emplace_back(level[begin].first, page_id);
+    }
+    level = std::move(parents);
+  }
+  root_page_id_ = level[0].second;
+  root_latch_.WUnlock();
+  return true;
+}
+
+/*****************************************************************************
+ * GETROOTPAGEID
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+page_id_t BPLUSTREE_TYPE::GetRootPageId() {
+  root_latch_.RLock();
+  page_id_t root_page_id = root_page_id_;
+  root_latch_.RUnlock();
+  return root_page_id;
+}
+
+/*****************************************************************************
+ * VERIFY INTEGRITY
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void BPLUSTREE_TYPE::VerifyIntegrity() {
+  root_latch_.WLock();
+  if (root_page_id_ != INVALID_PAGE_ID) {
+    std::vector<page_id_t> leaves;
+    VerifySubtree(root_page_id_, nullptr, nullptr, true, &leaves);
+    // The sibling links chain the leaves in the order of the tree.
+    page_id_t page_id = leaves[0];
+    for (size_t i = 0; i < leaves.size(); i++) {
+      BUSTUB_ASSERT(page_id == leaves[i], "The sibling links must chain the leaves in key order.");
+      Page *page = FetchPage(page_id);
+      page_id = reinterpret_cast<LeafPage *>(page->GetData())->GetNextPageId();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    }
+    BUSTUB_ASSERT(page_id == INVALID_PAGE_ID, "The last leaf must not have a next sibling.");
+  }
+  root_latch_.WUnlock();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+int BPLUSTREE_TYPE::VerifySubtree(page_id_t page_id, const KeyType *lower, const KeyType *upper, bool is_root,
+                                  std::vector<page_id_t> *leaves) {
+  Page *page = FetchPage(page_id);
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  BUSTUB_ASSERT(node->GetPageId() == page_id, "A page must store its own page id.");
+  BUSTUB_ASSERT(node->GetSize() <= node->GetMaxSize(), "A page must not hold more than its maximum size.");
+  BUSTUB_ASSERT(is_root || node->GetSize() >= node->GetMinSize(), "A page other than the root must not underflow.");
+  int height = 1;
+  if (node->IsLeafPage()) {
+    auto *leaf = reinterpret_cast<LeafPage *>(node);
+    BUSTUB_ASSERT(leaf->GetSize() > 0, "A leaf must not be empty.");
+    for (int i = 0; i < leaf->GetSize(); i++) {
+      [[maybe_unused]] KeyType key = leaf->KeyAt(i);
+      BUSTUB_ASSERT(i == 0 || comparator_(leaf->KeyAt(i - 1), key) < 0, "The keys of a leaf must increase.");
+      BUSTUB_ASSERT(lower == nullptr || comparator_(*lower, key) <= 0, "A key must not be below its subtree.");
+      BUSTUB_ASSERT(upper == nullptr || comparator_(key, *upper) < 0, "A key must not be above its subtree.");
+    }
+    leaves->push_back(page_id);
+  } else {
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    BUSTUB_ASSERT(internal->GetSize() >= 2, "An internal page must have at least two children.");
+    int child_height = 0;
+    for (int i = 0; i < internal->GetSize(); i++) {
+      KeyType child_lower = internal->KeyAt(i);
+      KeyType child_upper = i + 1 < internal->GetSize() ? internal->KeyAt(i + 1) : KeyType();
+      if (i > 0) {
+        BUSTUB_ASSERT(i == 1 || comparator_(internal->KeyAt(i - 1), child_lower) < 0,
+                      "The separators of an internal page must increase.");
+        BUSTUB_ASSERT(lower == nullptr || comparator_(*lower, child_lower) <= 0,
+                      "A separator must not be below its subtree.");
+        BUSTUB_ASSERT(upper == nullptr || comparator_(child_lower, *upper) < 0,
+                      "A separator must not be above its subtree.");
+      }
+      int height_i = VerifySubtree(internal->ValueAt(i), i == 0 ? lower : &child_lower,
+                                   i + 1 < internal->GetSize() ? &child_upper : upper, false, leaves);
+      BUSTUB_ASSERT(i == 0 || height_i == child_height, "All leaves must be at the same depth.");
+      child_height = height_i;
+    }
+    height = child_height + 1;
+  }
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  return height;
+}
+
+/*****************************************************************************
+ * UTILITIES
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+Page *BPLUSTREE_TYPE::FindLeaf(const KeyType *key, bool write_leaf, bool *is_root) {
+  Page *page = FetchPage(root_page_id_);
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  // Pages never change their type, it can be read before the page is latched.
+  if (node->IsLeafPage() && write_leaf) {
+    page->WLatch();
+  } else {
+    page->RLatch();
+  }
+  root_latch_.RUnlock();
+  *is_root = true;
+
+  while (!node->IsLeafPage()) {
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    page_id_t child_page_id = key == nullptr ? internal->ValueAt(0) : internal->Lookup(*key, comparator_);
+    Page *child_page = FetchPage(child_page_id);
+    auto *child = reinterpret_cast<BPlusTreePage *>(child_page->GetData());
+    if (child->IsLeafPage() && write_leaf) {
+      child_page->WLatch();
+    } else {
+      child_page->RLatch();
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = child_page;
+    node = child;
+    *is_root = false;
+  }
+  return page;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+Page *BPLUSTREE_TYPE::FindLeafPessimistic(const KeyType &key, Operation op, LatchedPath *path) {
+  root_latch_.WLock();
+  path->root_latched_ = true;
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    return nullptr;
+  }
+  page_id_t page_id = root_page_id_;
+  bool is_root = true;
+  while (true) {
+    Page *page = FetchPage(page_id);
+    page->WLatch();
+    auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    if (IsSafe(node, op, is_root)) {
+      // Nothing above the page changes, release the pages above.
+      ReleasePath(path, false);
+    }
+    path->pages_.push_back(page);
+    if (node->IsLeafPage()) {
+      return page;
+    }
+    page_id = reinterpret_cast<InternalPage *>(node)->Lookup(key, comparator_);
+    is_root = false;
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool BPLUSTREE_TYPE::IsSafe(const BPlusTreePage *node, Operation op, bool is_root) const {
+  if (op == Operation::INSERT) {
+    return node->GetSize() < node->GetMaxSize();
+  }
+  if (is_root) {
+    // The root shrinks the tree once it is left with a single child, or when its leaf is emptied.
+    return node->GetSize() > (node->IsLeafPage() ? 1 : 2);
+  }
+  return node->GetSize() > node->GetMinSize();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void BPLUSTREE_TYPE::ReleasePath(LatchedPath *path, bool is_dirty) {
+  for (Page *page : path->pages_) {
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), is_dirty);
+  }
+  path->pages_.clear();
+  if (path->root_latched_) {
+    root_latch_.WUnlock();
+    path->root_latched_ = false;
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+Page *BPLUSTREE_TYPE::FetchPage(page_id_t page_id) {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch a B+ tree page, the buffer pool is full.");
+  }
+  return page;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+Page *BPLUSTREE_TYPE::NewPage(page_id_t *page_id) {
+  Page *page = buffer_pool_manager_->NewPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate a B+ tree page, the buffer pool is full.");
+  }
+  return page;
+}
+
+template class BPlusTree<GenericKey<4>, RID, GenericComparator<4>>;
+template class BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+template class BPlusTree<GenericKey<16>, RID, GenericComparator<16>>;
+template class BPlusTree<GenericKey<32>, RID, GenericComparator<32>>;
+template class BPlusTree<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
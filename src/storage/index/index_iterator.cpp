@@ -0,0 +1,122 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_iterator.cpp
+//
+// Identification: src/storage/index/index_iterator.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/index_iterator.h"
+
+#include "common/exception.h"
+#include "common/rid.h"
+
+namespace bustub {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+INDEXITERATOR_TYPE::IndexIterator(BufferPoolManager *buffer_pool_manager, Page *page, int index)
+    : buffer_pool_manager_(buffer_pool_manager),
+      page_(page),
+      leaf_(reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(page->GetData())),
+      index_(index) {
+  SkipEmptyLeaves();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+INDEXITERATOR_TYPE::~IndexIterator() {
+  Release();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+INDEXITERATOR_TYPE::IndexIterator(IndexIterator &&other) noexcept
+    : buffer_pool_manager_(other.buffer_pool_manager_), page_(other.page_), leaf_(other.leaf_), index_(other.index_) {
+  other.page_ = nullptr;
+  other.leaf_ = nullptr;
+  other.index_ = 0;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator=(IndexIterator &&other) noexcept {
+  if (this != &other) {
+    Release();
+    buffer_pool_manager_ = other.buffer_pool_manager_;
+    page_ = other.page_;
+    leaf_ = other.leaf_;
+    index_ = other.index_;
+    other.page_ = nullptr;
+    other.leaf_ = nullptr;
+    other.index_ = 0;
+  }
+  return *this;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool INDEXITERATOR_TYPE::IsEnd() const {
+  return page_ == nullptr;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+const MappingType &INDEXITERATOR_TYPE::operator*() const {
+  return leaf_->GetItem(index_);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator++() {
+  index_++;
+  SkipEmptyLeaves();
+  return *this;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool INDEXITERATOR_TYPE::operator==(const IndexIterator &itr) const {
+  return page_ == itr.page_ && index_ == itr.index_;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool INDEXITERATOR_TYPE::operator!=(const IndexIterator &itr) const {
+  return !(*this == itr);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void INDEXITERATOR_TYPE::SkipEmptyLeaves() {
+  while (page_ != nullptr && index_ >= leaf_->GetSize()) {
+    page_id_t next_page_id = leaf_->GetNextPageId();
+    if (next_page_id == INVALID_PAGE_ID) {
+      Release();
+      return;
+    }
+    // The current leaf stays latched until the next one is, so that the next leaf cannot be merged away meanwhile.
+    Page *next_page = buffer_pool_manager_->FetchPage(next_page_id);
+    if (next_page == nullptr) {
+      Release();
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch a B+ tree page, the buffer pool is full.");
+    }
+    next_page->RLatch();
+    Release();
+    page_ = next_page;
+    leaf_ = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(next_page->GetData());
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void INDEXITERATOR_TYPE::Release() {
+  if (page_ != nullptr) {
+    page_->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_->GetPageId(), false);
+  }
+  page_ = nullptr;
+  leaf_ = nullptr;
+  index_ = 0;
+}
+
+template class IndexIterator<GenericKey<4>, RID, GenericComparator<4>>;
+template class IndexIterator<GenericKey<8>, RID, GenericComparator<8>>;
+template class IndexIterator<GenericKey<16>, RID, GenericComparator<16>>;
+template class IndexIterator<GenericKey<32>, RID, GenericComparator<32>>;
+template class IndexIterator<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
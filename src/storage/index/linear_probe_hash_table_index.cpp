@@ -1,3 +1,7 @@
+#include <algorithm>
+#include <deque>
+#include <thread>  // NOLINT
+#include <utility>
 #include <vector>
 
 #include "storage/index/linear_probe_hash_table_index.h"
@@ -17,7 +21,7 @@ template <typename KeyType, typename ValueType, typename KeyComparator>
 void HASH_TABLE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
   // construct insert index key
   KeyType index_key;
-  index_key.SetFromKey(key);
+  index_key.SetFromKey(key, GetKeySchema());
 
   container_.Insert(transaction, index_key, rid);
 }
@@ -26,7 +30,7 @@ template <typename KeyType, typename ValueType, typename KeyComparator>
 void HASH_TABLE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
   // construct delete index key
   KeyType index_key;
-  index_key.SetFromKey(key);
+  index_key.SetFromKey(key, GetKeySchema());
 
   container_.Remove(transaction, index_key, rid);
 }
@@ -35,10 +39,63 @@ template <typename KeyType, typename ValueType, typename KeyComparator>
 void HASH_TABLE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
   // construct scan index key
   KeyType index_key;
-  index_key.SetFromKey(key);
+  index_key.SetFromKey(key, GetKeySchema());
 
   container_.GetValue(transaction, index_key, result);
 }
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_INDEX_TYPE::ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *results,
+                                     Transaction *transaction) {
+  // construct the scan index keys
+  std::vector<KeyType> index_keys(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    index_keys[i].SetFromKey(keys[i], GetKeySchema());
+  }
+
+  container_.GetValues(transaction, index_keys, results);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_INDEX_TYPE::BulkLoad(TableHeap *table_heap, const Schema *table_schema, Transaction *transaction) {
+  // bulk inserts do not look for the pairs the table holds already
+  if (!container_.IsEmpty()) {
+    return false;
+  }
+  std::deque<Tuple> tuples;
+  for (auto iter = table_heap->Begin(transaction); iter != table_heap->End(); ++iter) {
+    tuples.push_back(*iter);
+  }
+
+  // construct the index keys, a range of the tuples per thread; small tables are not worth starting threads for
+  std::vector<std::pair<KeyType, ValueType>> entries(tuples.size());
+  size_t num_threads = std::clamp<size_t>(tuples.size() / 10000, 1, std::max(1U, std::thread::hardware_concurrency()));
+  auto build_keys = [&](size_t begin, size_t end) {
+    std::vector<Value> values;
+    for (size_t i = begin; i < end; i++) {
+      values.clear();
+      for (uint32_t key_attr : GetKeyAttrs()) {
+        values.push_back(tuples[i].GetValue(table_schema, key_attr));
+      }
+      entries[i].first.SetFromKey(Tuple(values, GetKeySchema()), GetKeySchema());
+      entries[i].second = tuples[i].GetRid();
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t t = 1; t < num_threads; t++) {
+    threads.emplace_back(build_keys, tuples.size() * t / num_threads, tuples.size() * (t + 1) / num_threads);
+  }
+  build_keys(0, tuples.size() / num_threads);
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // presize, a table that runs out of buckets falls back to inserting the rest one pair at a time
+  container_.Resize(entries.size());
+  container_.BulkInsert(transaction, entries);
+  return true;
+}
+
 template class LinearProbeHashTableIndex<GenericKey<4>, RID, GenericComparator<4>>;
 template class LinearProbeHashTableIndex<GenericKey<8>, RID, GenericComparator<8>>;
 template class LinearProbeHashTableIndex<GenericKey<16>, RID, GenericComparator<16>>;
@@ -0,0 +1,43 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_page.cpp
+//
+// Identification: src/storage/page/b_plus_tree_page.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+bool BPlusTreePage::IsLeafPage() const { return page_type_ == IndexPageType::LEAF_PAGE; }
+
+void BPlusTreePage::SetPageType(IndexPageType page_type) { page_type_ = page_type; }
+
+int BPlusTreePage::GetSize() const { return size_; }
+
+void BPlusTreePage::SetSize(int size) { size_ = size; }
+
+void BPlusTreePage::IncreaseSize(int amount) { size_ += amount; }
+
+int BPlusTreePage::GetMaxSize() const { return max_size_; }
+
+void BPlusTreePage::SetMaxSize(int max_size) { max_size_ = max_size; }
+
+/*
+ * A leaf holds at least half of its maximum number of entries, an internal page at least half of its maximum number
+ * of children, rounded up, so that a page that underflows can always either merge with a sibling or borrow from it.
+ */
+int BPlusTreePage::GetMinSize() const { return IsLeafPage() ? max_size_ / 2 : (max_size_ + 1) / 2; }
+
+page_id_t BPlusTreePage::GetPageId() const { return page_id_; }
+
+void BPlusTreePage::SetPageId(page_id_t page_id) { page_id_ = page_id; }
+
+void BPlusTreePage::SetLSN(lsn_t lsn) { lsn_ = lsn; }
+
+}  // namespace bustub
@@ -11,39 +11,113 @@
 //===----------------------------------------------------------------------===//
 
 #include "storage/page/hash_table_block_page.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+#include <cstring>
+
 #include "storage/index/generic_key.h"
 
 namespace bustub {
 
+namespace {
+
+/** @return the bit of bucket_ind in its bitmap word */
+inline uint32_t BitOf(slot_offset_t bucket_ind) { return 1U << (bucket_ind % BLOCK_GROUP_SIZE); }
+
+/** @return one bit per byte of fingerprints that equals fingerprint, for BLOCK_GROUP_SIZE bytes */
+inline uint32_t MatchFingerprints(const uint8_t *fingerprints, uint8_t fingerprint) {
+#ifdef __AVX2__
+  __m256i group = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(fingerprints));
+  __m256i equal = _mm256_cmpeq_epi8(group, _mm256_set1_epi8(static_cast<char>(fingerprint)));
+  return static_cast<uint32_t>(_mm256_movemask_epi8(equal));
+#else
+  constexpr uint64_t low_bits = 0x0101010101010101ULL;
+  constexpr uint64_t high_bits = 0x8080808080808080ULL;
+  uint32_t match = 0;
+  for (size_t i = 0; i < BLOCK_GROUP_SIZE; i += 8) {
+    uint64_t word;
+    std::memcpy(&word, fingerprints + i, sizeof(word));
+    // Bytes equal to the fingerprint become 0, and exactly those get their high bit set.
+    word ^= low_bits * fingerprint;
+    uint64_t zero = ~(((word & ~high_bits) + ~high_bits) | word | ~high_bits);
+    // Gathers the high bits of the bytes into the top byte, in little endian byte order.
+    match |= static_cast<uint32_t>(((zero >> 7) * 0x0102040810204080ULL) >> 56) << i;
+  }
+  return match;
+#endif
+}
+
+}  // namespace
+
 template <typename KeyType, typename ValueType, typename KeyComparator>
 KeyType HASH_TABLE_BLOCK_TYPE::KeyAt(slot_offset_t bucket_ind) const {
-  return {};
+  return array_[bucket_ind].first;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 ValueType HASH_TABLE_BLOCK_TYPE::ValueAt(slot_offset_t bucket_ind) const {
-  return {};
+  return array_[bucket_ind].second;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-bool HASH_TABLE_BLOCK_TYPE::Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value) {
-  return false;
+bool HASH_TABLE_BLOCK_TYPE::Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value,
+                                   uint8_t fingerprint) {
+  uint32_t bit = BitOf(bucket_ind);
+  if ((occupied_[bucket_ind / BLOCK_GROUP_SIZE].fetch_or(bit, std::memory_order_relaxed) & bit) != 0) {
+    return false;
+  }
+  array_[bucket_ind] = MappingType(key, value);
+  fingerprints_[bucket_ind] = fingerprint;
+  // Readers that see the readable bit also see the key, the value and the fingerprint.
+  readable_[bucket_ind / BLOCK_GROUP_SIZE].fetch_or(bit, std::memory_order_release);
+  return true;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BLOCK_TYPE::Remove(slot_offset_t bucket_ind) {}
+bool HASH_TABLE_BLOCK_TYPE::Remove(slot_offset_t bucket_ind) {
+  uint32_t bit = BitOf(bucket_ind);
+  return (readable_[bucket_ind / BLOCK_GROUP_SIZE].fetch_and(~bit, std::memory_order_relaxed) & bit) != 0;
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_BLOCK_TYPE::IsOccupied(slot_offset_t bucket_ind) const {
-  return false;
+  return (occupied_[bucket_ind / BLOCK_GROUP_SIZE].load(std::memory_order_relaxed) & BitOf(bucket_ind)) != 0;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_BLOCK_TYPE::IsReadable(slot_offset_t bucket_ind) const {
-  return false;
+  return (readable_[bucket_ind / BLOCK_GROUP_SIZE].load(std::memory_order_acquire) & BitOf(bucket_ind)) != 0;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+size_t HASH_TABLE_BLOCK_TYPE::NumReadable() const {
+  size_t num_readable = 0;
+  for (const auto &readable : readable_) {
+    num_readable += __builtin_popcount(readable.load(std::memory_order_relaxed));
+  }
+  return num_readable;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t HASH_TABLE_BLOCK_TYPE::MatchGroup(size_t group, uint8_t fingerprint, uint32_t *free) const {
+  // The readable bits are loaded first, so that the fingerprints of the slots they cover are already written. A slot
+  // that becomes readable later was inserted concurrently with the lookup, and may be missed.
+  uint32_t readable = readable_[group].load(std::memory_order_acquire);
+  *free = ~occupied_[group].load(std::memory_order_relaxed);
+  return readable & MatchFingerprints(&fingerprints_[group * BLOCK_GROUP_SIZE], fingerprint);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_BLOCK_TYPE::Prefetch(slot_offset_t bucket_ind) const {
+  size_t group = bucket_ind / BLOCK_GROUP_SIZE;
+  __builtin_prefetch(&readable_[group]);
+  __builtin_prefetch(&occupied_[group]);
+  __builtin_prefetch(&fingerprints_[group * BLOCK_GROUP_SIZE]);
+  __builtin_prefetch(&array_[bucket_ind]);
 }
 
-// DO NOT REMOVE ANYTHING BELOW THIS LINE
 template class HashTableBlockPage<int, int, IntComparator>;
 template class HashTableBlockPage<GenericKey<4>, RID, GenericComparator<4>>;
 template class HashTableBlockPage<GenericKey<8>, RID, GenericComparator<8>>;
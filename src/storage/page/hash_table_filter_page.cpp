@@ -0,0 +1,57 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_filter_page.cpp
+//
+// Identification: src/storage/page/hash_table_filter_page.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/hash_table_filter_page.h"
+
+#include "common/macros.h"
+
+namespace bustub {
+
+void HashTableFilterPage::KeyMasks(uint64_t bit_hash, size_t num_bits, uint64_t masks[FILTER_LINE_WORDS]) {
+  BUSTUB_ASSERT(num_bits <= FILTER_MAX_KEY_BITS, "A key sets at most FILTER_MAX_KEY_BITS bits.");
+  constexpr uint64_t line_bits = FILTER_LINE_WORDS * 64;
+  // The step is odd, so the bits of a key are distinct.
+  uint64_t bit = bit_hash % line_bits;
+  uint64_t step = (bit_hash >> 32) % line_bits | 1;
+  for (size_t word = 0; word < FILTER_LINE_WORDS; word++) {
+    masks[word] = 0;
+  }
+  for (size_t i = 0; i < num_bits; i++) {
+    masks[bit / 64] |= uint64_t{1} << (bit % 64);
+    bit = (bit + step) % line_bits;
+  }
+}
+
+void HashTableFilterPage::Insert(size_t line, uint64_t bit_hash, size_t num_bits) {
+  uint64_t masks[FILTER_LINE_WORDS];
+  KeyMasks(bit_hash, num_bits, masks);
+  std::atomic<uint64_t> *words = &words_[line * FILTER_LINE_WORDS];
+  for (size_t word = 0; word < FILTER_LINE_WORDS; word++) {
+    // Skipping the words that have the bits already keeps the cache line shared between concurrent inserts.
+    if (masks[word] != 0 && (words[word].load(std::memory_order_relaxed) & masks[word]) != masks[word]) {
+      words[word].fetch_or(masks[word]);
+    }
+  }
+}
+
+bool HashTableFilterPage::MayContain(size_t line, uint64_t bit_hash, size_t num_bits) const {
+  uint64_t masks[FILTER_LINE_WORDS];
+  KeyMasks(bit_hash, num_bits, masks);
+  const std::atomic<uint64_t> *words = &words_[line * FILTER_LINE_WORDS];
+  bool contains = true;
+  for (size_t word = 0; word < FILTER_LINE_WORDS; word++) {
+    contains &= (words[word].load(std::memory_order_relaxed) & masks[word]) == masks[word];
+  }
+  return contains;
+}
+
+}  // namespace bustub
@@ -13,22 +13,40 @@
 #include "storage/page/hash_table_header_page.h"
 
 namespace bustub {
-page_id_t HashTableHeaderPage::GetBlockPageId(size_t index) { return 0; }
+page_id_t HashTableHeaderPage::GetBlockPageId(size_t index) {
+  BUSTUB_ASSERT(index < next_ind_, "The header page has no block with this index.");
+  return block_page_ids_[index];
+}
 
-page_id_t HashTableHeaderPage::GetPageId() const { return 0; }
+page_id_t HashTableHeaderPage::GetPageId() const { return page_id_; }
 
-void HashTableHeaderPage::SetPageId(bustub::page_id_t page_id) {}
+void HashTableHeaderPage::SetPageId(bustub::page_id_t page_id) { page_id_ = page_id; }
 
-lsn_t HashTableHeaderPage::GetLSN() const { return 0; }
+lsn_t HashTableHeaderPage::GetLSN() const { return lsn_; }
 
-void HashTableHeaderPage::SetLSN(lsn_t lsn) {}
+void HashTableHeaderPage::SetLSN(lsn_t lsn) { lsn_ = lsn; }
 
-void HashTableHeaderPage::AddBlockPageId(page_id_t page_id) {}
+void HashTableHeaderPage::AddBlockPageId(page_id_t page_id) {
+  BUSTUB_ASSERT(next_ind_ + num_filter_pages_ < HASH_TABLE_HEADER_MAX_BLOCKS, "The header page is full.");
+  block_page_ids_[next_ind_++] = page_id;
+}
 
-size_t HashTableHeaderPage::NumBlocks() { return 0; }
+size_t HashTableHeaderPage::NumBlocks() { return next_ind_; }
 
-void HashTableHeaderPage::SetSize(size_t size) {}
+void HashTableHeaderPage::AddFilterPageId(page_id_t page_id) {
+  BUSTUB_ASSERT(next_ind_ + num_filter_pages_ < HASH_TABLE_HEADER_MAX_BLOCKS, "The header page is full.");
+  block_page_ids_[HASH_TABLE_HEADER_MAX_BLOCKS - 1 - num_filter_pages_++] = page_id;
+}
 
-size_t HashTableHeaderPage::GetSize() const { return 0; }
+page_id_t HashTableHeaderPage::GetFilterPageId(size_t index) {
+  BUSTUB_ASSERT(index < num_filter_pages_, "The header page has no filter page with this index.");
+  return block_page_ids_[HASH_TABLE_HEADER_MAX_BLOCKS - 1 - index];
+}
+
+size_t HashTableHeaderPage::NumFilterPages() { return num_filter_pages_; }
+
+void HashTableHeaderPage::SetSize(size_t size) { size_ = size; }
+
+size_t HashTableHeaderPage::GetSize() const { return size_; }
 
 }  // namespace bustub
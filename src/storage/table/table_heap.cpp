@@ -18,15 +18,21 @@
 namespace bustub {
 
 TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-                     page_id_t first_page_id)
+                     page_id_t first_page_id, VersionStore *version_store, table_oid_t oid)
     : buffer_pool_manager_(buffer_pool_manager),
       lock_manager_(lock_manager),
       log_manager_(log_manager),
-      first_page_id_(first_page_id) {}
+      first_page_id_(first_page_id),
+      version_store_(version_store),
+      oid_(oid) {}
 
 TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-                     Transaction *txn)
-    : buffer_pool_manager_(buffer_pool_manager), lock_manager_(lock_manager), log_manager_(log_manager) {
+                     Transaction *txn, VersionStore *version_store, table_oid_t oid)
+    : buffer_pool_manager_(buffer_pool_manager),
+      lock_manager_(lock_manager),
+      log_manager_(log_manager),
+      version_store_(version_store),
+      oid_(oid) {
   // Initialize the first table page.
   auto first_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(&first_page_id_));
   BUSTUB_ASSERT(first_page != nullptr, "Couldn't create a page for the table heap.");
@@ -41,6 +47,9 @@ bool TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) {
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
+  if (!LockIntention(LockMode::EXCLUSIVE, txn)) {
+    return false;
+  }
 
   auto cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
   if (cur_page == nullptr) {
@@ -51,7 +60,7 @@ bool TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) {
   cur_page->WLatch();
   // Insert into the first page with enough space. If no such page exists, create a new page and insert into that.
   // INVARIANT: cur_page is WLatched if you leave the loop normally.
-  while (!cur_page->InsertTuple(tuple, rid, txn, lock_manager_, log_manager_)) {
+  while (!cur_page->InsertTuple(tuple, rid, txn, lock_manager_, log_manager_, oid_)) {
     auto next_page_id = cur_page->GetNextPageId();
     // If the next page is a valid page,
     if (next_page_id != INVALID_PAGE_ID) {
@@ -81,6 +90,13 @@ bool TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) {
       cur_page = new_page;
     }
   }
+  if (version_store_ != nullptr) {
+    version_store_->RecordWrite(this, *rid, txn, nullptr, false);
+  }
+  if (txn->GetConcurrencyMode() == ConcurrencyMode::OPTIMISTIC) {
+    // Optimistic inserts go to the table right away, hidden from the others until they commit.
+    tids_.Install(*rid, true);
+  }
   // This line has caused most of us to double-take and "whoa double unlatch".
   // We are not, in fact, double unlatching. See the invariant above.
   cur_page->WUnlatch();
@@ -91,6 +107,13 @@ bool TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) {
 }
 
 bool TableHeap::MarkDelete(const RID &rid, Transaction *txn) {
+  if (IsBuffered(txn)) {
+    txn->GetWriteSet()->emplace_back(rid, WType::DELETE, Tuple{}, this);
+    return true;
+  }
+  if (!LockIntention(LockMode::EXCLUSIVE, txn)) {
+    return false;
+  }
   // TODO(Amadou): remove empty page
   // Find the page which contains the tuple.
   auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
@@ -101,15 +124,38 @@ bool TableHeap::MarkDelete(const RID &rid, Transaction *txn) {
   }
   // Otherwise, mark the tuple as deleted.
   page->WLatch();
-  page->MarkDelete(rid, txn, lock_manager_, log_manager_);
+  if (!CanWrite(rid, txn)) {
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetTablePageId(), false);
+    return false;
+  }
+  // Snapshots taken before the delete still see the tuple, so keep its image.
+  Tuple old_tuple;
+  bool is_deleted;
+  if (version_store_ != nullptr) {
+    page->ReadTuple(rid, &old_tuple, &is_deleted);
+  }
+  bool is_marked = page->MarkDelete(rid, txn, lock_manager_, log_manager_, oid_);
+  if (is_marked && version_store_ != nullptr) {
+    version_store_->RecordWrite(this, rid, txn, &old_tuple, true);
+  }
   page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), is_marked);
   // Update the transaction's write set.
-  txn->GetWriteSet()->emplace_back(rid, WType::DELETE, Tuple{}, this);
-  return true;
+  if (is_marked) {
+    txn->GetWriteSet()->emplace_back(rid, WType::DELETE, Tuple{}, this);
+  }
+  return is_marked;
 }
 
 bool TableHeap::UpdateTuple(const Tuple &tuple, const RID &rid, Transaction *txn) {
+  if (IsBuffered(txn)) {
+    txn->GetWriteSet()->emplace_back(rid, WType::UPDATE, tuple, this);
+    return true;
+  }
+  if (!LockIntention(LockMode::EXCLUSIVE, txn)) {
+    return false;
+  }
   // Find the page which contains the tuple.
   auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
   // If the page could not be found, then abort the transaction.
@@ -120,7 +166,15 @@ bool TableHeap::UpdateTuple(const Tuple &tuple, const RID &rid, Transaction *txn
   // Update the tuple; but first save the old value for rollbacks.
   Tuple old_tuple;
   page->WLatch();
-  bool is_updated = page->UpdateTuple(tuple, &old_tuple, rid, txn, lock_manager_, log_manager_);
+  if (!CanWrite(rid, txn)) {
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetTablePageId(), false);
+    return false;
+  }
+  bool is_updated = page->UpdateTuple(tuple, &old_tuple, rid, txn, lock_manager_, log_manager_, oid_);
+  if (is_updated && version_store_ != nullptr) {
+    version_store_->RecordWrite(this, rid, txn, &old_tuple, false);
+  }
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), is_updated);
   // Update the transaction's write set.
@@ -154,6 +208,13 @@ void TableHeap::RollbackDelete(const RID &rid, Transaction *txn) {
 }
 
 bool TableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn) {
+  if (txn->GetConcurrencyMode() == ConcurrencyMode::OPTIMISTIC) {
+    return GetTupleOptimistic(rid, tuple, txn);
+  }
+  // Snapshot reads do not lock.
+  if (version_store_ == nullptr && !LockIntention(LockMode::SHARED, txn)) {
+    return false;
+  }
   // Find the page which contains the tuple.
   auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
   // If the page could not be found, then abort the transaction.
@@ -163,21 +224,120 @@ bool TableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn) {
   }
   // Read the tuple from the page.
   page->RLatch();
-  bool res = page->GetTuple(rid, tuple, txn, lock_manager_);
+  bool res;
+  if (version_store_ != nullptr) {
+    // The chain is read under the page latch, so that it matches the heap version.
+    bool is_deleted = true;
+    bool in_heap = page->ReadTuple(rid, tuple, &is_deleted) && !is_deleted;
+    res = version_store_->Read(rid, txn, in_heap, tuple);
+  } else {
+    res = page->GetTuple(rid, tuple, txn, lock_manager_, oid_);
+  }
   page->RUnlatch();
   buffer_pool_manager_->UnpinPage(rid.GetPageId(), false);
   return res;
 }
 
-TableIterator TableHeap::Begin(Transaction *txn) {
-  // Start an iterator from the first page.
+bool TableHeap::LockRow(const RID &rid, LockMode lock_mode, Transaction *txn) {
+  if (!enable_logging || txn->IsExclusiveLocked(rid) || (lock_mode == LockMode::SHARED && txn->IsSharedLocked(rid))) {
+    return true;
+  }
+  return LockIntention(lock_mode, txn) && lock_manager_->LockRow(txn, oid_, rid, lock_mode);
+}
+
+bool TableHeap::LockIntention(LockMode lock_mode, Transaction *txn) {
+  if (!enable_logging || oid_ == INVALID_TABLE_OID) {
+    return true;
+  }
+  LockMode intention = lock_mode == LockMode::SHARED ? LockMode::INTENTION_SHARED : LockMode::INTENTION_EXCLUSIVE;
+  return lock_manager_->LockTable(txn, oid_, intention);
+}
+
+bool TableHeap::CanWrite(const RID &rid, Transaction *txn) {
+  if (version_store_ == nullptr || version_store_->CanWrite(rid, txn)) {
+    return true;
+  }
+  // First updater wins.
+  txn->SetState(TransactionState::ABORTED);
+  return false;
+}
+
+bool TableHeap::GetTupleOptimistic(const RID &rid, Tuple *tuple, Transaction *txn) {
+  // The transaction sees its own buffered writes.
+  auto write_set = txn->GetWriteSet();
+  bool is_own_insert = false;
+  for (auto item = write_set->rbegin(); item != write_set->rend(); ++item) {
+    if (item->table_ != this || !(item->rid_ == rid)) {
+      continue;
+    }
+    if (item->wtype_ == WType::UPDATE) {
+      *tuple = item->tuple_;
+      tuple->rid_ = rid;
+      return true;
+    }
+    if (item->wtype_ == WType::DELETE) {
+      return false;
+    }
+    is_own_insert = true;
+    break;
+  }
+
+  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  if (page == nullptr) {
+    txn->SetState(TransactionState::ABORTED);
+    return false;
+  }
+  // Writes are installed while the TID word is locked, so a read between two equal TID words saw no write.
+  uint64_t tid;
+  bool in_heap;
+  do {
+    tid = tids_.Read(rid);
+    bool is_deleted = true;
+    page->RLatch();
+    in_heap = page->ReadTuple(rid, tuple, &is_deleted) && !is_deleted;
+    page->RUnlatch();
+  } while (tids_.Read(rid) != tid);
+  buffer_pool_manager_->UnpinPage(rid.GetPageId(), false);
+
+  if (is_own_insert) {
+    return in_heap;
+  }
+  txn->GetReadSet()->emplace_back(rid, tid, this);
+  return in_heap && (tid & TidTable::ABSENT_BIT) == 0;
+}
+
+void TableHeap::GetFirstRid(RID *rid) {
   auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
   page->RLatch();
-  RID rid;
-  // If this fails because there is no tuple, then RID will be the default-constructed value, which means EOF.
-  page->GetFirstTupleRid(&rid);
+  FindRid(page, page->GetFirstTupleRid(rid), rid);
+}
+
+void TableHeap::GetNextRid(const RID &rid, RID *next_rid) {
+  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  page->RLatch();
+  FindRid(page, page->GetNextTupleRid(rid, next_rid), next_rid);
+}
+
+void TableHeap::FindRid(TablePage *page, bool found, RID *rid) {
+  while (!found && page->GetNextPageId() != INVALID_PAGE_ID) {
+    auto next_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page->GetNextPageId()));
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetTablePageId(), false);
+    page = next_page;
+    page->RLatch();
+    found = page->GetFirstTupleRid(rid);
+  }
+  if (!found) {
+    // The end of the table.
+    *rid = RID();
+  }
   page->RUnlatch();
-  buffer_pool_manager_->UnpinPage(first_page_id_, false);
+  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), false);
+}
+
+TableIterator TableHeap::Begin(Transaction *txn) {
+  RID rid;
+  GetFirstRid(&rid);
   return TableIterator(this, rid, txn);
 }
 
@@ -18,8 +18,9 @@ namespace bustub {
 
 TableIterator::TableIterator(TableHeap *table_heap, RID rid, Transaction *txn)
     : table_heap_(table_heap), tuple_(new Tuple(rid)), txn_(txn) {
-  if (rid.GetPageId() != INVALID_PAGE_ID) {
-    table_heap_->GetTuple(tuple_->rid_, tuple_, txn_);
+  if (rid.GetPageId() != INVALID_PAGE_ID && !table_heap_->GetTuple(tuple_->rid_, tuple_, txn_) && SkipsInvisible()) {
+    // The tuple is not visible to the transaction.
+    ++(*this);
   }
 }
 
@@ -34,33 +35,10 @@ Tuple *TableIterator::operator->() {
 }
 
 TableIterator &TableIterator::operator++() {
-  BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
-  auto cur_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(tuple_->rid_.GetPageId()));
-  cur_page->RLatch();
-  assert(cur_page != nullptr);  // all pages are pinned
-
-  RID next_tuple_rid;
-  if (!cur_page->GetNextTupleRid(tuple_->rid_,
-                                 &next_tuple_rid)) {  // end of this page
-    while (cur_page->GetNextPageId() != INVALID_PAGE_ID) {
-      auto next_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(cur_page->GetNextPageId()));
-      cur_page->RUnlatch();
-      buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
-      cur_page = next_page;
-      cur_page->RLatch();
-      if (cur_page->GetFirstTupleRid(&next_tuple_rid)) {
-        break;
-      }
-    }
+  bool is_visible = Advance();
+  while (!is_visible && SkipsInvisible()) {
+    is_visible = Advance();
   }
-  tuple_->rid_ = next_tuple_rid;
-
-  if (*this != table_heap_->End()) {
-    table_heap_->GetTuple(tuple_->rid_, tuple_, txn_);
-  }
-  // release until copy the tuple
-  cur_page->RUnlatch();
-  buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
   return *this;
 }
 
@@ -70,4 +48,23 @@ TableIterator TableIterator::operator++(int) {
   return clone;
 }
 
+bool TableIterator::SkipsInvisible() {
+  // Under snapshot isolation, tuples outside the snapshot are skipped. Optimistic transactions skip the tuples
+  // inserted by running transactions and their own buffered deletes.
+  return table_heap_->version_store_ != nullptr ||
+         (txn_ != nullptr && txn_->GetConcurrencyMode() == ConcurrencyMode::OPTIMISTIC);
+}
+
+bool TableIterator::Advance() {
+  // GetNextRid releases the page before GetTuple latches it again, since a writer waiting for the latch would block
+  // the second read latch while we hold the first.
+  RID next_rid;
+  table_heap_->GetNextRid(tuple_->rid_, &next_rid);
+  tuple_->rid_ = next_rid;
+  if (*this != table_heap_->End()) {
+    return table_heap_->GetTuple(tuple_->rid_, tuple_, txn_);
+  }
+  return true;
+}
+
 }  // namespace bustub
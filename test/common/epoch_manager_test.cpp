@@ -0,0 +1,154 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// epoch_manager_test.cpp
+//
+// Identification: test/common/epoch_manager_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/epoch_manager.h"
+#include "common/exception.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(EpochManagerTest, DeferTest) {
+  EpochManager epoch_manager(1);
+  int reclaimed = 0;
+
+  // Nobody is inside an epoch, so the object is reclaimed right away.
+  epoch_manager.Retire([&] { reclaimed++; });
+  EXPECT_EQ(1, reclaimed);
+
+  {
+    EpochGuard guard(&epoch_manager);
+    {
+      // Epochs nest.
+      EpochGuard nested(&epoch_manager);
+    }
+    epoch_manager.Retire([&] { reclaimed++; });
+    EXPECT_EQ(1, reclaimed);
+    EXPECT_EQ(1, epoch_manager.GetNumRetired());
+  }
+  EXPECT_EQ(1, epoch_manager.Reclaim());
+  EXPECT_EQ(2, reclaimed);
+  EXPECT_EQ(0, epoch_manager.GetNumRetired());
+}
+
+// NOLINTNEXTLINE
+TEST(EpochManagerTest, OtherThreadTest) {
+  EpochManager epoch_manager(1);
+  std::atomic<bool> entered{false};
+  std::atomic<bool> done{false};
+  std::atomic<int> reclaimed{0};
+
+  std::thread reader([&] {
+    EpochGuard guard(&epoch_manager);
+    entered = true;
+    while (!done) {
+      std::this_thread::yield();
+    }
+  });
+  while (!entered) {
+    std::this_thread::yield();
+  }
+  // The reader entered before the object was retired, so it may still read it.
+  epoch_manager.Retire([&] { reclaimed++; });
+  EXPECT_EQ(0, epoch_manager.Reclaim());
+  {
+    // A thread entering later does not hold the object back.
+    EpochGuard guard(&epoch_manager);
+    done = true;
+    reader.join();
+    EXPECT_EQ(1, epoch_manager.Reclaim());
+  }
+  EXPECT_EQ(1, reclaimed);
+}
+
+// NOLINTNEXTLINE
+TEST(EpochManagerTest, ConcurrentReclaimTest) {
+  const int num_threads = 4;
+  const int num_swaps = 10000;
+  EpochManager epoch_manager;
+  // Readers read the shared object while writers replace it and retire the old one, which is poisoned on reclaim.
+  std::atomic<std::atomic<int> *> shared{new std::atomic<int>(1)};
+  std::atomic<bool> stop{false};
+  std::atomic<int> bad_reads{0};
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&] {
+      while (!stop) {
+        EpochGuard guard(&epoch_manager);
+        if (shared.load()->load() != 1) {
+          bad_reads++;
+        }
+      }
+    });
+  }
+  for (int i = 0; i < num_swaps; i++) {
+    std::atomic<int> *old = shared.exchange(new std::atomic<int>(1));
+    epoch_manager.Retire([old] {
+      old->store(0);
+      delete old;
+    });
+  }
+  stop = true;
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  epoch_manager.Reclaim();
+  EXPECT_EQ(0, epoch_manager.GetNumRetired());
+  EXPECT_EQ(0, bad_reads);
+  delete shared.load();
+}
+
+// NOLINTNEXTLINE
+TEST(EpochManagerTest, TooManyThreadsTest) {
+  const int num_threads = EPOCH_MAX_THREADS + 1;
+  EpochManager epoch_manager;
+  std::atomic<int> entered{0};
+  std::atomic<int> failed{0};
+  std::atomic<bool> done{false};
+
+  // More threads than there are slots stay inside an epoch, the ones that find no slot left get an exception.
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&] {
+      try {
+        EpochGuard guard(&epoch_manager);
+        entered++;
+        while (!done) {
+          std::this_thread::yield();
+        }
+      } catch (const Exception &e) {
+        failed++;
+      }
+    });
+  }
+  while (entered + failed < num_threads) {
+    std::this_thread::yield();
+  }
+  EXPECT_LE(entered, EPOCH_MAX_THREADS);
+  EXPECT_GE(failed, 1);
+  done = true;
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // The threads gave their slots back when they ended.
+  std::thread other([&] { EpochGuard guard(&epoch_manager); });
+  other.join();
+}
+
+}  // namespace bustub
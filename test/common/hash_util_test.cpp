@@ -0,0 +1,51 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_util_test.cpp
+//
+// Identification: test/common/hash_util_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/util/hash_util.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(HashUtilTest, Crc32cTest) {
+  // Check values from RFC 3720, appendix B.4.
+  std::string digits = "123456789";
+  EXPECT_EQ(0xE3069283, HashUtil::Crc32c(digits.data(), digits.size()));
+  EXPECT_EQ(0xE3069283, HashUtil::Crc32cPortable(digits.data(), digits.size()));
+  std::vector<char> zeroes(32, 0);
+  EXPECT_EQ(0x8A9136AA, HashUtil::Crc32c(zeroes.data(), zeroes.size()));
+  std::vector<char> ones(32, static_cast<char>(0xFF));
+  EXPECT_EQ(0x62A8AB43, HashUtil::Crc32c(ones.data(), ones.size()));
+  EXPECT_EQ(0U, HashUtil::Crc32c(digits.data(), 0));
+
+  // Both implementations agree on every length and alignment, and checksumming in pieces gives the same result.
+  std::mt19937 rng(15445);
+  std::vector<char> data(1024);
+  for (auto &byte : data) {
+    byte = static_cast<char>(rng());
+  }
+  for (size_t offset = 0; offset < 8; offset++) {
+    for (size_t length = 0; length + offset <= 100; length++) {
+      uint32_t crc = HashUtil::Crc32c(data.data() + offset, length);
+      EXPECT_EQ(HashUtil::Crc32cPortable(data.data() + offset, length), crc);
+      size_t split = length / 3;
+      EXPECT_EQ(crc, HashUtil::Crc32c(data.data() + offset + split, length - split,
+                                      HashUtil::Crc32c(data.data() + offset, split)));
+    }
+  }
+}
+
+}  // namespace bustub
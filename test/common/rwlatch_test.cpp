@@ -10,6 +10,13 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <shared_mutex>  // NOLINT
+#include <string>
 #include <thread>  // NOLINT
 #include <vector>
 
@@ -18,6 +25,7 @@
 
 namespace bustub {
 
+template <typename Latch>
 class Counter {
  public:
   Counter() = default;
@@ -36,13 +44,13 @@ class Counter {
 
  private:
   int count_{0};
-  ReaderWriterLatch mutex{};
+  Latch mutex{};
 };
 
 // NOLINTNEXTLINE
 TEST(RWLatchTest, BasicTest) {
   int num_threads = 100;
-  Counter counter{};
+  Counter<ReaderWriterLatch> counter{};
   counter.Add(5);
   std::vector<std::thread> threads;
   for (int tid = 0; tid < num_threads; tid++) {
@@ -57,4 +65,150 @@ TEST(RWLatchTest, BasicTest) {
   }
   EXPECT_EQ(counter.Read(), 55);
 }
+
+// NOLINTNEXTLINE
+TEST(RWLatchTest, DistributedBasicTest) {
+  int num_threads = 100;
+  Counter<DistributedReaderWriterLatch> counter{};
+  counter.Add(5);
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    if (tid % 2 == 0) {
+      threads.emplace_back([&counter]() { counter.Read(); });
+    } else {
+      threads.emplace_back([&counter]() { counter.Add(1); });
+    }
+  }
+  for (int i = 0; i < num_threads; i++) {
+    threads[i].join();
+  }
+  EXPECT_EQ(counter.Read(), 55);
+}
+
+/** Readers must never see a writer in its critical section, and writers must never overlap. */
+template <typename Latch>
+void CheckExclusion() {
+  const int num_threads = 4;
+  const int num_ops = 20000;
+  Latch latch;
+  int writes = 0;
+  std::atomic<int> active_readers{0};
+  std::atomic<int> active_writers{0};
+  std::atomic<int> violations{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < num_ops; i++) {
+        if ((i + t) % 8 == 0) {
+          latch.WLock();
+          if (active_writers.fetch_add(1) != 0 || active_readers.load() != 0) {
+            violations++;
+          }
+          writes++;
+          active_writers--;
+          latch.WUnlock();
+        } else {
+          latch.RLock();
+          active_readers++;
+          if (active_writers.load() != 0) {
+            violations++;
+          }
+          active_readers--;
+          latch.RUnlock();
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(0, violations);
+  EXPECT_EQ(num_threads * num_ops / 8, writes);
+}
+
+// NOLINTNEXTLINE
+TEST(RWLatchTest, ExclusionTest) {
+  CheckExclusion<ReaderWriterLatch>();
+  CheckExclusion<DistributedReaderWriterLatch>();
+}
+
+/** Gives std::shared_mutex the interface of the latches, as a baseline. */
+class SharedMutexLatch {
+ public:
+  void WLock() { mutex_.lock(); }
+  void WUnlock() { mutex_.unlock(); }
+  void RLock() { mutex_.lock_shared(); }
+  void RUnlock() { mutex_.unlock_shared(); }
+
+ private:
+  std::shared_mutex mutex_;
+};
+
+/**
+ * Runs threads that read a small shared array under the read latch and increment it under the write latch.
+ * @return the number of latched sections per second
+ */
+template <typename Latch>
+double RunLatchBenchmark(int num_threads, int write_percent, std::chrono::milliseconds duration) {
+  Latch latch;
+  uint64_t data[8] = {};
+  std::atomic<bool> stop{false};
+  std::atomic<size_t> ops{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      std::mt19937 rng(t);
+      std::uniform_int_distribution<int> percent(0, 99);
+      size_t local_ops = 0;
+      uint64_t sum = 0;
+      while (!stop) {
+        if (percent(rng) < write_percent) {
+          latch.WLock();
+          for (auto &value : data) {
+            value++;
+          }
+          latch.WUnlock();
+        } else {
+          latch.RLock();
+          for (auto value : data) {
+            sum += value;
+          }
+          latch.RUnlock();
+        }
+        local_ops++;
+      }
+      ops += local_ops;
+      EXPECT_GE(sum, 0);
+    });
+  }
+  std::this_thread::sleep_for(duration);
+  stop = true;
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  std::chrono::duration<double> seconds = duration;
+  return ops / seconds.count();
+}
+
+/**
+ * Compares the latches across read/write ratios and thread counts.
+ *
+ * Run with --gtest_also_run_disabled_tests, sized by BUSTUB_LATCH_BENCH_MS.
+ */
+// NOLINTNEXTLINE
+TEST(RWLatchBenchmarkTest, DISABLED_RWLatchBenchmark) {
+  const char *ms_env = std::getenv("BUSTUB_LATCH_BENCH_MS");
+  const auto duration = std::chrono::milliseconds(ms_env != nullptr ? std::atoi(ms_env) : 500);
+  for (int write_percent : {0, 1, 10, 50}) {
+    for (int num_threads = 1; num_threads <= 4; num_threads *= 2) {
+      std::cout << "writes: " << write_percent << "%, threads: " << num_threads << ", ops/s ReaderWriterLatch: "
+                << RunLatchBenchmark<ReaderWriterLatch>(num_threads, write_percent, duration)
+                << ", DistributedReaderWriterLatch: "
+                << RunLatchBenchmark<DistributedReaderWriterLatch>(num_threads, write_percent, duration)
+                << ", std::shared_mutex: " << RunLatchBenchmark<SharedMutexLatch>(num_threads, write_percent, duration)
+                << std::endl;
+    }
+  }
+}
+
 }  // namespace bustub
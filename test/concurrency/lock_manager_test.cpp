@@ -10,11 +10,24 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
 #include <thread>  // NOLINT
+#include <vector>
 
+#include "common/bustub_instance.h"
 #include "concurrency/lock_manager.h"
 #include "concurrency/transaction_manager.h"
 #include "gtest/gtest.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
@@ -56,13 +69,111 @@ void BasicTest1(DeadlockMode deadlock_mode) {
 }
 
 // NOLINTNEXTLINE
-TEST(LockManagerTest, DISABLED_BasicTest) {
+TEST(LockManagerTest, BasicTest) {
   BasicTest1(DeadlockMode::PREVENTION);
   BasicTest1(DeadlockMode::DETECTION);
 }
 
 // NOLINTNEXTLINE
-TEST(LockManagerTest, DISABLED_GraphEdgeTest) {
+TEST(LockManagerTest, ExclusiveWaitTest) {
+  LockManager lock_mgr{TwoPLMode::REGULAR};
+  Transaction txn0(0);
+  Transaction txn1(1);
+  Transaction txn2(2);
+  RID rid{0, 0};
+
+  EXPECT_TRUE(lock_mgr.LockExclusive(&txn0, rid));
+  std::atomic<bool> released{false};
+  std::thread t1([&] {
+    EXPECT_TRUE(lock_mgr.LockShared(&txn1, rid));
+    EXPECT_TRUE(released);
+  });
+  std::thread t2([&] {
+    EXPECT_TRUE(lock_mgr.LockShared(&txn2, rid));
+    EXPECT_TRUE(released);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  released = true;
+  EXPECT_TRUE(lock_mgr.Unlock(&txn0, rid));
+  t1.join();
+  t2.join();
+  EXPECT_TRUE(txn1.IsSharedLocked(rid));
+  EXPECT_TRUE(txn2.IsSharedLocked(rid));
+
+  // Locking after unlocking violates two-phase locking.
+  EXPECT_EQ(TransactionState::SHRINKING, txn0.GetState());
+  EXPECT_FALSE(lock_mgr.LockShared(&txn0, RID{0, 1}));
+  EXPECT_EQ(TransactionState::ABORTED, txn0.GetState());
+  EXPECT_TRUE(lock_mgr.Unlock(&txn1, rid));
+  EXPECT_TRUE(lock_mgr.Unlock(&txn2, rid));
+  EXPECT_FALSE(lock_mgr.Unlock(&txn2, rid));
+}
+
+// NOLINTNEXTLINE
+TEST(LockManagerTest, UpgradeTest) {
+  LockManager lock_mgr{TwoPLMode::REGULAR};
+  Transaction txn0(0);
+  Transaction txn1(1);
+  Transaction txn2(2);
+  RID rid{3, 7};
+
+  EXPECT_TRUE(lock_mgr.LockShared(&txn0, rid));
+  EXPECT_TRUE(lock_mgr.LockShared(&txn1, rid));
+  std::atomic<bool> released{false};
+  std::thread t0([&] {
+    // The upgrade waits for the other reader, but goes ahead of the writer that queued up before it.
+    EXPECT_TRUE(lock_mgr.LockUpgrade(&txn0, rid));
+    EXPECT_TRUE(released);
+    EXPECT_TRUE(txn0.IsExclusiveLocked(rid));
+    EXPECT_FALSE(txn0.IsSharedLocked(rid));
+    released = false;
+    EXPECT_TRUE(lock_mgr.Unlock(&txn0, rid));
+  });
+  std::thread t2([&] {
+    EXPECT_TRUE(lock_mgr.LockExclusive(&txn2, rid));
+    EXPECT_FALSE(released);
+    EXPECT_TRUE(lock_mgr.Unlock(&txn2, rid));
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  released = true;
+  EXPECT_TRUE(lock_mgr.Unlock(&txn1, rid));
+  t0.join();
+  t2.join();
+}
+
+// NOLINTNEXTLINE
+TEST(LockManagerTest, UpgradeWithdrawnWaiterTest) {
+  LockManager lock_mgr{TwoPLMode::REGULAR};
+  Transaction txn0(0);
+  Transaction txn1(1);
+  Transaction txn2(2);
+  RID rid{3, 7};
+
+  EXPECT_TRUE(lock_mgr.LockShared(&txn0, rid));
+  EXPECT_TRUE(lock_mgr.LockShared(&txn1, rid));
+  std::atomic<bool> released{false};
+  std::thread t1([&] {
+    EXPECT_TRUE(lock_mgr.LockUpgrade(&txn1, rid));
+    EXPECT_TRUE(released);
+    EXPECT_TRUE(lock_mgr.Unlock(&txn1, rid));
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  // A writer queued behind the upgrade gives up, the upgrade is still pending.
+  txn2.SetLockTimeout(std::chrono::milliseconds(50));
+  EXPECT_FALSE(lock_mgr.LockExclusive(&txn2, rid));
+  EXPECT_EQ(TransactionState::ABORTED, txn2.GetState());
+
+  // So the other reader cannot upgrade ahead of it and write what txn1 has read.
+  released = true;
+  EXPECT_FALSE(lock_mgr.LockUpgrade(&txn0, rid));
+  EXPECT_EQ(TransactionState::ABORTED, txn0.GetState());
+  t1.join();
+  EXPECT_EQ(0U, lock_mgr.GetNumLockRequests());
+}
+
+// NOLINTNEXTLINE
+TEST(LockManagerTest, GraphEdgeTest) {
   LockManager lock_mgr{TwoPLMode::REGULAR, DeadlockMode::DETECTION};
   TransactionManager txn_mgr{&lock_mgr};
   RID rid{0, 0};
@@ -77,7 +188,7 @@ TEST(LockManagerTest, DISABLED_GraphEdgeTest) {
 }
 
 // NOLINTNEXTLINE
-TEST(LockManagerTest, DISABLED_BasicCycleTest) {
+TEST(LockManagerTest, BasicCycleTest) {
   LockManager lock_mgr{TwoPLMode::REGULAR, DeadlockMode::DETECTION}; /* Use Deadlock detection */
   TransactionManager txn_mgr{&lock_mgr};
 
@@ -95,7 +206,7 @@ TEST(LockManagerTest, DISABLED_BasicCycleTest) {
 }
 
 // NOLINTNEXTLINE
-TEST(LockManagerTest, DISABLED_BasicDeadlockDetectionTest) {
+TEST(LockManagerTest, BasicDeadlockDetectionTest) {
   LockManager lock_mgr{TwoPLMode::REGULAR, DeadlockMode::DETECTION};
   cycle_detection_interval = std::chrono::milliseconds(500);
   TransactionManager txn_mgr{&lock_mgr};
@@ -147,4 +258,702 @@ TEST(LockManagerTest, DISABLED_BasicDeadlockDetectionTest) {
   delete txn0;
   delete txn1;
 }
+
+// NOLINTNEXTLINE
+TEST(LockManagerTest, WoundWaitTest) {
+  LockManager lock_mgr{TwoPLMode::REGULAR, DeadlockMode::PREVENTION, PreventionPolicy::WOUND_WAIT};
+  Transaction txn0(0);
+  Transaction txn1(1);
+  RID rid0{0, 0};
+  RID rid1{1, 1};
+
+  // The younger transaction waits for the older one, which then wounds it instead of closing the cycle.
+  EXPECT_TRUE(lock_mgr.LockExclusive(&txn0, rid0));
+  EXPECT_TRUE(lock_mgr.LockExclusive(&txn1, rid1));
+  std::thread t1([&] {
+    EXPECT_FALSE(lock_mgr.LockExclusive(&txn1, rid0));
+    EXPECT_EQ(TransactionState::ABORTED, txn1.GetState());
+    EXPECT_TRUE(lock_mgr.Unlock(&txn1, rid1));
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_TRUE(lock_mgr.LockExclusive(&txn0, rid1));
+  EXPECT_EQ(TransactionState::GROWING, txn0.GetState());
+  t1.join();
+  EXPECT_TRUE(lock_mgr.Unlock(&txn0, rid0));
+  EXPECT_TRUE(lock_mgr.Unlock(&txn0, rid1));
+}
+
+// NOLINTNEXTLINE
+TEST(LockManagerTest, WoundedCommitTest) {
+  LockManager lock_mgr{TwoPLMode::STRICT, DeadlockMode::PREVENTION, PreventionPolicy::WOUND_WAIT};
+  TransactionManager txn_mgr{&lock_mgr};
+  auto *txn0 = txn_mgr.Begin();
+  auto *txn1 = txn_mgr.Begin();
+  RID rid{0, 0};
+
+  // The younger transaction holds all its locks when the older one wounds it, so it is not waiting to notice.
+  EXPECT_TRUE(lock_mgr.LockExclusive(txn1, rid));
+  std::thread t0([&] { EXPECT_TRUE(lock_mgr.LockExclusive(txn0, rid)); });
+  while (txn1->GetState() != TransactionState::ABORTED) {
+    std::this_thread::yield();
+  }
+  // Its commit rolls it back instead, which hands the lock to the older transaction.
+  EXPECT_FALSE(txn_mgr.Commit(txn1));
+  EXPECT_EQ(TransactionState::ABORTED, txn1->GetState());
+  t0.join();
+  EXPECT_TRUE(txn_mgr.Commit(txn0));
+  txn_mgr.Recycle(txn0);
+  txn_mgr.Recycle(txn1);
+}
+
+// NOLINTNEXTLINE
+TEST(LockManagerTest, WaitDieTest) {
+  LockManager lock_mgr{TwoPLMode::REGULAR, DeadlockMode::PREVENTION, PreventionPolicy::WAIT_DIE};
+  Transaction txn0(0);
+  Transaction txn1(1);
+  Transaction txn2(2);
+  RID rid{0, 0};
+
+  // A younger requester dies right away, an older one waits.
+  EXPECT_TRUE(lock_mgr.LockExclusive(&txn1, rid));
+  EXPECT_FALSE(lock_mgr.LockShared(&txn2, rid));
+  EXPECT_EQ(TransactionState::ABORTED, txn2.GetState());
+  std::atomic<bool> released{false};
+  std::thread t0([&] {
+    EXPECT_TRUE(lock_mgr.LockShared(&txn0, rid));
+    EXPECT_TRUE(released);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  released = true;
+  EXPECT_TRUE(lock_mgr.Unlock(&txn1, rid));
+  t0.join();
+  EXPECT_EQ(TransactionState::GROWING, txn0.GetState());
+  EXPECT_TRUE(lock_mgr.Unlock(&txn0, rid));
+}
+
+// NOLINTNEXTLINE
+TEST(LockManagerTest, CompatibilityTest) {
+  // Under wait-die a younger transaction gives up instead of waiting for an older one, so nothing ever blocks here.
+  LockManager lock_mgr{TwoPLMode::REGULAR, DeadlockMode::PREVENTION, PreventionPolicy::WAIT_DIE};
+  const LockMode modes[] = {LockMode::INTENTION_SHARED, LockMode::INTENTION_EXCLUSIVE, LockMode::SHARED,
+                            LockMode::SHARED_INTENTION_EXCLUSIVE, LockMode::EXCLUSIVE};
+  const bool compatible[5][5] = {{true, true, true, true, false},
+                                 {true, true, false, false, false},
+                                 {true, false, true, false, false},
+                                 {true, false, false, false, false},
+                                 {false, false, false, false, false}};
+  txn_id_t next_txn_id = 0;
+  for (int held = 0; held < 5; held++) {
+    for (int requested = 0; requested < 5; requested++) {
+      Transaction older(next_txn_id++);
+      Transaction younger(next_txn_id++);
+      ASSERT_TRUE(lock_mgr.LockTable(&older, 0, modes[held]));
+      EXPECT_EQ(compatible[held][requested], lock_mgr.LockTable(&younger, 0, modes[requested]));
+      lock_mgr.UnlockTable(&older, 0);
+      lock_mgr.UnlockTable(&younger, 0);
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(LockManagerTest, HierarchyTest) {
+  LockManager lock_mgr{TwoPLMode::STRICT};
+  TransactionManager txn_mgr{&lock_mgr};
+  table_oid_t oid = 3;
+  RID rid{5, 1};
+
+  // Rows can only be locked under a table lock.
+  auto *txn0 = txn_mgr.Begin();
+  EXPECT_FALSE(lock_mgr.LockRow(txn0, oid, rid, LockMode::SHARED));
+  EXPECT_EQ(TransactionState::ABORTED, txn0->GetState());
+  txn_mgr.Abort(txn0);
+
+  // Readers and writers of different rows share the table.
+  auto *reader = txn_mgr.Begin();
+  auto *writer = txn_mgr.Begin();
+  EXPECT_TRUE(lock_mgr.LockTable(reader, oid, LockMode::INTENTION_SHARED));
+  EXPECT_TRUE(lock_mgr.LockTable(writer, oid, LockMode::INTENTION_EXCLUSIVE));
+  EXPECT_TRUE(lock_mgr.LockRow(writer, oid, rid, LockMode::EXCLUSIVE));
+  EXPECT_TRUE(lock_mgr.LockRow(reader, oid, RID{5, 2}, LockMode::SHARED));
+  // A shared page lock covers the rows of the page, but an intention shared one does not permit writing them.
+  EXPECT_TRUE(lock_mgr.LockPage(reader, oid, 6, LockMode::SHARED));
+  EXPECT_TRUE(lock_mgr.LockRow(reader, oid, RID{6, 0}, LockMode::SHARED));
+  EXPECT_FALSE(reader->IsSharedLocked(RID{6, 0}));
+  EXPECT_FALSE(lock_mgr.LockRow(reader, oid, RID{6, 0}, LockMode::EXCLUSIVE));
+  txn_mgr.Abort(reader);
+
+  // A scan takes a single shared table lock, which waits for the writer.
+  auto *scanner = txn_mgr.Begin();
+  std::atomic<bool> committed{false};
+  std::thread scan([&] {
+    EXPECT_TRUE(lock_mgr.LockTable(scanner, oid, LockMode::SHARED));
+    EXPECT_TRUE(committed);
+    for (uint32_t slot = 0; slot < 100; slot++) {
+      EXPECT_TRUE(lock_mgr.LockRow(scanner, oid, RID{5, slot}, LockMode::SHARED));
+    }
+    EXPECT_TRUE(scanner->GetSharedLockSet()->empty());
+    // Updating some of the scanned rows needs SIX.
+    EXPECT_TRUE(lock_mgr.LockTable(scanner, oid, LockMode::INTENTION_EXCLUSIVE));
+    EXPECT_EQ(LockMode::SHARED_INTENTION_EXCLUSIVE, scanner->GetTableLockMap()->at(oid));
+    EXPECT_TRUE(lock_mgr.LockRow(scanner, oid, rid, LockMode::EXCLUSIVE));
+    EXPECT_TRUE(scanner->IsExclusiveLocked(rid));
+    txn_mgr.Commit(scanner);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  committed = true;
+  txn_mgr.Commit(writer);
+  scan.join();
+  EXPECT_TRUE(scanner->GetTableLockMap()->empty());
+  EXPECT_TRUE(scanner->GetExclusiveLockSet()->empty());
+
+  delete txn0;
+  delete reader;
+  delete writer;
+  delete scanner;
+}
+
+// NOLINTNEXTLINE
+TEST(LockManagerTest, EscalationTest) {
+  LockManager lock_mgr{TwoPLMode::STRICT};
+  lock_mgr.SetEscalationThreshold(10);
+  TransactionManager txn_mgr{&lock_mgr};
+  auto lock_rows = [&](Transaction *txn, table_oid_t oid, LockMode lock_mode, uint32_t first, uint32_t count) {
+    for (uint32_t slot = first; slot < first + count; slot++) {
+      EXPECT_TRUE(lock_mgr.LockRow(txn, oid, RID{static_cast<page_id_t>(oid), slot}, lock_mode));
+    }
+  };
+
+  // A reader's row locks become a shared table lock.
+  auto *reader = txn_mgr.Begin();
+  EXPECT_TRUE(lock_mgr.LockTable(reader, 0, LockMode::INTENTION_SHARED));
+  lock_rows(reader, 0, LockMode::SHARED, 0, 10);
+  EXPECT_EQ(0U, lock_mgr.GetNumEscalations());
+  EXPECT_EQ(11U, lock_mgr.GetNumLockRequests());
+  lock_rows(reader, 0, LockMode::SHARED, 10, 1);
+  EXPECT_EQ(1U, lock_mgr.GetNumEscalations());
+  EXPECT_EQ(1U, lock_mgr.GetNumLockRequests());
+  EXPECT_EQ(LockMode::SHARED, reader->GetTableLockMap()->at(0));
+  EXPECT_TRUE(reader->GetSharedLockSet()->empty());
+
+  // A writer that only read so far gets SIX, so it can still write rows.
+  auto *writer = txn_mgr.Begin();
+  EXPECT_TRUE(lock_mgr.LockTable(writer, 1, LockMode::INTENTION_EXCLUSIVE));
+  lock_rows(writer, 1, LockMode::SHARED, 0, 11);
+  EXPECT_EQ(2U, lock_mgr.GetNumEscalations());
+  EXPECT_EQ(LockMode::SHARED_INTENTION_EXCLUSIVE, writer->GetTableLockMap()->at(1));
+  lock_rows(writer, 1, LockMode::EXCLUSIVE, 0, 10);
+  EXPECT_EQ(10U, writer->GetExclusiveLockSet()->size());
+  // Once it writes more rows, the exclusive row locks become an exclusive table lock.
+  lock_rows(writer, 1, LockMode::EXCLUSIVE, 10, 1);
+  EXPECT_EQ(3U, lock_mgr.GetNumEscalations());
+  EXPECT_EQ(LockMode::EXCLUSIVE, writer->GetTableLockMap()->at(1));
+  EXPECT_TRUE(writer->GetExclusiveLockSet()->empty());
+
+  // Escalation does not wait for the table lock, the row locks are kept instead.
+  auto *other_writer = txn_mgr.Begin();
+  EXPECT_TRUE(lock_mgr.LockTable(other_writer, 2, LockMode::INTENTION_EXCLUSIVE));
+  lock_rows(other_writer, 2, LockMode::EXCLUSIVE, 100, 1);
+  auto *blocked_reader = txn_mgr.Begin();
+  EXPECT_TRUE(lock_mgr.LockTable(blocked_reader, 2, LockMode::INTENTION_SHARED));
+  lock_rows(blocked_reader, 2, LockMode::SHARED, 0, 11);
+  EXPECT_EQ(3U, lock_mgr.GetNumEscalations());
+  EXPECT_EQ(11U, blocked_reader->GetSharedLockSet()->size());
+
+  for (auto *txn : {reader, writer, other_writer, blocked_reader}) {
+    txn_mgr.Commit(txn);
+    delete txn;
+  }
+  EXPECT_EQ(0U, lock_mgr.GetNumLockRequests());
+  EXPECT_EQ(0U, lock_mgr.GetLockTableMemory());
+}
+
+/** Removes every log segment file written for the given log name. */
+static void RemoveLogSegments(const std::string &log_name) {
+  std::error_code ec;
+  for (const auto &entry : std::filesystem::directory_iterator(".", ec)) {
+    std::string name = entry.path().filename().string();
+    if (name.compare(0, log_name.size() + 1, log_name + ".") == 0) {
+      std::filesystem::remove(entry.path(), ec);
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(LockManagerTest, EscalatedTableWriteTest) {
+  remove("lock_manager_test.db");
+  RemoveLogSegments("lock_manager_test.log");
+  auto *bustub = new BustubInstance("lock_manager_test.db");
+  bustub->log_manager_->RunFlushThread();
+  bustub->lock_manager_->SetEscalationThreshold(10);
+  auto *txn_mgr = bustub->transaction_manager_;
+  Schema schema{std::vector<Column>{Column{"a", TypeId::INTEGER}}};
+  const table_oid_t oid = 0;
+
+  auto *txn = txn_mgr->Begin();
+  TableHeap table(bustub->buffer_pool_manager_, bustub->lock_manager_, bustub->log_manager_, txn, nullptr, oid);
+  std::vector<RID> rids(20);
+  for (int i = 0; i < 20; i++) {
+    ASSERT_TRUE(table.InsertTuple(Tuple({ValueFactory::GetIntegerValue(i)}, &schema), &rids[i], txn));
+  }
+  txn_mgr->Commit(txn);
+  delete txn;
+
+  // Reading every row escalates the reader's row locks to a shared table lock.
+  size_t escalations = bustub->lock_manager_->GetNumEscalations();
+  auto *reader = txn_mgr->Begin();
+  Tuple tuple;
+  for (const auto &rid : rids) {
+    ASSERT_TRUE(table.GetTuple(rid, &tuple, reader));
+  }
+  EXPECT_EQ(escalations + 1, bustub->lock_manager_->GetNumEscalations());
+  EXPECT_EQ(LockMode::SHARED, reader->GetTableLockMap()->at(oid));
+  EXPECT_TRUE(reader->GetSharedLockSet()->empty());
+
+  // The reader gave up its row locks, but a writer of one of its rows still waits for it.
+  std::atomic<bool> deleted{false};
+  auto *writer = txn_mgr->Begin();
+  std::thread writer_thread([&] {
+    EXPECT_TRUE(table.MarkDelete(rids[0], writer));
+    deleted = true;
+    txn_mgr->Commit(writer);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_FALSE(deleted);
+  txn_mgr->Commit(reader);
+  writer_thread.join();
+  EXPECT_TRUE(deleted);
+  delete reader;
+  delete writer;
+
+  delete bustub;
+  remove("lock_manager_test.db");
+  RemoveLogSegments("lock_manager_test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(LockManagerTest, WaitPolicyTest) {
+  LockManager lock_mgr{TwoPLMode::STRICT};
+  TransactionManager txn_mgr{&lock_mgr};
+  RID rid{0, 0};
+  RID other_rid{0, 1};
+
+  auto *holder = txn_mgr.Begin();
+  EXPECT_TRUE(lock_mgr.LockExclusive(holder, rid));
+
+  // SKIP LOCKED fails right away and leaves the transaction usable.
+  auto *skipper = txn_mgr.Begin();
+  EXPECT_FALSE(lock_mgr.LockShared(skipper, rid, LockWaitPolicy::SKIP_LOCKED));
+  EXPECT_EQ(TransactionState::GROWING, skipper->GetState());
+  EXPECT_TRUE(skipper->GetSharedLockSet()->empty());
+  EXPECT_TRUE(lock_mgr.LockShared(skipper, other_rid, LockWaitPolicy::SKIP_LOCKED));
+
+  // A failed upgrade keeps the shared lock.
+  auto *reader = txn_mgr.Begin();
+  EXPECT_TRUE(lock_mgr.LockShared(reader, other_rid));
+  EXPECT_FALSE(lock_mgr.LockUpgrade(skipper, other_rid, LockWaitPolicy::SKIP_LOCKED));
+  EXPECT_EQ(TransactionState::GROWING, skipper->GetState());
+  EXPECT_TRUE(skipper->IsSharedLocked(other_rid));
+
+  // NOWAIT aborts the transaction instead of waiting.
+  auto *nowait = txn_mgr.Begin();
+  EXPECT_FALSE(lock_mgr.LockShared(nowait, rid, LockWaitPolicy::NOWAIT));
+  EXPECT_EQ(TransactionState::ABORTED, nowait->GetState());
+  txn_mgr.Abort(nowait);
+
+  // Once the lock is free, the policies make no difference.
+  txn_mgr.Commit(holder);
+  EXPECT_TRUE(lock_mgr.LockExclusive(skipper, rid, LockWaitPolicy::NOWAIT));
+
+  for (auto *txn : {skipper, reader}) {
+    txn_mgr.Commit(txn);
+  }
+  for (auto *txn : {holder, skipper, reader, nowait}) {
+    delete txn;
+  }
+  EXPECT_EQ(0U, lock_mgr.GetNumLockRequests());
+}
+
+// NOLINTNEXTLINE
+TEST(LockManagerTest, LockTimeoutTest) {
+  LockManager lock_mgr{TwoPLMode::STRICT};
+  TransactionManager txn_mgr{&lock_mgr};
+  RID rid{0, 0};
+
+  auto *holder = txn_mgr.Begin();
+  EXPECT_TRUE(lock_mgr.LockExclusive(holder, rid));
+
+  // The waiter gives up once its timeout expires.
+  auto *waiter = txn_mgr.Begin();
+  waiter->SetLockTimeout(std::chrono::milliseconds(50));
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_FALSE(lock_mgr.LockShared(waiter, rid));
+  EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(50));
+  EXPECT_EQ(TransactionState::ABORTED, waiter->GetState());
+  txn_mgr.Abort(waiter);
+
+  // A lock granted before the timeout expires is kept.
+  auto *patient = txn_mgr.Begin();
+  patient->SetLockTimeout(std::chrono::seconds(10));
+  std::thread t([&] {
+    EXPECT_TRUE(lock_mgr.LockShared(patient, rid));
+    EXPECT_EQ(TransactionState::GROWING, patient->GetState());
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  txn_mgr.Commit(holder);
+  t.join();
+  txn_mgr.Commit(patient);
+
+  for (auto *txn : {holder, waiter, patient}) {
+    delete txn;
+  }
+  EXPECT_EQ(0U, lock_mgr.GetNumLockRequests());
+}
+
+/** Draws ranks in [0, n) following a Zipfian distribution. */
+class ZipfianGenerator {
+ public:
+  ZipfianGenerator(size_t n, double theta) : cdf_(n) {
+    double sum = 0;
+    for (size_t i = 0; i < n; i++) {
+      sum += 1.0 / std::pow(static_cast<double>(i + 1), theta);
+      cdf_[i] = sum;
+    }
+    for (auto &value : cdf_) {
+      value /= sum;
+    }
+  }
+
+  size_t Next(std::mt19937_64 *rng) const {
+    double u = std::uniform_real_distribution<double>(0, 1)(*rng);
+    return std::min<size_t>(std::lower_bound(cdf_.begin(), cdf_.end(), u) - cdf_.begin(), cdf_.size() - 1);
+  }
+
+ private:
+  std::vector<double> cdf_;
+};
+
+/**
+ * Reports lock acquisitions and releases per second for uniform and Zipfian (theta 0.99) RIDs, several read/write
+ * mixes and thread counts, with a single latch versus the striped lock table. Every transaction locks
+ * BUSTUB_LOCK_BENCH_LOCKS_PER_TXN (4 by default) RIDs in RID order, so that it cannot deadlock, and then unlocks them.
+ * Each configuration runs for BUSTUB_LOCK_BENCH_MS milliseconds (500 by default).
+ */
+// NOLINTNEXTLINE
+TEST(LockManagerTest, DISABLED_LockManagerBenchmark) {
+  const char *ms_env = std::getenv("BUSTUB_LOCK_BENCH_MS");
+  const auto duration = std::chrono::milliseconds(ms_env != nullptr ? std::atoi(ms_env) : 500);
+  const char *locks_env = std::getenv("BUSTUB_LOCK_BENCH_LOCKS_PER_TXN");
+  const size_t locks_per_txn = locks_env != nullptr ? std::atoi(locks_env) : 4;
+  const size_t num_rids = 100000;
+  const ZipfianGenerator zipfian(num_rids, 0.99);
+
+  for (bool zipf : {false, true}) {
+    for (double read_ratio : {1.0, 0.9, 0.5}) {
+      for (size_t num_stripes : {static_cast<size_t>(1), static_cast<size_t>(LOCK_TABLE_STRIPES)}) {
+        for (size_t num_threads = 1; num_threads <= 8; num_threads *= 2) {
+          LockManager lock_mgr{TwoPLMode::REGULAR, DeadlockMode::PREVENTION, PreventionPolicy::WOUND_WAIT, num_stripes};
+          std::atomic<bool> stop{false};
+          std::atomic<txn_id_t> next_txn_id{0};
+          std::atomic<size_t> total_ops{0};
+          std::vector<std::thread> threads;
+          for (size_t t = 0; t < num_threads; t++) {
+            threads.emplace_back([&, t] {
+              std::mt19937_64 rng(t);
+              std::uniform_int_distribution<size_t> uniform(0, num_rids - 1);
+              std::bernoulli_distribution read(read_ratio);
+              std::vector<size_t> rids;
+              size_t ops = 0;
+              while (!stop) {
+                rids.clear();
+                while (rids.size() < locks_per_txn) {
+                  size_t rid = zipf ? zipfian.Next(&rng) : uniform(rng);
+                  if (std::find(rids.begin(), rids.end(), rid) == rids.end()) {
+                    rids.push_back(rid);
+                  }
+                }
+                std::sort(rids.begin(), rids.end());
+                Transaction txn(next_txn_id++);
+                for (auto rid : rids) {
+                  RID record(static_cast<page_id_t>(rid / 64), static_cast<uint32_t>(rid % 64));
+                  bool locked = read(rng) ? lock_mgr.LockShared(&txn, record) : lock_mgr.LockExclusive(&txn, record);
+                  ASSERT_TRUE(locked);
+                }
+                for (auto rid : rids) {
+                  lock_mgr.Unlock(&txn, RID(static_cast<page_id_t>(rid / 64), static_cast<uint32_t>(rid % 64)));
+                }
+                ops += 2 * rids.size();
+              }
+              total_ops += ops;
+            });
+          }
+          std::this_thread::sleep_for(duration);
+          stop = true;
+          for (auto &thread : threads) {
+            thread.join();
+          }
+          std::chrono::duration<double> seconds = duration;
+          std::cout << (zipf ? "zipfian" : "uniform") << ", read ratio: " << read_ratio << ", stripes: " << num_stripes
+                    << ", threads: " << num_threads << ", ops/s: " << total_ops / seconds.count() << std::endl;
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Runs transactions that exclusively lock BUSTUB_DEADLOCK_BENCH_LOCKS_PER_TXN (4 by default) random RIDs out of 16 in
+ * random order, so that they deadlock often, for BUSTUB_DEADLOCK_BENCH_MS milliseconds (1000 by default) per
+ * configuration. Aborted transactions restart with their original id. Reports commits per second, the abort rate and
+ * the latency from the first attempt of a transaction to its commit for wound-wait, wait-die and detection.
+ */
+// NOLINTNEXTLINE
+TEST(LockManagerTest, DISABLED_DeadlockBenchmark) {
+  const char *ms_env = std::getenv("BUSTUB_DEADLOCK_BENCH_MS");
+  const auto duration = std::chrono::milliseconds(ms_env != nullptr ? std::atoi(ms_env) : 1000);
+  const char *locks_env = std::getenv("BUSTUB_DEADLOCK_BENCH_LOCKS_PER_TXN");
+  const size_t locks_per_txn = locks_env != nullptr ? std::atoi(locks_env) : 4;
+  const uint32_t num_rids = 16;
+
+  struct Config {
+    const char *name_;
+    DeadlockMode deadlock_mode_;
+    PreventionPolicy prevention_policy_;
+  };
+  for (const auto &config : {Config{"wound-wait", DeadlockMode::PREVENTION, PreventionPolicy::WOUND_WAIT},
+                             Config{"wait-die", DeadlockMode::PREVENTION, PreventionPolicy::WAIT_DIE},
+                             Config{"detection", DeadlockMode::DETECTION, PreventionPolicy::WOUND_WAIT}}) {
+    for (size_t num_threads : {2, 4, 8}) {
+      LockManager lock_mgr{TwoPLMode::REGULAR, config.deadlock_mode_, config.prevention_policy_};
+      std::atomic<bool> stop{false};
+      std::atomic<txn_id_t> next_txn_id{0};
+      std::atomic<size_t> aborts{0};
+      std::vector<std::vector<double>> latencies(num_threads);
+      std::vector<std::thread> threads;
+      for (size_t t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t] {
+          std::mt19937_64 rng(t);
+          std::vector<RID> rids;
+          while (!stop) {
+            rids.clear();
+            while (rids.size() < locks_per_txn) {
+              RID rid(0, rng() % num_rids);
+              if (std::find(rids.begin(), rids.end(), rid) == rids.end()) {
+                rids.push_back(rid);
+              }
+            }
+            txn_id_t txn_id = next_txn_id++;
+            auto start = std::chrono::steady_clock::now();
+            bool committed = false;
+            while (!committed && !stop) {
+              Transaction txn(txn_id);
+              size_t locked = 0;
+              while (locked < rids.size() && lock_mgr.LockExclusive(&txn, rids[locked])) {
+                locked++;
+              }
+              // A wounded transaction may hold all its locks already, but must not commit.
+              committed = locked == rids.size() && txn.GetState() == TransactionState::GROWING;
+              for (size_t i = 0; i < locked; i++) {
+                lock_mgr.Unlock(&txn, rids[i]);
+              }
+              if (!committed) {
+                aborts++;
+              }
+            }
+            if (committed) {
+              std::chrono::duration<double, std::micro> latency = std::chrono::steady_clock::now() - start;
+              latencies[t].push_back(latency.count());
+            }
+          }
+        });
+      }
+      std::this_thread::sleep_for(duration);
+      stop = true;
+      for (auto &thread : threads) {
+        thread.join();
+      }
+
+      std::vector<double> all;
+      for (const auto &thread_latencies : latencies) {
+        all.insert(all.end(), thread_latencies.begin(), thread_latencies.end());
+      }
+      std::sort(all.begin(), all.end());
+      auto percentile = [&all](double p) { return all.empty() ? 0 : all[static_cast<size_t>(p * (all.size() - 1))]; };
+      std::chrono::duration<double> seconds = duration;
+      std::cout << config.name_ << ", threads: " << num_threads << ", commits/s: " << all.size() / seconds.count()
+                << ", aborts per commit: " << static_cast<double>(aborts) / std::max<size_t>(all.size(), 1)
+                << ", p50 us: " << percentile(0.5) << ", p99 us: " << percentile(0.99)
+                << ", p99.9 us: " << percentile(0.999) << ", max us: " << (all.empty() ? 0 : all.back()) << std::endl;
+    }
+  }
+}
+
+/**
+ * Induces BUSTUB_DEADLOCK_RESOLUTION_ROUNDS (200 by default) two-transaction deadlocks and reports the time from the
+ * request that closes the cycle until the victim gives up waiting.
+ */
+// NOLINTNEXTLINE
+TEST(LockManagerTest, DISABLED_DeadlockResolutionBenchmark) {
+  const char *rounds_env = std::getenv("BUSTUB_DEADLOCK_RESOLUTION_ROUNDS");
+  const int rounds = rounds_env != nullptr ? std::atoi(rounds_env) : 200;
+  LockManager lock_mgr{TwoPLMode::REGULAR, DeadlockMode::DETECTION};
+  RID rid0{0, 0};
+  RID rid1{0, 1};
+
+  std::vector<double> resolution_times;
+  for (int round = 0; round < rounds; round++) {
+    Transaction older(2 * round);
+    Transaction younger(2 * round + 1);
+    ASSERT_TRUE(lock_mgr.LockExclusive(&older, rid0));
+    ASSERT_TRUE(lock_mgr.LockExclusive(&younger, rid1));
+    std::chrono::steady_clock::time_point resolved;
+    std::thread waiter([&] {
+      EXPECT_FALSE(lock_mgr.LockExclusive(&younger, rid0));
+      resolved = std::chrono::steady_clock::now();
+      lock_mgr.Unlock(&younger, rid1);
+    });
+    // Give the younger transaction time to block, then close the cycle.
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    auto closed = std::chrono::steady_clock::now();
+    EXPECT_TRUE(lock_mgr.LockExclusive(&older, rid1));
+    waiter.join();
+    lock_mgr.Unlock(&older, rid0);
+    lock_mgr.Unlock(&older, rid1);
+    std::chrono::duration<double, std::micro> resolution_time = resolved - closed;
+    resolution_times.push_back(resolution_time.count());
+  }
+  std::sort(resolution_times.begin(), resolution_times.end());
+  std::cout << "deadlocks: " << rounds << ", resolution p50 us: " << resolution_times[rounds / 2]
+            << ", p99 us: " << resolution_times[rounds * 99 / 100] << ", max us: " << resolution_times.back()
+            << std::endl;
+}
+
+/**
+ * Locks the BUSTUB_SCAN_BENCH_ROWS rows (1000000 by default) of a table for a scan, once with a row lock per row under
+ * an intention shared table lock and once with a single shared table lock, and reports the time to lock and release.
+ */
+// NOLINTNEXTLINE
+TEST(LockManagerTest, DISABLED_ScanLockBenchmark) {
+  const char *rows_env = std::getenv("BUSTUB_SCAN_BENCH_ROWS");
+  const uint32_t num_rows = rows_env != nullptr ? std::atoi(rows_env) : 1000000;
+  const uint32_t rows_per_page = 64;
+  LockManager lock_mgr{TwoPLMode::STRICT};
+  TransactionManager txn_mgr{&lock_mgr};
+
+  for (LockMode table_mode : {LockMode::INTENTION_SHARED, LockMode::SHARED}) {
+    auto *txn = txn_mgr.Begin();
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(lock_mgr.LockTable(txn, 0, table_mode));
+    for (uint32_t row = 0; row < num_rows; row++) {
+      ASSERT_TRUE(lock_mgr.LockRow(txn, 0, RID(row / rows_per_page, row % rows_per_page), LockMode::SHARED));
+    }
+    size_t row_locks = txn->GetSharedLockSet()->size();
+    auto locked = std::chrono::steady_clock::now();
+    txn_mgr.Commit(txn);
+    auto released = std::chrono::steady_clock::now();
+    delete txn;
+    std::chrono::duration<double, std::milli> lock_time = locked - start;
+    std::chrono::duration<double, std::milli> release_time = released - locked;
+    std::cout << (table_mode == LockMode::SHARED ? "table S" : "table IS + row S") << ", rows: " << num_rows
+              << ", row locks held: " << row_locks << ", lock ms: " << lock_time.count()
+              << ", release ms: " << release_time.count() << std::endl;
+  }
+}
+
+/**
+ * Locks BUSTUB_ESCALATION_BENCH_ROWS rows (1000000 by default) of a table one by one under an intention shared table
+ * lock, with and without lock escalation, and reports the time, the lock requests and the lock table memory.
+ */
+// NOLINTNEXTLINE
+TEST(LockManagerTest, DISABLED_EscalationBenchmark) {
+  const char *rows_env = std::getenv("BUSTUB_ESCALATION_BENCH_ROWS");
+  const uint32_t num_rows = rows_env != nullptr ? std::atoi(rows_env) : 1000000;
+  const uint32_t rows_per_page = 64;
+
+  for (bool escalation : {false, true}) {
+    LockManager lock_mgr{TwoPLMode::STRICT};
+    lock_mgr.SetEscalationThreshold(escalation ? LOCK_ESCALATION_THRESHOLD : num_rows + 1);
+    TransactionManager txn_mgr{&lock_mgr};
+    auto *txn = txn_mgr.Begin();
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(lock_mgr.LockTable(txn, 0, LockMode::INTENTION_SHARED));
+    for (uint32_t row = 0; row < num_rows; row++) {
+      ASSERT_TRUE(lock_mgr.LockRow(txn, 0, RID(row / rows_per_page, row % rows_per_page), LockMode::SHARED));
+    }
+    auto locked = std::chrono::steady_clock::now();
+    size_t requests = lock_mgr.GetNumLockRequests();
+    size_t memory = lock_mgr.GetLockTableMemory();
+    txn_mgr.Commit(txn);
+    auto released = std::chrono::steady_clock::now();
+    delete txn;
+    std::chrono::duration<double, std::milli> lock_time = locked - start;
+    std::chrono::duration<double, std::milli> release_time = released - locked;
+    std::cout << (escalation ? "escalation" : "no escalation") << ", rows: " << num_rows
+              << ", escalations: " << lock_mgr.GetNumEscalations() << ", lock requests: " << requests
+              << ", lock table bytes: " << memory << ", lock ms: " << lock_time.count()
+              << ", release ms: " << release_time.count() << std::endl;
+  }
+}
+
+/**
+ * Drains a queue of BUSTUB_JOB_BENCH_JOBS jobs (2000 by default) with 1 to 4 workers. A worker claims a job by locking
+ * its row exclusively and holds the lock for BUSTUB_JOB_BENCH_US microseconds (100 by default) of work. All workers
+ * scan the queue from the front; with BLOCK they queue up behind each other on the same job, with SKIP LOCKED they move
+ * on to the next free one.
+ */
+// NOLINTNEXTLINE
+TEST(LockManagerTest, DISABLED_JobQueueBenchmark) {
+  const char *jobs_env = std::getenv("BUSTUB_JOB_BENCH_JOBS");
+  const char *us_env = std::getenv("BUSTUB_JOB_BENCH_US");
+  const uint32_t num_jobs = jobs_env != nullptr ? std::atoi(jobs_env) : 2000;
+  const auto work = std::chrono::microseconds(us_env != nullptr ? std::atoi(us_env) : 100);
+
+  for (LockWaitPolicy policy : {LockWaitPolicy::BLOCK, LockWaitPolicy::SKIP_LOCKED}) {
+    for (int num_threads = 1; num_threads <= 4; num_threads *= 2) {
+      LockManager lock_mgr{TwoPLMode::STRICT};
+      TransactionManager txn_mgr{&lock_mgr};
+      std::vector<std::atomic<bool>> done(num_jobs);
+      std::atomic<uint32_t> num_done{0};
+      std::atomic<uint32_t> num_skipped{0};
+      std::vector<std::thread> threads;
+      auto start = std::chrono::steady_clock::now();
+      for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&] {
+          while (num_done < num_jobs) {
+            for (uint32_t job = 0; job < num_jobs; job++) {
+              if (done[job]) {
+                continue;
+              }
+              auto *txn = txn_mgr.Begin();
+              if (!lock_mgr.LockExclusive(txn, RID(job / 64, job % 64), policy)) {
+                num_skipped++;
+                txn_mgr.Abort(txn);
+                delete txn;
+                continue;
+              }
+              // Another worker may have finished the job while this one waited for it.
+              bool claimed = !done[job];
+              if (claimed) {
+                std::this_thread::sleep_for(work);
+                done[job] = true;
+                num_done++;
+              }
+              txn_mgr.Commit(txn);
+              delete txn;
+              if (claimed) {
+                break;
+              }
+            }
+          }
+        });
+      }
+      for (auto &thread : threads) {
+        thread.join();
+      }
+      std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+      std::cout << (policy == LockWaitPolicy::BLOCK ? "BLOCK" : "SKIP LOCKED") << ", threads: " << num_threads
+                << ", jobs/s: " << num_jobs / seconds.count() << ", skipped locks: " << num_skipped << std::endl;
+    }
+  }
+}
+
 }  // namespace bustub
@@ -0,0 +1,415 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// mvcc_test.cpp
+//
+// Identification: test/concurrency/mvcc_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "concurrency/transaction_manager.h"
+#include "concurrency/version_store.h"
+#include "gtest/gtest.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/** A versioned table of single integer tuples. */
+class MVCCTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Garbage is collected when the tests ask for it.
+    gc_interval = std::chrono::hours(1);
+    disk_manager_ = new DiskManager(db_file_);
+    bpm_ = new BufferPoolManager(50, disk_manager_);
+    lock_manager_ = new LockManager(TwoPLMode::STRICT);
+    version_store_ = new VersionStore();
+    txn_mgr_ = new TransactionManager(lock_manager_, nullptr, version_store_);
+    auto *txn = txn_mgr_->Begin();
+    table_ = new TableHeap(bpm_, lock_manager_, nullptr, txn, version_store_);
+    txn_mgr_->Commit(txn);
+    delete txn;
+  }
+
+  void TearDown() override {
+    delete table_;
+    delete txn_mgr_;
+    delete version_store_;
+    delete lock_manager_;
+    delete bpm_;
+    disk_manager_->ShutDown();
+    delete disk_manager_;
+    remove(db_file_.c_str());
+    remove("mvcc_test.log");
+    gc_interval = std::chrono::milliseconds(50);
+  }
+
+  Tuple MakeTuple(int32_t value) { return Tuple({ValueFactory::GetIntegerValue(value)}, &schema_); }
+
+  /** @return the value of the tuple at rid seen by txn, or -1 if txn does not see it */
+  int32_t Read(const RID &rid, Transaction *txn) {
+    Tuple tuple;
+    if (!table_->GetTuple(rid, &tuple, txn)) {
+      return -1;
+    }
+    return tuple.GetValue(&schema_, 0).GetAs<int32_t>();
+  }
+
+  /** @return the sum of the values in the snapshot of txn */
+  int64_t Sum(Transaction *txn) {
+    int64_t sum = 0;
+    for (auto it = table_->Begin(txn); it != table_->End(); ++it) {
+      sum += it->GetValue(&schema_, 0).GetAs<int32_t>();
+    }
+    return sum;
+  }
+
+  std::string db_file_{"mvcc_test.db"};
+  Schema schema_{std::vector<Column>{Column{"a", TypeId::INTEGER}}};
+  DiskManager *disk_manager_;
+  BufferPoolManager *bpm_;
+  LockManager *lock_manager_;
+  VersionStore *version_store_;
+  TransactionManager *txn_mgr_;
+  TableHeap *table_;
+};
+
+// NOLINTNEXTLINE
+TEST_F(MVCCTest, SnapshotReadTest) {
+  std::vector<RID> rids(3);
+  auto *txn0 = txn_mgr_->Begin();
+  for (int32_t i = 0; i < 3; i++) {
+    ASSERT_TRUE(table_->InsertTuple(MakeTuple(i + 1), &rids[i], txn0));
+  }
+  txn_mgr_->Commit(txn0);
+
+  auto *reader = txn_mgr_->Begin();
+  auto *writer = txn_mgr_->Begin();
+  ASSERT_TRUE(table_->UpdateTuple(MakeTuple(10), rids[0], writer));
+  ASSERT_TRUE(table_->MarkDelete(rids[1], writer));
+  RID new_rid;
+  ASSERT_TRUE(table_->InsertTuple(MakeTuple(100), &new_rid, writer));
+  // The writer sees its own writes, nobody else sees them before it commits.
+  EXPECT_EQ(10, Read(rids[0], writer));
+  EXPECT_EQ(-1, Read(rids[1], writer));
+  EXPECT_EQ(100, Read(new_rid, writer));
+  EXPECT_EQ(113, Sum(writer));
+  EXPECT_EQ(1, Read(rids[0], reader));
+  EXPECT_EQ(6, Sum(reader));
+  txn_mgr_->Commit(writer);
+
+  // The reader keeps its snapshot, a new transaction sees the commit.
+  EXPECT_EQ(1, Read(rids[0], reader));
+  EXPECT_EQ(2, Read(rids[1], reader));
+  EXPECT_EQ(-1, Read(new_rid, reader));
+  EXPECT_EQ(6, Sum(reader));
+  auto *late_reader = txn_mgr_->Begin();
+  EXPECT_EQ(10, Read(rids[0], late_reader));
+  EXPECT_EQ(-1, Read(rids[1], late_reader));
+  EXPECT_EQ(113, Sum(late_reader));
+  // Snapshot reads take no locks.
+  EXPECT_TRUE(reader->GetSharedLockSet()->empty());
+  txn_mgr_->Commit(reader);
+  txn_mgr_->Commit(late_reader);
+
+  delete txn0;
+  delete reader;
+  delete writer;
+  delete late_reader;
+}
+
+// NOLINTNEXTLINE
+TEST_F(MVCCTest, FirstUpdaterWinsTest) {
+  RID rid;
+  auto *txn0 = txn_mgr_->Begin();
+  ASSERT_TRUE(table_->InsertTuple(MakeTuple(1), &rid, txn0));
+  txn_mgr_->Commit(txn0);
+
+  auto *txn1 = txn_mgr_->Begin();
+  auto *txn2 = txn_mgr_->Begin();
+  auto *txn3 = txn_mgr_->Begin();
+  ASSERT_TRUE(table_->UpdateTuple(MakeTuple(2), rid, txn1));
+  ASSERT_TRUE(table_->UpdateTuple(MakeTuple(3), rid, txn1));
+  // Another transaction is writing the tuple.
+  EXPECT_FALSE(table_->UpdateTuple(MakeTuple(4), rid, txn2));
+  EXPECT_EQ(TransactionState::ABORTED, txn2->GetState());
+  txn_mgr_->Abort(txn2);
+  EXPECT_EQ(3, Read(rid, txn1));
+  txn_mgr_->Commit(txn1);
+
+  // A newer version was committed after the snapshot was taken.
+  EXPECT_FALSE(table_->MarkDelete(rid, txn3));
+  EXPECT_EQ(TransactionState::ABORTED, txn3->GetState());
+  txn_mgr_->Abort(txn3);
+
+  auto *txn4 = txn_mgr_->Begin();
+  EXPECT_TRUE(table_->MarkDelete(rid, txn4));
+  txn_mgr_->Commit(txn4);
+  auto *txn5 = txn_mgr_->Begin();
+  EXPECT_EQ(-1, Read(rid, txn5));
+  txn_mgr_->Commit(txn5);
+
+  delete txn0;
+  delete txn1;
+  delete txn2;
+  delete txn3;
+  delete txn4;
+  delete txn5;
+}
+
+// NOLINTNEXTLINE
+TEST_F(MVCCTest, AbortTest) {
+  std::vector<RID> rids(2);
+  auto *txn0 = txn_mgr_->Begin();
+  ASSERT_TRUE(table_->InsertTuple(MakeTuple(1), &rids[0], txn0));
+  ASSERT_TRUE(table_->InsertTuple(MakeTuple(2), &rids[1], txn0));
+  txn_mgr_->Commit(txn0);
+  txn_mgr_->GarbageCollect();
+
+  auto *reader = txn_mgr_->Begin();
+  auto *txn1 = txn_mgr_->Begin();
+  RID new_rid;
+  ASSERT_TRUE(table_->InsertTuple(MakeTuple(100), &new_rid, txn1));
+  ASSERT_TRUE(table_->UpdateTuple(MakeTuple(200), new_rid, txn1));
+  ASSERT_TRUE(table_->UpdateTuple(MakeTuple(10), rids[0], txn1));
+  ASSERT_TRUE(table_->MarkDelete(rids[1], txn1));
+  txn_mgr_->Abort(txn1);
+
+  EXPECT_EQ(3, Sum(reader));
+  auto *txn2 = txn_mgr_->Begin();
+  EXPECT_EQ(1, Read(rids[0], txn2));
+  EXPECT_EQ(2, Read(rids[1], txn2));
+  EXPECT_EQ(-1, Read(new_rid, txn2));
+  EXPECT_EQ(3, Sum(txn2));
+  // The rolled back tuples were committed before every snapshot, so they need no versions.
+  EXPECT_EQ(0, version_store_->GetNumChains());
+  // The aborted writes do not conflict with later ones.
+  EXPECT_TRUE(table_->UpdateTuple(MakeTuple(5), rids[0], txn2));
+  txn_mgr_->Commit(txn2);
+  txn_mgr_->Commit(reader);
+
+  delete txn0;
+  delete reader;
+  delete txn1;
+  delete txn2;
+}
+
+// NOLINTNEXTLINE
+TEST_F(MVCCTest, GarbageCollectionTest) {
+  const int32_t num_tuples = 100;
+  std::vector<RID> rids(num_tuples);
+  auto *txn0 = txn_mgr_->Begin();
+  for (int32_t i = 0; i < num_tuples; i++) {
+    ASSERT_TRUE(table_->InsertTuple(MakeTuple(i), &rids[i], txn0));
+  }
+  txn_mgr_->Commit(txn0);
+
+  auto *reader = txn_mgr_->Begin();
+  for (int32_t round = 1; round <= 3; round++) {
+    auto *writer = txn_mgr_->Begin();
+    for (int32_t i = 0; i < num_tuples; i++) {
+      ASSERT_TRUE(table_->UpdateTuple(MakeTuple(i + round * num_tuples), rids[i], writer));
+    }
+    txn_mgr_->Commit(writer);
+    delete writer;
+  }
+  auto *deleter = txn_mgr_->Begin();
+  for (int32_t i = 0; i < num_tuples / 2; i++) {
+    ASSERT_TRUE(table_->MarkDelete(rids[i], deleter));
+  }
+  txn_mgr_->Commit(deleter);
+
+  // The reader still needs the original versions. The ones from before the inserts are garbage, the ones written
+  // since the reader began are kept as long as it runs.
+  EXPECT_EQ(num_tuples * 4 + num_tuples / 2, version_store_->GetNumVersions());
+  txn_mgr_->GarbageCollect();
+  EXPECT_EQ(num_tuples * 3 + num_tuples / 2, version_store_->GetNumVersions());
+  EXPECT_EQ(num_tuples * (num_tuples - 1) / 2, Sum(reader));
+  txn_mgr_->Commit(reader);
+
+  txn_mgr_->GarbageCollect();
+  EXPECT_EQ(0, version_store_->GetNumChains());
+  auto *txn1 = txn_mgr_->Begin();
+  int64_t expected = 0;
+  for (int32_t i = num_tuples / 2; i < num_tuples; i++) {
+    expected += i + 3 * num_tuples;
+  }
+  EXPECT_EQ(expected, Sum(txn1));
+  // The space of the deleted tuples was reclaimed.
+  RID rid;
+  ASSERT_TRUE(table_->InsertTuple(MakeTuple(0), &rid, txn1));
+  EXPECT_EQ(rids[0], rid);
+  txn_mgr_->Commit(txn1);
+
+  delete txn0;
+  delete reader;
+  delete deleter;
+  delete txn1;
+}
+
+// NOLINTNEXTLINE
+TEST_F(MVCCTest, ConcurrentTransferTest) {
+  // Writers move amounts between tuples, so every snapshot sums up to the same total.
+  const int32_t num_tuples = 16;
+  const int32_t initial = 1000;
+  std::vector<RID> rids(num_tuples);
+  auto *txn0 = txn_mgr_->Begin();
+  for (int32_t i = 0; i < num_tuples; i++) {
+    ASSERT_TRUE(table_->InsertTuple(MakeTuple(initial), &rids[i], txn0));
+  }
+  txn_mgr_->Commit(txn0);
+  delete txn0;
+
+  std::atomic<bool> stop{false};
+  std::atomic<size_t> num_commits{0};
+  std::vector<std::thread> writers;
+  for (int t = 0; t < 2; t++) {
+    writers.emplace_back([&, t] {
+      std::mt19937 rng(t);
+      std::uniform_int_distribution<int32_t> pick(0, num_tuples - 1);
+      while (!stop) {
+        int32_t from = pick(rng);
+        int32_t to = (from + 1 + pick(rng) % (num_tuples - 1)) % num_tuples;
+        auto *txn = txn_mgr_->Begin();
+        int32_t from_value = Read(rids[from], txn);
+        int32_t to_value = Read(rids[to], txn);
+        if (table_->UpdateTuple(MakeTuple(from_value - 1), rids[from], txn) &&
+            table_->UpdateTuple(MakeTuple(to_value + 1), rids[to], txn)) {
+          txn_mgr_->Commit(txn);
+          num_commits++;
+        } else {
+          txn_mgr_->Abort(txn);
+        }
+        delete txn;
+      }
+    });
+  }
+  // Keep reading until the writers got going, the reads alone may be over before they are scheduled.
+  for (int i = 0; i < 200 || num_commits < 100; i++) {
+    auto *reader = txn_mgr_->Begin();
+    ASSERT_EQ(num_tuples * initial, Sum(reader));
+    txn_mgr_->Commit(reader);
+    delete reader;
+  }
+  stop = true;
+  for (auto &writer : writers) {
+    writer.join();
+  }
+  EXPECT_GT(num_commits, 0);
+}
+
+/**
+ * Scans a table of BUSTUB_MVCC_BENCH_ROWS rows (1000 by default) in reader threads while two writer threads update
+ * random rows of it, for BUSTUB_MVCC_BENCH_MS milliseconds (1000 by default) per configuration. Reports the rows read
+ * per second by committed scans and the committed updates per second, under strict two-phase locking and under
+ * snapshot isolation. Under two-phase locking, rows are locked here rather than by the table pages, which only lock
+ * while logging is enabled and then wait for locks while holding page latches.
+ */
+// NOLINTNEXTLINE
+TEST(MVCCBenchmarkTest, DISABLED_SnapshotReadBenchmark) {
+  const char *rows_env = std::getenv("BUSTUB_MVCC_BENCH_ROWS");
+  const int32_t num_rows = rows_env != nullptr ? std::atoi(rows_env) : 1000;
+  const char *ms_env = std::getenv("BUSTUB_MVCC_BENCH_MS");
+  const auto duration = std::chrono::milliseconds(ms_env != nullptr ? std::atoi(ms_env) : 1000);
+  const int num_writers = 2;
+  Schema schema{std::vector<Column>{Column{"a", TypeId::INTEGER}}};
+
+  for (bool mvcc : {false, true}) {
+    for (int num_readers = 1; num_readers <= 4; num_readers *= 2) {
+      auto *disk_manager = new DiskManager("mvcc_bench.db");
+      auto *bpm = new BufferPoolManager(256, disk_manager);
+      auto *lock_manager = new LockManager(TwoPLMode::STRICT);
+      auto *version_store = mvcc ? new VersionStore() : nullptr;
+      auto *txn_mgr = new TransactionManager(lock_manager, nullptr, version_store);
+
+      auto *txn = txn_mgr->Begin();
+      auto *table = new TableHeap(bpm, lock_manager, nullptr, txn, version_store);
+      std::vector<RID> rids(num_rows);
+      for (int32_t i = 0; i < num_rows; i++) {
+        ASSERT_TRUE(table->InsertTuple(Tuple({ValueFactory::GetIntegerValue(i)}, &schema), &rids[i], txn));
+      }
+      txn_mgr->Commit(txn);
+      delete txn;
+
+      std::atomic<bool> stop{false};
+      std::atomic<size_t> rows_read{0};
+      std::atomic<size_t> updates{0};
+      std::vector<std::thread> threads;
+      for (int t = 0; t < num_readers; t++) {
+        threads.emplace_back([&] {
+          while (!stop) {
+            auto *reader = txn_mgr->Begin();
+            size_t rows = 0;
+            for (auto it = table->Begin(reader); it != table->End() && !stop; ++it) {
+              if (!mvcc && !lock_manager->LockShared(reader, it->GetRid())) {
+                break;
+              }
+              rows++;
+            }
+            if (reader->GetState() == TransactionState::ABORTED) {
+              txn_mgr->Abort(reader);
+            } else {
+              txn_mgr->Commit(reader);
+              rows_read += rows;
+            }
+            delete reader;
+          }
+        });
+      }
+      for (int t = 0; t < num_writers; t++) {
+        threads.emplace_back([&, t] {
+          std::mt19937 rng(t);
+          std::uniform_int_distribution<int32_t> pick(0, num_rows - 1);
+          while (!stop) {
+            auto *writer = txn_mgr->Begin();
+            int32_t row = pick(rng);
+            if ((mvcc || lock_manager->LockExclusive(writer, rids[row])) &&
+                table->UpdateTuple(Tuple({ValueFactory::GetIntegerValue(-row)}, &schema), rids[row], writer)) {
+              txn_mgr->Commit(writer);
+              updates++;
+            } else {
+              txn_mgr->Abort(writer);
+            }
+            delete writer;
+          }
+        });
+      }
+      std::this_thread::sleep_for(duration);
+      stop = true;
+      for (auto &thread : threads) {
+        thread.join();
+      }
+      std::chrono::duration<double> seconds = duration;
+      std::cout << (mvcc ? "snapshot isolation" : "strict 2PL") << ", readers: " << num_readers
+                << ", rows read/s: " << rows_read / seconds.count() << ", updates/s: " << updates / seconds.count()
+                << std::endl;
+
+      delete table;
+      delete txn_mgr;
+      delete version_store;
+      delete lock_manager;
+      delete bpm;
+      disk_manager->ShutDown();
+      delete disk_manager;
+      remove("mvcc_bench.db");
+      remove("mvcc_bench.log");
+    }
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,318 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// occ_test.cpp
+//
+// Identification: test/concurrency/occ_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "concurrency/transaction_manager.h"
+#include "gtest/gtest.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/** A table of single integer tuples written by optimistic transactions. */
+class OCCTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    disk_manager_ = new DiskManager(db_file_);
+    bpm_ = new BufferPoolManager(50, disk_manager_);
+    lock_manager_ = new LockManager(TwoPLMode::STRICT);
+    txn_mgr_ = new TransactionManager(lock_manager_);
+    auto *txn = txn_mgr_->Begin();
+    table_ = new TableHeap(bpm_, lock_manager_, nullptr, txn);
+    txn_mgr_->Commit(txn);
+    delete txn;
+  }
+
+  void TearDown() override {
+    delete table_;
+    delete txn_mgr_;
+    delete lock_manager_;
+    delete bpm_;
+    disk_manager_->ShutDown();
+    delete disk_manager_;
+    remove(db_file_.c_str());
+    remove("occ_test.log");
+  }
+
+  Transaction *Begin() { return txn_mgr_->Begin(nullptr, ConcurrencyMode::OPTIMISTIC); }
+
+  Tuple MakeTuple(int32_t value) { return Tuple({ValueFactory::GetIntegerValue(value)}, &schema_); }
+
+  /** @return the value of the tuple at rid seen by txn, or -1 if txn does not see it */
+  int32_t Read(const RID &rid, Transaction *txn) {
+    Tuple tuple;
+    if (!table_->GetTuple(rid, &tuple, txn)) {
+      return -1;
+    }
+    return tuple.GetValue(&schema_, 0).GetAs<int32_t>();
+  }
+
+  /** Inserts the values in a committed transaction. */
+  std::vector<RID> Load(const std::vector<int32_t> &values) {
+    std::vector<RID> rids(values.size());
+    auto *txn = Begin();
+    for (size_t i = 0; i < values.size(); i++) {
+      EXPECT_TRUE(table_->InsertTuple(MakeTuple(values[i]), &rids[i], txn));
+    }
+    EXPECT_TRUE(txn_mgr_->Commit(txn));
+    delete txn;
+    return rids;
+  }
+
+  std::string db_file_{"occ_test.db"};
+  Schema schema_{std::vector<Column>{Column{"a", TypeId::INTEGER}}};
+  DiskManager *disk_manager_;
+  BufferPoolManager *bpm_;
+  LockManager *lock_manager_;
+  TransactionManager *txn_mgr_;
+  TableHeap *table_;
+};
+
+// NOLINTNEXTLINE
+TEST_F(OCCTest, BufferedWriteTest) {
+  auto rids = Load({1, 2});
+
+  auto *writer = Begin();
+  ASSERT_TRUE(table_->UpdateTuple(MakeTuple(10), rids[0], writer));
+  ASSERT_TRUE(table_->MarkDelete(rids[1], writer));
+  // The writer sees its own writes, nobody else sees them before it commits.
+  EXPECT_EQ(10, Read(rids[0], writer));
+  EXPECT_EQ(-1, Read(rids[1], writer));
+  auto *reader = Begin();
+  EXPECT_EQ(1, Read(rids[0], reader));
+  EXPECT_EQ(2, Read(rids[1], reader));
+  EXPECT_TRUE(txn_mgr_->Commit(reader));
+  delete reader;
+  EXPECT_TRUE(txn_mgr_->Commit(writer));
+  delete writer;
+
+  reader = Begin();
+  EXPECT_EQ(10, Read(rids[0], reader));
+  EXPECT_EQ(-1, Read(rids[1], reader));
+  EXPECT_TRUE(txn_mgr_->Commit(reader));
+  delete reader;
+}
+
+// NOLINTNEXTLINE
+TEST_F(OCCTest, ReadValidationTest) {
+  auto rids = Load({1, 2});
+
+  // The reader computes its write from a value that changes before it commits.
+  auto *reader = Begin();
+  ASSERT_EQ(1, Read(rids[0], reader));
+  ASSERT_TRUE(table_->UpdateTuple(MakeTuple(Read(rids[0], reader) + 1), rids[1], reader));
+  auto *writer = Begin();
+  ASSERT_TRUE(table_->UpdateTuple(MakeTuple(5), rids[0], writer));
+  EXPECT_TRUE(txn_mgr_->Commit(writer));
+  delete writer;
+  EXPECT_FALSE(txn_mgr_->Commit(reader));
+  EXPECT_EQ(TransactionState::ABORTED, reader->GetState());
+  delete reader;
+
+  // The write of the aborted reader was never installed.
+  auto *check = Begin();
+  EXPECT_EQ(5, Read(rids[0], check));
+  EXPECT_EQ(2, Read(rids[1], check));
+  EXPECT_TRUE(txn_mgr_->Commit(check));
+  delete check;
+}
+
+// NOLINTNEXTLINE
+TEST_F(OCCTest, WriteConflictTest) {
+  auto rids = Load({1});
+
+  // Both transactions read and write the same tuple, the first one to commit wins.
+  auto *txn1 = Begin();
+  auto *txn2 = Begin();
+  ASSERT_TRUE(table_->UpdateTuple(MakeTuple(Read(rids[0], txn1) + 1), rids[0], txn1));
+  ASSERT_TRUE(table_->UpdateTuple(MakeTuple(Read(rids[0], txn2) + 10), rids[0], txn2));
+  EXPECT_TRUE(txn_mgr_->Commit(txn2));
+  EXPECT_FALSE(txn_mgr_->Commit(txn1));
+  delete txn1;
+  delete txn2;
+
+  auto *check = Begin();
+  EXPECT_EQ(11, Read(rids[0], check));
+  EXPECT_TRUE(txn_mgr_->Commit(check));
+  delete check;
+}
+
+// NOLINTNEXTLINE
+TEST_F(OCCTest, InsertAbortTest) {
+  auto *inserter = Begin();
+  RID rid;
+  ASSERT_TRUE(table_->InsertTuple(MakeTuple(7), &rid, inserter));
+  EXPECT_EQ(7, Read(rid, inserter));
+  // An insert is hidden until it commits, and cannot be written by others.
+  auto *other = Begin();
+  EXPECT_EQ(-1, Read(rid, other));
+  ASSERT_TRUE(table_->UpdateTuple(MakeTuple(8), rid, other));
+  txn_mgr_->Abort(inserter);
+  delete inserter;
+  EXPECT_FALSE(txn_mgr_->Commit(other));
+  delete other;
+
+  auto *check = Begin();
+  EXPECT_EQ(-1, Read(rid, check));
+  size_t num_tuples = 0;
+  for (auto it = table_->Begin(check); it != table_->End(); ++it) {
+    num_tuples++;
+  }
+  EXPECT_EQ(0, num_tuples);
+  EXPECT_TRUE(txn_mgr_->Commit(check));
+  delete check;
+}
+
+// NOLINTNEXTLINE
+TEST_F(OCCTest, ConcurrentIncrementTest) {
+  const int num_threads = 4;
+  const int num_increments = 200;
+  auto rids = Load({0, 0});
+
+  std::vector<std::thread> threads;
+  std::atomic<int> num_aborts{0};
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&] {
+      for (int i = 0; i < num_increments; i++) {
+        // Retry until the increment of both counters commits.
+        while (true) {
+          auto *txn = Begin();
+          for (const auto &rid : rids) {
+            EXPECT_TRUE(table_->UpdateTuple(MakeTuple(Read(rid, txn) + 1), rid, txn));
+          }
+          bool committed = txn_mgr_->Commit(txn);
+          delete txn;
+          if (committed) {
+            break;
+          }
+          num_aborts++;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // No increment was lost, and both counters changed together.
+  auto *check = Begin();
+  EXPECT_EQ(num_threads * num_increments, Read(rids[0], check));
+  EXPECT_EQ(num_threads * num_increments, Read(rids[1], check));
+  EXPECT_TRUE(txn_mgr_->Commit(check));
+  delete check;
+}
+
+/**
+ * Compares strict two-phase locking with optimistic concurrency control on short read-modify-write transactions.
+ * Each transaction increments two random rows. With many rows the transactions rarely touch the same row, with few
+ * rows they conflict all the time.
+ *
+ * Run with --gtest_also_run_disabled_tests, sized by BUSTUB_OCC_BENCH_MS.
+ */
+// NOLINTNEXTLINE
+TEST(OCCBenchmarkTest, DISABLED_OCCBenchmark) {
+  const char *ms_env = std::getenv("BUSTUB_OCC_BENCH_MS");
+  const auto duration = std::chrono::milliseconds(ms_env != nullptr ? std::atoi(ms_env) : 1000);
+  Schema schema{std::vector<Column>{Column{"a", TypeId::INTEGER}}};
+
+  for (int32_t num_rows : {10000, 16}) {
+    for (bool occ : {false, true}) {
+      for (int num_threads = 1; num_threads <= 4; num_threads *= 2) {
+        const ConcurrencyMode mode = occ ? ConcurrencyMode::OPTIMISTIC : ConcurrencyMode::PESSIMISTIC;
+        auto *disk_manager = new DiskManager("occ_bench.db");
+        auto *bpm = new BufferPoolManager(256, disk_manager);
+        auto *lock_manager = new LockManager(TwoPLMode::STRICT);
+        auto *txn_mgr = new TransactionManager(lock_manager);
+
+        auto *txn = txn_mgr->Begin(nullptr, mode);
+        auto *table = new TableHeap(bpm, lock_manager, nullptr, txn);
+        std::vector<RID> rids(num_rows);
+        for (int32_t i = 0; i < num_rows; i++) {
+          ASSERT_TRUE(table->InsertTuple(Tuple({ValueFactory::GetIntegerValue(0)}, &schema), &rids[i], txn));
+        }
+        txn_mgr->Commit(txn);
+        delete txn;
+
+        std::atomic<bool> stop{false};
+        std::atomic<size_t> commits{0};
+        std::atomic<size_t> aborts{0};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < num_threads; t++) {
+          threads.emplace_back([&, t] {
+            std::mt19937 rng(t);
+            std::uniform_int_distribution<int32_t> pick(0, num_rows - 1);
+            while (!stop) {
+              int32_t rows[2] = {pick(rng), pick(rng)};
+              if (rows[0] == rows[1]) {
+                continue;
+              }
+              // Locks are taken in row order, so that the 2PL transactions never deadlock.
+              std::sort(rows, rows + 2);
+              auto *writer = txn_mgr->Begin(nullptr, mode);
+              bool ok = true;
+              for (int32_t row : rows) {
+                Tuple tuple;
+                ok = ok && (occ || lock_manager->LockExclusive(writer, rids[row])) &&
+                     table->GetTuple(rids[row], &tuple, writer) &&
+                     table->UpdateTuple(
+                         Tuple({ValueFactory::GetIntegerValue(tuple.GetValue(&schema, 0).GetAs<int32_t>() + 1)},
+                               &schema),
+                         rids[row], writer);
+              }
+              if (ok && txn_mgr->Commit(writer)) {
+                commits++;
+              } else {
+                if (!ok) {
+                  txn_mgr->Abort(writer);
+                }
+                aborts++;
+              }
+              delete writer;
+            }
+          });
+        }
+        std::this_thread::sleep_for(duration);
+        stop = true;
+        for (auto &thread : threads) {
+          thread.join();
+        }
+        std::chrono::duration<double> seconds = duration;
+        std::cout << (occ ? "OCC" : "strict 2PL") << ", rows: " << num_rows << ", threads: " << num_threads
+                  << ", commits/s: " << commits / seconds.count()
+                  << ", abort rate: " << static_cast<double>(aborts) / std::max<size_t>(commits + aborts, 1)
+                  << std::endl;
+
+        delete table;
+        delete txn_mgr;
+        delete lock_manager;
+        delete bpm;
+        disk_manager->ShutDown();
+        delete disk_manager;
+        remove("occ_bench.db");
+        remove("occ_bench.log");
+      }
+    }
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,198 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// transaction_manager_test.cpp
+//
+// Identification: test/concurrency/transaction_manager_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdlib>
+#include <iostream>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "concurrency/transaction_manager.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(TransactionManagerTest, RegistryTest) {
+  LockManager lock_manager(TwoPLMode::STRICT);
+  TransactionManager txn_mgr(&lock_manager);
+
+  auto *txn0 = txn_mgr.Begin();
+  auto *txn1 = txn_mgr.Begin();
+  EXPECT_EQ(2, txn_mgr.GetNumTransactions());
+  {
+    EpochGuard guard(txn_mgr.GetEpochManager());
+    EXPECT_EQ(txn0, txn_mgr.GetTransaction(txn0->GetTransactionId()));
+    EXPECT_EQ(txn1, txn_mgr.GetTransaction(txn1->GetTransactionId()));
+  }
+
+  // Ended transactions are no longer registered.
+  txn_id_t txn0_id = txn0->GetTransactionId();
+  txn_id_t txn1_id = txn1->GetTransactionId();
+  txn_mgr.Commit(txn0);
+  txn_mgr.Abort(txn1);
+  EXPECT_EQ(0, txn_mgr.GetNumTransactions());
+  EXPECT_EQ(nullptr, txn_mgr.GetTransaction(txn0_id));
+  EXPECT_EQ(nullptr, txn_mgr.GetTransaction(txn1_id));
+  txn_mgr.Recycle(txn0);
+  txn_mgr.Recycle(txn1);
+}
+
+// NOLINTNEXTLINE
+TEST(TransactionManagerTest, RecycleTest) {
+  LockManager lock_manager(TwoPLMode::STRICT);
+  TransactionManager txn_mgr(&lock_manager);
+
+  auto *txn = txn_mgr.Begin();
+  txn->GetExclusiveLockSet()->emplace(0, 0);
+  txn->SetPrevLSN(3);
+  txn_mgr.Abort(txn);
+  Transaction *other;
+  {
+    // A thread that may have looked the transaction up holds back its reuse.
+    EpochGuard guard(txn_mgr.GetEpochManager());
+    txn_mgr.Recycle(txn);
+    EXPECT_EQ(0, txn_mgr.GetEpochManager()->Reclaim());
+    other = txn_mgr.Begin();
+    EXPECT_NE(txn, other);
+  }
+  EXPECT_EQ(1, txn_mgr.GetEpochManager()->Reclaim());
+
+  // The recycled transaction comes back clean, with a new id.
+  auto *reused = txn_mgr.Begin(nullptr, ConcurrencyMode::OPTIMISTIC);
+  EXPECT_EQ(txn, reused);
+  EXPECT_EQ(other->GetTransactionId() + 1, reused->GetTransactionId());
+  EXPECT_EQ(TransactionState::GROWING, reused->GetState());
+  EXPECT_EQ(ConcurrencyMode::OPTIMISTIC, reused->GetConcurrencyMode());
+  EXPECT_EQ(INVALID_LSN, reused->GetPrevLSN());
+  EXPECT_TRUE(reused->GetExclusiveLockSet()->empty());
+  txn_mgr.Commit(other);
+  txn_mgr.Commit(reused);
+  txn_mgr.Recycle(other);
+  txn_mgr.Recycle(reused);
+}
+
+// NOLINTNEXTLINE
+TEST(TransactionManagerTest, EndOnOtherThreadTest) {
+  LockManager lock_manager(TwoPLMode::STRICT);
+  TransactionManager txn_mgr(&lock_manager);
+
+  // Transactions that end on another thread than they began on release the global latch all the same.
+  auto *txn0 = txn_mgr.Begin();
+  std::thread committer([&] { txn_mgr.Commit(txn0); });
+  committer.join();
+  Transaction *txn1;
+  std::thread beginner([&] { txn1 = txn_mgr.Begin(); });
+  beginner.join();
+  txn_mgr.Abort(txn1);
+
+  // No transaction is running, so blocking them returns right away; a leaked reader would hang it.
+  txn_mgr.BlockAllTransactions();
+  txn_mgr.ResumeTransactions();
+  txn_mgr.Recycle(txn0);
+  txn_mgr.Recycle(txn1);
+}
+
+// NOLINTNEXTLINE
+TEST(TransactionManagerTest, ConcurrentLookupTest) {
+  const int num_threads = 4;
+  const int num_txns = 2000;
+  LockManager lock_manager(TwoPLMode::STRICT);
+  TransactionManager txn_mgr(&lock_manager);
+  std::atomic<txn_id_t> last_id{0};
+  std::atomic<bool> stop{false};
+  std::atomic<int> bad_lookups{0};
+
+  // Lookups race with transactions ending and being reused, but never see a transaction under another id.
+  std::vector<std::thread> lookups;
+  for (int t = 0; t < 2; t++) {
+    lookups.emplace_back([&] {
+      while (!stop) {
+        txn_id_t txn_id = last_id.load();
+        EpochGuard guard(txn_mgr.GetEpochManager());
+        Transaction *txn = txn_mgr.GetTransaction(txn_id);
+        if (txn != nullptr && txn->GetTransactionId() != txn_id) {
+          bad_lookups++;
+        }
+      }
+    });
+  }
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&] {
+      for (int i = 0; i < num_txns; i++) {
+        auto *txn = txn_mgr.Begin();
+        last_id = txn->GetTransactionId();
+        txn_mgr.Commit(txn);
+        txn_mgr.Recycle(txn);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  stop = true;
+  for (auto &thread : lookups) {
+    thread.join();
+  }
+  EXPECT_EQ(0, bad_lookups);
+  EXPECT_EQ(0, txn_mgr.GetNumTransactions());
+}
+
+/**
+ * Measures how many empty transactions begin and commit per second, with transactions recycled through the pool and
+ * with every transaction allocated and freed.
+ *
+ * Run with --gtest_also_run_disabled_tests, sized by BUSTUB_TXN_BENCH_MS.
+ */
+// NOLINTNEXTLINE
+TEST(TransactionManagerBenchmarkTest, DISABLED_BeginCommitBenchmark) {
+  const char *ms_env = std::getenv("BUSTUB_TXN_BENCH_MS");
+  const auto duration = std::chrono::milliseconds(ms_env != nullptr ? std::atoi(ms_env) : 1000);
+
+  for (bool recycle : {false, true}) {
+    for (int num_threads = 1; num_threads <= 4; num_threads *= 2) {
+      LockManager lock_manager(TwoPLMode::STRICT);
+      TransactionManager txn_mgr(&lock_manager);
+      std::atomic<bool> stop{false};
+      std::atomic<size_t> commits{0};
+      std::vector<std::thread> threads;
+      for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&] {
+          size_t local_commits = 0;
+          while (!stop) {
+            auto *txn = txn_mgr.Begin();
+            txn_mgr.Commit(txn);
+            if (recycle) {
+              txn_mgr.Recycle(txn);
+            } else {
+              delete txn;
+            }
+            local_commits++;
+          }
+          commits += local_commits;
+        });
+      }
+      std::this_thread::sleep_for(duration);
+      stop = true;
+      for (auto &thread : threads) {
+        thread.join();
+      }
+      std::chrono::duration<double> seconds = duration;
+      std::cout << (recycle ? "recycled" : "allocated") << ", threads: " << num_threads
+                << ", transactions/s: " << commits / seconds.count() << std::endl;
+    }
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,278 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table_test.cpp
+//
+// Identification: test/container/extendible_hash_table_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "container/hash/extendible_hash_table.h"
+#include "container/hash/linear_probe_hash_table.h"
+#include "gtest/gtest.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ExtendibleHashTableTest, SampleTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  // insert a few values
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(1, res.size()) << "Failed to insert " << i << std::endl;
+    EXPECT_EQ(i, res[0]);
+  }
+
+  // insert one more value for each key
+  for (int i = 0; i < 5; i++) {
+    // duplicate values for the same key are not allowed
+    EXPECT_FALSE(ht.Insert(nullptr, i, i));
+    if (i != 0) {
+      EXPECT_TRUE(ht.Insert(nullptr, i, 2 * i));
+    }
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(i == 0 ? 1 : 2, res.size());
+  }
+
+  // look for a key that does not exist
+  std::vector<int> res;
+  EXPECT_FALSE(ht.GetValue(nullptr, 20, &res));
+  EXPECT_EQ(0, res.size());
+
+  // delete all values
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+    EXPECT_FALSE(ht.Remove(nullptr, i, i));
+    if (i != 0) {
+      EXPECT_TRUE(ht.Remove(nullptr, i, 2 * i));
+    }
+    std::vector<int> res;
+    EXPECT_FALSE(ht.GetValue(nullptr, i, &res));
+  }
+  EXPECT_EQ(0, ht.GetGlobalDepth());
+  ht.VerifyIntegrity();
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(ExtendibleHashTableTest, SplitMergeTest) {
+  const int num_keys = 20000;
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  // the buckets split and the directory grows as the keys are inserted
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  EXPECT_GT(ht.GetGlobalDepth(), 4);
+  ht.VerifyIntegrity();
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    ASSERT_EQ(1, res.size());
+    EXPECT_EQ(i, res[0]);
+  }
+
+  // removing half of the keys keeps the others
+  for (int i = 0; i < num_keys; i += 2) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+  }
+  ht.VerifyIntegrity();
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    EXPECT_EQ(i % 2 == 1, ht.GetValue(nullptr, i, &res));
+  }
+
+  // the empty buckets merge and the directory shrinks back to a single entry
+  for (int i = 1; i < num_keys; i += 2) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+  }
+  EXPECT_EQ(0, ht.GetGlobalDepth());
+  ht.VerifyIntegrity();
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(ExtendibleHashTableTest, MaxDepthTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  // the values of one key all hash to the same bucket, which cannot be split once it is full
+  int num_values = 0;
+  while (ht.Insert(nullptr, 0, num_values)) {
+    num_values++;
+  }
+  EXPECT_EQ(8 * (PAGE_SIZE - 1) / (8 * sizeof(std::pair<int, int>) + 9), num_values);
+  EXPECT_EQ(9, ht.GetGlobalDepth());
+  ht.VerifyIntegrity();
+
+  // other keys still fit
+  EXPECT_TRUE(ht.Insert(nullptr, 1, 1));
+  std::vector<int> res;
+  EXPECT_TRUE(ht.GetValue(nullptr, 0, &res));
+  EXPECT_EQ(num_values, res.size());
+
+  for (int i = 0; i < num_values; i++) {
+    EXPECT_TRUE(ht.Remove(nullptr, 0, i));
+  }
+  EXPECT_TRUE(ht.Remove(nullptr, 1, 1));
+  EXPECT_EQ(0, ht.GetGlobalDepth());
+  ht.VerifyIntegrity();
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(ExtendibleHashTableTest, ConcurrentTest) {
+  const int num_threads = 4;
+  const int num_keys = 10000;
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  // Every thread inserts two values for each of its keys, and then removes one of them, so buckets split and merge
+  // while the threads run.
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      for (int i = t; i < num_keys; i += num_threads) {
+        EXPECT_TRUE(ht.Insert(nullptr, i, i));
+        EXPECT_TRUE(ht.Insert(nullptr, i, -i - 1));
+      }
+      for (int i = t; i < num_keys; i += num_threads) {
+        std::vector<int> res;
+        EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+        EXPECT_EQ(2, res.size());
+        EXPECT_TRUE(ht.Remove(nullptr, i, -i - 1));
+        if (i % 4 < 2) {
+          EXPECT_TRUE(ht.Remove(nullptr, i, i));
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  ht.VerifyIntegrity();
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    EXPECT_EQ(i % 4 >= 2, ht.GetValue(nullptr, i, &res));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+/**
+ * Measures inserts, and lookups of keys in and not in the table, for BUSTUB_HASH_BENCH_MS milliseconds (1000 by
+ * default) on BUSTUB_HASH_BENCH_KEYS keys (50000 by default). The linear probe hash table is sized for a load factor,
+ * the extendible hash table grows as the keys are inserted.
+ */
+template <typename HashTableType>
+void LoadFactorBenchmark(const std::string &name, HashTableType *ht, int64_t num_keys) {
+  const char *ms_env = std::getenv("BUSTUB_HASH_BENCH_MS");
+  const auto duration = std::chrono::milliseconds(ms_env != nullptr ? std::atoi(ms_env) : 1000);
+  auto make_key = [](int64_t i) {
+    GenericKey<8> key;
+    key.SetFromInteger(i);
+    return key;
+  };
+
+  auto start = std::chrono::steady_clock::now();
+  for (int64_t i = 0; i < num_keys; i++) {
+    ht->Insert(nullptr, make_key(i), RID(i));
+  }
+  std::chrono::duration<double> insert_seconds = std::chrono::steady_clock::now() - start;
+  std::cout << name << ", inserts/s: " << num_keys / insert_seconds.count();
+
+  for (bool hit : {true, false}) {
+    std::mt19937_64 rng(0);
+    std::uniform_int_distribution<int64_t> pick_key(0, num_keys - 1);
+    std::vector<RID> result;
+    size_t num_ops = 0;
+    size_t num_found = 0;
+    start = std::chrono::steady_clock::now();
+    auto end = start + duration;
+    while (std::chrono::steady_clock::now() < end) {
+      for (int i = 0; i < 1000; i++) {
+        result.clear();
+        num_found += ht->GetValue(nullptr, make_key(hit ? pick_key(rng) : num_keys + pick_key(rng)), &result) ? 1 : 0;
+      }
+      num_ops += 1000;
+    }
+    std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(hit ? num_ops : 0, num_found);
+    std::cout << ", " << (hit ? "hits" : "misses") << "/s: " << num_ops / seconds.count();
+  }
+  std::cout << std::endl;
+}
+
+// NOLINTNEXTLINE
+TEST(ExtendibleHashTableTest, DISABLED_LoadFactorBenchmark) {
+  const char *keys_env = std::getenv("BUSTUB_HASH_BENCH_KEYS");
+  const int64_t num_keys = keys_env != nullptr ? std::atoi(keys_env) : 50000;
+  Schema key_schema{std::vector<Column>{Column{"a", TypeId::BIGINT}}};
+  GenericComparator<8> comparator(&key_schema);
+
+  for (int load_percent : {50, 75, 90, 95}) {
+    auto *disk_manager = new DiskManager("hash_bench.db");
+    auto *bpm = new BufferPoolManager(1024, disk_manager);
+    LinearProbeHashTable<GenericKey<8>, RID, GenericComparator<8>> ht("bench", bpm, comparator,
+                                                                      num_keys * 100 / load_percent,
+                                                                      HashFunction<GenericKey<8>>());
+    LoadFactorBenchmark("linear probing, load factor " + std::to_string(load_percent) + "%", &ht, num_keys);
+    disk_manager->ShutDown();
+    remove("hash_bench.db");
+    delete disk_manager;
+    delete bpm;
+  }
+
+  auto *disk_manager = new DiskManager("hash_bench.db");
+  auto *bpm = new BufferPoolManager(1024, disk_manager);
+  ExtendibleHashTable<GenericKey<8>, RID, GenericComparator<8>> ht("bench", bpm, comparator,
+                                                                   HashFunction<GenericKey<8>>());
+  LoadFactorBenchmark("extendible hashing", &ht, num_keys);
+  std::cout << "extendible hashing, global depth after inserts: " << ht.GetGlobalDepth() << std::endl;
+  disk_manager->ShutDown();
+  remove("hash_bench.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+}  // namespace bustub
@@ -0,0 +1,247 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_function_test.cpp
+//
+// Identification: test/container/hash_function_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "container/hash/hash_function.h"
+#include "gtest/gtest.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+template <typename KeyType>
+KeyType MakeKey(int64_t i);
+
+template <>
+int MakeKey<int>(int64_t i) {
+  return static_cast<int>(i);
+}
+
+template <>
+GenericKey<4> MakeKey<GenericKey<4>>(int64_t i) {
+  // SetFromInteger writes 8 bytes, of which the last ones vary for small integers
+  GenericKey<4> key;
+  auto value = static_cast<uint32_t>(i);
+  memcpy(key.data_, &value, sizeof(value));
+  return key;
+}
+
+template <>
+GenericKey<8> MakeKey<GenericKey<8>>(int64_t i) {
+  GenericKey<8> key;
+  key.SetFromInteger(i);
+  return key;
+}
+
+template <>
+GenericKey<16> MakeKey<GenericKey<16>>(int64_t i) {
+  GenericKey<16> key;
+  key.SetFromInteger(i);
+  return key;
+}
+
+template <>
+GenericKey<32> MakeKey<GenericKey<32>>(int64_t i) {
+  GenericKey<32> key;
+  key.SetFromInteger(i);
+  return key;
+}
+
+template <>
+GenericKey<64> MakeKey<GenericKey<64>>(int64_t i) {
+  GenericKey<64> key;
+  key.SetFromInteger(i);
+  return key;
+}
+
+/**
+ * Hashes sequential keys into 4096 buckets, by the low bits of the hash (as bucket and directory indexes do) and by
+ * the high bits (as fingerprints do).
+ * @return the chi-square statistics of the bucket counts divided by their degrees of freedom, about 1 for a good hash
+ */
+template <typename KeyType, typename HashFn>
+std::pair<double, double> BucketChiSquare(HashFn hash_fn) {
+  const int num_buckets = 4096;
+  const int num_keys = 64 * num_buckets;
+  std::vector<int> low(num_buckets);
+  std::vector<int> high(num_buckets);
+  for (int64_t i = 0; i < num_keys; i++) {
+    uint64_t hash = hash_fn.GetHash(MakeKey<KeyType>(i));
+    low[hash % num_buckets]++;
+    high[hash >> 52]++;
+  }
+  auto chi_square = [&](const std::vector<int> &counts) {
+    double expected = static_cast<double>(num_keys) / num_buckets;
+    double sum = 0;
+    for (int count : counts) {
+      sum += (count - expected) * (count - expected) / expected;
+    }
+    return sum / (num_buckets - 1);
+  };
+  return {chi_square(low), chi_square(high)};
+}
+
+/**
+ * Flips every bit of random keys and checks which bits of the hash change.
+ * @return the largest deviation from 1/2 of the probability that a hash bit changes, over all key and hash bits
+ */
+template <typename KeyType, typename HashFn>
+double AvalancheBias(HashFn hash_fn) {
+  const int num_keys = 1000;
+  const size_t num_key_bits = 8 * sizeof(KeyType);
+  std::vector<std::vector<int>> flips(num_key_bits, std::vector<int>(64));
+  std::mt19937_64 rng(0);
+  for (int k = 0; k < num_keys; k++) {
+    KeyType key;
+    for (size_t byte = 0; byte < sizeof(KeyType); byte++) {
+      reinterpret_cast<char *>(&key)[byte] = static_cast<char>(rng());
+    }
+    uint64_t hash = hash_fn.GetHash(key);
+    for (size_t bit = 0; bit < num_key_bits; bit++) {
+      KeyType flipped = key;
+      reinterpret_cast<char *>(&flipped)[bit / 8] ^= static_cast<char>(1 << (bit % 8));
+      uint64_t diff = hash ^ hash_fn.GetHash(flipped);
+      for (int out = 0; out < 64; out++) {
+        flips[bit][out] += (diff >> out) & 1;
+      }
+    }
+  }
+  double bias = 0;
+  for (const auto &bit_flips : flips) {
+    for (int count : bit_flips) {
+      bias = std::max(bias, std::abs(static_cast<double>(count) / num_keys - 0.5));
+    }
+  }
+  return bias;
+}
+
+// NOLINTNEXTLINE
+TEST(HashFunctionTest, DistributionTest) {
+  // Sequential keys fill the buckets evenly; a chi-square of 1.2 for 4095 degrees of freedom has a p-value of 1e-9.
+  for (auto chi_square : {BucketChiSquare<GenericKey<8>>(Crc32cHashFunction<GenericKey<8>>()),
+                          BucketChiSquare<GenericKey<8>>(WyHashFunction<GenericKey<8>>()),
+                          BucketChiSquare<GenericKey<64>>(Crc32cHashFunction<GenericKey<64>>()),
+                          BucketChiSquare<GenericKey<64>>(WyHashFunction<GenericKey<64>>()),
+                          BucketChiSquare<int>(Crc32cHashFunction<int>()),
+                          BucketChiSquare<int>(WyHashFunction<int>())}) {
+    EXPECT_LT(chi_square.first, 1.2);
+    EXPECT_LT(chi_square.second, 1.2);
+  }
+
+  // Every key bit changes every hash bit about half of the time. CRC32C is linear, a key bit always flips the same
+  // checksum bits, and only the final multiplication mixes them, so it avalanches less well.
+  EXPECT_LT(AvalancheBias<GenericKey<16>>(WyHashFunction<GenericKey<16>>()), 0.1);
+  EXPECT_LT(AvalancheBias<GenericKey<16>>(Crc32cHashFunction<GenericKey<16>>()), 0.2);
+}
+
+// NOLINTNEXTLINE
+TEST(HashFunctionTest, WyHashTest) {
+  // Every length takes a different path through the rounds; hashes of the prefixes of a string all differ.
+  std::string bytes(200, 'x');
+  std::vector<uint64_t> hashes;
+  for (size_t length = 0; length <= bytes.size(); length++) {
+    hashes.push_back(HashUtil::WyHash(bytes.data(), length));
+    EXPECT_EQ(hashes.back(), HashUtil::WyHash(bytes.data(), length));
+    EXPECT_NE(hashes.back(), HashUtil::WyHash(bytes.data(), length, 1));
+  }
+  std::sort(hashes.begin(), hashes.end());
+  EXPECT_EQ(hashes.end(), std::adjacent_find(hashes.begin(), hashes.end()));
+
+  // Each byte matters, wherever it is.
+  for (size_t length : {1, 3, 4, 8, 15, 16, 17, 48, 49, 100}) {
+    std::string copy = bytes.substr(0, length);
+    uint64_t hash = HashUtil::WyHash(copy.data(), length);
+    for (size_t i = 0; i < length; i++) {
+      copy[i] = 'y';
+      EXPECT_NE(hash, HashUtil::WyHash(copy.data(), length)) << length << " " << i;
+      copy[i] = 'x';
+    }
+  }
+
+  EXPECT_NE(HashUtil::CombineHashes(1, 2), HashUtil::CombineHashes(2, 1));
+}
+
+/**
+ * Measures hashes of sequential keys for BUSTUB_HASH_BENCH_MS milliseconds (1000 by default), and reports the bucket
+ * chi-squares and the avalanche bias of the hash function.
+ */
+template <typename KeyType, typename HashFn>
+void HashFunctionBenchmark(const std::string &name, HashFn hash_fn) {
+  const char *ms_env = std::getenv("BUSTUB_HASH_BENCH_MS");
+  const auto duration = std::chrono::milliseconds(ms_env != nullptr ? std::atoi(ms_env) : 1000);
+  std::vector<KeyType> keys;
+  for (int64_t i = 0; i < 1024; i++) {
+    keys.push_back(MakeKey<KeyType>(i));
+  }
+  size_t num_ops = 0;
+  uint64_t checksum = 0;
+  auto start = std::chrono::steady_clock::now();
+  auto end = start + duration;
+  while (std::chrono::steady_clock::now() < end) {
+    for (const auto &key : keys) {
+      checksum += hash_fn.GetHash(key);
+    }
+    num_ops += keys.size();
+  }
+  std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+  auto chi_square = BucketChiSquare<KeyType>(hash_fn);
+  std::cout << name << ", hashes/s: " << num_ops / seconds.count() << ", chi-square low bits: " << chi_square.first
+            << ", high bits: " << chi_square.second << ", avalanche bias: " << AvalancheBias<KeyType>(hash_fn)
+            << " (" << checksum % 10 << ")" << std::endl;
+}
+
+template <typename KeyType>
+void HashFunctionBenchmarks(const std::string &key_name) {
+  HashFunctionBenchmark<KeyType>(key_name + " murmur3", HashFunction<KeyType>());
+  HashFunctionBenchmark<KeyType>(key_name + " crc32c", Crc32cHashFunction<KeyType>());
+  HashFunctionBenchmark<KeyType>(key_name + " wyhash", WyHashFunction<KeyType>());
+}
+
+// NOLINTNEXTLINE
+TEST(HashFunctionTest, DISABLED_HashFunctionBenchmark) {
+  HashFunctionBenchmarks<int>("int");
+  HashFunctionBenchmarks<GenericKey<4>>("GenericKey<4>");
+  HashFunctionBenchmarks<GenericKey<8>>("GenericKey<8>");
+  HashFunctionBenchmarks<GenericKey<16>>("GenericKey<16>");
+  HashFunctionBenchmarks<GenericKey<32>>("GenericKey<32>");
+  HashFunctionBenchmarks<GenericKey<64>>("GenericKey<64>");
+
+  // HashUtil::HashBytes, used for varchar join and aggregation keys, was a byte-at-a-time loop before
+  const char *ms_env = std::getenv("BUSTUB_HASH_BENCH_MS");
+  const auto duration = std::chrono::milliseconds(ms_env != nullptr ? std::atoi(ms_env) : 1000);
+  for (size_t length : {8, 32, 128}) {
+    std::string bytes(length, 'x');
+    size_t num_ops = 0;
+    uint64_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    auto end = start + duration;
+    while (std::chrono::steady_clock::now() < end) {
+      for (int i = 0; i < 1000; i++) {
+        bytes[0] = static_cast<char>(i);
+        checksum += HashUtil::HashBytes(bytes.data(), bytes.size());
+      }
+      num_ops += 1000;
+    }
+    std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+    std::cout << "HashBytes, " << length << " bytes, hashes/s: " << num_ops / seconds.count() << " ("
+              << checksum % 10 << ")" << std::endl;
+  }
+}
+
+}  // namespace bustub
@@ -10,7 +10,9 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <random>
 #include <thread>  // NOLINT
+#include <utility>
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
@@ -18,12 +20,15 @@
 #include "gtest/gtest.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/page/hash_table_block_page.h"
+#include "storage/page/hash_table_bucket_page.h"
+#include "storage/page/hash_table_directory_page.h"
+#include "storage/page/hash_table_filter_page.h"
 #include "storage/page/hash_table_header_page.h"
 
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(HashTablePageTest, DISABLED_HeaderPageSampleTest) {
+TEST(HashTablePageTest, HeaderPageSampleTest) {
   DiskManager *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManager(5, disk_manager);
 
@@ -52,6 +57,19 @@ TEST(HashTablePageTest, DISABLED_HeaderPageSampleTest) {
     EXPECT_EQ(i, header_page->GetBlockPageId(i));
   }
 
+  // filter page IDs fill the page from its end
+  for (unsigned i = 0; i < 3; i++) {
+    header_page->AddFilterPageId(100 + i);
+    EXPECT_EQ(i + 1, header_page->NumFilterPages());
+  }
+  header_page->AddBlockPageId(10);
+  for (int i = 0; i < 3; i++) {
+    EXPECT_EQ(100 + i, header_page->GetFilterPageId(i));
+  }
+  for (int i = 0; i < 11; i++) {
+    EXPECT_EQ(i, header_page->GetBlockPageId(i));
+  }
+
   // unpin the header page now that we are done
   bpm->UnpinPage(header_page_id, true, nullptr);
   disk_manager->ShutDown();
@@ -61,7 +79,7 @@ TEST(HashTablePageTest, DISABLED_HeaderPageSampleTest) {
 }
 
 // NOLINTNEXTLINE
-TEST(HashTablePageTest, DISABLED_BlockPageSampleTest) {
+TEST(HashTablePageTest, BlockPageSampleTest) {
   DiskManager *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManager(5, disk_manager);
 
@@ -73,7 +91,7 @@ TEST(HashTablePageTest, DISABLED_BlockPageSampleTest) {
 
   // insert a few (key, value) pairs
   for (unsigned i = 0; i < 10; i++) {
-    block_page->Insert(i, i, i);
+    block_page->Insert(i, i, i, i % 3);
   }
 
   // check for the inserted pairs
@@ -103,6 +121,16 @@ TEST(HashTablePageTest, DISABLED_BlockPageSampleTest) {
     }
   }
 
+  // check the fingerprint matches: readable slots with the fingerprint, and the slots never occupied
+  uint32_t free;
+  EXPECT_EQ(0b0001000001U, block_page->MatchGroup(0, 0, &free));
+  EXPECT_EQ(~0b1111111111U, free);
+  EXPECT_EQ(0b0000010000U, block_page->MatchGroup(0, 1, &free));
+  EXPECT_EQ(0b0100000100U, block_page->MatchGroup(0, 2, &free));
+  EXPECT_EQ(0U, block_page->MatchGroup(0, 3, &free));
+  EXPECT_EQ(0U, block_page->MatchGroup(1, 0, &free));
+  EXPECT_EQ(~0U, free);
+
   // unpin the header page now that we are done
   bpm->UnpinPage(block_page_id, true, nullptr);
   disk_manager->ShutDown();
@@ -111,4 +139,154 @@ TEST(HashTablePageTest, DISABLED_BlockPageSampleTest) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTablePageTest, FilterPageSampleTest) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(5, disk_manager);
+
+  page_id_t filter_page_id = INVALID_PAGE_ID;
+  auto filter_page = reinterpret_cast<HashTableFilterPage *>(bpm->NewPage(&filter_page_id, nullptr)->GetData());
+
+  // inserted keys are always found, in their line only
+  std::mt19937_64 rng(0);
+  std::vector<uint64_t> hashes;
+  EXPECT_FALSE(filter_page->MayContain(3, 0, 8));
+  for (int i = 0; i < 200; i++) {
+    hashes.push_back(rng());
+    filter_page->Insert(3, hashes.back(), 8);
+    EXPECT_TRUE(filter_page->MayContain(3, hashes.back(), 8));
+    EXPECT_FALSE(filter_page->MayContain(4, hashes.back(), 8));
+  }
+  for (uint64_t hash : hashes) {
+    EXPECT_TRUE(filter_page->MayContain(3, hash, 8));
+  }
+
+  // 200 keys of 8 bits fill most of a line of 512 bits, a line of 8 keys hardly any
+  for (int i = 0; i < 8; i++) {
+    filter_page->Insert(5, rng(), 8);
+  }
+  int line_3_positives = 0;
+  int line_5_positives = 0;
+  for (int i = 0; i < 1000; i++) {
+    uint64_t hash = rng();
+    line_3_positives += filter_page->MayContain(3, hash, 8) ? 1 : 0;
+    line_5_positives += filter_page->MayContain(5, hash, 8) ? 1 : 0;
+  }
+  EXPECT_GT(line_3_positives, 500);
+  EXPECT_LT(line_5_positives, 10);
+
+  bpm->UnpinPage(filter_page_id, true, nullptr);
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTablePageTest, DirectoryPageSampleTest) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(5, disk_manager);
+
+  // get a directory page from the BufferPoolManager
+  page_id_t directory_page_id = INVALID_PAGE_ID;
+  auto directory_page =
+      reinterpret_cast<HashTableDirectoryPage *>(bpm->NewPage(&directory_page_id, nullptr)->GetData());
+  EXPECT_EQ(0, directory_page->GetGlobalDepth());
+  directory_page->SetPageId(directory_page_id);
+  EXPECT_EQ(directory_page_id, directory_page->GetPageId());
+  directory_page->SetBucketPageId(0, 10);
+
+  // grow the directory: bucket 10 splits into 10 and 11, and then bucket 10 into 10 and 12
+  directory_page->IncrGlobalDepth();
+  EXPECT_EQ(2, directory_page->Size());
+  EXPECT_EQ(10, directory_page->GetBucketPageId(1));
+  directory_page->SetBucketPageId(1, 11);
+  directory_page->SetLocalDepth(0, 1);
+  directory_page->SetLocalDepth(1, 1);
+  directory_page->IncrGlobalDepth();
+  EXPECT_EQ(4, directory_page->Size());
+  EXPECT_EQ(0x3, directory_page->GetGlobalDepthMask());
+  EXPECT_EQ(11, directory_page->GetBucketPageId(3));
+  EXPECT_EQ(1, directory_page->GetLocalDepth(3));
+  directory_page->SetBucketPageId(2, 12);
+  directory_page->SetLocalDepth(0, 2);
+  directory_page->SetLocalDepth(2, 2);
+  directory_page->VerifyIntegrity();
+
+  EXPECT_EQ(2, directory_page->GetSplitImageIndex(0));
+  EXPECT_EQ(0, directory_page->GetSplitImageIndex(1));
+  EXPECT_EQ(0x3, directory_page->GetLocalDepthMask(2));
+  EXPECT_EQ(0x1, directory_page->GetLocalDepthMask(1));
+  EXPECT_FALSE(directory_page->CanShrink());
+
+  // merge bucket 12 back into 10, then the directory can shrink
+  directory_page->SetBucketPageId(2, 10);
+  directory_page->SetLocalDepth(0, 1);
+  directory_page->SetLocalDepth(2, 1);
+  EXPECT_TRUE(directory_page->CanShrink());
+  directory_page->DecrGlobalDepth();
+  EXPECT_EQ(2, directory_page->Size());
+  directory_page->VerifyIntegrity();
+
+  // unpin the directory page now that we are done
+  bpm->UnpinPage(directory_page_id, true, nullptr);
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTablePageTest, BucketPageSampleTest) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(5, disk_manager);
+
+  // get a bucket page from the BufferPoolManager
+  page_id_t bucket_page_id = INVALID_PAGE_ID;
+  auto bucket_page = reinterpret_cast<HashTableBucketPage<int, int, IntComparator> *>(
+      bpm->NewPage(&bucket_page_id, nullptr)->GetData());
+  EXPECT_TRUE(bucket_page->IsEmpty());
+  // a few keys share a fingerprint
+  auto fingerprint = [](int key) { return static_cast<uint8_t>(key % 3); };
+
+  // insert a few (key, value) pairs
+  for (int i = 0; i < 10; i++) {
+    EXPECT_TRUE(bucket_page->Insert(i, i, fingerprint(i), IntComparator()));
+  }
+  // the same pair cannot be inserted twice, another value for the key can
+  EXPECT_FALSE(bucket_page->Insert(0, 0, fingerprint(0), IntComparator()));
+  EXPECT_TRUE(bucket_page->Insert(0, 1, fingerprint(0), IntComparator()));
+  EXPECT_EQ(11, bucket_page->NumReadable());
+
+  std::vector<int> result;
+  EXPECT_TRUE(bucket_page->GetValue(0, fingerprint(0), IntComparator(), &result));
+  EXPECT_EQ((std::vector<int>{0, 1}), result);
+  result.clear();
+  EXPECT_FALSE(bucket_page->GetValue(20, fingerprint(20), IntComparator(), &result));
+
+  // remove a few pairs, the freed slots are reused
+  for (int i = 0; i < 10; i += 2) {
+    EXPECT_TRUE(bucket_page->Remove(i, i, fingerprint(i), IntComparator()));
+    EXPECT_FALSE(bucket_page->Remove(i, i, fingerprint(i), IntComparator()));
+  }
+  EXPECT_FALSE(bucket_page->IsReadable(0));
+  EXPECT_TRUE(bucket_page->Insert(20, 20, fingerprint(20), IntComparator()));
+  EXPECT_TRUE(bucket_page->IsReadable(0));
+  EXPECT_EQ(20, bucket_page->KeyAt(0));
+
+  // fill the bucket
+  for (int i = 100; !bucket_page->IsFull(); i++) {
+    EXPECT_TRUE(bucket_page->Insert(i, i, fingerprint(i), IntComparator()));
+  }
+  EXPECT_EQ(8 * (PAGE_SIZE - 1) / (8 * sizeof(std::pair<int, int>) + 9), bucket_page->NumReadable());
+  EXPECT_FALSE(bucket_page->Insert(-1, -1, fingerprint(-1), IntComparator()));
+
+  // unpin the bucket page now that we are done
+  bpm->UnpinPage(bucket_page_id, true, nullptr);
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
 }  // namespace bustub
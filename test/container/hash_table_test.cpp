@@ -10,6 +10,14 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
 #include <thread>  // NOLINT
 #include <vector>
 
@@ -17,11 +25,12 @@
 #include "container/hash/linear_probe_hash_table.h"
 #include "gtest/gtest.h"
 #include "murmur3/MurmurHash3.h"
+#include "storage/index/generic_key.h"
 
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(HashTableTest, DISABLED_SampleTest) {
+TEST(HashTableTest, SampleTest) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManager(50, disk_manager);
 
@@ -104,4 +113,632 @@ TEST(HashTableTest, DISABLED_SampleTest) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTableTest, ResizeTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 10, HashFunction<int>());
+
+  // The table doubles whenever it is full.
+  for (int i = 0; i < 5000; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  EXPECT_GE(ht.GetSize(), 5000);
+  for (int i = 0; i < 5000; i++) {
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    EXPECT_EQ(1, res.size());
+    EXPECT_EQ(i, res[0]);
+  }
+
+  // Resizing explicitly keeps the pairs too.
+  size_t size = ht.GetSize();
+  ht.Resize(size);
+  EXPECT_GE(ht.GetSize(), 2 * size);
+  for (int i = 0; i < 5000; i++) {
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    EXPECT_EQ(1, res.size());
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, TombstoneTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 100, HashFunction<int>());
+
+  // Removes leave tombstones behind. Once they fill the table, it is rebuilt without them at the same size.
+  for (int i = 0; i < 1000; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+    EXPECT_FALSE(ht.Remove(nullptr, i, i));
+  }
+  EXPECT_EQ(100, ht.GetSize());
+  for (int i = 0; i < 1000; i++) {
+    std::vector<int> res;
+    EXPECT_FALSE(ht.GetValue(nullptr, i, &res));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, ConcurrentTest) {
+  const int num_threads = 4;
+  const int num_keys = 2000;
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  // The table starts small, so that it is resized while the threads insert.
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 10, HashFunction<int>());
+
+  // Every thread inserts two values for each of its keys, and then removes one of them.
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      for (int i = t; i < num_keys; i += num_threads) {
+        EXPECT_TRUE(ht.Insert(nullptr, i, i));
+        EXPECT_TRUE(ht.Insert(nullptr, i, -i - 1));
+      }
+      for (int i = t; i < num_keys; i += num_threads) {
+        std::vector<int> res;
+        EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+        EXPECT_EQ(2, res.size());
+        EXPECT_TRUE(ht.Remove(nullptr, i, -i - 1));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    ASSERT_EQ(1, res.size());
+    EXPECT_EQ(i, res[0]);
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, MigrationTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 10, HashFunction<int>());
+
+  // The table keeps growing, so most operations find a migration running. Every pair is found exactly once.
+  for (int i = 0; i < 3000; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    EXPECT_FALSE(ht.Insert(nullptr, i / 2, i / 2));
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, i / 3, &res));
+    EXPECT_EQ(1, res.size());
+  }
+  // Removes find the pairs wherever the migration left them.
+  for (int i = 0; i < 3000; i += 2) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+  }
+  for (int i = 0; i < 3000; i++) {
+    std::vector<int> res;
+    EXPECT_EQ(i % 2 == 1, ht.GetValue(nullptr, i, &res));
+    EXPECT_EQ(i % 2, res.size());
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, ConcurrentMigrationTest) {
+  const int num_threads = 4;
+  const int num_keys = 4000;
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(100, disk_manager);
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 10, HashFunction<int>());
+
+  // Every thread inserts its keys and removes every other one, checking its keys while other threads migrate.
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      for (int i = t; i < num_keys; i += num_threads) {
+        EXPECT_TRUE(ht.Insert(nullptr, i, i));
+        std::vector<int> res;
+        EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+        EXPECT_EQ(1, res.size());
+        if (i % 2 == 0) {
+          EXPECT_TRUE(ht.Remove(nullptr, i, i));
+          EXPECT_FALSE(ht.Remove(nullptr, i, i));
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    EXPECT_EQ(i % 2 == 1, ht.GetValue(nullptr, i, &res));
+    EXPECT_EQ(i % 2, res.size());
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, BatchLookupTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 10, HashFunction<int>());
+
+  // A batch finds what single lookups find, while the table grows and migrates. Every third key has two values, the
+  // batches repeat keys and look up keys that are not in the table.
+  auto check_batch = [&](const std::vector<int> &keys) {
+    std::vector<std::vector<int>> results(1, std::vector<int>{-42});
+    size_t num_found = ht.GetValues(nullptr, keys, &results);
+    ASSERT_EQ(keys.size(), results.size());
+    size_t num_single_found = 0;
+    for (size_t k = 0; k < keys.size(); k++) {
+      std::vector<int> res(k == 0 ? 1 : 0, -42);
+      num_single_found += ht.GetValue(nullptr, keys[k], &res) ? 1 : 0;
+      std::sort(res.begin(), res.end());
+      std::sort(results[k].begin(), results[k].end());
+      EXPECT_EQ(res, results[k]) << keys[k];
+    }
+    EXPECT_EQ(num_single_found, num_found);
+  };
+  std::vector<int> keys;
+  for (int i = 0; i < 3000; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    if (i % 3 == 0) {
+      EXPECT_TRUE(ht.Insert(nullptr, i, -i - 1));
+    }
+    if (i % 100 == 99) {
+      keys.clear();
+      for (int j = 0; j < i + 100; j += 7) {
+        keys.push_back(j);
+        keys.push_back(j / 2);
+      }
+      check_batch(keys);
+    }
+  }
+
+  // In a table that is almost full, probe sequences run across block pages and wrap around.
+  LinearProbeHashTable<int, int, IntComparator> full_ht("full", bpm, IntComparator(), 1000, HashFunction<int>());
+  for (int i = 0; i < 990; i++) {
+    EXPECT_TRUE(full_ht.Insert(nullptr, i, i));
+  }
+  keys.clear();
+  for (int i = 0; i < 2000; i++) {
+    keys.push_back(i);
+  }
+  std::vector<std::vector<int>> results;
+  EXPECT_EQ(990, full_ht.GetValues(nullptr, keys, &results));
+  for (int i = 0; i < 2000; i++) {
+    EXPECT_EQ(i < 990 ? std::vector<int>{i} : std::vector<int>{}, results[i]);
+  }
+  EXPECT_EQ(1000, full_ht.GetSize());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, BloomFilterTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 10, HashFunction<int>(), 10);
+
+  // The filters of the tables follow the table as it grows. Inserted keys are always found, most of the others are
+  // filtered out.
+  for (int i = 0; i < 3000; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, i / 2, &res));
+    EXPECT_TRUE(ht.MayContain(i / 3));
+  }
+  int num_positives = 0;
+  for (int i = 3000; i < 13000; i++) {
+    num_positives += ht.MayContain(i) ? 1 : 0;
+    std::vector<int> res;
+    EXPECT_FALSE(ht.GetValue(nullptr, i, &res));
+  }
+  EXPECT_LT(num_positives, 500);
+
+  // Removed keys stay in the filter until the table is rebuilt.
+  for (int i = 0; i < 3000; i += 2) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+    EXPECT_FALSE(ht.Remove(nullptr, i, i));
+  }
+  ht.Resize(ht.GetSize());
+  num_positives = 0;
+  for (int i = 0; i < 3000; i++) {
+    std::vector<int> res;
+    EXPECT_EQ(i % 2 == 1, ht.GetValue(nullptr, i, &res));
+    if (i % 2 == 1) {
+      EXPECT_TRUE(ht.MayContain(i));
+    } else {
+      num_positives += ht.MayContain(i) ? 1 : 0;
+    }
+  }
+  EXPECT_LT(num_positives, 75);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, BulkInsertTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1000, HashFunction<int>(), 8);
+
+  // Bulk inserts fill a table that holds pairs already. Probe sequences run across block pages and wrap around, and
+  // the table only grows once it is full.
+  for (int i = 0; i < 100; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  std::vector<std::pair<int, int>> pairs;
+  for (int i = 100; i < 990; i++) {
+    pairs.emplace_back(i / 2, i);
+  }
+  ht.BulkInsert(nullptr, pairs);
+  EXPECT_EQ(1000, ht.GetSize());
+  pairs.clear();
+  for (int i = 990; i < 3000; i++) {
+    pairs.emplace_back(i / 2, i);
+  }
+  ht.BulkInsert(nullptr, pairs);
+  EXPECT_LT(1000, ht.GetSize());
+
+  for (int key = 0; key < 1500; key++) {
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, key, &res));
+    std::sort(res.begin(), res.end());
+    std::vector<int> expected;
+    for (int i = std::max(2 * key, 100); i <= 2 * key + 1; i++) {
+      expected.push_back(i);
+    }
+    if (key < 100) {
+      expected.insert(expected.begin(), key);
+      std::sort(expected.begin(), expected.end());
+    }
+    EXPECT_EQ(expected, res) << key;
+    EXPECT_TRUE(ht.MayContain(key));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+/**
+ * Runs BUSTUB_HASH_BENCH_MS milliseconds (1000 by default) of a mix of lookups, inserts and removes on a table of
+ * BUSTUB_HASH_BENCH_KEYS keys (10000 by default) with 1 to 4 threads. Keys are drawn from twice the key count, so
+ * inserts and removes keep the table about half full, and the removes leave tombstones that the table has to clean up.
+ */
+template <size_t KeySize>
+void HashTableBenchmark(int lookup_percent) {
+  const char *ms_env = std::getenv("BUSTUB_HASH_BENCH_MS");
+  const char *keys_env = std::getenv("BUSTUB_HASH_BENCH_KEYS");
+  const auto duration = std::chrono::milliseconds(ms_env != nullptr ? std::atoi(ms_env) : 1000);
+  const int64_t num_keys = keys_env != nullptr ? std::atoi(keys_env) : 10000;
+  Schema key_schema{std::vector<Column>{Column{"a", TypeId::BIGINT}}};
+  auto make_key = [](int64_t i) {
+    GenericKey<KeySize> key;
+    key.SetFromInteger(i);
+    return key;
+  };
+
+  for (int num_threads = 1; num_threads <= 4; num_threads *= 2) {
+    auto *disk_manager = new DiskManager("hash_bench.db");
+    auto *bpm = new BufferPoolManager(1024, disk_manager);
+    LinearProbeHashTable<GenericKey<KeySize>, RID, GenericComparator<KeySize>> ht(
+        "bench", bpm, GenericComparator<KeySize>(&key_schema), 4 * num_keys, HashFunction<GenericKey<KeySize>>());
+    for (int64_t i = 0; i < num_keys; i++) {
+      ht.Insert(nullptr, make_key(i), RID(i));
+    }
+
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> num_ops{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+      threads.emplace_back([&, t] {
+        std::mt19937_64 rng(t);
+        std::uniform_int_distribution<int64_t> pick_key(0, 2 * num_keys - 1);
+        std::uniform_int_distribution<int> pick_op(0, 99);
+        std::vector<RID> result;
+        size_t ops = 0;
+        while (!stop) {
+          int64_t i = pick_key(rng);
+          int op = pick_op(rng);
+          if (op < lookup_percent) {
+            result.clear();
+            ht.GetValue(nullptr, make_key(i), &result);
+          } else if (op % 2 == 0) {
+            ht.Insert(nullptr, make_key(i), RID(i));
+          } else {
+            ht.Remove(nullptr, make_key(i), RID(i));
+          }
+          ops++;
+        }
+        num_ops += ops;
+      });
+    }
+    std::this_thread::sleep_for(duration);
+    stop = true;
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    std::chrono::duration<double> seconds = duration;
+    std::cout << "key bytes: " << KeySize << ", lookups: " << lookup_percent << "%, threads: " << num_threads
+              << ", ops/s: " << num_ops / seconds.count() << ", buckets: " << ht.GetSize() << std::endl;
+
+    disk_manager->ShutDown();
+    remove("hash_bench.db");
+    delete disk_manager;
+    delete bpm;
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, DISABLED_HashTableBenchmark) {
+  for (int lookup_percent : {90, 50}) {
+    HashTableBenchmark<8>(lookup_percent);
+    HashTableBenchmark<16>(lookup_percent);
+    HashTableBenchmark<32>(lookup_percent);
+    HashTableBenchmark<64>(lookup_percent);
+  }
+}
+
+/**
+ * Looks up keys in a table of BUSTUB_HASH_BENCH_KEYS keys (10000 by default) that is three quarters full, for
+ * BUSTUB_HASH_BENCH_MS milliseconds (1000 by default). Hits look up keys in the table, misses look up keys that are
+ * not, which probe until they reach a free slot.
+ */
+template <size_t KeySize>
+void HashTableLookupBenchmark() {
+  const char *ms_env = std::getenv("BUSTUB_HASH_BENCH_MS");
+  const char *keys_env = std::getenv("BUSTUB_HASH_BENCH_KEYS");
+  const auto duration = std::chrono::milliseconds(ms_env != nullptr ? std::atoi(ms_env) : 1000);
+  const int64_t num_keys = keys_env != nullptr ? std::atoi(keys_env) : 10000;
+  Schema key_schema{std::vector<Column>{Column{"a", TypeId::BIGINT}}};
+  auto make_key = [](int64_t i) {
+    GenericKey<KeySize> key;
+    key.SetFromInteger(i);
+    return key;
+  };
+
+  auto *disk_manager = new DiskManager("hash_bench.db");
+  auto *bpm = new BufferPoolManager(1024, disk_manager);
+  LinearProbeHashTable<GenericKey<KeySize>, RID, GenericComparator<KeySize>> ht(
+      "bench", bpm, GenericComparator<KeySize>(&key_schema), num_keys * 4 / 3, HashFunction<GenericKey<KeySize>>());
+  for (int64_t i = 0; i < num_keys; i++) {
+    ht.Insert(nullptr, make_key(i), RID(i));
+  }
+
+  for (bool hit : {true, false}) {
+    std::mt19937_64 rng(0);
+    std::uniform_int_distribution<int64_t> pick_key(0, num_keys - 1);
+    std::vector<RID> result;
+    size_t num_ops = 0;
+    size_t num_found = 0;
+    auto start = std::chrono::steady_clock::now();
+    auto end = start + duration;
+    while (std::chrono::steady_clock::now() < end) {
+      for (int i = 0; i < 1000; i++) {
+        result.clear();
+        num_found += ht.GetValue(nullptr, make_key(hit ? pick_key(rng) : num_keys + pick_key(rng)), &result) ? 1 : 0;
+      }
+      num_ops += 1000;
+    }
+    std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(hit ? num_ops : 0, num_found);
+    std::cout << "key bytes: " << KeySize << ", " << (hit ? "hits" : "misses")
+              << ", lookups/s: " << num_ops / seconds.count() << std::endl;
+  }
+
+  disk_manager->ShutDown();
+  remove("hash_bench.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, DISABLED_HashTableLookupBenchmark) {
+  HashTableLookupBenchmark<8>();
+  HashTableLookupBenchmark<16>();
+  HashTableLookupBenchmark<32>();
+  HashTableLookupBenchmark<64>();
+}
+
+/**
+ * Looks up random keys in batches of 1 to 256 keys, for BUSTUB_HASH_BENCH_MS milliseconds (1000 by default) per batch
+ * size. A batch size of 1 calls GetValue. A table has at most HASH_TABLE_HEADER_MAX_BLOCKS block pages, about 4 MB, so
+ * BUSTUB_HASH_BENCH_TABLES tables (32 by default) of the largest size, three quarters full, make the data larger than
+ * the L3 cache, and each batch goes to a random table.
+ */
+// NOLINTNEXTLINE
+TEST(HashTableTest, DISABLED_BatchLookupBenchmark) {
+  using KeyType = GenericKey<8>;
+  using ValueType = RID;
+  const char *ms_env = std::getenv("BUSTUB_HASH_BENCH_MS");
+  const char *tables_env = std::getenv("BUSTUB_HASH_BENCH_TABLES");
+  const auto duration = std::chrono::milliseconds(ms_env != nullptr ? std::atoi(ms_env) : 1000);
+  const int num_tables = tables_env != nullptr ? std::atoi(tables_env) : 32;
+  const size_t num_buckets = HASH_TABLE_HEADER_MAX_BLOCKS * BLOCK_ARRAY_SIZE;
+  const int64_t num_keys = num_buckets * 3 / 4;
+  Schema key_schema{std::vector<Column>{Column{"a", TypeId::BIGINT}}};
+  auto make_key = [](int64_t i) {
+    KeyType key;
+    key.SetFromInteger(i);
+    return key;
+  };
+
+  // The buffer pool holds all tables
+  auto *disk_manager = new DiskManager("hash_bench.db");
+  auto *bpm = new BufferPoolManager(num_tables * (HASH_TABLE_HEADER_MAX_BLOCKS + 1) + 16, disk_manager);
+  std::vector<std::unique_ptr<LinearProbeHashTable<KeyType, ValueType, GenericComparator<8>>>> tables;
+  for (int t = 0; t < num_tables; t++) {
+    tables.emplace_back(new LinearProbeHashTable<KeyType, ValueType, GenericComparator<8>>(
+        "bench", bpm, GenericComparator<8>(&key_schema), num_buckets, HashFunction<KeyType>()));
+    for (int64_t i = 0; i < num_keys; i++) {
+      tables.back()->Insert(nullptr, make_key(i), RID(i));
+    }
+  }
+
+  std::mt19937_64 rng(0);
+  std::uniform_int_distribution<int64_t> pick_key(0, num_keys - 1);
+  std::uniform_int_distribution<int> pick_table(0, num_tables - 1);
+  for (size_t batch_size : {1, 4, 16, 64, 256}) {
+    std::vector<KeyType> keys(batch_size);
+    std::vector<std::vector<RID>> results;
+    std::vector<RID> result;
+    size_t num_ops = 0;
+    size_t num_found = 0;
+    auto start = std::chrono::steady_clock::now();
+    auto end = start + duration;
+    while (std::chrono::steady_clock::now() < end) {
+      for (auto &key : keys) {
+        key = make_key(pick_key(rng));
+      }
+      auto &ht = *tables[pick_table(rng)];
+      if (batch_size == 1) {
+        result.clear();
+        num_found += ht.GetValue(nullptr, keys[0], &result) ? 1 : 0;
+      } else {
+        results.clear();
+        num_found += ht.GetValues(nullptr, keys, &results);
+      }
+      num_ops += batch_size;
+    }
+    std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(num_ops, num_found);
+    std::cout << "tables: " << num_tables << ", keys: " << num_tables * num_keys << ", batch size: " << batch_size
+              << ", lookups/s: " << num_ops / seconds.count() << std::endl;
+  }
+
+  tables.clear();
+  disk_manager->ShutDown();
+  remove("hash_bench.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+/**
+ * Looks up keys in a table of BUSTUB_HASH_BENCH_KEYS keys (100000 by default) that is three quarters full, with Bloom
+ * filters of 0 to 16 bits per bucket, for BUSTUB_HASH_BENCH_MS milliseconds (1000 by default) each, and reports the
+ * lookup latencies of hits and misses and the false positive rate of the filter.
+ */
+// NOLINTNEXTLINE
+TEST(HashTableTest, DISABLED_BloomFilterBenchmark) {
+  const char *ms_env = std::getenv("BUSTUB_HASH_BENCH_MS");
+  const char *keys_env = std::getenv("BUSTUB_HASH_BENCH_KEYS");
+  const auto duration = std::chrono::milliseconds(ms_env != nullptr ? std::atoi(ms_env) : 1000);
+  const int64_t num_keys = keys_env != nullptr ? std::atoi(keys_env) : 100000;
+  const size_t num_buckets = num_keys * 4 / 3;
+  Schema key_schema{std::vector<Column>{Column{"a", TypeId::BIGINT}}};
+  auto make_key = [](int64_t i) {
+    GenericKey<8> key;
+    key.SetFromInteger(i);
+    return key;
+  };
+
+  for (size_t bits_per_bucket : {0, 4, 8, 12, 16}) {
+    auto *disk_manager = new DiskManager("hash_bench.db");
+    auto *bpm = new BufferPoolManager(1100, disk_manager);
+    LinearProbeHashTable<GenericKey<8>, RID, GenericComparator<8>> ht("bench", bpm,
+                                                                        GenericComparator<8>(&key_schema), num_buckets,
+                                                                        HashFunction<GenericKey<8>>(), bits_per_bucket);
+    for (int64_t i = 0; i < num_keys; i++) {
+      ht.Insert(nullptr, make_key(i), RID(i));
+    }
+
+    std::cout << "filter bits per key: " << static_cast<double>(bits_per_bucket * num_buckets) / num_keys;
+    for (bool hit : {true, false}) {
+      std::mt19937_64 rng(0);
+      std::uniform_int_distribution<int64_t> pick_key(0, num_keys - 1);
+      std::vector<RID> result;
+      size_t num_ops = 0;
+      size_t num_found = 0;
+      auto start = std::chrono::steady_clock::now();
+      auto end = start + duration;
+      while (std::chrono::steady_clock::now() < end) {
+        for (int i = 0; i < 1000; i++) {
+          result.clear();
+          num_found += ht.GetValue(nullptr, make_key(hit ? pick_key(rng) : num_keys + pick_key(rng)), &result) ? 1 : 0;
+        }
+        num_ops += 1000;
+      }
+      std::chrono::duration<double, std::nano> nanos = std::chrono::steady_clock::now() - start;
+      EXPECT_EQ(hit ? num_ops : 0, num_found);
+      std::cout << ", " << (hit ? "hit" : "miss") << " ns: " << nanos.count() / num_ops;
+    }
+    size_t num_positives = 0;
+    for (int64_t i = num_keys; i < 2 * num_keys; i++) {
+      num_positives += ht.MayContain(make_key(i)) ? 1 : 0;
+    }
+    std::cout << ", false positives: " << static_cast<double>(num_positives) / num_keys << std::endl;
+
+    disk_manager->ShutDown();
+    remove("hash_bench.db");
+    delete disk_manager;
+    delete bpm;
+  }
+}
+
+/**
+ * Inserts BUSTUB_HASH_BENCH_KEYS keys (200000 by default) into a table of 1000 buckets, which grows eight times on the
+ * way, and reports the latency of the slowest inserts.
+ */
+// NOLINTNEXTLINE
+TEST(HashTableTest, DISABLED_GrowthLatencyBenchmark) {
+  const char *keys_env = std::getenv("BUSTUB_HASH_BENCH_KEYS");
+  const int num_keys = keys_env != nullptr ? std::atoi(keys_env) : 200000;
+  auto *disk_manager = new DiskManager("hash_bench.db");
+  auto *bpm = new BufferPoolManager(4096, disk_manager);
+  LinearProbeHashTable<int, int, IntComparator> ht("bench", bpm, IntComparator(), 1000, HashFunction<int>());
+
+  std::vector<double> latencies(num_keys);
+  auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < num_keys; i++) {
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(ht.Insert(nullptr, i, i));
+    latencies[i] = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+  }
+  std::chrono::duration<double, std::milli> total = std::chrono::steady_clock::now() - begin;
+  std::sort(latencies.begin(), latencies.end());
+  std::cout << "keys: " << num_keys << ", buckets: " << ht.GetSize() << ", total ms: " << total.count()
+            << ", p50 us: " << latencies[num_keys / 2] << ", p99.9 us: " << latencies[num_keys * 999 / 1000]
+            << ", max us: " << latencies.back() << std::endl;
+
+  disk_manager->ShutDown();
+  remove("hash_bench.db");
+  delete disk_manager;
+  delete bpm;
+}
+
 }  // namespace bustub
@@ -122,7 +122,7 @@ class ExecutorTest : public ::testing::Test {
 };
 
 // NOLINTNEXTLINE
-TEST_F(ExecutorTest, DISABLED_SimpleSeqScanTest) {
+TEST_F(ExecutorTest, SimpleSeqScanTest) {
   // SELECT colA, colB FROM test_1 WHERE colA < 500
   TableMetadata *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
   Schema &schema = table_info->schema_;
@@ -148,6 +148,70 @@ TEST_F(ExecutorTest, DISABLED_SimpleSeqScanTest) {
   ASSERT_EQ(num_tuples, 500);
 }
 
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, SkipLockedSeqScanTest) {
+  // SELECT colA FROM test_1 WHERE colA < 10 FOR SHARE SKIP LOCKED
+  TableMetadata *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  Schema &schema = table_info->schema_;
+  auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto *const10 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(10));
+  auto *predicate = MakeComparisonExpression(colA, const10, ComparisonType::LessThan);
+  auto *out_schema = MakeOutputSchema({{"colA", colA}});
+
+  LockManager lock_manager{TwoPLMode::STRICT};
+  TransactionManager txn_mgr{&lock_manager};
+  SeqScanPlanNode plan{out_schema, predicate, table_info->oid_, LockWaitPolicy::SKIP_LOCKED};
+  auto scan = [&](Transaction *scanner, const SeqScanPlanNode *scan_plan) {
+    ExecutorContext exec_ctx{scanner, GetExecutorContext()->GetCatalog(),
+                             GetExecutorContext()->GetBufferPoolManager(), &lock_manager};
+    auto executor = ExecutorFactory::CreateExecutor(&exec_ctx, scan_plan);
+    executor->Init();
+    Tuple tuple;
+    std::unordered_set<int32_t> seen;
+    while (executor->Next(&tuple)) {
+      seen.insert(tuple.GetValue(out_schema, 0).GetAs<int32_t>());
+    }
+    return seen;
+  };
+
+  // Another transaction holds an exclusive lock on the first row.
+  auto *holder = txn_mgr.Begin();
+  RID first_rid;
+  table_info->table_->GetFirstRid(&first_rid);
+  ASSERT_TRUE(lock_manager.LockTable(holder, table_info->oid_, LockMode::INTENTION_EXCLUSIVE));
+  ASSERT_TRUE(lock_manager.LockRow(holder, table_info->oid_, first_rid, LockMode::EXCLUSIVE));
+
+  // The locked row is skipped, and the scanner neither waits nor aborts.
+  auto *scanner = txn_mgr.Begin();
+  auto seen = scan(scanner, &plan);
+  EXPECT_EQ(TransactionState::GROWING, scanner->GetState());
+  EXPECT_EQ(9, seen.size());
+  EXPECT_EQ(0, seen.count(0));
+  txn_mgr.Commit(scanner);
+
+  // Under NOWAIT, the locked row aborts the scanner instead.
+  SeqScanPlanNode nowait_plan{out_schema, predicate, table_info->oid_, LockWaitPolicy::NOWAIT};
+  auto *nowait_scanner = txn_mgr.Begin();
+  EXPECT_TRUE(scan(nowait_scanner, &nowait_plan).empty());
+  EXPECT_EQ(TransactionState::ABORTED, nowait_scanner->GetState());
+  txn_mgr.Abort(nowait_scanner);
+  txn_mgr.Commit(holder);
+
+  // A table locked by another transaction is skipped as a whole.
+  auto *table_holder = txn_mgr.Begin();
+  ASSERT_TRUE(lock_manager.LockTable(table_holder, table_info->oid_, LockMode::EXCLUSIVE));
+  auto *table_scanner = txn_mgr.Begin();
+  EXPECT_TRUE(scan(table_scanner, &plan).empty());
+  EXPECT_EQ(TransactionState::GROWING, table_scanner->GetState());
+  txn_mgr.Commit(table_scanner);
+  txn_mgr.Commit(table_holder);
+
+  for (auto *txn : {holder, scanner, nowait_scanner, table_holder, table_scanner}) {
+    delete txn;
+  }
+  EXPECT_EQ(0U, lock_manager.GetNumLockRequests());
+}
+
 // NOLINTNEXTLINE
 TEST_F(ExecutorTest, DISABLED_SimpleRawInsertTest) {
   // INSERT INTO empty_table2 VALUES (100, 10), (101, 11), (102, 12)
@@ -10,7 +10,12 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <chrono>  // NOLINT
+#include <cstdlib>
+#include <filesystem>
+#include <random>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "common/bustub_instance.h"
@@ -23,13 +28,25 @@
 #include "storage/table/table_heap.h"
 #include "storage/table/table_iterator.h"
 #include "storage/table/tuple.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
+/** Removes every log segment file written for the given log name. */
+static void RemoveLogSegments(const std::string &log_name) {
+  std::error_code ec;
+  for (const auto &entry : std::filesystem::directory_iterator(".", ec)) {
+    std::string name = entry.path().filename().string();
+    if (name.compare(0, log_name.size() + 1, log_name + ".") == 0) {
+      std::filesystem::remove(entry.path(), ec);
+    }
+  }
+}
+
 // NOLINTNEXTLINE
-TEST(RecoveryTest, DISABLED_RedoTest) {
+TEST(RecoveryTest, RedoTest) {
   remove("test.db");
-  remove("test.log");
+  RemoveLogSegments("test.log");
 
   BustubInstance *bustub_instance = new BustubInstance("test.db");
 
@@ -95,7 +112,7 @@ TEST(RecoveryTest, DISABLED_RedoTest) {
   LOG_INFO("Redo underway...");
   log_recovery->Redo();
   LOG_INFO("Undo underway...");
-  log_recovery->Undo();
+  EXPECT_TRUE(log_recovery->Undo());
 
   LOG_INFO("Check if recovery success");
   txn = bustub_instance->transaction_manager_->Begin();
@@ -118,13 +135,13 @@ TEST(RecoveryTest, DISABLED_RedoTest) {
   delete bustub_instance;
   LOG_INFO("Tearing down the system..");
   remove("test.db");
-  remove("test.log");
+  RemoveLogSegments("test.log");
 }
 
 // NOLINTNEXTLINE
-TEST(RecoveryTest, DISABLED_UndoTest) {
+TEST(RecoveryTest, UndoTest) {
   remove("test.db");
-  remove("test.log");
+  RemoveLogSegments("test.log");
   BustubInstance *bustub_instance = new BustubInstance("test.db");
 
   ASSERT_FALSE(enable_logging);
@@ -183,7 +200,7 @@ TEST(RecoveryTest, DISABLED_UndoTest) {
 
   log_recovery->Redo();
   LOG_INFO("Redo underway...");
-  log_recovery->Undo();
+  EXPECT_TRUE(log_recovery->Undo());
   LOG_INFO("Undo underway...");
 
   LOG_INFO("Check if failed txn is undo successfully");
@@ -202,13 +219,707 @@ TEST(RecoveryTest, DISABLED_UndoTest) {
   delete bustub_instance;
   LOG_INFO("Tearing down the system..");
   remove("test.db");
-  remove("test.log");
+  RemoveLogSegments("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(RecoveryTest, ParallelRedoTest) {
+  remove("test.db");
+  RemoveLogSegments("test.log");
+  auto *bustub_instance = new BustubInstance("test.db");
+  bustub_instance->log_manager_->RunFlushThread();
+
+  Column col1{"a", TypeId::VARCHAR, 20};
+  Column col2{"b", TypeId::SMALLINT};
+  Schema schema{std::vector<Column>{col1, col2}};
+
+  // Spread the committed work over many more pages than the buffer pool holds.
+  Transaction *txn = bustub_instance->transaction_manager_->Begin();
+  auto *test_table = new TableHeap(bustub_instance->buffer_pool_manager_, bustub_instance->lock_manager_,
+                                   bustub_instance->log_manager_, txn);
+  page_id_t first_page_id = test_table->GetFirstPageId();
+  std::unordered_map<int64_t, Tuple> expected;
+  std::vector<RID> rids;
+  for (int i = 0; i < 2000; i++) {
+    RID rid;
+    Tuple tuple = ConstructTuple(&schema);
+    ASSERT_TRUE(test_table->InsertTuple(tuple, &rid, txn));
+    expected[rid.Get()] = tuple;
+    rids.push_back(rid);
+  }
+  for (size_t i = 0; i < rids.size(); i += 7) {
+    Tuple tuple = ConstructTuple(&schema);
+    if (test_table->UpdateTuple(tuple, rids[i], txn)) {
+      expected[rids[i].Get()] = tuple;
+    }
+  }
+  for (size_t i = 3; i < rids.size(); i += 11) {
+    ASSERT_TRUE(test_table->MarkDelete(rids[i], txn));
+    expected.erase(rids[i].Get());
+  }
+  bustub_instance->transaction_manager_->Commit(txn);
+  delete txn;
+
+  // A loser whose changes must disappear again.
+  Transaction *loser = bustub_instance->transaction_manager_->Begin();
+  std::vector<RID> loser_rids;
+  for (int i = 0; i < 100; i++) {
+    RID rid;
+    ASSERT_TRUE(test_table->InsertTuple(ConstructTuple(&schema), &rid, loser));
+    loser_rids.push_back(rid);
+  }
+  bustub_instance->log_manager_->Flush();
+  delete loser;
+  delete test_table;
+
+  // Crash.
+  delete bustub_instance;
+
+  bustub_instance = new BustubInstance("test.db");
+  auto *log_recovery =
+      new LogRecovery(bustub_instance->disk_manager_, bustub_instance->buffer_pool_manager_, nullptr, 4);
+  EXPECT_EQ(4, log_recovery->GetNumWorkers());
+  log_recovery->Redo();
+  EXPECT_TRUE(log_recovery->Undo());
+  EXPECT_GT(log_recovery->GetNumRedoRecords(), 2000);
+  delete log_recovery;
+
+  txn = bustub_instance->transaction_manager_->Begin();
+  test_table = new TableHeap(bustub_instance->buffer_pool_manager_, bustub_instance->lock_manager_,
+                             bustub_instance->log_manager_, first_page_id);
+  size_t num_tuples = 0;
+  for (auto it = test_table->Begin(txn); it != test_table->End(); ++it) {
+    auto found = expected.find(it->GetRid().Get());
+    ASSERT_NE(found, expected.end());
+    ASSERT_EQ(it->GetLength(), found->second.GetLength());
+    ASSERT_EQ(0, memcmp(it->GetData(), found->second.GetData(), it->GetLength()));
+    num_tuples++;
+  }
+  EXPECT_EQ(expected.size(), num_tuples);
+  Tuple tuple;
+  for (const auto &rid : loser_rids) {
+    EXPECT_FALSE(test_table->GetTuple(rid, &tuple, txn));
+  }
+  bustub_instance->transaction_manager_->Commit(txn);
+  delete txn;
+  delete test_table;
+
+  delete bustub_instance;
+  remove("test.db");
+  RemoveLogSegments("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(RecoveryTest, LogTruncationTest) {
+  remove("test.db");
+  RemoveLogSegments("test.log");
+  std::filesystem::remove_all("test_log_archive");
+  auto *bustub_instance = new BustubInstance("test.db");
+  // Tiny segments, so that every commit below starts a new one.
+  bustub_instance->disk_manager_->SetLogSegmentSize(1024);
+  bustub_instance->disk_manager_->SetLogArchiveDirectory("test_log_archive");
+  bustub_instance->log_manager_->RunFlushThread();
+
+  Column col1{"a", TypeId::VARCHAR, 20};
+  Column col2{"b", TypeId::SMALLINT};
+  Schema schema{std::vector<Column>{col1, col2}};
+
+  Transaction *txn = bustub_instance->transaction_manager_->Begin();
+  auto *test_table = new TableHeap(bustub_instance->buffer_pool_manager_, bustub_instance->lock_manager_,
+                                   bustub_instance->log_manager_, txn);
+  page_id_t first_page_id = test_table->GetFirstPageId();
+  bustub_instance->transaction_manager_->Commit(txn);
+  delete txn;
+
+  std::unordered_map<int64_t, Tuple> expected;
+  auto insert_committed = [&](int num_txns) {
+    for (int i = 0; i < num_txns; i++) {
+      Transaction *insert_txn = bustub_instance->transaction_manager_->Begin();
+      for (int j = 0; j < 50; j++) {
+        RID rid;
+        Tuple tuple = ConstructTuple(&schema);
+        ASSERT_TRUE(test_table->InsertTuple(tuple, &rid, insert_txn));
+        expected[rid.Get()] = tuple;
+      }
+      bustub_instance->transaction_manager_->Commit(insert_txn);
+      delete insert_txn;
+    }
+  };
+  insert_committed(10);
+  size_t num_segments = bustub_instance->disk_manager_->GetNumLogSegments();
+  EXPECT_GT(num_segments, 10U);
+
+  // The checkpoint leaves only the segment currently being written, and archives the rest.
+  bustub_instance->checkpoint_manager_->BeginCheckpoint();
+  bustub_instance->checkpoint_manager_->EndCheckpoint();
+  EXPECT_EQ(1U, bustub_instance->disk_manager_->GetNumLogSegments());
+  size_t num_archived = 0;
+  for (const auto &entry : std::filesystem::directory_iterator("test_log_archive")) {
+    EXPECT_EQ(0, entry.path().filename().string().compare(0, 9, "test.log."));
+    num_archived++;
+  }
+  EXPECT_EQ(num_segments - 1, num_archived);
+
+  insert_committed(5);
+  Transaction *loser = bustub_instance->transaction_manager_->Begin();
+  std::vector<RID> loser_rids;
+  for (int i = 0; i < 50; i++) {
+    RID rid;
+    ASSERT_TRUE(test_table->InsertTuple(ConstructTuple(&schema), &rid, loser));
+    loser_rids.push_back(rid);
+  }
+  bustub_instance->log_manager_->Flush();
+  delete loser;
+  delete test_table;
+
+  // Crash, then recover from what is left of the log.
+  delete bustub_instance;
+
+  bustub_instance = new BustubInstance("test.db");
+  EXPECT_GT(bustub_instance->disk_manager_->GetLogStartOffset(), 0U);
+  auto *log_recovery = new LogRecovery(bustub_instance->disk_manager_, bustub_instance->buffer_pool_manager_);
+  log_recovery->Redo();
+  EXPECT_TRUE(log_recovery->Undo());
+  delete log_recovery;
+
+  txn = bustub_instance->transaction_manager_->Begin();
+  test_table = new TableHeap(bustub_instance->buffer_pool_manager_, bustub_instance->lock_manager_,
+                             bustub_instance->log_manager_, first_page_id);
+  size_t num_tuples = 0;
+  for (auto it = test_table->Begin(txn); it != test_table->End(); ++it) {
+    auto found = expected.find(it->GetRid().Get());
+    ASSERT_NE(found, expected.end());
+    ASSERT_EQ(0, memcmp(it->GetData(), found->second.GetData(), it->GetLength()));
+    num_tuples++;
+  }
+  EXPECT_EQ(expected.size(), num_tuples);
+  Tuple tuple;
+  for (const auto &rid : loser_rids) {
+    EXPECT_FALSE(test_table->GetTuple(rid, &tuple, txn));
+  }
+  bustub_instance->transaction_manager_->Commit(txn);
+  delete txn;
+  delete test_table;
+
+  delete bustub_instance;
+  remove("test.db");
+  RemoveLogSegments("test.log");
+  std::filesystem::remove_all("test_log_archive");
+}
+
+// NOLINTNEXTLINE
+TEST(RecoveryTest, UndoRestartTest) {
+  remove("test.db");
+  RemoveLogSegments("test.log");
+  auto *bustub_instance = new BustubInstance("test.db");
+  bustub_instance->log_manager_->RunFlushThread();
+
+  Column col1{"a", TypeId::VARCHAR, 20};
+  Column col2{"b", TypeId::SMALLINT};
+  Schema schema{std::vector<Column>{col1, col2}};
+
+  Transaction *txn = bustub_instance->transaction_manager_->Begin();
+  auto *test_table = new TableHeap(bustub_instance->buffer_pool_manager_, bustub_instance->lock_manager_,
+                                   bustub_instance->log_manager_, txn);
+  page_id_t first_page_id = test_table->GetFirstPageId();
+  std::vector<RID> rids(30);
+  for (auto &rid : rids) {
+    ASSERT_TRUE(test_table->InsertTuple(ConstructTuple(&schema), &rid, txn));
+  }
+  bustub_instance->transaction_manager_->Commit(txn);
+  delete txn;
+
+  // Reads the whole table into a map from RID to tuple data.
+  auto scan_table = [&]() {
+    std::unordered_map<int64_t, std::string> tuples;
+    Transaction *scan_txn = bustub_instance->transaction_manager_->Begin();
+    auto *table = new TableHeap(bustub_instance->buffer_pool_manager_, bustub_instance->lock_manager_,
+                                bustub_instance->log_manager_, first_page_id);
+    for (auto it = table->Begin(scan_txn); it != table->End(); ++it) {
+      tuples[it->GetRid().Get()] = std::string(it->GetData(), it->GetLength());
+    }
+    bustub_instance->transaction_manager_->Commit(scan_txn);
+    delete scan_txn;
+    delete table;
+    return tuples;
+  };
+  auto expected = scan_table();
+
+  // Several losers that each insert, delete and update tuples of their own.
+  for (int i = 0; i < 4; i++) {
+    Transaction *loser = bustub_instance->transaction_manager_->Begin();
+    for (int j = 0; j < 5; j++) {
+      RID rid;
+      ASSERT_TRUE(test_table->InsertTuple(ConstructTuple(&schema), &rid, loser));
+    }
+    ASSERT_TRUE(test_table->MarkDelete(rids[i * 6], loser));
+    test_table->UpdateTuple(ConstructTuple(&schema), rids[i * 6 + 1], loser);
+    delete loser;
+  }
+  bustub_instance->log_manager_->Flush();
+  delete test_table;
+  delete bustub_instance;
+
+  auto recover = [&]() {
+    bustub_instance = new BustubInstance("test.db");
+    LogRecovery log_recovery(bustub_instance->disk_manager_, bustub_instance->buffer_pool_manager_,
+                             bustub_instance->log_manager_, 2);
+    log_recovery.Redo();
+    EXPECT_TRUE(log_recovery.Undo());
+  };
+
+  // The CLRs and ABORT records of the first recovery start a new segment.
+  recover();
+  EXPECT_EQ(2U, bustub_instance->disk_manager_->GetNumLogSegments());
+  EXPECT_EQ(expected, scan_table());
+  delete bustub_instance;
+
+  // Crash during undo: only the first half of the CLRs made it to disk.
+  std::string last_segment;
+  for (const auto &entry : std::filesystem::directory_iterator(".")) {
+    std::string name = entry.path().filename().string();
+    if (name.compare(0, 9, "test.log.") == 0 && name > last_segment) {
+      last_segment = name;
+    }
+  }
+  auto segment_size = std::filesystem::file_size(last_segment);
+  std::filesystem::resize_file(last_segment, segment_size / 2);
+  recover();
+  EXPECT_EQ(expected, scan_table());
+  delete bustub_instance;
+
+  // Every loser has been rolled back completely now, so recovering again has nothing to undo or log.
+  recover();
+  EXPECT_EQ(expected, scan_table());
+  EXPECT_EQ(3U, bustub_instance->disk_manager_->GetNumLogSegments());
+  delete bustub_instance;
+
+  remove("test.db");
+  RemoveLogSegments("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(RecoveryTest, UpdateDeltaTest) {
+  std::vector<Column> cols;
+  for (int i = 0; i < 8; i++) {
+    cols.emplace_back("c" + std::to_string(i), TypeId::BIGINT);
+  }
+  cols.emplace_back("v", TypeId::VARCHAR, 100);
+  Schema schema{cols};
+  auto make_tuple = [&](int64_t changed, const std::string &varchar) {
+    std::vector<Value> values;
+    for (int i = 0; i < 8; i++) {
+      values.push_back(ValueFactory::GetBigIntValue(i == 3 ? changed : i));
+    }
+    values.push_back(ValueFactory::GetVarcharValue(varchar));
+    return Tuple(values, &schema);
+  };
+  auto check_round_trip = [](const Tuple &old_tuple, const Tuple &new_tuple) {
+    LogRecord update(0, INVALID_LSN, LogRecordType::UPDATE, RID(0, 0), old_tuple, new_tuple);
+    Tuple rebuilt;
+    EXPECT_TRUE(update.ApplyUpdateDelta(old_tuple, true, &rebuilt));
+    EXPECT_EQ(new_tuple.GetLength(), rebuilt.GetLength());
+    EXPECT_EQ(0, memcmp(new_tuple.GetData(), rebuilt.GetData(), new_tuple.GetLength()));
+    EXPECT_TRUE(update.ApplyUpdateDelta(new_tuple, false, &rebuilt));
+    EXPECT_EQ(old_tuple.GetLength(), rebuilt.GetLength());
+    EXPECT_EQ(0, memcmp(old_tuple.GetData(), rebuilt.GetData(), old_tuple.GetLength()));
+    return update.GetSize();
+  };
+
+  std::string text(80, 'a');
+  Tuple old_tuple = make_tuple(3, text);
+  int32_t full_size = check_round_trip(old_tuple, make_tuple(4, std::string(80, 'b')));
+  // Changing a single column only logs the bytes of that column.
+  int32_t one_column_size = check_round_trip(old_tuple, make_tuple(1000, text));
+  EXPECT_LT(one_column_size, full_size / 4);
+  check_round_trip(old_tuple, old_tuple);
+  // Two changes far apart in a tuple of the same size.
+  std::string changed_text = text;
+  changed_text[70] = 'z';
+  check_round_trip(old_tuple, make_tuple(1000, changed_text));
+  // The tuple grows and shrinks.
+  check_round_trip(old_tuple, make_tuple(3, text + "tail"));
+  check_round_trip(old_tuple, make_tuple(3, "a"));
+  check_round_trip(old_tuple, make_tuple(-1, ""));
+
+  // A base tuple that does not match the update is rejected.
+  LogRecord update(0, INVALID_LSN, LogRecordType::UPDATE, RID(0, 0), old_tuple, make_tuple(3, "a"));
+  Tuple rebuilt;
+  EXPECT_FALSE(update.ApplyUpdateDelta(make_tuple(3, "ab"), true, &rebuilt));
+  // So is one of the right size that differs in the changed bytes, e.g. an update that was applied already.
+  Tuple new_tuple = make_tuple(1000, text);
+  LogRecord same_size(0, INVALID_LSN, LogRecordType::UPDATE, RID(0, 0), old_tuple, new_tuple);
+  EXPECT_FALSE(same_size.ApplyUpdateDelta(new_tuple, true, &rebuilt));
+  EXPECT_FALSE(same_size.ApplyUpdateDelta(old_tuple, false, &rebuilt));
+  EXPECT_FALSE(same_size.ApplyUpdateDelta(make_tuple(7, text), true, &rebuilt));
+}
+
+// NOLINTNEXTLINE
+TEST(RecoveryTest, TornTailTest) {
+  remove("test.db");
+  RemoveLogSegments("test.log");
+  auto *bustub_instance = new BustubInstance("test.db");
+  bustub_instance->log_manager_->RunFlushThread();
+
+  Column col1{"a", TypeId::VARCHAR, 20};
+  Column col2{"b", TypeId::SMALLINT};
+  Schema schema{std::vector<Column>{col1, col2}};
+
+  Transaction *txn = bustub_instance->transaction_manager_->Begin();
+  auto *test_table = new TableHeap(bustub_instance->buffer_pool_manager_, bustub_instance->lock_manager_,
+                                   bustub_instance->log_manager_, txn);
+  page_id_t first_page_id = test_table->GetFirstPageId();
+  RID committed_rid;
+  ASSERT_TRUE(test_table->InsertTuple(ConstructTuple(&schema), &committed_rid, txn));
+  bustub_instance->transaction_manager_->Commit(txn);
+  delete txn;
+
+  // The COMMIT record of the second transaction is the last record in the log, and the crash tears it.
+  txn = bustub_instance->transaction_manager_->Begin();
+  RID torn_rid;
+  ASSERT_TRUE(test_table->InsertTuple(ConstructTuple(&schema), &torn_rid, txn));
+  bustub_instance->transaction_manager_->Commit(txn);
+  delete txn;
+  delete test_table;
+  delete bustub_instance;
+
+  std::string segment_file;
+  for (const auto &entry : std::filesystem::directory_iterator(".")) {
+    if (entry.path().filename().string().compare(0, 9, "test.log.") == 0) {
+      segment_file = entry.path().string();
+    }
+  }
+  ASSERT_FALSE(segment_file.empty());
+  auto log_size = std::filesystem::file_size(segment_file);
+  std::filesystem::resize_file(segment_file, log_size - 5);
+
+  bustub_instance = new BustubInstance("test.db");
+  auto *log_recovery = new LogRecovery(bustub_instance->disk_manager_, bustub_instance->buffer_pool_manager_);
+  log_recovery->Redo();
+  EXPECT_TRUE(log_recovery->Undo());
+  delete log_recovery;
+  // Only the torn part of the last record is cut off.
+  EXPECT_EQ(log_size - 5 - (LogRecord(0, 0, LogRecordType::COMMIT).GetSize() - 5),
+            std::filesystem::file_size(segment_file));
+
+  txn = bustub_instance->transaction_manager_->Begin();
+  test_table = new TableHeap(bustub_instance->buffer_pool_manager_, bustub_instance->lock_manager_,
+                             bustub_instance->log_manager_, first_page_id);
+  Tuple tuple;
+  EXPECT_TRUE(test_table->GetTuple(committed_rid, &tuple, txn));
+  EXPECT_FALSE(test_table->GetTuple(torn_rid, &tuple, txn));
+  bustub_instance->transaction_manager_->Commit(txn);
+  delete txn;
+  delete test_table;
+
+  delete bustub_instance;
+  remove("test.db");
+  RemoveLogSegments("test.log");
+}
+
+/**
+ * Replays a synthetic log of BUSTUB_RECOVERY_BENCH_LOG_MB megabytes (1024 by default) of inserts and updates spread
+ * over many pages, and reports the redo throughput for a growing number of redo workers.
+ */
+// NOLINTNEXTLINE
+TEST(RecoveryTest, DISABLED_RedoBenchmark) {
+  const char *log_mb_env = std::getenv("BUSTUB_RECOVERY_BENCH_LOG_MB");
+  const size_t log_bytes = (log_mb_env != nullptr ? std::strtoull(log_mb_env, nullptr, 10) : 1024) << 20;
+  const size_t pool_size = 1024;
+  const page_id_t num_pages = 4096;
+  const int tuples_per_page = 32;
+
+  remove("bench.db");
+  RemoveLogSegments("bench.log");
+  Column col1{"a", TypeId::BIGINT};
+  Column col2{"b", TypeId::BIGINT};
+  Schema schema{std::vector<Column>{col1, col2}};
+  Tuple tuple({ValueFactory::GetBigIntValue(1), ValueFactory::GetBigIntValue(2)}, &schema);
+
+  {
+    auto *disk_manager = new DiskManager("bench.db");
+    auto *log_manager = new LogManager(disk_manager);
+    log_manager->RunFlushThread();
+    size_t bytes = 0;
+    txn_id_t txn_id = 0;
+    lsn_t prev_lsn = INVALID_LSN;
+    auto append = [&](LogRecord *log_record) {
+      prev_lsn = log_manager->AppendLogRecord(log_record);
+      bytes += log_record->GetSize();
+    };
+    LogRecord begin(txn_id, prev_lsn, LogRecordType::BEGIN);
+    append(&begin);
+    for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+      LogRecord new_page(txn_id, prev_lsn, LogRecordType::NEWPAGE, page_id - 1, page_id);
+      append(&new_page);
+    }
+    // Fill the pages round robin so consecutive records hit different pages, then keep updating the same slots.
+    for (size_t i = 0; bytes < log_bytes; i++) {
+      auto page_id = static_cast<page_id_t>(i % num_pages);
+      auto slot = static_cast<uint32_t>(i / num_pages);
+      if (slot < static_cast<uint32_t>(tuples_per_page)) {
+        LogRecord insert(txn_id, prev_lsn, LogRecordType::INSERT, RID(page_id, slot), tuple);
+        append(&insert);
+      } else {
+        LogRecord update(txn_id, prev_lsn, LogRecordType::UPDATE, RID(page_id, slot % tuples_per_page), tuple,
+                         tuple);
+        append(&update);
+      }
+    }
+    LogRecord commit(txn_id, prev_lsn, LogRecordType::COMMIT);
+    append(&commit);
+    log_manager->StopFlushThread();
+    delete log_manager;
+    disk_manager->ShutDown();
+    delete disk_manager;
+  }
+
+  for (size_t num_workers = 1; num_workers <= 8; num_workers *= 2) {
+    remove("bench.db");
+    auto *disk_manager = new DiskManager("bench.db");
+    auto *bpm = new BufferPoolManager(pool_size, disk_manager);
+    LogRecovery log_recovery(disk_manager, bpm, nullptr, num_workers);
+    auto start = std::chrono::steady_clock::now();
+    log_recovery.Redo();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "redo workers: " << num_workers << ", records: " << log_recovery.GetNumRedoRecords()
+              << ", seconds: " << elapsed.count()
+              << ", records/second: " << static_cast<double>(log_recovery.GetNumRedoRecords()) / elapsed.count()
+              << std::endl;
+    delete bpm;
+    disk_manager->ShutDown();
+    delete disk_manager;
+  }
+  remove("bench.db");
+  RemoveLogSegments("bench.log");
+}
+
+/**
+ * Crashes while BUSTUB_UNDO_BENCH_TXNS (2000 by default) transactions with 20 changes each are in flight, and reports
+ * the time to availability, i.e. redo plus undo, for a growing number of recovery workers.
+ */
+// NOLINTNEXTLINE
+TEST(RecoveryTest, DISABLED_UndoBenchmark) {
+  const char *txns_env = std::getenv("BUSTUB_UNDO_BENCH_TXNS");
+  const int num_txns = txns_env != nullptr ? std::atoi(txns_env) : 2000;
+  const int changes_per_txn = 20;
+  const size_t pool_size = 1024;
+
+  remove("bench.db");
+  RemoveLogSegments("bench.log");
+  std::filesystem::remove_all("bench_backup");
+  Column col1{"a", TypeId::BIGINT};
+  Column col2{"b", TypeId::VARCHAR, 32};
+  Schema schema{std::vector<Column>{col1, col2}};
+  auto make_tuple = [&](int64_t value) {
+    return Tuple({ValueFactory::GetBigIntValue(value), ValueFactory::GetVarcharValue(std::string(32, 'x'))}, &schema);
+  };
+
+  {
+    auto *disk_manager = new DiskManager("bench.db");
+    auto *log_manager = new LogManager(disk_manager);
+    auto *bpm = new BufferPoolManager(pool_size, disk_manager, log_manager);
+    auto *lock_manager = new LockManager(TwoPLMode::STRICT, DeadlockMode::PREVENTION);
+    auto *txn_manager = new TransactionManager(lock_manager, log_manager);
+    log_manager->RunFlushThread();
+    Transaction *txn = txn_manager->Begin();
+    auto *table = new TableHeap(bpm, lock_manager, log_manager, txn);
+    txn_manager->Commit(txn);
+    delete txn;
+
+    // The losers interleave their inserts and updates, like concurrent transactions do.
+    std::vector<Transaction *> losers;
+    std::vector<RID> last_rids(num_txns);
+    for (int i = 0; i < num_txns; i++) {
+      losers.push_back(txn_manager->Begin());
+    }
+    for (int change = 0; change < changes_per_txn; change++) {
+      for (int i = 0; i < num_txns; i++) {
+        if (change % 2 == 0) {
+          ASSERT_TRUE(table->InsertTuple(make_tuple(change), &last_rids[i], losers[i]));
+        } else {
+          ASSERT_TRUE(table->UpdateTuple(make_tuple(change), last_rids[i], losers[i]));
+        }
+      }
+    }
+    log_manager->StopFlushThread();
+    for (auto loser : losers) {
+      delete loser;
+    }
+    delete table;
+    delete txn_manager;
+    delete lock_manager;
+    delete bpm;
+    delete log_manager;
+    disk_manager->ShutDown();
+    delete disk_manager;
+  }
+  // Every run recovers from the same crashed state.
+  std::filesystem::create_directory("bench_backup");
+  for (const auto &entry : std::filesystem::directory_iterator(".")) {
+    std::string name = entry.path().filename().string();
+    if (name == "bench.db" || name.compare(0, 10, "bench.log.") == 0) {
+      std::filesystem::copy_file(entry.path(), std::filesystem::path("bench_backup") / name);
+    }
+  }
+
+  for (size_t num_workers = 1; num_workers <= 8; num_workers *= 2) {
+    remove("bench.db");
+    RemoveLogSegments("bench.log");
+    for (const auto &entry : std::filesystem::directory_iterator("bench_backup")) {
+      std::filesystem::copy_file(entry.path(), entry.path().filename());
+    }
+    auto *disk_manager = new DiskManager("bench.db");
+    auto *log_manager = new LogManager(disk_manager);
+    auto *bpm = new BufferPoolManager(pool_size, disk_manager, log_manager);
+    LogRecovery log_recovery(disk_manager, bpm, log_manager, num_workers);
+    auto start = std::chrono::steady_clock::now();
+    log_recovery.Redo();
+    auto redone = std::chrono::steady_clock::now();
+    EXPECT_TRUE(log_recovery.Undo());
+    auto undone = std::chrono::steady_clock::now();
+    std::chrono::duration<double> redo_time = redone - start;
+    std::chrono::duration<double> undo_time = undone - redone;
+    std::cout << "recovery workers: " << num_workers << ", redo seconds: " << redo_time.count()
+              << ", undo seconds: " << undo_time.count()
+              << ", time to availability: " << (redo_time + undo_time).count() << std::endl;
+    delete bpm;
+    delete log_manager;
+    disk_manager->ShutDown();
+    delete disk_manager;
+  }
+  remove("bench.db");
+  RemoveLogSegments("bench.log");
+  std::filesystem::remove_all("bench_backup");
+}
+
+/**
+ * Runs BUSTUB_UPDATE_BENCH_TXNS (20000 by default) transactions that each change one column of ten wide tuples, and
+ * reports the log bytes per transaction and the time it takes to redo them.
+ */
+// NOLINTNEXTLINE
+TEST(RecoveryTest, DISABLED_UpdateLogBenchmark) {
+  const char *txns_env = std::getenv("BUSTUB_UPDATE_BENCH_TXNS");
+  const int num_txns = txns_env != nullptr ? std::atoi(txns_env) : 20000;
+  const int num_tuples = 1000;
+  const int updates_per_txn = 10;
+
+  remove("bench.db");
+  RemoveLogSegments("bench.log");
+  std::vector<Column> cols;
+  for (int i = 0; i < 16; i++) {
+    cols.emplace_back("c" + std::to_string(i), TypeId::BIGINT);
+  }
+  cols.emplace_back("v", TypeId::VARCHAR, 64);
+  Schema schema{cols};
+  auto make_tuple = [&](int64_t counter) {
+    std::vector<Value> values;
+    for (int i = 0; i < 16; i++) {
+      values.push_back(ValueFactory::GetBigIntValue(i == 7 ? counter : i));
+    }
+    values.push_back(ValueFactory::GetVarcharValue(std::string(64, 'v')));
+    return Tuple(values, &schema);
+  };
+  auto log_bytes = [] {
+    uintmax_t bytes = 0;
+    for (const auto &entry : std::filesystem::directory_iterator(".")) {
+      if (entry.path().filename().string().compare(0, 10, "bench.log.") == 0) {
+        bytes += entry.file_size();
+      }
+    }
+    return bytes;
+  };
+
+  auto *bustub_instance = new BustubInstance("bench.db");
+  bustub_instance->log_manager_->RunFlushThread();
+  Transaction *txn = bustub_instance->transaction_manager_->Begin();
+  auto *test_table = new TableHeap(bustub_instance->buffer_pool_manager_, bustub_instance->lock_manager_,
+                                   bustub_instance->log_manager_, txn);
+  std::vector<RID> rids(num_tuples);
+  for (auto &rid : rids) {
+    ASSERT_TRUE(test_table->InsertTuple(make_tuple(0), &rid, txn));
+  }
+  bustub_instance->transaction_manager_->Commit(txn);
+  delete txn;
+
+  uintmax_t bytes_before = log_bytes();
+  std::mt19937 rng(15445);
+  for (int i = 0; i < num_txns; i++) {
+    txn = bustub_instance->transaction_manager_->Begin();
+    for (int j = 0; j < updates_per_txn; j++) {
+      ASSERT_TRUE(test_table->UpdateTuple(make_tuple(i * updates_per_txn + j), rids[rng() % num_tuples], txn));
+    }
+    bustub_instance->transaction_manager_->Commit(txn);
+    delete txn;
+  }
+  uintmax_t update_bytes = log_bytes() - bytes_before;
+  // BEGIN and COMMIT records are just a header.
+  size_t header_size = LogRecord(0, INVALID_LSN, LogRecordType::BEGIN).GetSize();
+  size_t update_size = header_size + sizeof(RID) + 2 * (sizeof(int32_t) + make_tuple(0).GetLength());
+  size_t full_image_bytes = 2 * header_size + updates_per_txn * update_size;
+  std::cout << "log bytes per transaction: " << static_cast<double>(update_bytes) / num_txns
+            << ", with full tuple images: " << full_image_bytes << std::endl;
+  delete test_table;
+  delete bustub_instance;
+
+  remove("bench.db");
+  bustub_instance = new BustubInstance("bench.db");
+  LogRecovery log_recovery(bustub_instance->disk_manager_, bustub_instance->buffer_pool_manager_);
+  auto start = std::chrono::steady_clock::now();
+  log_recovery.Redo();
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  std::cout << "redo records: " << log_recovery.GetNumRedoRecords() << ", seconds: " << elapsed.count()
+            << ", records/second: " << static_cast<double>(log_recovery.GetNumRedoRecords()) / elapsed.count()
+            << std::endl;
+  delete bustub_instance;
+  remove("bench.db");
+  RemoveLogSegments("bench.log");
+}
+
+/**
+ * Appends BUSTUB_LOG_BENCH_RECORDS (5 million by default) insert records through a running log manager and reports
+ * the append throughput.
+ */
+// NOLINTNEXTLINE
+TEST(RecoveryTest, DISABLED_LogAppendBenchmark) {
+  const char *records_env = std::getenv("BUSTUB_LOG_BENCH_RECORDS");
+  const size_t num_records = records_env != nullptr ? std::strtoull(records_env, nullptr, 10) : 5000000;
+
+  remove("bench.db");
+  RemoveLogSegments("bench.log");
+  Column col1{"a", TypeId::BIGINT};
+  Column col2{"b", TypeId::VARCHAR, 100};
+  Schema schema{std::vector<Column>{col1, col2}};
+  Tuple tuple({ValueFactory::GetBigIntValue(1), ValueFactory::GetVarcharValue(std::string(100, 'x'))}, &schema);
+
+  auto *disk_manager = new DiskManager("bench.db");
+  auto *log_manager = new LogManager(disk_manager);
+  log_manager->RunFlushThread();
+  size_t bytes = 0;
+  lsn_t prev_lsn = INVALID_LSN;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < num_records; i++) {
+    LogRecord insert(0, prev_lsn, LogRecordType::INSERT, RID(static_cast<page_id_t>(i / 32), i % 32), tuple);
+    prev_lsn = log_manager->AppendLogRecord(&insert);
+    bytes += insert.GetSize();
+  }
+  log_manager->Flush();
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  std::cout << "records: " << num_records << ", seconds: " << elapsed.count()
+            << ", records/second: " << static_cast<double>(num_records) / elapsed.count()
+            << ", MB/second: " << static_cast<double>(bytes) / (1 << 20) / elapsed.count() << std::endl;
+  log_manager->StopFlushThread();
+  delete log_manager;
+  disk_manager->ShutDown();
+  delete disk_manager;
+  remove("bench.db");
+  RemoveLogSegments("bench.log");
 }
 
 // NOLINTNEXTLINE
-TEST(RecoveryTest, DISABLED_CheckpointTest) {
+TEST(RecoveryTest, CheckpointTest) {
   remove("test.db");
-  remove("test.log");
+  RemoveLogSegments("test.log");
   BustubInstance *bustub_instance = new BustubInstance("test.db");
 
   EXPECT_FALSE(enable_logging);
@@ -312,6 +1023,6 @@ TEST(RecoveryTest, DISABLED_CheckpointTest) {
 
   LOG_INFO("Tearing down the system..");
   remove("test.db");
-  remove("test.log");
+  RemoveLogSegments("test.log");
 }
 }  // namespace bustub
@@ -0,0 +1,405 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_test.cpp
+//
+// Identification: test/storage/b_plus_tree_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/b_plus_tree_index.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+using BPlusTreeType = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+
+GenericKey<8> MakeKey(int64_t i) {
+  GenericKey<8> key;
+  key.SetFromInteger(i);
+  return key;
+}
+
+/** Collects the keys of the entries from an iterator up to the end. */
+std::vector<int64_t> ScanKeys(IndexIterator<GenericKey<8>, RID, GenericComparator<8>> iterator) {
+  std::vector<int64_t> keys;
+  for (; !iterator.IsEnd(); ++iterator) {
+    keys.push_back((*iterator).second.Get());
+  }
+  return keys;
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeTest, InsertTest) {
+  const int num_keys = 2000;
+  Schema key_schema{std::vector<Column>{Column{"a", TypeId::BIGINT}}};
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  // small pages, so that the tree grows a few levels
+  BPlusTreeType tree("foo_pk", bpm, GenericComparator<8>(&key_schema), 3, 4);
+  EXPECT_TRUE(tree.IsEmpty());
+  EXPECT_TRUE(tree.Begin().IsEnd());
+
+  std::vector<int64_t> keys;
+  for (int64_t i = 0; i < num_keys; i++) {
+    keys.push_back(i);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+  for (int64_t key : keys) {
+    EXPECT_TRUE(tree.Insert(MakeKey(key), RID(key)));
+  }
+  EXPECT_FALSE(tree.IsEmpty());
+  tree.VerifyIntegrity();
+
+  // keys are unique
+  EXPECT_FALSE(tree.Insert(MakeKey(7), RID(8)));
+  for (int64_t i = 0; i < num_keys; i++) {
+    std::vector<RID> result;
+    EXPECT_TRUE(tree.GetValue(MakeKey(i), &result));
+    ASSERT_EQ(1, result.size());
+    EXPECT_EQ(i, result[0].Get());
+  }
+  std::vector<RID> result;
+  EXPECT_FALSE(tree.GetValue(MakeKey(num_keys), &result));
+  EXPECT_FALSE(tree.GetValue(MakeKey(-1), &result));
+  EXPECT_EQ(0, result.size());
+
+  // the iterator returns the keys in order
+  std::sort(keys.begin(), keys.end());
+  EXPECT_EQ(keys, ScanKeys(tree.Begin()));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeTest, DeleteTest) {
+  const int num_keys = 2000;
+  Schema key_schema{std::vector<Column>{Column{"a", TypeId::BIGINT}}};
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  BPlusTreeType tree("foo_pk", bpm, GenericComparator<8>(&key_schema), 4, 3);
+
+  std::vector<int64_t> keys;
+  for (int64_t i = 0; i < num_keys; i++) {
+    keys.push_back(i);
+    EXPECT_TRUE(tree.Insert(MakeKey(i), RID(i)));
+  }
+
+  // removing every other key in random order merges and redistributes pages
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+  std::vector<int64_t> remaining;
+  for (int64_t key : keys) {
+    if (key % 2 == 0) {
+      EXPECT_TRUE(tree.Remove(MakeKey(key)));
+      EXPECT_FALSE(tree.Remove(MakeKey(key)));
+    } else {
+      remaining.push_back(key);
+    }
+  }
+  tree.VerifyIntegrity();
+  for (int64_t i = 0; i < num_keys; i++) {
+    std::vector<RID> result;
+    EXPECT_EQ(i % 2 == 1, tree.GetValue(MakeKey(i), &result));
+  }
+  std::sort(remaining.begin(), remaining.end());
+  EXPECT_EQ(remaining, ScanKeys(tree.Begin()));
+
+  // the tree shrinks down to nothing, and grows again
+  for (int64_t key : keys) {
+    EXPECT_EQ(key % 2 == 1, tree.Remove(MakeKey(key)));
+  }
+  EXPECT_TRUE(tree.IsEmpty());
+  EXPECT_EQ(INVALID_PAGE_ID, tree.GetRootPageId());
+  EXPECT_TRUE(tree.Begin().IsEnd());
+  EXPECT_TRUE(tree.Insert(MakeKey(1), RID(1)));
+  EXPECT_EQ(std::vector<int64_t>{1}, ScanKeys(tree.Begin()));
+  tree.VerifyIntegrity();
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeTest, RangeScanTest) {
+  Schema key_schema{std::vector<Column>{Column{"a", TypeId::BIGINT}}};
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  BPlusTreeType tree("foo_pk", bpm, GenericComparator<8>(&key_schema), 3, 3);
+
+  // keys 0, 10, ..., 990
+  for (int64_t i = 0; i < 100; i++) {
+    EXPECT_TRUE(tree.Insert(MakeKey(10 * i), RID(10 * i)));
+  }
+
+  // a scan starts at the first key that is not smaller than the start key
+  std::vector<int64_t> expected;
+  for (int64_t i = 50; i < 100; i++) {
+    expected.push_back(10 * i);
+  }
+  EXPECT_EQ(expected, ScanKeys(tree.Begin(MakeKey(500))));
+  EXPECT_EQ(expected, ScanKeys(tree.Begin(MakeKey(495))));
+  expected.erase(expected.begin());
+  EXPECT_EQ(expected, ScanKeys(tree.Begin(MakeKey(501))));
+  EXPECT_EQ(100, ScanKeys(tree.Begin(MakeKey(-5))).size());
+  EXPECT_TRUE(tree.Begin(MakeKey(991)) == tree.End());
+
+  // iterators release their leaves, so the tree can be modified after a scan ends early
+  {
+    auto iterator = tree.Begin(MakeKey(200));
+    EXPECT_EQ(200, (*iterator).second.Get());
+    ++iterator;
+    EXPECT_EQ(210, (*iterator).second.Get());
+  }
+  for (int64_t i = 0; i < 100; i++) {
+    EXPECT_TRUE(tree.Remove(MakeKey(10 * i)));
+  }
+  EXPECT_TRUE(tree.IsEmpty());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeTest, BulkLoadTest) {
+  Schema key_schema{std::vector<Column>{Column{"a", TypeId::BIGINT}}};
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  for (int num_keys : {0, 1, 5, 6, 7, 100, 1000}) {
+    BPlusTreeType tree("foo_pk", bpm, GenericComparator<8>(&key_schema), 5, 3);
+    std::vector<std::pair<GenericKey<8>, RID>> items;
+    std::vector<int64_t> keys;
+    for (int64_t i = 0; i < num_keys; i++) {
+      items.emplace_back(MakeKey(2 * i), RID(2 * i));
+      keys.push_back(2 * i);
+    }
+    EXPECT_TRUE(tree.BulkLoad(items));
+    tree.VerifyIntegrity();
+    EXPECT_EQ(keys, ScanKeys(tree.Begin()));
+
+    // the tree takes inserts and removes afterwards
+    for (int64_t i = 0; i < num_keys; i++) {
+      EXPECT_TRUE(tree.Insert(MakeKey(2 * i + 1), RID(2 * i + 1)));
+    }
+    tree.VerifyIntegrity();
+    for (int64_t i = 0; i < 2 * num_keys; i++) {
+      EXPECT_TRUE(tree.Remove(MakeKey(i)));
+    }
+    EXPECT_TRUE(tree.IsEmpty());
+  }
+
+  // the input must be sorted and unique, and the tree empty
+  BPlusTreeType tree("foo_pk", bpm, GenericComparator<8>(&key_schema), 5, 3);
+  std::vector<std::pair<GenericKey<8>, RID>> unsorted{{MakeKey(2), RID(2)}, {MakeKey(1), RID(1)}};
+  EXPECT_FALSE(tree.BulkLoad(unsorted));
+  std::vector<std::pair<GenericKey<8>, RID>> duplicates{{MakeKey(1), RID(1)}, {MakeKey(1), RID(1)}};
+  EXPECT_FALSE(tree.BulkLoad(duplicates));
+  EXPECT_TRUE(tree.IsEmpty());
+  EXPECT_TRUE(tree.Insert(MakeKey(0), RID(0)));
+  std::vector<std::pair<GenericKey<8>, RID>> sorted{{MakeKey(1), RID(1)}, {MakeKey(2), RID(2)}};
+  EXPECT_FALSE(tree.BulkLoad(sorted));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeTest, ConcurrentTest) {
+  const int num_threads = 4;
+  const int num_keys = 4000;
+  Schema key_schema{std::vector<Column>{Column{"a", TypeId::BIGINT}}};
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  BPlusTreeType tree("foo_pk", bpm, GenericComparator<8>(&key_schema), 3, 4);
+
+  // Every thread inserts its keys and removes half of them again while a scanner checks that the keys are in order,
+  // so pages split and merge under the scans.
+  std::atomic<bool> done{false};
+  std::thread scanner([&] {
+    while (!done) {
+      std::vector<int64_t> keys = ScanKeys(tree.Begin());
+      EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+      EXPECT_EQ(keys.end(), std::adjacent_find(keys.begin(), keys.end()));
+    }
+  });
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      std::vector<int64_t> keys;
+      for (int64_t i = t; i < num_keys; i += num_threads) {
+        keys.push_back(i);
+      }
+      std::shuffle(keys.begin(), keys.end(), std::mt19937(t));
+      for (int64_t key : keys) {
+        EXPECT_TRUE(tree.Insert(MakeKey(key), RID(key)));
+      }
+      for (int64_t key : keys) {
+        std::vector<RID> result;
+        EXPECT_TRUE(tree.GetValue(MakeKey(key), &result));
+        if (key % 4 < 2) {
+          EXPECT_TRUE(tree.Remove(MakeKey(key)));
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  done = true;
+  scanner.join();
+
+  tree.VerifyIntegrity();
+  std::vector<int64_t> expected;
+  for (int64_t i = 0; i < num_keys; i++) {
+    if (i % 4 >= 2) {
+      expected.push_back(i);
+    }
+  }
+  EXPECT_EQ(expected, ScanKeys(tree.Begin()));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeTest, IndexTest) {
+  Schema schema{std::vector<Column>{Column{"a", TypeId::BIGINT}, Column{"b", TypeId::INTEGER}}};
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  // the index takes over its metadata
+  auto *metadata = new IndexMetadata("foo_pk", "foo", &schema, {0});
+  BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>> index(metadata, bpm);
+
+  for (int64_t i = 0; i < 1000; i++) {
+    Tuple key(std::vector<Value>{ValueFactory::GetBigIntValue(i)}, metadata->GetKeySchema());
+    index.InsertEntry(key, RID(i), nullptr);
+  }
+  Tuple key(std::vector<Value>{ValueFactory::GetBigIntValue(500)}, metadata->GetKeySchema());
+  std::vector<RID> result;
+  index.ScanKey(key, &result, nullptr);
+  EXPECT_EQ(std::vector<RID>{RID(500)}, result);
+  index.DeleteEntry(key, RID(500), nullptr);
+  result.clear();
+  index.ScanKey(key, &result, nullptr);
+  EXPECT_TRUE(result.empty());
+
+  EXPECT_EQ(999, ScanKeys(index.GetBeginIterator()).size());
+  EXPECT_EQ(499, ScanKeys(index.GetBeginIterator(MakeKey(500))).size());
+  EXPECT_TRUE(index.GetEndIterator().IsEnd());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+/**
+ * Measures point lookups and range scans of BUSTUB_BTREE_BENCH_SCAN keys (100 by default) for BUSTUB_BTREE_BENCH_MS
+ * milliseconds (1000 by default) on a tree bulk loaded with BUSTUB_BTREE_BENCH_KEYS keys (100000 by default), while
+ * 0, 1 or 2 other threads insert keys in between.
+ */
+// NOLINTNEXTLINE
+TEST(BPlusTreeTest, DISABLED_PointRangeBenchmark) {
+  const char *ms_env = std::getenv("BUSTUB_BTREE_BENCH_MS");
+  const auto duration = std::chrono::milliseconds(ms_env != nullptr ? std::atoi(ms_env) : 1000);
+  const char *keys_env = std::getenv("BUSTUB_BTREE_BENCH_KEYS");
+  const int64_t num_keys = keys_env != nullptr ? std::atoi(keys_env) : 100000;
+  const char *scan_env = std::getenv("BUSTUB_BTREE_BENCH_SCAN");
+  const int64_t scan_length = scan_env != nullptr ? std::atoi(scan_env) : 100;
+  Schema key_schema{std::vector<Column>{Column{"a", TypeId::BIGINT}}};
+
+  for (int num_inserters : {0, 1, 2}) {
+    auto *disk_manager = new DiskManager("btree_bench.db");
+    auto *bpm = new BufferPoolManager(4096, disk_manager);
+    BPlusTreeType tree("bench", bpm, GenericComparator<8>(&key_schema));
+    std::vector<std::pair<GenericKey<8>, RID>> items;
+    for (int64_t i = 0; i < num_keys; i++) {
+      items.emplace_back(MakeKey(2 * i), RID(2 * i));
+    }
+    tree.BulkLoad(items);
+
+    // the inserters fill in the odd keys
+    std::atomic<bool> done{false};
+    std::atomic<size_t> num_inserts{0};
+    std::vector<std::thread> inserters;
+    for (int t = 0; t < num_inserters; t++) {
+      inserters.emplace_back([&, t] {
+        for (int64_t i = t; i < num_keys && !done; i += num_inserters) {
+          tree.Insert(MakeKey(2 * i + 1), RID(2 * i + 1));
+          num_inserts++;
+        }
+      });
+    }
+
+    std::cout << "inserters: " << num_inserters;
+    for (bool range : {false, true}) {
+      std::mt19937_64 rng(0);
+      std::uniform_int_distribution<int64_t> pick_key(0, num_keys - 1);
+      size_t num_ops = 0;
+      size_t num_found = 0;
+      auto start = std::chrono::steady_clock::now();
+      auto end = start + duration;
+      while (std::chrono::steady_clock::now() < end) {
+        for (int i = 0; i < 100; i++) {
+          int64_t key = 2 * pick_key(rng);
+          if (range) {
+            auto iterator = tree.Begin(MakeKey(key));
+            for (int64_t j = 0; j < scan_length && !iterator.IsEnd(); j++, ++iterator) {
+              num_found++;
+            }
+          } else {
+            std::vector<RID> result;
+            num_found += tree.GetValue(MakeKey(key), &result) ? 1 : 0;
+          }
+        }
+        num_ops += 100;
+      }
+      std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+      if (!range) {
+        EXPECT_EQ(num_ops, num_found);
+      }
+      std::cout << ", " << (range ? "range scans/s: " : "point lookups/s: ") << num_ops / seconds.count();
+    }
+    done = true;
+    for (auto &inserter : inserters) {
+      inserter.join();
+    }
+    std::cout << ", inserts during the run: " << num_inserts << std::endl;
+
+    disk_manager->ShutDown();
+    remove("btree_bench.db");
+    delete disk_manager;
+    delete bpm;
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,194 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// generic_key_test.cpp
+//
+// Identification: test/storage/generic_key_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/index/generic_key.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+template <size_t KeySize>
+GenericKey<KeySize> MakeKey(const std::vector<Value> &values, Schema *key_schema) {
+  GenericKey<KeySize> key;
+  key.SetFromKey(Tuple(values, key_schema), key_schema);
+  return key;
+}
+
+// NOLINTNEXTLINE
+TEST(GenericKeyTest, IntegerOrderTest) {
+  Schema key_schema{std::vector<Column>{Column{"a", TypeId::BIGINT}}};
+  GenericComparator<8> comparator(&key_schema);
+  std::vector<int64_t> values{BUSTUB_INT64_MIN, -1000000000000, -256, -1, 0, 1, 255, 256, BUSTUB_INT64_MAX};
+  for (size_t i = 0; i < values.size(); i++) {
+    GenericKey<8> key;
+    key.SetFromInteger(values[i]);
+    EXPECT_EQ(values[i], key.ToString());
+    EXPECT_EQ(values[i], key.ToValue(&key_schema, 0).GetAs<int64_t>());
+    for (size_t j = 0; j < values.size(); j++) {
+      GenericKey<8> other = MakeKey<8>({ValueFactory::GetBigIntValue(values[j])}, &key_schema);
+      EXPECT_EQ(i < j, comparator(key, other) < 0);
+      EXPECT_EQ(i == j, comparator(key, other) == 0);
+      EXPECT_EQ(i > j, comparator(key, other) > 0);
+    }
+  }
+
+  // NULL sorts first
+  GenericKey<8> null_key = MakeKey<8>({ValueFactory::GetNullValueByType(TypeId::BIGINT)}, &key_schema);
+  EXPECT_TRUE(null_key.ToValue(&key_schema, 0).IsNull());
+  GenericKey<8> min_key;
+  min_key.SetFromInteger(BUSTUB_INT64_MIN);
+  EXPECT_LT(comparator(null_key, min_key), 0);
+}
+
+// NOLINTNEXTLINE
+TEST(GenericKeyTest, DecimalOrderTest) {
+  Schema key_schema{std::vector<Column>{Column{"a", TypeId::DECIMAL}}};
+  GenericComparator<8> comparator(&key_schema);
+  std::vector<double> values{-1e300, -1e100, -2.5, -1e-300, 0.0, 1e-300, 2.5, 1e100, BUSTUB_DECIMAL_MAX};
+  for (size_t i = 0; i < values.size(); i++) {
+    GenericKey<8> key = MakeKey<8>({ValueFactory::GetDecimalValue(values[i])}, &key_schema);
+    EXPECT_EQ(values[i], key.ToValue(&key_schema, 0).GetAs<double>());
+    for (size_t j = 0; j < values.size(); j++) {
+      GenericKey<8> other = MakeKey<8>({ValueFactory::GetDecimalValue(values[j])}, &key_schema);
+      EXPECT_EQ(i < j, comparator(key, other) < 0);
+      EXPECT_EQ(i == j, comparator(key, other) == 0);
+    }
+  }
+
+  // -0.0 equals 0.0, so the keys have to be equal bytes for hash indexes
+  GenericKey<8> negative_zero = MakeKey<8>({ValueFactory::GetDecimalValue(-0.0)}, &key_schema);
+  GenericKey<8> zero = MakeKey<8>({ValueFactory::GetDecimalValue(0.0)}, &key_schema);
+  EXPECT_EQ(0, memcmp(negative_zero.data_, zero.data_, 8));
+  EXPECT_EQ(0.0, negative_zero.ToValue(&key_schema, 0).GetAs<double>());
+
+  // NULL sorts first
+  GenericKey<8> null_key = MakeKey<8>({ValueFactory::GetNullValueByType(TypeId::DECIMAL)}, &key_schema);
+  EXPECT_TRUE(null_key.ToValue(&key_schema, 0).IsNull());
+  EXPECT_LT(comparator(null_key, MakeKey<8>({ValueFactory::GetDecimalValue(-1e300)}, &key_schema)), 0);
+}
+
+// NOLINTNEXTLINE
+TEST(GenericKeyTest, TimestampOrderTest) {
+  Schema key_schema{std::vector<Column>{Column{"a", TypeId::TIMESTAMP}}};
+  GenericComparator<8> comparator(&key_schema);
+  std::vector<uint64_t> values{0, 1, 1000000, BUSTUB_TIMESTAMP_NULL - 1};
+  for (size_t i = 0; i < values.size(); i++) {
+    GenericKey<8> key = MakeKey<8>({ValueFactory::GetTimestampValue(values[i])}, &key_schema);
+    EXPECT_EQ(values[i], key.ToValue(&key_schema, 0).GetAs<uint64_t>());
+    for (size_t j = 0; j < values.size(); j++) {
+      GenericKey<8> other = MakeKey<8>({ValueFactory::GetTimestampValue(values[j])}, &key_schema);
+      EXPECT_EQ(i < j, comparator(key, other) < 0);
+      EXPECT_EQ(i == j, comparator(key, other) == 0);
+    }
+  }
+
+  // NULL, the largest timestamp in a tuple, sorts first
+  GenericKey<8> null_key = MakeKey<8>({ValueFactory::GetTimestampValue(BUSTUB_TIMESTAMP_NULL)}, &key_schema);
+  EXPECT_TRUE(null_key.ToValue(&key_schema, 0).IsNull());
+  EXPECT_LT(comparator(null_key, MakeKey<8>({ValueFactory::GetTimestampValue(0)}, &key_schema)), 0);
+}
+
+// NOLINTNEXTLINE
+TEST(GenericKeyTest, MultiColumnTest) {
+  Schema key_schema{std::vector<Column>{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 20},
+                                        Column{"c", TypeId::SMALLINT}}};
+  GenericComparator<16> comparator(&key_schema);
+  auto make_key = [&](int32_t a, const Value &b, int16_t c) {
+    return MakeKey<16>({ValueFactory::GetIntegerValue(a), b, ValueFactory::GetSmallIntValue(c)}, &key_schema);
+  };
+
+  // the columns compare in order, the varchar gets the 10 bytes the integers leave
+  std::vector<GenericKey<16>> keys{
+      make_key(-5, ValueFactory::GetVarcharValue("zzz"), 9),
+      make_key(3, ValueFactory::GetNullValueByType(TypeId::VARCHAR), 9),
+      make_key(3, ValueFactory::GetVarcharValue(""), 9),
+      make_key(3, ValueFactory::GetVarcharValue("ab"), -1),
+      make_key(3, ValueFactory::GetVarcharValue("ab"), 0),
+      make_key(3, ValueFactory::GetVarcharValue("abc"), -9),
+      make_key(3, ValueFactory::GetVarcharValue("b"), 0),
+  };
+  for (size_t i = 0; i < keys.size(); i++) {
+    for (size_t j = 0; j < keys.size(); j++) {
+      EXPECT_EQ(i < j, comparator(keys[i], keys[j]) < 0) << i << " " << j;
+      EXPECT_EQ(i == j, comparator(keys[i], keys[j]) == 0) << i << " " << j;
+    }
+  }
+
+  GenericKey<16> key = keys[5];
+  EXPECT_EQ(3, key.ToValue(&key_schema, 0).GetAs<int32_t>());
+  EXPECT_EQ("abc", key.ToValue(&key_schema, 1).ToString());
+  EXPECT_EQ(-9, key.ToValue(&key_schema, 2).GetAs<int16_t>());
+  EXPECT_TRUE(keys[1].ToValue(&key_schema, 1).IsNull());
+
+  // varchars are compared by the prefix that fits into the key
+  EXPECT_EQ(0, comparator(make_key(1, ValueFactory::GetVarcharValue("abcdefghijklm"), 2),
+                          make_key(1, ValueFactory::GetVarcharValue("abcdefghijxyz"), 2)));
+  EXPECT_EQ("abcdefghi",
+            make_key(1, ValueFactory::GetVarcharValue("abcdefghijklm"), 2).ToValue(&key_schema, 1).ToString());
+}
+
+/**
+ * Measures comparisons of random keys for BUSTUB_KEY_BENCH_MS milliseconds (1000 by default), for a BIGINT key and
+ * for an (INTEGER, VARCHAR) key.
+ */
+template <size_t KeySize>
+void ComparatorBenchmark(const std::string &name, const std::vector<GenericKey<KeySize>> &keys,
+                         const GenericComparator<KeySize> &comparator) {
+  const char *ms_env = std::getenv("BUSTUB_KEY_BENCH_MS");
+  const auto duration = std::chrono::milliseconds(ms_env != nullptr ? std::atoi(ms_env) : 1000);
+  size_t num_ops = 0;
+  int64_t checksum = 0;
+  auto start = std::chrono::steady_clock::now();
+  auto end = start + duration;
+  while (std::chrono::steady_clock::now() < end) {
+    for (size_t i = 0; i < keys.size(); i++) {
+      checksum += comparator(keys[i], keys[(i * 7 + 1) % keys.size()]) < 0 ? 1 : 0;
+    }
+    num_ops += keys.size();
+  }
+  std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+  std::cout << name << ", comparisons/s: " << num_ops / seconds.count() << " (" << checksum << ")" << std::endl;
+}
+
+// NOLINTNEXTLINE
+TEST(GenericKeyTest, DISABLED_ComparatorBenchmark) {
+  const int num_keys = 4096;
+  std::mt19937_64 rng(0);
+
+  Schema bigint_schema{std::vector<Column>{Column{"a", TypeId::BIGINT}}};
+  std::vector<GenericKey<8>> bigint_keys;
+  for (int i = 0; i < num_keys; i++) {
+    bigint_keys.push_back(MakeKey<8>({ValueFactory::GetBigIntValue(rng())}, &bigint_schema));
+  }
+  ComparatorBenchmark("BIGINT", bigint_keys, GenericComparator<8>(&bigint_schema));
+
+  Schema pair_schema{std::vector<Column>{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 20}}};
+  std::vector<GenericKey<32>> pair_keys;
+  for (int i = 0; i < num_keys; i++) {
+    // few distinct integers, so that most comparisons go on to the varchar
+    std::string name = "user" + std::to_string(rng() % 100000);
+    pair_keys.push_back(MakeKey<32>(
+        {ValueFactory::GetIntegerValue(static_cast<int32_t>(rng() % 4)), ValueFactory::GetVarcharValue(name)},
+        &pair_schema));
+  }
+  ComparatorBenchmark("(INTEGER, VARCHAR)", pair_keys, GenericComparator<32>(&pair_schema));
+}
+
+}  // namespace bustub
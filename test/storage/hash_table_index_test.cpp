@@ -0,0 +1,160 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_index_test.cpp
+//
+// Identification: test/storage/hash_table_index_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/linear_probe_hash_table_index.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/** Fills a table with rows (i, i % num_keys) and returns their RIDs. */
+std::vector<RID> FillTable(TableHeap *table, const Schema *schema, int64_t num_rows, int32_t num_keys,
+                           Transaction *txn) {
+  std::vector<RID> rids;
+  for (int64_t i = 0; i < num_rows; i++) {
+    Tuple tuple({ValueFactory::GetBigIntValue(i), ValueFactory::GetIntegerValue(static_cast<int32_t>(i % num_keys))},
+                schema);
+    RID rid;
+    EXPECT_TRUE(table->InsertTuple(tuple, &rid, txn));
+    rids.push_back(rid);
+  }
+  return rids;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableIndexTest, BulkLoadTest) {
+  Schema schema{std::vector<Column>{Column{"a", TypeId::BIGINT}, Column{"b", TypeId::INTEGER}}};
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(100, disk_manager);
+  Transaction txn(0);
+  TableHeap table(bpm, nullptr, nullptr, &txn);
+  std::vector<RID> rids = FillTable(&table, &schema, 5000, 1000, &txn);
+
+  // An index with enough buckets, and one that is resized before it is loaded. The index is on b, every key has 5 RIDs.
+  for (size_t num_buckets : {10000, 100}) {
+    // the index takes over its metadata
+    auto *metadata = new IndexMetadata("foo_b", "foo", &schema, {1});
+    LinearProbeHashTableIndex<GenericKey<8>, RID, GenericComparator<8>> index(metadata, bpm, num_buckets,
+                                                                              HashFunction<GenericKey<8>>());
+    EXPECT_TRUE(index.BulkLoad(&table, &schema, &txn));
+    // loading the table again would insert every entry twice
+    EXPECT_FALSE(index.BulkLoad(&table, &schema, &txn));
+
+    std::vector<Tuple> keys;
+    for (int32_t b = 0; b < 1001; b++) {
+      keys.emplace_back(std::vector<Value>{ValueFactory::GetIntegerValue(b)}, metadata->GetKeySchema());
+    }
+    std::vector<std::vector<RID>> results;
+    index.ScanKeys(keys, &results, nullptr);
+    for (int32_t b = 0; b < 1001; b++) {
+      std::vector<RID> expected;
+      for (int64_t i = b; i < 5000 && b < 1000; i += 1000) {
+        expected.push_back(rids[i]);
+      }
+      std::sort(results[b].begin(), results[b].end(),
+                [](const RID &l, const RID &r) { return l.Get() < r.Get(); });
+      EXPECT_EQ(expected, results[b]) << b;
+    }
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableIndexTest, BulkLoadResizeTest) {
+  Schema schema{std::vector<Column>{Column{"a", TypeId::BIGINT}, Column{"b", TypeId::INTEGER}}};
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(100, disk_manager);
+  Transaction txn(0);
+  TableHeap table(bpm, nullptr, nullptr, &txn);
+  const int64_t num_rows = 20000;
+  std::vector<RID> rids = FillTable(&table, &schema, num_rows, 1, &txn);
+
+  // The index starts out with far fewer buckets than the table has rows, it is sized for all of them up front.
+  auto *metadata = new IndexMetadata("foo_a", "foo", &schema, {0});
+  LinearProbeHashTableIndex<GenericKey<8>, RID, GenericComparator<8>> index(metadata, bpm, 16,
+                                                                            HashFunction<GenericKey<8>>());
+  EXPECT_TRUE(index.BulkLoad(&table, &schema, &txn));
+  EXPECT_GE(index.GetNumBuckets(), 2 * num_rows);
+
+  std::vector<Tuple> keys;
+  for (int64_t a = 0; a < num_rows; a++) {
+    keys.emplace_back(std::vector<Value>{ValueFactory::GetBigIntValue(a)}, metadata->GetKeySchema());
+  }
+  std::vector<std::vector<RID>> results;
+  index.ScanKeys(keys, &results, nullptr);
+  for (int64_t a = 0; a < num_rows; a++) {
+    EXPECT_EQ(std::vector<RID>{rids[a]}, results[a]) << a;
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+/**
+ * Builds an index on a table of BUSTUB_INDEX_BENCH_ROWS rows (100000 by default) with an entry per tuple, and with a
+ * bulk load. The index has twice as many buckets as the table has rows; the block pages of a hash table fit into a
+ * single header page, which limits the size of the table.
+ */
+// NOLINTNEXTLINE
+TEST(HashTableIndexTest, DISABLED_BulkLoadBenchmark) {
+  const char *rows_env = std::getenv("BUSTUB_INDEX_BENCH_ROWS");
+  const int64_t num_rows = rows_env != nullptr ? std::atoi(rows_env) : 100000;
+  Schema schema{std::vector<Column>{Column{"a", TypeId::BIGINT}, Column{"b", TypeId::INTEGER}}};
+  auto *disk_manager = new DiskManager("index_bench.db");
+  auto *bpm = new BufferPoolManager(num_rows / 50 + 4096, disk_manager);
+  Transaction txn(0);
+  TableHeap table(bpm, nullptr, nullptr, &txn);
+  FillTable(&table, &schema, num_rows, static_cast<int32_t>(num_rows), &txn);
+
+  for (bool bulk : {false, true}) {
+    auto *metadata = new IndexMetadata("foo_a", "foo", &schema, {0});
+    LinearProbeHashTableIndex<GenericKey<8>, RID, GenericComparator<8>> index(metadata, bpm, 2 * num_rows,
+                                                                              HashFunction<GenericKey<8>>());
+    auto start = std::chrono::steady_clock::now();
+    if (bulk) {
+      index.BulkLoad(&table, &schema, &txn);
+    } else {
+      for (auto iter = table.Begin(&txn); iter != table.End(); ++iter) {
+        Tuple key({iter->GetValue(&schema, 0)}, metadata->GetKeySchema());
+        index.InsertEntry(key, iter->GetRid(), &txn);
+      }
+    }
+    std::chrono::duration<double, std::milli> millis = std::chrono::steady_clock::now() - start;
+    std::vector<RID> result;
+    index.ScanKey(Tuple({ValueFactory::GetBigIntValue(num_rows / 2)}, metadata->GetKeySchema()), &result, nullptr);
+    EXPECT_EQ(1, result.size());
+    std::cout << "rows: " << num_rows << ", " << (bulk ? "bulk load" : "entry per tuple") << " ms: " << millis.count()
+              << std::endl;
+  }
+
+  disk_manager->ShutDown();
+  remove("index_bench.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+}  // namespace bustub